@@ -54,6 +54,7 @@ void AStar3D::add_point(int64_t p_id, const Vector3 &p_pos, real_t p_weight_scal
 	bool p_exists = points.lookup(p_id, found_pt);
 
 	if (!p_exists) {
+		ERR_FAIL_COND_MSG(frozen, vformat("Can't add point with id: %d to a frozen graph.", p_id));
 		Point *pt = memnew(Point);
 		pt->id = p_id;
 		pt->pos = p_pos;
@@ -66,6 +67,7 @@ void AStar3D::add_point(int64_t p_id, const Vector3 &p_pos, real_t p_weight_scal
 	} else {
 		found_pt->pos = p_pos;
 		found_pt->weight_scale = p_weight_scale;
+		_update_frozen_point(found_pt);
 	}
 }
 
@@ -83,6 +85,7 @@ void AStar3D::set_point_position(int64_t p_id, const Vector3 &p_pos) {
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set point's position. Point with id: %d doesn't exist.", p_id));
 
 	p->pos = p_pos;
+	_update_frozen_point(p);
 }
 
 real_t AStar3D::get_point_weight_scale(int64_t p_id) const {
@@ -100,12 +103,14 @@ void AStar3D::set_point_weight_scale(int64_t p_id, real_t p_weight_scale) {
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
 
 	p->weight_scale = p_weight_scale;
+	_update_frozen_point(p);
 }
 
 void AStar3D::remove_point(int64_t p_id) {
 	Point *p = nullptr;
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't remove point. Point with id: %d doesn't exist.", p_id));
+	ERR_FAIL_COND_MSG(frozen, vformat("Can't remove point with id: %d from a frozen graph.", p_id));
 
 	for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
 		Segment s(p_id, (*it.key));
@@ -130,6 +135,7 @@ void AStar3D::remove_point(int64_t p_id) {
 
 void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional) {
 	ERR_FAIL_COND_MSG(p_id == p_with_id, vformat("Can't connect point with id: %d to itself.", p_id));
+	ERR_FAIL_COND_MSG(frozen, "Can't connect points of a frozen graph.");
 
 	Point *a = nullptr;
 	bool from_exists = points.lookup(p_id, a);
@@ -167,6 +173,8 @@ void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional
 }
 
 void AStar3D::disconnect_points(int64_t p_id, int64_t p_with_id, bool bidirectional) {
+	ERR_FAIL_COND_MSG(frozen, "Can't disconnect points of a frozen graph.");
+
 	Point *a = nullptr;
 	bool a_exists = points.lookup(p_id, a);
 	ERR_FAIL_COND_MSG(!a_exists, vformat("Can't disconnect points. Point with id: %d doesn't exist.", p_id));
@@ -227,6 +235,13 @@ Vector<int64_t> AStar3D::get_point_connections(int64_t p_id) {
 
 	Vector<int64_t> point_list;
 
+	if (frozen) {
+		for (uint32_t i = frozen_neighbor_offsets[p->frozen_index]; i < frozen_neighbor_offsets[p->frozen_index + 1]; i++) {
+			point_list.push_back(frozen_ids[frozen_neighbors[i]]);
+		}
+		return point_list;
+	}
+
 	for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
 		point_list.push_back((*it.key));
 	}
@@ -243,6 +258,8 @@ bool AStar3D::are_points_connected(int64_t p_id, int64_t p_with_id, bool bidirec
 }
 
 void AStar3D::clear() {
+	_clear_frozen();
+	frozen = false;
 	last_free_id = 0;
 	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
 		memdelete(*(it.value));
@@ -440,6 +457,21 @@ Vector<Vector3> AStar3D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 		return ret;
 	}
 
+	if (frozen) {
+		LocalVector<uint32_t> index_path;
+		if (!_solve_frozen(this, a->frozen_index, b->frozen_index, p_allow_partial_path, index_path)) {
+			return Vector<Vector3>();
+		}
+
+		Vector<Vector3> path;
+		path.resize(index_path.size());
+		Vector3 *w = path.ptrw();
+		for (uint32_t i = 0; i < index_path.size(); i++) {
+			w[i] = frozen_positions[index_path[i]];
+		}
+		return path;
+	}
+
 	Point *begin_point = a;
 	Point *end_point = b;
 
@@ -494,6 +526,21 @@ Vector<int64_t> AStar3D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 		return ret;
 	}
 
+	if (frozen) {
+		LocalVector<uint32_t> index_path;
+		if (!_solve_frozen(this, a->frozen_index, b->frozen_index, p_allow_partial_path, index_path)) {
+			return Vector<int64_t>();
+		}
+
+		Vector<int64_t> path;
+		path.resize(index_path.size());
+		int64_t *w = path.ptrw();
+		for (uint32_t i = 0; i < index_path.size(); i++) {
+			w[i] = frozen_ids[index_path[i]];
+		}
+		return path;
+	}
+
 	Point *begin_point = a;
 	Point *end_point = b;
 
@@ -539,6 +586,7 @@ void AStar3D::set_point_disabled(int64_t p_id, bool p_disabled) {
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set if point is disabled. Point with id: %d doesn't exist.", p_id));
 
 	p->enabled = !p_disabled;
+	_update_frozen_point(p);
 }
 
 bool AStar3D::is_point_disabled(int64_t p_id) const {
@@ -549,6 +597,224 @@ bool AStar3D::is_point_disabled(int64_t p_id) const {
 	return !p->enabled;
 }
 
+void AStar3D::set_frozen(bool p_frozen) {
+	if (frozen == p_frozen) {
+		return;
+	}
+
+	if (!p_frozen) {
+		_unpack_frozen_neighbors();
+	}
+	_clear_frozen();
+	frozen = p_frozen;
+	if (!frozen) {
+		return;
+	}
+
+	const uint32_t point_count = points.get_num_elements();
+	LocalVector<Point *> packed_points;
+	packed_points.reserve(point_count);
+	frozen_ids.resize(point_count);
+	frozen_positions.resize(point_count);
+	frozen_weight_scales.resize(point_count);
+	frozen_enabled.resize(point_count);
+	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		Point *p = *it.value;
+		p->frozen_index = packed_points.size();
+		packed_points.push_back(p);
+		_update_frozen_point(p);
+	}
+
+	frozen_neighbor_offsets.resize(point_count + 1);
+	for (uint32_t i = 0; i < point_count; i++) {
+		frozen_neighbor_offsets[i] = frozen_neighbors.size();
+		const Point *p = packed_points[i];
+		for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
+			frozen_neighbors.push_back((*it.value)->frozen_index);
+		}
+	}
+	frozen_neighbor_offsets[point_count] = frozen_neighbors.size();
+
+	// The packed arrays hold the connections now, shrink the per-point maps to their minimum until unfrozen.
+	for (Point *p : packed_points) {
+		p->neighbors = OAHashMap<int64_t, Point *>(1u);
+		p->unlinked_neighbours = OAHashMap<int64_t, Point *>(1u);
+	}
+
+	// Extensions look up their overrides on the first call, do it now rather than from the query threads.
+	GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost);
+	GDVIRTUAL_IS_OVERRIDDEN(_compute_cost);
+}
+
+bool AStar3D::is_frozen() const {
+	return frozen;
+}
+
+void AStar3D::_unpack_frozen_neighbors() {
+	const uint32_t point_count = frozen_ids.size();
+	LocalVector<Point *> packed_points;
+	packed_points.resize(point_count);
+	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		packed_points[(*it.value)->frozen_index] = *it.value;
+	}
+
+	for (uint32_t i = 0; i < point_count; i++) {
+		Point *p = packed_points[i];
+		for (uint32_t j = frozen_neighbor_offsets[i]; j < frozen_neighbor_offsets[i + 1]; j++) {
+			Point *e = packed_points[frozen_neighbors[j]];
+			p->neighbors.set(e->id, e);
+		}
+	}
+
+	// Points keep the one-way connections towards them apart, see connect_points().
+	for (Point *p : packed_points) {
+		for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
+			Point *e = *it.value;
+			if (!e->neighbors.has(p->id)) {
+				e->unlinked_neighbours.set(p->id, p);
+			}
+		}
+	}
+}
+
+void AStar3D::_update_frozen_point(const Point *p_point) {
+	if (!frozen) {
+		return;
+	}
+	const uint32_t index = p_point->frozen_index;
+	frozen_ids[index] = p_point->id;
+	frozen_positions[index] = p_point->pos;
+	frozen_weight_scales[index] = p_point->weight_scale;
+	frozen_enabled[index] = p_point->enabled;
+}
+
+void AStar3D::_clear_frozen() {
+	frozen_ids.clear();
+	frozen_positions.clear();
+	frozen_weight_scales.clear();
+	frozen_enabled.clear();
+	frozen_neighbor_offsets.clear();
+	frozen_neighbors.clear();
+
+	MutexLock lock(frozen_searches_mutex);
+	for (FrozenSearch *search : frozen_searches) {
+		memdelete(search);
+	}
+	frozen_searches.clear();
+}
+
+template <typename T>
+bool AStar3D::_solve_frozen(T *p_owner, uint32_t p_begin_index, uint32_t p_end_index, bool p_allow_partial_path, LocalVector<uint32_t> &r_path) const {
+	if (!frozen_enabled[p_end_index] && !p_allow_partial_path) {
+		return false;
+	}
+
+	FrozenSearch *search = nullptr;
+	{
+		MutexLock lock(frozen_searches_mutex);
+		if (!frozen_searches.is_empty()) {
+			search = frozen_searches[frozen_searches.size() - 1];
+			frozen_searches.remove_at(frozen_searches.size() - 1);
+		}
+	}
+	if (search == nullptr) {
+		search = memnew(FrozenSearch);
+	}
+	if (search->points.size() != frozen_ids.size()) {
+		search->points.resize(frozen_ids.size());
+		for (FrozenSearchPoint &point : search->points) {
+			point = FrozenSearchPoint();
+		}
+		search->pass = 0;
+	}
+
+	// Points are pushed to the open list again when a shorter path to them is found, the outdated entries are skipped.
+	const uint64_t search_pass = ++search->pass;
+	LocalVector<FrozenSearchPoint> &search_points = search->points;
+	LocalVector<FrozenOpenPoint> &open_list = search->open_list;
+	SortArray<FrozenOpenPoint, SortFrozenOpenPoints> sorter;
+	open_list.clear();
+
+	const int64_t end_id = frozen_ids[p_end_index];
+	FrozenSearchPoint &begin_point = search_points[p_begin_index];
+	begin_point.open_pass = search_pass;
+	begin_point.g_score = 0;
+	FrozenOpenPoint begin;
+	begin.index = p_begin_index;
+	begin.f_score = p_owner->_estimate_cost(frozen_ids[p_begin_index], end_id);
+	open_list.push_back(begin);
+
+	bool found_route = false;
+	uint32_t closest_index = UINT32_MAX;
+	real_t closest_g_score = 0;
+	real_t closest_h_score = 0;
+
+	while (!open_list.is_empty()) {
+		const FrozenOpenPoint current = open_list[0];
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.remove_at(open_list.size() - 1);
+
+		FrozenSearchPoint &p = search_points[current.index];
+		if (p.closed_pass == search_pass || current.g_score > p.g_score) {
+			continue;
+		}
+		p.closed_pass = search_pass;
+
+		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
+		const real_t h_score = current.f_score - current.g_score;
+		if (closest_index == UINT32_MAX || closest_h_score > h_score || (closest_h_score >= h_score && closest_g_score > current.g_score)) {
+			closest_index = current.index;
+			closest_g_score = current.g_score;
+			closest_h_score = h_score;
+		}
+
+		if (current.index == p_end_index) {
+			found_route = true;
+			break;
+		}
+
+		const int64_t p_id = frozen_ids[current.index];
+		for (uint32_t i = frozen_neighbor_offsets[current.index]; i < frozen_neighbor_offsets[current.index + 1]; i++) {
+			const uint32_t e_index = frozen_neighbors[i];
+			FrozenSearchPoint &e = search_points[e_index];
+			if (!frozen_enabled[e_index] || e.closed_pass == search_pass) {
+				continue;
+			}
+
+			const int64_t e_id = frozen_ids[e_index];
+			const real_t tentative_g_score = current.g_score + p_owner->_compute_cost(p_id, e_id) * frozen_weight_scales[e_index];
+			if (e.open_pass == search_pass && tentative_g_score >= e.g_score) { // The new path is worse than the previous.
+				continue;
+			}
+
+			e.open_pass = search_pass;
+			e.prev_index = current.index;
+			e.g_score = tentative_g_score;
+
+			FrozenOpenPoint open;
+			open.index = e_index;
+			open.g_score = tentative_g_score;
+			open.f_score = tentative_g_score + p_owner->_estimate_cost(e_id, end_id);
+			open_list.push_back(open);
+			sorter.push_heap(0, open_list.size() - 1, 0, open, open_list.ptr());
+		}
+	}
+
+	// Use the closest point for partial paths.
+	const bool has_path = found_route || (p_allow_partial_path && closest_index != UINT32_MAX);
+	if (has_path) {
+		for (uint32_t index = found_route ? p_end_index : closest_index; index != p_begin_index; index = search_points[index].prev_index) {
+			r_path.push_back(index);
+		}
+		r_path.push_back(p_begin_index);
+		r_path.invert();
+	}
+
+	MutexLock lock(frozen_searches_mutex);
+	frozen_searches.push_back(search);
+	return has_path;
+}
+
 void AStar3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_available_point_id"), &AStar3D::get_available_point_id);
 	ClassDB::bind_method(D_METHOD("add_point", "id", "position", "weight_scale"), &AStar3D::add_point, DEFVAL(1.0));
@@ -564,6 +830,9 @@ void AStar3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_point_disabled", "id", "disabled"), &AStar3D::set_point_disabled, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("is_point_disabled", "id"), &AStar3D::is_point_disabled);
 
+	ClassDB::bind_method(D_METHOD("set_frozen", "frozen"), &AStar3D::set_frozen, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_frozen"), &AStar3D::is_frozen);
+
 	ClassDB::bind_method(D_METHOD("connect_points", "id", "to_id", "bidirectional"), &AStar3D::connect_points, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("disconnect_points", "id", "to_id", "bidirectional"), &AStar3D::disconnect_points, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("are_points_connected", "id", "to_id", "bidirectional"), &AStar3D::are_points_connected, DEFVAL(true));
@@ -638,6 +907,18 @@ bool AStar2D::is_point_disabled(int64_t p_id) const {
 	return astar.is_point_disabled(p_id);
 }
 
+void AStar2D::set_frozen(bool p_frozen) {
+	astar.set_frozen(p_frozen);
+	if (p_frozen) {
+		GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost);
+		GDVIRTUAL_IS_OVERRIDDEN(_compute_cost);
+	}
+}
+
+bool AStar2D::is_frozen() const {
+	return astar.is_frozen();
+}
+
 void AStar2D::connect_points(int64_t p_id, int64_t p_with_id, bool p_bidirectional) {
 	astar.connect_points(p_id, p_with_id, p_bidirectional);
 }
@@ -723,6 +1004,22 @@ Vector<Vector2> AStar2D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 		return ret;
 	}
 
+	if (astar.frozen) {
+		LocalVector<uint32_t> index_path;
+		if (!astar._solve_frozen(this, a->frozen_index, b->frozen_index, p_allow_partial_path, index_path)) {
+			return Vector<Vector2>();
+		}
+
+		Vector<Vector2> path;
+		path.resize(index_path.size());
+		Vector2 *w = path.ptrw();
+		for (uint32_t i = 0; i < index_path.size(); i++) {
+			const Vector3 &pos = astar.frozen_positions[index_path[i]];
+			w[i] = Vector2(pos.x, pos.y);
+		}
+		return path;
+	}
+
 	AStar3D::Point *begin_point = a;
 	AStar3D::Point *end_point = b;
 
@@ -777,6 +1074,21 @@ Vector<int64_t> AStar2D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 		return ret;
 	}
 
+	if (astar.frozen) {
+		LocalVector<uint32_t> index_path;
+		if (!astar._solve_frozen(this, a->frozen_index, b->frozen_index, p_allow_partial_path, index_path)) {
+			return Vector<int64_t>();
+		}
+
+		Vector<int64_t> path;
+		path.resize(index_path.size());
+		int64_t *w = path.ptrw();
+		for (uint32_t i = 0; i < index_path.size(); i++) {
+			w[i] = astar.frozen_ids[index_path[i]];
+		}
+		return path;
+	}
+
 	AStar3D::Point *begin_point = a;
 	AStar3D::Point *end_point = b;
 
@@ -903,6 +1215,9 @@ void AStar2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_point_disabled", "id", "disabled"), &AStar2D::set_point_disabled, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("is_point_disabled", "id"), &AStar2D::is_point_disabled);
 
+	ClassDB::bind_method(D_METHOD("set_frozen", "frozen"), &AStar2D::set_frozen, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_frozen"), &AStar2D::is_frozen);
+
 	ClassDB::bind_method(D_METHOD("connect_points", "id", "to_id", "bidirectional"), &AStar2D::connect_points, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("disconnect_points", "id", "to_id", "bidirectional"), &AStar2D::disconnect_points, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("are_points_connected", "id", "to_id", "bidirectional"), &AStar2D::are_points_connected, DEFVAL(true));
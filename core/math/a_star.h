@@ -33,6 +33,8 @@
 
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 
 /**
@@ -64,6 +66,9 @@ class AStar3D : public RefCounted {
 		// Used for getting closest_point_of_last_pathing_call.
 		real_t abs_g_score = 0;
 		real_t abs_f_score = 0;
+
+		// Index in the packed arrays of a frozen graph.
+		uint32_t frozen_index = 0;
 	};
 
 	struct SortPoints {
@@ -108,6 +113,39 @@ class AStar3D : public RefCounted {
 		}
 	};
 
+	// Search state of a point in a query on a frozen graph.
+	struct FrozenSearchPoint {
+		uint32_t prev_index = 0;
+		uint64_t open_pass = 0;
+		uint64_t closed_pass = 0;
+		real_t g_score = 0;
+	};
+
+	struct FrozenOpenPoint {
+		uint32_t index = 0;
+		real_t g_score = 0;
+		real_t f_score = 0;
+	};
+
+	struct SortFrozenOpenPoints {
+		_FORCE_INLINE_ bool operator()(const FrozenOpenPoint &A, const FrozenOpenPoint &B) const { // Returns true when the Point A is worse than Point B.
+			if (A.f_score > B.f_score) {
+				return true;
+			} else if (A.f_score < B.f_score) {
+				return false;
+			} else {
+				return A.g_score < B.g_score;
+			}
+		}
+	};
+
+	// Buffers of one query at a time, reused by the following queries.
+	struct FrozenSearch {
+		uint64_t pass = 0;
+		LocalVector<FrozenSearchPoint> points;
+		LocalVector<FrozenOpenPoint> open_list;
+	};
+
 	int64_t last_free_id = 0;
 	uint64_t pass = 1;
 
@@ -115,8 +153,26 @@ class AStar3D : public RefCounted {
 	HashSet<Segment, Segment> segments;
 	Point *last_closest_point = nullptr;
 
+	// A frozen graph is also packed into arrays, with the neighbors of each point in a contiguous range.
+	// Its queries keep their state in their own buffers, so that several threads can query it at once.
+	bool frozen = false;
+	LocalVector<int64_t> frozen_ids;
+	LocalVector<Vector3> frozen_positions;
+	LocalVector<real_t> frozen_weight_scales;
+	LocalVector<bool> frozen_enabled;
+	LocalVector<uint32_t> frozen_neighbor_offsets;
+	LocalVector<uint32_t> frozen_neighbors;
+	mutable BinaryMutex frozen_searches_mutex;
+	mutable LocalVector<FrozenSearch *> frozen_searches;
+
 	bool _solve(Point *begin_point, Point *end_point, bool p_allow_partial_path);
 
+	void _update_frozen_point(const Point *p_point);
+	void _unpack_frozen_neighbors();
+	void _clear_frozen();
+	template <typename T>
+	bool _solve_frozen(T *p_owner, uint32_t p_begin_index, uint32_t p_end_index, bool p_allow_partial_path, LocalVector<uint32_t> &r_path) const;
+
 protected:
 	static void _bind_methods();
 
@@ -148,6 +204,9 @@ public:
 	void set_point_disabled(int64_t p_id, bool p_disabled = true);
 	bool is_point_disabled(int64_t p_id) const;
 
+	void set_frozen(bool p_frozen = true);
+	bool is_frozen() const;
+
 	void connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional = true);
 	void disconnect_points(int64_t p_id, int64_t p_with_id, bool bidirectional = true);
 	bool are_points_connected(int64_t p_id, int64_t p_with_id, bool bidirectional = true) const;
@@ -169,6 +228,7 @@ public:
 
 class AStar2D : public RefCounted {
 	GDCLASS(AStar2D, RefCounted);
+	friend class AStar3D;
 	AStar3D astar;
 
 	bool _solve(AStar3D::Point *begin_point, AStar3D::Point *end_point, bool p_allow_partial_path);
@@ -204,6 +264,9 @@ public:
 	void set_point_disabled(int64_t p_id, bool p_disabled = true);
 	bool is_point_disabled(int64_t p_id) const;
 
+	void set_frozen(bool p_frozen = true);
+	bool is_frozen() const;
+
 	void connect_points(int64_t p_id, int64_t p_with_id, bool p_bidirectional = true);
 	void disconnect_points(int64_t p_id, int64_t p_with_id, bool p_bidirectional = true);
 	bool are_points_connected(int64_t p_id, int64_t p_with_id, bool p_bidirectional = true) const;
@@ -33,6 +33,10 @@
 
 #include "core/variant/typed_array.h"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 static real_t heuristic_euclidean(const Vector2i &p_from, const Vector2i &p_to) {
 	real_t dx = (real_t)ABS(p_to.x - p_from.x);
 	real_t dy = (real_t)ABS(p_to.y - p_from.y);
@@ -60,6 +64,85 @@ static real_t heuristic_chebyshev(const Vector2i &p_from, const Vector2i &p_to)
 
 static real_t (*heuristics[AStarGrid2D::HEURISTIC_MAX])(const Vector2i &, const Vector2i &) = { heuristic_euclidean, heuristic_manhattan, heuristic_octile, heuristic_chebyshev };
 
+// Both expect a non-zero value.
+static _FORCE_INLINE_ uint32_t count_trailing_zeros(uint64_t p_value) {
+#if defined(__GNUC__)
+	return __builtin_ctzll(p_value);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, p_value);
+	return index;
+#else
+	uint32_t count = 0;
+	while (!(p_value & 1)) {
+		p_value >>= 1;
+		count++;
+	}
+	return count;
+#endif
+}
+
+static _FORCE_INLINE_ uint32_t count_leading_zeros(uint64_t p_value) {
+#if defined(__GNUC__)
+	return __builtin_clzll(p_value);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanReverse64(&index, p_value);
+	return 63 - index;
+#else
+	uint32_t count = 0;
+	while (!(p_value & (uint64_t(1) << 63))) {
+		p_value <<= 1;
+		count++;
+	}
+	return count;
+#endif
+}
+
+// Returns the 64 bits of a mask row starting at p_bit. Bits outside of the mask are solid.
+static _FORCE_INLINE_ uint64_t load_mask_bits(const LocalVector<uint64_t> &p_mask, uint32_t p_stride, int64_t p_row, int64_t p_bit) {
+	if (p_row < 0 || (p_row + 1) * p_stride > p_mask.size()) {
+		return UINT64_MAX;
+	}
+	const uint64_t *row = p_mask.ptr() + p_row * p_stride;
+	const int64_t word = p_bit >= 0 ? p_bit / 64 : -((63 - p_bit) / 64);
+	const uint32_t shift = p_bit - word * 64;
+	const uint64_t low = (word >= 0 && word < p_stride) ? row[word] : UINT64_MAX;
+	if (shift == 0) {
+		return low;
+	}
+	const uint64_t high = (word + 1 >= 0 && word + 1 < p_stride) ? row[word + 1] : UINT64_MAX;
+	return (low >> shift) | (high << (64 - shift));
+}
+
+// Returns the bits of the 64 points from p_bit on in p_dir direction. The first point is the lowest bit
+// when going forward and the highest bit when going backward, so that bit scans find the closest point.
+static _FORCE_INLINE_ uint64_t load_mask_steps(const LocalVector<uint64_t> &p_mask, uint32_t p_stride, int64_t p_row, int64_t p_bit, int32_t p_dir) {
+	return load_mask_bits(p_mask, p_stride, p_row, p_dir > 0 ? p_bit : p_bit - 63);
+}
+
+static _FORCE_INLINE_ uint32_t get_first_step(uint64_t p_steps, int32_t p_dir) {
+	return p_dir > 0 ? count_trailing_zeros(p_steps) : count_leading_zeros(p_steps);
+}
+
+static _FORCE_INLINE_ uint64_t get_step_bit(uint32_t p_step, int32_t p_dir) {
+	return uint64_t(1) << (p_dir > 0 ? p_step : 63 - p_step);
+}
+
+// Clears the bits in [p_from, p_to) of a mask row.
+static void clear_mask_bits(uint64_t *p_row, uint32_t p_from, uint32_t p_to) {
+	uint32_t bit = p_from;
+	while (bit < p_to) {
+		if ((bit & 63) == 0 && bit + 64 <= p_to) {
+			p_row[bit >> 6] = 0;
+			bit += 64;
+		} else {
+			p_row[bit >> 6] &= ~(uint64_t(1) << (bit & 63));
+			bit++;
+		}
+	}
+}
+
 void AStarGrid2D::set_region(const Rect2i &p_region) {
 	ERR_FAIL_COND(p_region.size.x < 0 || p_region.size.y < 0);
 	if (p_region != region) {
@@ -128,46 +211,61 @@ void AStarGrid2D::update() {
 
 	points.clear();
 	solid_mask.clear();
-
-	const int32_t end_x = region.get_end().x;
-	const int32_t end_y = region.get_end().y;
-	const Vector2 half_cell_size = cell_size / 2;
-	for (int32_t x = region.position.x; x < end_x + 2; x++) {
-		solid_mask.push_back(true);
-	}
-
-	for (int32_t y = region.position.y; y < end_y; y++) {
-		LocalVector<Point> line;
-		solid_mask.push_back(true);
-		for (int32_t x = region.position.x; x < end_x; x++) {
-			Vector2 v = offset;
-			switch (cell_shape) {
-				case CELL_SHAPE_ISOMETRIC_RIGHT:
-					v += half_cell_size + Vector2(x + y, y - x) * half_cell_size;
-					break;
-				case CELL_SHAPE_ISOMETRIC_DOWN:
-					v += half_cell_size + Vector2(x - y, x + y) * half_cell_size;
-					break;
-				case CELL_SHAPE_SQUARE:
-					v += Vector2(x, y) * cell_size;
-					break;
-				default:
-					break;
+	solid_mask_transposed.clear();
+	weight_scales.clear();
+
+	// Everything is solid except for the region, leaving a solid border around it.
+	solid_mask_stride = (region.size.x + 2 + 63) / 64;
+	solid_mask_transposed_stride = (region.size.y + 2 + 63) / 64;
+	solid_mask.resize(solid_mask_stride * (region.size.y + 2));
+	solid_mask_transposed.resize(solid_mask_transposed_stride * (region.size.x + 2));
+	for (uint64_t &word : solid_mask) {
+		word = UINT64_MAX;
+	}
+	for (uint64_t &word : solid_mask_transposed) {
+		word = UINT64_MAX;
+	}
+	for (int32_t y = 1; y <= region.size.y; y++) {
+		clear_mask_bits(solid_mask.ptr() + y * solid_mask_stride, 1, region.size.x + 1);
+	}
+	for (int32_t x = 1; x <= region.size.x; x++) {
+		clear_mask_bits(solid_mask_transposed.ptr() + x * solid_mask_transposed_stride, 1, region.size.y + 1);
+	}
+
+	if (!compact_storage_enabled) {
+		const int32_t end_x = region.get_end().x;
+		const int32_t end_y = region.get_end().y;
+		for (int32_t y = region.position.y; y < end_y; y++) {
+			LocalVector<Point> line;
+			for (int32_t x = region.position.x; x < end_x; x++) {
+				line.push_back(Point(Vector2i(x, y)));
 			}
-			line.push_back(Point(Vector2i(x, y), v));
-			solid_mask.push_back(false);
+			points.push_back(line);
 		}
-		solid_mask.push_back(true);
-		points.push_back(line);
-	}
-
-	for (int32_t x = region.position.x; x < end_x + 2; x++) {
-		solid_mask.push_back(true);
 	}
 
 	dirty = false;
 }
 
+Vector2 AStarGrid2D::_get_point_position_unchecked(const Vector2i &p_id) const {
+	const Vector2 half_cell_size = cell_size / 2;
+	Vector2 v = offset;
+	switch (cell_shape) {
+		case CELL_SHAPE_ISOMETRIC_RIGHT:
+			v += half_cell_size + Vector2(p_id.x + p_id.y, p_id.y - p_id.x) * half_cell_size;
+			break;
+		case CELL_SHAPE_ISOMETRIC_DOWN:
+			v += half_cell_size + Vector2(p_id.x - p_id.y, p_id.x + p_id.y) * half_cell_size;
+			break;
+		case CELL_SHAPE_SQUARE:
+			v += Vector2(p_id.x, p_id.y) * cell_size;
+			break;
+		default:
+			break;
+	}
+	return v;
+}
+
 bool AStarGrid2D::is_in_bounds(int32_t p_x, int32_t p_y) const {
 	return region.has_point(Vector2i(p_x, p_y));
 }
@@ -188,6 +286,17 @@ bool AStarGrid2D::is_jumping_enabled() const {
 	return jumping_enabled;
 }
 
+void AStarGrid2D::set_compact_storage_enabled(bool p_enabled) {
+	if (compact_storage_enabled != p_enabled) {
+		compact_storage_enabled = p_enabled;
+		dirty = true;
+	}
+}
+
+bool AStarGrid2D::is_compact_storage_enabled() const {
+	return compact_storage_enabled;
+}
+
 void AStarGrid2D::set_diagonal_mode(DiagonalMode p_diagonal_mode) {
 	ERR_FAIL_INDEX((int)p_diagonal_mode, (int)DIAGONAL_MODE_MAX);
 	diagonal_mode = p_diagonal_mode;
@@ -231,13 +340,13 @@ void AStarGrid2D::set_point_weight_scale(const Vector2i &p_id, real_t p_weight_s
 	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set point's weight scale. Point %s out of bounds %s.", p_id, region));
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
-	_get_point_unchecked(p_id)->weight_scale = p_weight_scale;
+	_set_weight_scale_unchecked(p_id, p_weight_scale);
 }
 
 real_t AStarGrid2D::get_point_weight_scale(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, 0, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), 0, vformat("Can't get point's weight scale. Point %s out of bounds %s.", p_id, region));
-	return _get_point_unchecked(p_id)->weight_scale;
+	return _get_weight_scale_unchecked(p_id);
 }
 
 void AStarGrid2D::fill_solid_region(const Rect2i &p_region, bool p_solid) {
@@ -264,37 +373,55 @@ void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weig
 
 	for (int32_t y = safe_region.position.y; y < end_y; y++) {
 		for (int32_t x = safe_region.position.x; x < end_x; x++) {
-			_get_point_unchecked(x, y)->weight_scale = p_weight_scale;
+			_set_weight_scale_unchecked(Vector2i(x, y), p_weight_scale);
+		}
+	}
+}
+
+void AStarGrid2D::_set_weight_scale_unchecked(const Vector2i &p_id, real_t p_weight_scale) {
+	if (weight_scales.is_empty()) {
+		if (p_weight_scale == 1.0) {
+			return;
+		}
+		weight_scales.resize(region.size.x * region.size.y);
+		for (real_t &weight_scale : weight_scales) {
+			weight_scale = 1.0;
 		}
 	}
+	weight_scales[_to_index(p_id)] = p_weight_scale;
 }
 
-AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
-	int32_t from_x = p_from->id.x;
-	int32_t from_y = p_from->id.y;
+bool AStarGrid2D::_jump(const Vector2i &p_from, const Vector2i &p_to, Vector2i &r_jump) const {
+	int32_t from_x = p_from.x;
+	int32_t from_y = p_from.y;
 
-	int32_t to_x = p_to->id.x;
-	int32_t to_y = p_to->id.y;
+	int32_t to_x = p_to.x;
+	int32_t to_y = p_to.y;
 
 	int32_t dx = to_x - from_x;
 	int32_t dy = to_y - from_y;
 
+	Vector2i successor;
+
 	if (diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE) {
 		if (dx == 0 || dy == 0) {
-			return _forced_successor(to_x, to_y, dx, dy);
+			return _forced_successor(to_x, to_y, dx, dy, r_jump);
 		}
 
 		while (_is_walkable(to_x, to_y) && (diagonal_mode == DIAGONAL_MODE_ALWAYS || _is_walkable(to_x, to_y - dy) || _is_walkable(to_x - dx, to_y))) {
-			if (end->id.x == to_x && end->id.y == to_y) {
-				return end;
+			if (end_id.x == to_x && end_id.y == to_y) {
+				r_jump = end_id;
+				return true;
 			}
 
 			if ((_is_walkable(to_x - dx, to_y + dy) && !_is_walkable(to_x - dx, to_y)) || (_is_walkable(to_x + dx, to_y - dy) && !_is_walkable(to_x, to_y - dy))) {
-				return _get_point_unchecked(to_x, to_y);
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
-			if (_forced_successor(to_x + dx, to_y, dx, 0) != nullptr || _forced_successor(to_x, to_y + dy, 0, dy) != nullptr) {
-				return _get_point_unchecked(to_x, to_y);
+			if (_forced_successor(to_x + dx, to_y, dx, 0, successor) || _forced_successor(to_x, to_y + dy, 0, dy, successor)) {
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
 			to_x += dx;
@@ -303,20 +430,23 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 
 	} else if (diagonal_mode == DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES) {
 		if (dx == 0 || dy == 0) {
-			return _forced_successor(from_x, from_y, dx, dy, true);
+			return _forced_successor(from_x, from_y, dx, dy, r_jump, true);
 		}
 
 		while (_is_walkable(to_x, to_y) && _is_walkable(to_x, to_y - dy) && _is_walkable(to_x - dx, to_y)) {
-			if (end->id.x == to_x && end->id.y == to_y) {
-				return end;
+			if (end_id.x == to_x && end_id.y == to_y) {
+				r_jump = end_id;
+				return true;
 			}
 
 			if ((_is_walkable(to_x + dx, to_y + dy) && !_is_walkable(to_x, to_y + dy)) || !_is_walkable(to_x + dx, to_y)) {
-				return _get_point_unchecked(to_x, to_y);
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
-			if (_forced_successor(to_x, to_y, dx, 0) != nullptr || _forced_successor(to_x, to_y, 0, dy) != nullptr) {
-				return _get_point_unchecked(to_x, to_y);
+			if (_forced_successor(to_x, to_y, dx, 0, successor) || _forced_successor(to_x, to_y, 0, dy, successor)) {
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
 			to_x += dx;
@@ -325,130 +455,107 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 
 	} else { // DIAGONAL_MODE_NEVER
 		if (dy == 0) {
-			return _forced_successor(from_x, from_y, dx, 0, true);
+			return _forced_successor(from_x, from_y, dx, 0, r_jump, true);
 		}
 
 		while (_is_walkable(to_x, to_y)) {
-			if (end->id.x == to_x && end->id.y == to_y) {
-				return end;
+			if (end_id.x == to_x && end_id.y == to_y) {
+				r_jump = end_id;
+				return true;
 			}
 
 			if ((_is_walkable(to_x - 1, to_y) && !_is_walkable(to_x - 1, to_y - dy)) || (_is_walkable(to_x + 1, to_y) && !_is_walkable(to_x + 1, to_y - dy))) {
-				return _get_point_unchecked(to_x, to_y);
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
-			if (_forced_successor(to_x, to_y, 1, 0, true) != nullptr || _forced_successor(to_x, to_y, -1, 0, true) != nullptr) {
-				return _get_point_unchecked(to_x, to_y);
+			if (_forced_successor(to_x, to_y, 1, 0, successor, true) || _forced_successor(to_x, to_y, -1, 0, successor, true)) {
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
 			to_y += dy;
 		}
 	}
 
-	return nullptr;
+	return false;
 }
 
-AStarGrid2D::Point *AStarGrid2D::_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, bool p_inclusive) {
-	// Remembering previous results can improve performance.
-	bool l_prev = false, r_prev = false, l = false, r = false;
-
-	int32_t o_x = p_x, o_y = p_y;
-	if (p_inclusive) {
-		o_x += p_dx;
-		o_y += p_dy;
-	}
+bool AStarGrid2D::_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, Vector2i &r_successor, bool p_inclusive) const {
+	// Scans 64 points at a time along a row of the solid mask, or along a row of the transposed mask when going vertically.
+	// A point is a forced successor when the side neighbor ahead of it is walkable and the one beside it is not.
+	const bool horizontal = p_dx != 0;
+	const LocalVector<uint64_t> &mask = horizontal ? solid_mask : solid_mask_transposed;
+	const uint32_t stride = horizontal ? solid_mask_stride : solid_mask_transposed_stride;
+	const int32_t dir = horizontal ? p_dx : p_dy;
+	const int64_t row = horizontal ? p_y - region.position.y + 1 : p_x - region.position.x + 1;
+	const int64_t end_row = horizontal ? end_id.y - region.position.y + 1 : end_id.x - region.position.x + 1;
+	const int64_t end_bit = horizontal ? end_id.x - region.position.x + 1 : end_id.y - region.position.y + 1;
 
-	int32_t l_x = p_x - p_dy, l_y = p_y - p_dx;
-	int32_t r_x = p_x + p_dy, r_y = p_y + p_dx;
+	// The side neighbors are checked from the given point, which is one step behind the first scanned point when inclusive.
+	int64_t side_bit = horizontal ? p_x - region.position.x + 1 : p_y - region.position.y + 1;
+	int64_t bit = p_inclusive ? side_bit + dir : side_bit;
 
-	while (_is_walkable(o_x, o_y)) {
-		if (end->id.x == o_x && end->id.y == o_y) {
-			return end;
+	while (true) {
+		const uint64_t line = load_mask_steps(mask, stride, row, bit, dir);
+		uint64_t stop = line;
+		for (int64_t side_row = row - 1; side_row <= row + 1; side_row += 2) {
+			const uint64_t side = load_mask_steps(mask, stride, side_row, side_bit, dir);
+			const uint64_t side_ahead = load_mask_steps(mask, stride, side_row, side_bit + dir, dir);
+			stop |= side & ~side_ahead;
 		}
 
-		l_prev = l || _is_walkable(l_x, l_y);
-		r_prev = r || _is_walkable(r_x, r_y);
-
-		l_x += p_dx;
-		l_y += p_dy;
-		r_x += p_dx;
-		r_y += p_dy;
-
-		l = _is_walkable(l_x, l_y);
-		r = _is_walkable(r_x, r_y);
+		int64_t end_step = -1;
+		if (end_row == row && (end_bit - bit) * dir >= 0 && (end_bit - bit) * dir < 64) {
+			end_step = (end_bit - bit) * dir;
+			stop |= get_step_bit(end_step, dir);
+		}
 
-		if ((l && !l_prev) || (r && !r_prev)) {
-			return _get_point_unchecked(o_x, o_y);
+		if (stop == 0) {
+			bit += 64 * dir;
+			side_bit += 64 * dir;
+			continue;
 		}
 
-		o_x += p_dx;
-		o_y += p_dy;
+		// The solid border stops the scan at the latest at the end of the row.
+		const uint32_t step = get_first_step(stop, dir);
+		if (line & get_step_bit(step, dir)) {
+			return false;
+		}
+		if (step == end_step) {
+			r_successor = end_id;
+			return true;
+		}
+		const int32_t found = bit + step * dir;
+		r_successor = horizontal ? Vector2i(region.position.x + found - 1, p_y) : Vector2i(p_x, region.position.y + found - 1);
+		return true;
 	}
-	return nullptr;
 }
 
-void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
+void AStarGrid2D::_get_nbors(const Vector2i &p_id, LocalVector<Vector2i> &r_nbors) const {
+	// The solid border of the mask keeps all neighbors in bounds.
+	const int32_t x = p_id.x;
+	const int32_t y = p_id.y;
+
 	bool ts0 = false, td0 = false,
 		 ts1 = false, td1 = false,
 		 ts2 = false, td2 = false,
 		 ts3 = false, td3 = false;
 
-	Point *left = nullptr;
-	Point *right = nullptr;
-	Point *top = nullptr;
-	Point *bottom = nullptr;
-
-	Point *top_left = nullptr;
-	Point *top_right = nullptr;
-	Point *bottom_left = nullptr;
-	Point *bottom_right = nullptr;
-
-	{
-		bool has_left = false;
-		bool has_right = false;
-
-		if (p_point->id.x - 1 >= region.position.x) {
-			left = _get_point_unchecked(p_point->id.x - 1, p_point->id.y);
-			has_left = true;
-		}
-		if (p_point->id.x + 1 < region.position.x + region.size.width) {
-			right = _get_point_unchecked(p_point->id.x + 1, p_point->id.y);
-			has_right = true;
-		}
-		if (p_point->id.y - 1 >= region.position.y) {
-			top = _get_point_unchecked(p_point->id.x, p_point->id.y - 1);
-			if (has_left) {
-				top_left = _get_point_unchecked(p_point->id.x - 1, p_point->id.y - 1);
-			}
-			if (has_right) {
-				top_right = _get_point_unchecked(p_point->id.x + 1, p_point->id.y - 1);
-			}
-		}
-		if (p_point->id.y + 1 < region.position.y + region.size.height) {
-			bottom = _get_point_unchecked(p_point->id.x, p_point->id.y + 1);
-			if (has_left) {
-				bottom_left = _get_point_unchecked(p_point->id.x - 1, p_point->id.y + 1);
-			}
-			if (has_right) {
-				bottom_right = _get_point_unchecked(p_point->id.x + 1, p_point->id.y + 1);
-			}
-		}
-	}
-
-	if (top && !_get_solid_unchecked(top->id)) {
-		r_nbors.push_back(top);
+	if (_is_walkable(x, y - 1)) {
+		r_nbors.push_back(Vector2i(x, y - 1));
 		ts0 = true;
 	}
-	if (right && !_get_solid_unchecked(right->id)) {
-		r_nbors.push_back(right);
+	if (_is_walkable(x + 1, y)) {
+		r_nbors.push_back(Vector2i(x + 1, y));
 		ts1 = true;
 	}
-	if (bottom && !_get_solid_unchecked(bottom->id)) {
-		r_nbors.push_back(bottom);
+	if (_is_walkable(x, y + 1)) {
+		r_nbors.push_back(Vector2i(x, y + 1));
 		ts2 = true;
 	}
-	if (left && !_get_solid_unchecked(left->id)) {
-		r_nbors.push_back(left);
+	if (_is_walkable(x - 1, y)) {
+		r_nbors.push_back(Vector2i(x - 1, y));
 		ts3 = true;
 	}
 
@@ -477,17 +584,17 @@ void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 			break;
 	}
 
-	if (td0 && (top_left && !_get_solid_unchecked(top_left->id))) {
-		r_nbors.push_back(top_left);
+	if (td0 && _is_walkable(x - 1, y - 1)) {
+		r_nbors.push_back(Vector2i(x - 1, y - 1));
 	}
-	if (td1 && (top_right && !_get_solid_unchecked(top_right->id))) {
-		r_nbors.push_back(top_right);
+	if (td1 && _is_walkable(x + 1, y - 1)) {
+		r_nbors.push_back(Vector2i(x + 1, y - 1));
 	}
-	if (td2 && (bottom_right && !_get_solid_unchecked(bottom_right->id))) {
-		r_nbors.push_back(bottom_right);
+	if (td2 && _is_walkable(x + 1, y + 1)) {
+		r_nbors.push_back(Vector2i(x + 1, y + 1));
 	}
-	if (td3 && (bottom_left && !_get_solid_unchecked(bottom_left->id))) {
-		r_nbors.push_back(bottom_left);
+	if (td3 && _is_walkable(x - 1, y + 1)) {
+		r_nbors.push_back(Vector2i(x - 1, y + 1));
 	}
 }
 
@@ -503,13 +610,17 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_
 
 	LocalVector<Point *> open_list;
 	SortArray<Point *, SortPoints> sorter;
+	LocalVector<Vector2i> nbors;
+
+	// Jumps skip over the points between jump points without looking at their weight scales, so weighted grids use plain A*.
+	const bool jumping = jumping_enabled && weight_scales.is_empty();
 
 	p_begin_point->g_score = 0;
 	p_begin_point->f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
 	p_begin_point->abs_g_score = 0;
 	p_begin_point->abs_f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
 	open_list.push_back(p_begin_point);
-	end = p_end_point;
+	end_id = p_end_point->id;
 
 	while (!open_list.is_empty()) {
 		Point *p = open_list[0]; // The currently processed point.
@@ -528,23 +639,26 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_
 		open_list.remove_at(open_list.size() - 1);
 		p->closed_pass = pass; // Mark the point as closed.
 
-		LocalVector<Point *> nbors;
-		_get_nbors(p, nbors);
+		nbors.clear();
+		_get_nbors(p->id, nbors);
 
-		for (Point *e : nbors) {
+		for (const Vector2i &nbor_id : nbors) {
 			real_t weight_scale = 1.0;
+			Point *e = nullptr;
 
-			if (jumping_enabled) {
-				// TODO: Make it works with weight_scale.
-				e = _jump(p, e);
-				if (!e || e->closed_pass == pass) {
+			if (jumping) {
+				Vector2i jump_id;
+				if (!_jump(p->id, nbor_id, jump_id)) {
 					continue;
 				}
+				e = _get_point_unchecked(jump_id);
 			} else {
-				if (_get_solid_unchecked(e->id) || e->closed_pass == pass) {
-					continue;
-				}
-				weight_scale = e->weight_scale;
+				e = _get_point_unchecked(nbor_id);
+				weight_scale = _get_weight_scale_unchecked(nbor_id);
+			}
+
+			if (e->closed_pass == pass) {
+				continue;
 			}
 
 			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * weight_scale;
@@ -576,6 +690,140 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_
 	return found_route;
 }
 
+bool AStarGrid2D::_solve_compact(const Vector2i &p_begin_id, const Vector2i &p_end_id, bool p_allow_partial_path, LocalVector<Vector2i> &r_path) {
+	if (_get_solid_unchecked(p_end_id) && !p_allow_partial_path) {
+		return false;
+	}
+
+	// Points get pushed to the open list again when a shorter path to them is found, the outdated entries are skipped.
+	HashMap<uint32_t, CompactPoint> visited;
+	LocalVector<CompactOpenPoint> open_list;
+	SortArray<CompactOpenPoint, SortCompactOpenPoints> sorter;
+	LocalVector<Vector2i> nbors;
+
+	const uint32_t begin_index = _to_index(p_begin_id);
+	const uint32_t end_index = _to_index(p_end_id);
+	end_id = p_end_id;
+
+	// See _solve(), weight scales are only stored once one is set.
+	const bool jumping = jumping_enabled && weight_scales.is_empty();
+
+	visited.insert(begin_index, CompactPoint());
+	CompactOpenPoint begin;
+	begin.index = begin_index;
+	begin.f_score = _estimate_cost(p_begin_id, p_end_id);
+	open_list.push_back(begin);
+
+	bool found_route = false;
+	uint32_t closest_index = UINT32_MAX;
+	real_t closest_g_score = 0;
+	real_t closest_h_score = 0;
+
+	while (!open_list.is_empty()) {
+		const CompactOpenPoint current = open_list[0];
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.remove_at(open_list.size() - 1);
+
+		CompactPoint &p = visited[current.index];
+		if (p.closed || current.g_score > p.g_score) {
+			continue;
+		}
+		p.closed = true;
+
+		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
+		const real_t h_score = current.f_score - current.g_score;
+		if (closest_index == UINT32_MAX || closest_h_score > h_score || (closest_h_score >= h_score && closest_g_score > current.g_score)) {
+			closest_index = current.index;
+			closest_g_score = current.g_score;
+			closest_h_score = h_score;
+		}
+
+		if (current.index == end_index) {
+			found_route = true;
+			break;
+		}
+
+		const Vector2i p_id = _from_index(current.index);
+		nbors.clear();
+		_get_nbors(p_id, nbors);
+
+		for (const Vector2i &nbor_id : nbors) {
+			real_t weight_scale = 1.0;
+			Vector2i e_id = nbor_id;
+
+			if (jumping) {
+				if (!_jump(p_id, nbor_id, e_id)) {
+					continue;
+				}
+			} else {
+				weight_scale = _get_weight_scale_unchecked(nbor_id);
+			}
+
+			const uint32_t e_index = _to_index(e_id);
+			const real_t tentative_g_score = current.g_score + _compute_cost(p_id, e_id) * weight_scale;
+
+			HashMap<uint32_t, CompactPoint>::Iterator e = visited.find(e_index);
+			if (!e) {
+				e = visited.insert(e_index, CompactPoint());
+			} else if (e->value.closed || tentative_g_score >= e->value.g_score) {
+				continue;
+			}
+			e->value.prev_index = current.index;
+			e->value.g_score = tentative_g_score;
+
+			CompactOpenPoint open;
+			open.index = e_index;
+			open.g_score = tentative_g_score;
+			open.f_score = tentative_g_score + _estimate_cost(e_id, p_end_id);
+			open_list.push_back(open);
+			sorter.push_heap(0, open_list.size() - 1, 0, open, open_list.ptr());
+		}
+	}
+
+	if (!found_route) {
+		if (!p_allow_partial_path || closest_index == UINT32_MAX) {
+			return false;
+		}
+	}
+
+	for (uint32_t index = found_route ? end_index : closest_index; index != UINT32_MAX; index = visited[index].prev_index) {
+		r_path.push_back(_from_index(index));
+	}
+	r_path.invert();
+	return true;
+}
+
+bool AStarGrid2D::_find_path(const Vector2i &p_from_id, const Vector2i &p_to_id, bool p_allow_partial_path, LocalVector<Vector2i> &r_path) {
+	if (p_from_id == p_to_id) {
+		r_path.push_back(p_from_id);
+		return true;
+	}
+
+	if (compact_storage_enabled) {
+		return _solve_compact(p_from_id, p_to_id, p_allow_partial_path, r_path);
+	}
+
+	Point *begin_point = _get_point_unchecked(p_from_id);
+	Point *end_point = _get_point_unchecked(p_to_id);
+
+	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
+	if (!found_route) {
+		if (!p_allow_partial_path || last_closest_point == nullptr) {
+			return false;
+		}
+
+		// Use closest point instead.
+		end_point = last_closest_point;
+	}
+
+	for (Point *p = end_point; p != begin_point; p = p->prev_point) {
+		r_path.push_back(p->id);
+	}
+	r_path.push_back(begin_point->id);
+	r_path.invert();
+	return true;
+}
+
 real_t AStarGrid2D::_estimate_cost(const Vector2i &p_from_id, const Vector2i &p_end_id) {
 	real_t scost;
 	if (GDVIRTUAL_CALL(_estimate_cost, p_from_id, p_end_id, scost)) {
@@ -594,35 +842,36 @@ real_t AStarGrid2D::_compute_cost(const Vector2i &p_from_id, const Vector2i &p_t
 
 void AStarGrid2D::clear() {
 	points.clear();
+	solid_mask.clear();
+	solid_mask_transposed.clear();
+	weight_scales.clear();
 	region = Rect2i();
 }
 
 Vector2 AStarGrid2D::get_point_position(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, Vector2(), "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), Vector2(), vformat("Can't get point's position. Point %s out of bounds %s.", p_id, region));
-	return _get_point_unchecked(p_id)->pos;
+	return _get_point_position_unchecked(p_id);
 }
 
 TypedArray<Dictionary> AStarGrid2D::get_point_data_in_region(const Rect2i &p_region) const {
 	ERR_FAIL_COND_V_MSG(dirty, TypedArray<Dictionary>(), "Grid is not initialized. Call the update method.");
 	const Rect2i inter_region = region.intersection(p_region);
 
-	const int32_t start_x = inter_region.position.x - region.position.x;
-	const int32_t start_y = inter_region.position.y - region.position.y;
-	const int32_t end_x = inter_region.get_end().x - region.position.x;
-	const int32_t end_y = inter_region.get_end().y - region.position.y;
+	const int32_t end_x = inter_region.get_end().x;
+	const int32_t end_y = inter_region.get_end().y;
 
 	TypedArray<Dictionary> data;
 
-	for (int32_t y = start_y; y < end_y; y++) {
-		for (int32_t x = start_x; x < end_x; x++) {
-			const Point &p = points[y][x];
+	for (int32_t y = inter_region.position.y; y < end_y; y++) {
+		for (int32_t x = inter_region.position.x; x < end_x; x++) {
+			const Vector2i id(x, y);
 
 			Dictionary dict;
-			dict["id"] = p.id;
-			dict["position"] = p.pos;
-			dict["solid"] = _get_solid_unchecked(p.id);
-			dict["weight_scale"] = p.weight_scale;
+			dict["id"] = id;
+			dict["position"] = _get_point_position_unchecked(id);
+			dict["solid"] = _get_solid_unchecked(id);
+			dict["weight_scale"] = _get_weight_scale_unchecked(id);
 			data.push_back(dict);
 		}
 	}
@@ -635,49 +884,16 @@ Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vec
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_from_id), Vector<Vector2>(), vformat("Can't get id path. Point %s out of bounds %s.", p_from_id, region));
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_to_id), Vector<Vector2>(), vformat("Can't get id path. Point %s out of bounds %s.", p_to_id, region));
 
-	Point *a = _get_point(p_from_id.x, p_from_id.y);
-	Point *b = _get_point(p_to_id.x, p_to_id.y);
-
-	if (a == b) {
-		Vector<Vector2> ret;
-		ret.push_back(a->pos);
-		return ret;
-	}
-
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return Vector<Vector2>();
-		}
-
-		// Use closest point instead.
-		end_point = last_closest_point;
-	}
-
-	Point *p = end_point;
-	int32_t pc = 1;
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<Vector2i> id_path;
+	if (!_find_path(p_from_id, p_to_id, p_allow_partial_path, id_path)) {
+		return Vector<Vector2>();
 	}
 
 	Vector<Vector2> path;
-	path.resize(pc);
-
-	{
-		Vector2 *w = path.ptrw();
-
-		p = end_point;
-		int32_t idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->pos;
-			p = p->prev_point;
-		}
-
-		w[0] = p->pos;
+	path.resize(id_path.size());
+	Vector2 *w = path.ptrw();
+	for (uint32_t i = 0; i < id_path.size(); i++) {
+		w[i] = _get_point_position_unchecked(id_path[i]);
 	}
 
 	return path;
@@ -688,47 +904,15 @@ TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const V
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_from_id), TypedArray<Vector2i>(), vformat("Can't get id path. Point %s out of bounds %s.", p_from_id, region));
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_to_id), TypedArray<Vector2i>(), vformat("Can't get id path. Point %s out of bounds %s.", p_to_id, region));
 
-	Point *a = _get_point(p_from_id.x, p_from_id.y);
-	Point *b = _get_point(p_to_id.x, p_to_id.y);
-
-	if (a == b) {
-		TypedArray<Vector2i> ret;
-		ret.push_back(a->id);
-		return ret;
-	}
-
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return TypedArray<Vector2i>();
-		}
-
-		// Use closest point instead.
-		end_point = last_closest_point;
-	}
-
-	Point *p = end_point;
-	int32_t pc = 1;
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<Vector2i> id_path;
+	if (!_find_path(p_from_id, p_to_id, p_allow_partial_path, id_path)) {
+		return TypedArray<Vector2i>();
 	}
 
 	TypedArray<Vector2i> path;
-	path.resize(pc);
-
-	{
-		p = end_point;
-		int32_t idx = pc - 1;
-		while (p != begin_point) {
-			path[idx--] = p->id;
-			p = p->prev_point;
-		}
-
-		path[0] = p->id;
+	path.resize(id_path.size());
+	for (uint32_t i = 0; i < id_path.size(); i++) {
+		path[i] = id_path[i];
 	}
 
 	return path;
@@ -751,6 +935,8 @@ void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("update"), &AStarGrid2D::update);
 	ClassDB::bind_method(D_METHOD("set_jumping_enabled", "enabled"), &AStarGrid2D::set_jumping_enabled);
 	ClassDB::bind_method(D_METHOD("is_jumping_enabled"), &AStarGrid2D::is_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("set_compact_storage_enabled", "enabled"), &AStarGrid2D::set_compact_storage_enabled);
+	ClassDB::bind_method(D_METHOD("is_compact_storage_enabled"), &AStarGrid2D::is_compact_storage_enabled);
 	ClassDB::bind_method(D_METHOD("set_diagonal_mode", "mode"), &AStarGrid2D::set_diagonal_mode);
 	ClassDB::bind_method(D_METHOD("get_diagonal_mode"), &AStarGrid2D::get_diagonal_mode);
 	ClassDB::bind_method(D_METHOD("set_default_compute_heuristic", "heuristic"), &AStarGrid2D::set_default_compute_heuristic);
@@ -780,6 +966,7 @@ void AStarGrid2D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_shape", PROPERTY_HINT_ENUM, "Square,IsometricRight,IsometricDown"), "set_cell_shape", "get_cell_shape");
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "jumping_enabled"), "set_jumping_enabled", "is_jumping_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "compact_storage_enabled"), "set_compact_storage_enabled", "is_compact_storage_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_compute_heuristic", PROPERTY_HINT_ENUM, "Euclidean,Manhattan,Octile,Chebyshev"), "set_default_compute_heuristic", "get_default_compute_heuristic");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_estimate_heuristic", PROPERTY_HINT_ENUM, "Euclidean,Manhattan,Octile,Chebyshev"), "set_default_estimate_heuristic", "get_default_estimate_heuristic");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "diagonal_mode", PROPERTY_HINT_ENUM, "Never,Always,At Least One Walkable,Only If No Obstacles"), "set_diagonal_mode", "get_diagonal_mode");
@@ -33,6 +33,7 @@
 
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/templates/hash_map.h"
 #include "core/templates/list.h"
 #include "core/templates/local_vector.h"
 
@@ -71,6 +72,7 @@ private:
 	CellShape cell_shape = CELL_SHAPE_SQUARE;
 
 	bool jumping_enabled = false;
+	bool compact_storage_enabled = false;
 	DiagonalMode diagonal_mode = DIAGONAL_MODE_ALWAYS;
 	Heuristic default_compute_heuristic = HEURISTIC_EUCLIDEAN;
 	Heuristic default_estimate_heuristic = HEURISTIC_EUCLIDEAN;
@@ -78,9 +80,6 @@ private:
 	struct Point {
 		Vector2i id;
 
-		Vector2 pos;
-		real_t weight_scale = 1.0;
-
 		// Used for pathfinding.
 		Point *prev_point = nullptr;
 		real_t g_score = 0;
@@ -94,8 +93,8 @@ private:
 
 		Point() {}
 
-		Point(const Vector2i &p_id, const Vector2 &p_pos) :
-				id(p_id), pos(p_pos) {}
+		Point(const Vector2i &p_id) :
+				id(p_id) {}
 	};
 
 	struct SortPoints {
@@ -110,57 +109,101 @@ private:
 		}
 	};
 
-	LocalVector<bool> solid_mask;
+	// Search state of a point visited by a query in compact storage.
+	struct CompactPoint {
+		uint32_t prev_index = UINT32_MAX;
+		real_t g_score = 0;
+		bool closed = false;
+	};
+
+	struct CompactOpenPoint {
+		uint32_t index = 0;
+		real_t g_score = 0;
+		real_t f_score = 0;
+	};
+
+	struct SortCompactOpenPoints {
+		_FORCE_INLINE_ bool operator()(const CompactOpenPoint &A, const CompactOpenPoint &B) const { // Returns true when the Point A is worse than Point B.
+			if (A.f_score > B.f_score) {
+				return true;
+			} else if (A.f_score < B.f_score) {
+				return false;
+			} else {
+				return A.g_score < B.g_score;
+			}
+		}
+	};
+
+	// One bit per point, with a solid border around the region. Every row starts on a new word.
+	// The transposed mask has the columns as rows, so that vertical jumps can scan it like horizontal ones.
+	LocalVector<uint64_t> solid_mask;
+	LocalVector<uint64_t> solid_mask_transposed;
+	uint32_t solid_mask_stride = 0;
+	uint32_t solid_mask_transposed_stride = 0;
+
+	// Empty while all points have a weight scale of 1.0.
+	LocalVector<real_t> weight_scales;
+
+	// Empty with compact storage, where queries only keep the state of the points they visit.
 	LocalVector<LocalVector<Point>> points;
-	Point *end = nullptr;
+	Vector2i end_id;
 	Point *last_closest_point = nullptr;
 
 	uint64_t pass = 1;
 
 private: // Internal routines.
-	_FORCE_INLINE_ size_t _to_mask_index(int32_t p_x, int32_t p_y) const {
-		return ((p_y - region.position.y + 1) * (region.size.x + 2)) + p_x - region.position.x + 1;
+	_FORCE_INLINE_ bool _is_walkable(int32_t p_x, int32_t p_y) const {
+		const uint32_t bit = p_x - region.position.x + 1;
+		return !((solid_mask[(p_y - region.position.y + 1) * solid_mask_stride + (bit >> 6)] >> (bit & 63)) & 1);
 	}
 
-	_FORCE_INLINE_ bool _is_walkable(int32_t p_x, int32_t p_y) const {
-		return !solid_mask[_to_mask_index(p_x, p_y)];
+	_FORCE_INLINE_ uint32_t _to_index(const Vector2i &p_id) const {
+		return (p_id.y - region.position.y) * region.size.x + p_id.x - region.position.x;
 	}
 
-	_FORCE_INLINE_ Point *_get_point(int32_t p_x, int32_t p_y) {
-		if (region.has_point(Vector2i(p_x, p_y))) {
-			return &points[p_y - region.position.y][p_x - region.position.x];
-		}
-		return nullptr;
+	_FORCE_INLINE_ Vector2i _from_index(uint32_t p_index) const {
+		return Vector2i(region.position.x + p_index % region.size.x, region.position.y + p_index / region.size.x);
 	}
 
 	_FORCE_INLINE_ void _set_solid_unchecked(int32_t p_x, int32_t p_y, bool p_solid) {
-		solid_mask[_to_mask_index(p_x, p_y)] = p_solid;
+		const uint32_t column = p_x - region.position.x + 1;
+		const uint32_t row = p_y - region.position.y + 1;
+		uint64_t &word = solid_mask[row * solid_mask_stride + (column >> 6)];
+		uint64_t &transposed_word = solid_mask_transposed[column * solid_mask_transposed_stride + (row >> 6)];
+		if (p_solid) {
+			word |= uint64_t(1) << (column & 63);
+			transposed_word |= uint64_t(1) << (row & 63);
+		} else {
+			word &= ~(uint64_t(1) << (column & 63));
+			transposed_word &= ~(uint64_t(1) << (row & 63));
+		}
 	}
 
 	_FORCE_INLINE_ void _set_solid_unchecked(const Vector2i &p_id, bool p_solid) {
-		solid_mask[_to_mask_index(p_id.x, p_id.y)] = p_solid;
+		_set_solid_unchecked(p_id.x, p_id.y, p_solid);
 	}
 
 	_FORCE_INLINE_ bool _get_solid_unchecked(const Vector2i &p_id) const {
-		return solid_mask[_to_mask_index(p_id.x, p_id.y)];
+		return !_is_walkable(p_id.x, p_id.y);
 	}
 
-	_FORCE_INLINE_ Point *_get_point_unchecked(int32_t p_x, int32_t p_y) {
-		return &points[p_y - region.position.y][p_x - region.position.x];
+	_FORCE_INLINE_ real_t _get_weight_scale_unchecked(const Vector2i &p_id) const {
+		return weight_scales.is_empty() ? real_t(1.0) : weight_scales[_to_index(p_id)];
 	}
 
 	_FORCE_INLINE_ Point *_get_point_unchecked(const Vector2i &p_id) {
 		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
 	}
 
-	_FORCE_INLINE_ const Point *_get_point_unchecked(const Vector2i &p_id) const {
-		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
-	}
+	void _set_weight_scale_unchecked(const Vector2i &p_id, real_t p_weight_scale);
+	Vector2 _get_point_position_unchecked(const Vector2i &p_id) const;
 
-	void _get_nbors(Point *p_point, LocalVector<Point *> &r_nbors);
-	Point *_jump(Point *p_from, Point *p_to);
+	void _get_nbors(const Vector2i &p_id, LocalVector<Vector2i> &r_nbors) const;
+	bool _jump(const Vector2i &p_from, const Vector2i &p_to, Vector2i &r_jump) const;
+	bool _forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, Vector2i &r_successor, bool p_inclusive = false) const;
 	bool _solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path);
-	Point *_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, bool p_inclusive = false);
+	bool _solve_compact(const Vector2i &p_begin_id, const Vector2i &p_end_id, bool p_allow_partial_path, LocalVector<Vector2i> &r_path);
+	bool _find_path(const Vector2i &p_from_id, const Vector2i &p_to_id, bool p_allow_partial_path, LocalVector<Vector2i> &r_path);
 
 protected:
 	static void _bind_methods();
@@ -202,6 +245,9 @@ public:
 	void set_jumping_enabled(bool p_enabled);
 	bool is_jumping_enabled() const;
 
+	void set_compact_storage_enabled(bool p_enabled);
+	bool is_compact_storage_enabled() const;
+
 	void set_diagonal_mode(DiagonalMode p_diagonal_mode);
 	DiagonalMode get_diagonal_mode() const;
 
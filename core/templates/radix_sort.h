@@ -0,0 +1,124 @@
+/**************************************************************************/
+/*  radix_sort.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include "core/templates/local_vector.h"
+#include "core/typedefs.h"
+
+// Stable LSD radix sort for values ordered by an unsigned key of up to 128 bits.
+// The key is provided by KeyGetter as two 64-bit words, and values are sorted
+// by the high word first, then by the low word (same as comparing them as a
+// single 128-bit integer).
+//
+// Key bytes that are equal across all values are detected while building the
+// histograms and their passes are skipped, so narrow keys (or keys where only
+// a few fields vary) don't pay for the full key width.
+//
+// The instance keeps its scratch buffers between calls, so keep it around
+// when sorting every frame to avoid reallocations.
+
+template <typename T, typename KeyGetter>
+class RadixSort {
+	struct Entry {
+		uint64_t key_low;
+		uint64_t key_high;
+		T value;
+	};
+
+	static constexpr uint32_t DIGIT_BITS = 8;
+	static constexpr uint32_t DIGIT_COUNT = 1 << DIGIT_BITS;
+	static constexpr uint32_t PASS_COUNT = 128 / DIGIT_BITS;
+
+	LocalVector<Entry> entries;
+	LocalVector<Entry> scratch;
+
+	_FORCE_INLINE_ static uint32_t _get_digit(const Entry &p_entry, uint32_t p_pass) {
+		uint64_t word = p_pass < (PASS_COUNT / 2) ? p_entry.key_low : p_entry.key_high;
+		return (word >> ((p_pass % (PASS_COUNT / 2)) * DIGIT_BITS)) & (DIGIT_COUNT - 1);
+	}
+
+public:
+	KeyGetter get_key;
+
+	void sort(T *p_array, uint32_t p_size) {
+		if (p_size < 2) {
+			return;
+		}
+
+		if (entries.size() < p_size) {
+			entries.resize(p_size);
+			scratch.resize(p_size);
+		}
+
+		uint32_t histograms[PASS_COUNT][DIGIT_COUNT];
+		memset(histograms, 0, sizeof(histograms));
+
+		Entry *src = entries.ptr();
+		Entry *dst = scratch.ptr();
+
+		for (uint32_t i = 0; i < p_size; i++) {
+			Entry &entry = src[i];
+			get_key(p_array[i], entry.key_high, entry.key_low);
+			entry.value = p_array[i];
+			for (uint32_t pass = 0; pass < PASS_COUNT; pass++) {
+				histograms[pass][_get_digit(entry, pass)]++;
+			}
+		}
+
+		for (uint32_t pass = 0; pass < PASS_COUNT; pass++) {
+			uint32_t *histogram = histograms[pass];
+			if (histogram[_get_digit(src[0], pass)] == p_size) {
+				// All values share this digit, order would not change.
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < DIGIT_COUNT; i++) {
+				uint32_t count = histogram[i];
+				histogram[i] = offset;
+				offset += count;
+			}
+
+			for (uint32_t i = 0; i < p_size; i++) {
+				dst[histogram[_get_digit(src[i], pass)]++] = src[i];
+			}
+
+			SWAP(src, dst);
+		}
+
+		for (uint32_t i = 0; i < p_size; i++) {
+			p_array[i] = src[i].value;
+		}
+	}
+};
+
+#endif // RADIX_SORT_H
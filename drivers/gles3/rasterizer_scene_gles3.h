@@ -35,6 +35,7 @@
 
 #include "core/math/projection.h"
 #include "core/templates/paged_allocator.h"
+#include "core/templates/radix_sort.h"
 #include "core/templates/rid_owner.h"
 #include "core/templates/self_list.h"
 #include "drivers/gles3/shaders/effects/cubemap_filter.glsl.gen.h"
@@ -42,6 +43,7 @@
 #include "scene/resources/mesh.h"
 #include "servers/rendering/renderer_compositor.h"
 #include "servers/rendering/renderer_scene_render.h"
+#include "servers/rendering/rendering_cpu_profiler.h"
 #include "servers/rendering_server.h"
 #include "shader_gles3.h"
 #include "storage/light_storage.h"
@@ -589,7 +591,9 @@ private:
 			elements.clear();
 		}
 
-		//should eventually be replaced by radix
+		// Lists shorter than this are sorted with a comparison sort, which is faster
+		// than radix sort's fixed cost of building histograms.
+		static constexpr uint32_t RADIX_SORT_THRESHOLD = 256;
 
 		struct SortByKey {
 			_FORCE_INLINE_ bool operator()(const GeometryInstanceSurface *A, const GeometryInstanceSurface *B) const {
@@ -597,14 +601,28 @@ private:
 			}
 		};
 
+		struct GetSortKey {
+			_FORCE_INLINE_ void operator()(const GeometryInstanceSurface *p_element, uint64_t &r_key_high, uint64_t &r_key_low) const {
+				r_key_high = p_element->sort.sort_key2;
+				r_key_low = p_element->sort.sort_key1;
+			}
+		};
+
+		RadixSort<GeometryInstanceSurface *, GetSortKey> radix_sorter;
+
 		void sort_by_key() {
-			SortArray<GeometryInstanceSurface *, SortByKey> sorter;
-			sorter.sort(elements.ptr(), elements.size());
+			sort_by_key_range(0, elements.size());
 		}
 
 		void sort_by_key_range(uint32_t p_from, uint32_t p_size) {
-			SortArray<GeometryInstanceSurface *, SortByKey> sorter;
-			sorter.sort(elements.ptr() + p_from, p_size);
+			RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT);
+			RENDER_CPU_PROFILE_ELEMENTS(p_size);
+			if (p_size >= RADIX_SORT_THRESHOLD) {
+				radix_sorter.sort(elements.ptr() + p_from, p_size);
+			} else {
+				SortArray<GeometryInstanceSurface *, SortByKey> sorter;
+				sorter.sort(elements.ptr() + p_from, p_size);
+			}
 		}
 
 		struct SortByDepth {
@@ -615,6 +633,8 @@ private:
 
 		void sort_by_depth() { //used for shadows
 
+			RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT);
+			RENDER_CPU_PROFILE_ELEMENTS(elements.size());
 			SortArray<GeometryInstanceSurface *, SortByDepth> sorter;
 			sorter.sort(elements.ptr(), elements.size());
 		}
@@ -627,6 +647,8 @@ private:
 
 		void sort_by_reverse_depth_and_priority() { //used for alpha
 
+			RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT);
+			RENDER_CPU_PROFILE_ELEMENTS(elements.size());
 			SortArray<GeometryInstanceSurface *, SortByReverseDepthAndPriority> sorter;
 			sorter.sort(elements.ptr(), elements.size());
 		}
@@ -4103,8 +4103,11 @@ bool RenderingDeviceDriverVulkan::pipeline_cache_create(const Vector<uint8_t> &p
 		cache_info.initialDataSize = pipelines_cache.buffer.size() - sizeof(PipelineCacheHeader);
 		cache_info.pInitialData = pipelines_cache.buffer.ptr() + sizeof(PipelineCacheHeader);
 
-		if (pipeline_cache_control_support) {
+		// Background pipeline compilation needs the cache to be synchronized by the driver.
+		bool async_compilation = GLOBAL_GET("rendering/rendering_device/pipeline_cache/async_compilation");
+		if (pipeline_cache_control_support && !async_compilation) {
 			cache_info.flags = VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT;
+			pipelines_cache.externally_synchronized = true;
 		}
 
 		VkResult err = vkCreatePipelineCache(vk_device, &cache_info, VKC::get_allocation_callbacks(VK_OBJECT_TYPE_PIPELINE_CACHE), &pipelines_cache.vk_cache);
@@ -5334,6 +5337,8 @@ uint64_t RenderingDeviceDriverVulkan::api_trait_get(ApiTrait p_trait) {
 			return (uint64_t)MAX((uint64_t)16, physical_device_properties.limits.optimalBufferCopyOffsetAlignment);
 		case API_TRAIT_SHADER_CHANGE_INVALIDATION:
 			return (uint64_t)SHADER_CHANGE_INVALIDATION_INCOMPATIBLE_SETS_PLUS_CASCADE;
+		case API_TRAIT_THREAD_SAFE_PIPELINE_CREATION:
+			return !pipelines_cache.externally_synchronized;
 		default:
 			return RenderingDeviceDriver::api_trait_get(p_trait);
 	}
@@ -508,6 +508,7 @@ private:
 		size_t current_size = 0;
 		Vector<uint8_t> buffer; // Header then data.
 		VkPipelineCache vk_cache = VK_NULL_HANDLE;
+		bool externally_synchronized = false; // Pipelines can't be created from multiple threads at once if set.
 	};
 
 	static int caching_instance_count;
@@ -449,6 +449,10 @@ static void _pre_gen_shape_list(Ref<ImporterMesh> &mesh, Vector<Ref<Shape3D>> &r
 	ERR_FAIL_COND_MSG(mesh.is_null(), "Cannot generate shape list with null mesh value.");
 	if (!p_convex) {
 		Ref<ConcavePolygonShape3D> shape = mesh->create_trimesh_shape();
+		if (shape.is_valid()) {
+			// Save the BVH with the scene, so it's not built again on every load.
+			shape->set_save_bvh_enabled(true);
+		}
 		r_shape_list.push_back(shape);
 	} else {
 		Vector<Ref<Shape3D>> cd;
@@ -1996,6 +2000,7 @@ void ResourceImporterScene::get_internal_import_options(InternalImportCategory p
 			r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "generate/navmesh", PROPERTY_HINT_ENUM, "Disabled,Mesh + NavMesh,NavMesh Only"), 0));
 			r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "physics/body_type", PROPERTY_HINT_ENUM, "Static,Dynamic,Area"), 0));
 			r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "physics/shape_type", PROPERTY_HINT_ENUM, "Decompose Convex,Simple Convex,Trimesh,Box,Sphere,Cylinder,Capsule,Automatic", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), 7));
+			r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "physics/save_bvh"), true));
 			r_options->push_back(ImportOption(PropertyInfo(Variant::OBJECT, "physics/physics_material_override", PROPERTY_HINT_RESOURCE_TYPE, "PhysicsMaterial"), Variant()));
 			r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "physics/layer", PROPERTY_HINT_LAYERS_3D_PHYSICS), 1));
 			r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "physics/mask", PROPERTY_HINT_LAYERS_3D_PHYSICS), 1));
@@ -2133,6 +2138,15 @@ bool ResourceImporterScene::get_internal_option_visibility(InternalImportCategor
 					p_options.has("generate/physics") &&
 					p_options["generate/physics"].operator bool();
 
+			if (p_option == "physics/save_bvh") {
+				// Show if the collision is a trimesh, the only shape with a BVH.
+				const ShapeType physics_shape = (ShapeType)p_options["physics/shape_type"].operator int();
+				const BodyType body_type = (BodyType)p_options["physics/body_type"].operator int();
+				return generate_physics &&
+						(physics_shape == SHAPE_TYPE_TRIMESH ||
+								(physics_shape == SHAPE_TYPE_AUTOMATIC && body_type != BODY_TYPE_DYNAMIC));
+			}
+
 			if (p_option.contains("physics/")) {
 				// Show if need to generate collisions.
 				return generate_physics;
@@ -2331,6 +2345,7 @@ bool ResourceImporterScene::get_internal_option_update_view_required(InternalImp
 		case INTERNAL_IMPORT_CATEGORY_MESH_3D_NODE: {
 			if (
 					p_option == "generate/physics" ||
+					p_option == "physics/body_type" ||
 					p_option == "physics/shape_type" ||
 					p_option.contains("decomposition/") ||
 					p_option.contains("primitive/")) {
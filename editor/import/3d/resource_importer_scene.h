@@ -37,6 +37,7 @@
 #include "scene/3d/importer_mesh_instance_3d.h"
 #include "scene/resources/3d/box_shape_3d.h"
 #include "scene/resources/3d/capsule_shape_3d.h"
+#include "scene/resources/3d/concave_polygon_shape_3d.h"
 #include "scene/resources/3d/cylinder_shape_3d.h"
 #include "scene/resources/3d/importer_mesh.h"
 #include "scene/resources/3d/skin.h"
@@ -426,8 +427,17 @@ Vector<Ref<Shape3D>> ResourceImporterScene::get_collision_shapes(const Ref<Impor
 		shapes.push_back(p_mesh->create_convex_shape(true, /*Passing false, otherwise VHACD will be used to simplify (Decompose) the Mesh.*/ false));
 		return shapes;
 	} else if (generate_shape_type == SHAPE_TYPE_TRIMESH) {
+		Ref<ConcavePolygonShape3D> trimesh = p_mesh->create_trimesh_shape();
+		if (trimesh.is_valid()) {
+			// Imported scenes are loaded much more often than imported, so the BVH is built once here.
+			bool save_bvh = true;
+			if (p_options.has(SNAME("physics/save_bvh"))) {
+				save_bvh = p_options[SNAME("physics/save_bvh")];
+			}
+			trimesh->set_save_bvh_enabled(save_bvh);
+		}
 		Vector<Ref<Shape3D>> shapes;
-		shapes.push_back(p_mesh->create_trimesh_shape());
+		shapes.push_back(trimesh);
 		return shapes;
 	} else if (generate_shape_type == SHAPE_TYPE_BOX) {
 		Ref<BoxShape3D> box;
@@ -92,6 +92,14 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_FREE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_OBSTACLE_COUNT);
+	BIND_ENUM_CONSTANT(NAVIGATION_SYNC_TIME);
+	BIND_ENUM_CONSTANT(NAVIGATION_AVOIDANCE_TIME);
+	BIND_ENUM_CONSTANT(NAVIGATION_CALLBACKS_TIME);
+	BIND_ENUM_CONSTANT(NAVIGATION_PATH_QUERY_COUNT);
+	BIND_ENUM_CONSTANT(NAVIGATION_PATH_QUERY_TIME_P50);
+	BIND_ENUM_CONSTANT(NAVIGATION_PATH_QUERY_TIME_P99);
+	BIND_ENUM_CONSTANT(NAVIGATION_PATH_QUERY_SEARCHED_POLYGONS_P50);
+	BIND_ENUM_CONSTANT(NAVIGATION_PATH_QUERY_SEARCHED_POLYGONS_P99);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -143,6 +151,14 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		PNAME("navigation/edges_connected"),
 		PNAME("navigation/edges_free"),
 		PNAME("navigation/obstacles"),
+		PNAME("navigation/sync_time"),
+		PNAME("navigation/avoidance_time"),
+		PNAME("navigation/callbacks_time"),
+		PNAME("navigation/path_queries"),
+		PNAME("navigation/path_query_time_p50"),
+		PNAME("navigation/path_query_time_p99"),
+		PNAME("navigation/path_query_searched_polygons_p50"),
+		PNAME("navigation/path_query_searched_polygons_p99"),
 
 	};
 
@@ -229,6 +245,22 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
 		case NAVIGATION_OBSTACLE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_OBSTACLE_COUNT);
+		case NAVIGATION_SYNC_TIME:
+			return USEC_TO_SEC(NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_SYNC_TIME));
+		case NAVIGATION_AVOIDANCE_TIME:
+			return USEC_TO_SEC(NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_AVOIDANCE_TIME));
+		case NAVIGATION_CALLBACKS_TIME:
+			return USEC_TO_SEC(NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_CALLBACKS_TIME));
+		case NAVIGATION_PATH_QUERY_COUNT:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_PATH_QUERY_COUNT);
+		case NAVIGATION_PATH_QUERY_TIME_P50:
+			return USEC_TO_SEC(NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_PATH_QUERY_TIME_P50));
+		case NAVIGATION_PATH_QUERY_TIME_P99:
+			return USEC_TO_SEC(NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_PATH_QUERY_TIME_P99));
+		case NAVIGATION_PATH_QUERY_SEARCHED_POLYGONS_P50:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_PATH_QUERY_SEARCHED_POLYGONS_P50);
+		case NAVIGATION_PATH_QUERY_SEARCHED_POLYGONS_P99:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_PATH_QUERY_SEARCHED_POLYGONS_P99);
 
 		default: {
 		}
@@ -277,6 +309,14 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
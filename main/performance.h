@@ -101,6 +101,14 @@ public:
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
 		NAVIGATION_OBSTACLE_COUNT,
+		NAVIGATION_SYNC_TIME,
+		NAVIGATION_AVOIDANCE_TIME,
+		NAVIGATION_CALLBACKS_TIME,
+		NAVIGATION_PATH_QUERY_COUNT,
+		NAVIGATION_PATH_QUERY_TIME_P50,
+		NAVIGATION_PATH_QUERY_TIME_P99,
+		NAVIGATION_PATH_QUERY_SEARCHED_POLYGONS_P50,
+		NAVIGATION_PATH_QUERY_SEARCHED_POLYGONS_P99,
 		MONITOR_MAX
 	};
 
@@ -659,6 +659,39 @@ void GodotBody2D::integrate_velocities(real_t p_step) {
 	_update_transform_dependent();
 }
 
+void GodotBody2D::save_snapshot_state(SnapshotState &r_state) const {
+	r_state.transform = get_transform();
+	r_state.inv_transform = get_inv_transform();
+	r_state.new_transform = new_transform;
+	r_state.linear_velocity = linear_velocity;
+	r_state.angular_velocity = angular_velocity;
+	r_state.prev_linear_velocity = prev_linear_velocity;
+	r_state.prev_angular_velocity = prev_angular_velocity;
+	r_state.biased_linear_velocity = biased_linear_velocity;
+	r_state.biased_angular_velocity = biased_angular_velocity;
+	r_state.applied_force = applied_force;
+	r_state.applied_torque = applied_torque;
+	r_state.still_time = still_time;
+	r_state.active = active;
+}
+
+void GodotBody2D::restore_snapshot_state(const SnapshotState &p_state) {
+	_set_transform(p_state.transform);
+	_set_inv_transform(p_state.inv_transform);
+	_update_transform_dependent();
+	new_transform = p_state.new_transform;
+	linear_velocity = p_state.linear_velocity;
+	angular_velocity = p_state.angular_velocity;
+	prev_linear_velocity = p_state.prev_linear_velocity;
+	prev_angular_velocity = p_state.prev_angular_velocity;
+	biased_linear_velocity = p_state.biased_linear_velocity;
+	biased_angular_velocity = p_state.biased_angular_velocity;
+	applied_force = p_state.applied_force;
+	applied_torque = p_state.applied_torque;
+	still_time = p_state.still_time;
+	set_active(p_state.active);
+}
+
 void GodotBody2D::wakeup_neighbours() {
 	for (const Pair<GodotConstraint2D *, int> &E : constraint_list) {
 		const GodotConstraint2D *c = E.first;
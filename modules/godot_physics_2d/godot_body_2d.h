@@ -355,6 +355,26 @@ public:
 	void integrate_forces(real_t p_step);
 	void integrate_velocities(real_t p_step);
 
+	// Simulation state saved in space snapshots, the rest is either set by the user or derived from it.
+	struct SnapshotState {
+		Transform2Di transform;
+		Transform2Di inv_transform;
+		Transform2Di new_transform;
+		Vector2 linear_velocity;
+		real_t angular_velocity = 0.0;
+		Vector2 prev_linear_velocity;
+		real_t prev_angular_velocity = 0.0;
+		Vector2 biased_linear_velocity;
+		real_t biased_angular_velocity = 0.0;
+		Vector2 applied_force;
+		real_t applied_torque = 0.0;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void save_snapshot_state(SnapshotState &r_state) const;
+	void restore_snapshot_state(const SnapshotState &p_state);
+
 	_FORCE_INLINE_ Vector2 get_velocity_in_local_point(const Vector2 &rel_pos) const {
 		return linear_velocity + Vector2(-angular_velocity * rel_pos.y, angular_velocity * rel_pos.x);
 	}
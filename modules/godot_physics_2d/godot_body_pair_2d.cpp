@@ -161,18 +161,25 @@ void GodotBodyPair2D::_validate_contacts() {
 	}
 }
 
-// `_test_ccd` prevents tunneling by slowing down a high velocity body that is about to collide so
+// `_cast_ccd` prevents tunneling by slowing down a high velocity body that is about to collide so
 // that next frame it will be at an appropriate location to collide (i.e. slight overlap).
 // WARNING: The way velocity is adjusted down to cause a collision means the momentum will be
 // weaker than it should for a bounce!
 // Process: Only proceed if body A's motion is high relative to its size.
 // Cast forward along motion vector to see if A is going to enter/pass B's collider next frame, only proceed if it does.
-// Adjust the velocity of A down so that it will just slightly intersect the collider instead of blowing right past it.
-bool GodotBodyPair2D::_test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2Di &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2Di &p_xform_B) {
+// Compute a velocity for A so that it will just slightly intersect the collider instead of blowing right past it.
+// The cast doesn't modify the bodies, so it can run during the setup; `_apply_ccd` sets the velocity afterwards.
+void GodotBodyPair2D::_cast_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2Di &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2Di &p_xform_B, CCDCast &r_cast) {
+	r_cast.computed = true;
+	r_cast.hit = false;
+	r_cast.oneway_rejected = false;
+	r_cast.linear_velocity_A = p_A->get_linear_velocity();
+	r_cast.linear_velocity_B = p_B->get_linear_velocity();
+
 	Vector2i motion = p_A->get_linear_velocity() * p_step;
 	real_t mlen = motion.length();
 	if (mlen < CMP_EPSILON) {
-		return false;
+		return;
 	}
 
 	Vector2i mnormal = motion / mlen;
@@ -184,7 +191,7 @@ bool GodotBodyPair2D::_test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A,
 	// Let's say it should move more than 1/3 the size of the object in that axis.
 	bool fast_object = mlen > (max - min) * 0.3;
 	if (!fast_object) {
-		return false;
+		return;
 	}
 
 	// A is moving fast enough that tunneling might occur. See if it's really about to collide.
@@ -216,16 +223,15 @@ bool GodotBodyPair2D::_test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A,
 	if (!p_B->get_shape(p_shape_B)->intersect_segment(local_from, local_to, rpos, rnorm)) {
 		// there was no hit. Since the segment is the length of per-frame motion, this means the bodies will not
 		// actually collide yet on next frame. We'll probably check again next frame once they're closer.
-		return false;
+		return;
 	}
 
 	// Check one-way collision based on motion direction.
 	if (p_A->get_shape(p_shape_A)->allows_one_way_collision() && p_B->is_shape_set_as_one_way_collision(p_shape_B)) {
 		Vector2i direction = predicted_xform_B.columns[1].normalized();
 		if (direction.dot(mnormal) < CMP_EPSILON) {
-			collided = false;
-			oneway_disabled = true;
-			return false;
+			r_cast.oneway_rejected = true;
+			return;
 		}
 	}
 
@@ -234,9 +240,24 @@ bool GodotBodyPair2D::_test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A,
 	Vector2i hitpos = predicted_xform_B.xform(rpos);
 
 	real_t newlen = hitpos.distance_to(from) + (max - min) * 0.01; // adding 1% of body length to the distance between collision and support point should cause body A's support point to arrive just within B's collider next frame.
-	p_A->set_linear_velocity(mnormal * (newlen / p_step));
+	r_cast.hit = true;
+	r_cast.new_linear_velocity = mnormal * (newlen / p_step);
+}
 
-	return true;
+void GodotBodyPair2D::_apply_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2Di &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2Di &p_xform_B, CCDCast &r_cast) {
+	if (!r_cast.computed || r_cast.linear_velocity_A != p_A->get_linear_velocity() || r_cast.linear_velocity_B != p_B->get_linear_velocity()) {
+		// The velocities were modified by the pre-solve of another pair since the setup, cast again to get the same result as a serial step.
+		_cast_ccd(p_step, p_A, p_shape_A, p_xform_A, p_B, p_shape_B, p_xform_B, r_cast);
+	}
+
+	if (r_cast.oneway_rejected) {
+		collided = false;
+		oneway_disabled = true;
+	} else if (r_cast.hit) {
+		p_A->set_linear_velocity(r_cast.new_linear_velocity);
+	}
+
+	r_cast.computed = false;
 }
 
 real_t combine_bounce(GodotBody2D *A, GodotBody2D *B) {
@@ -249,6 +270,8 @@ real_t combine_friction(GodotBody2D *A, GodotBody2D *B) {
 
 bool GodotBodyPair2D::setup(real_t p_step) {
 	check_ccd = false;
+	ccd_casts[0].computed = false;
+	ccd_casts[1].computed = false;
 
 	if (!A->interacts_with(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self())) {
 		collided = false;
@@ -300,16 +323,16 @@ bool GodotBodyPair2D::setup(real_t p_step) {
 		oneway_disabled = false;
 
 		if (A->get_continuous_collision_detection_mode() == PhysicsServer2D::CCD_MODE_CAST_RAY && collide_A) {
+			_cast_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B, ccd_casts[0]);
 			check_ccd = true;
-			return true;
 		}
 
 		if (B->get_continuous_collision_detection_mode() == PhysicsServer2D::CCD_MODE_CAST_RAY && collide_B) {
+			_cast_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A, ccd_casts[1]);
 			check_ccd = true;
-			return true;
 		}
 
-		return false;
+		return check_ccd;
 	}
 
 	if (oneway_disabled) {
@@ -373,11 +396,11 @@ bool GodotBodyPair2D::pre_solve(real_t p_step) {
 			Transform2Di xform_B = xform_Bu * B->get_shape_transform(shape_B);
 
 			if (A->get_continuous_collision_detection_mode() == PhysicsServer2D::CCD_MODE_CAST_RAY && collide_A) {
-				_test_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B);
+				_apply_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B, ccd_casts[0]);
 			}
 
 			if (B->get_continuous_collision_detection_mode() == PhysicsServer2D::CCD_MODE_CAST_RAY && collide_B) {
-				_test_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A);
+				_apply_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A, ccd_casts[1]);
 			}
 		}
 
@@ -593,6 +616,24 @@ void GodotBodyPair2D::solve(real_t p_step) {
 	}
 }
 
+void GodotBodyPair2D::save_snapshot_state(SnapshotState &r_state) const {
+	for (int i = 0; i < contact_count; i++) {
+		r_state.contacts[i] = contacts[i];
+	}
+	r_state.contact_count = contact_count;
+	r_state.sep_axis = sep_axis;
+	r_state.oneway_disabled = oneway_disabled;
+}
+
+void GodotBodyPair2D::restore_snapshot_state(const SnapshotState &p_state) {
+	for (int i = 0; i < p_state.contact_count; i++) {
+		contacts[i] = p_state.contacts[i];
+	}
+	contact_count = p_state.contact_count;
+	sep_axis = p_state.sep_axis;
+	oneway_disabled = p_state.oneway_disabled;
+}
+
 GodotBodyPair2D::GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B) :
 		GodotConstraint2D(_arr, 2) {
 	A = p_A;
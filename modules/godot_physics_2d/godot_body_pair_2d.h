@@ -84,16 +84,45 @@ class GodotBodyPair2D : public GodotConstraint2D {
 	bool oneway_disabled = false;
 	bool report_contacts_only = false;
 
-	bool _test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2Di &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2Di &p_xform_B);
+	// Continuous collision casts are computed during the setup, which runs on multiple threads, and applied during the pre-solve.
+	struct CCDCast {
+		bool computed = false;
+		bool hit = false;
+		bool oneway_rejected = false;
+		Vector2 linear_velocity_A; // Velocities the cast was computed with.
+		Vector2 linear_velocity_B;
+		Vector2 new_linear_velocity;
+	};
+
+	CCDCast ccd_casts[2];
+
+	static void _cast_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2Di &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2Di &p_xform_B, CCDCast &r_cast);
+	void _apply_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2Di &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2Di &p_xform_B, CCDCast &r_cast);
 	void _validate_contacts();
 	static void _add_contact(const Vector2i &p_point_A, const Vector2i &p_point_B, void *p_self);
 	_FORCE_INLINE_ void _contact_added_callback(const Vector2i &p_point_A, const Vector2i &p_point_B);
 
 public:
+	// State carried over from one step to the next, saved in space snapshots.
+	struct SnapshotState {
+		Contact contacts[MAX_CONTACTS];
+		int contact_count = 0;
+		Vector2 sep_axis;
+		bool oneway_disabled = false;
+	};
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	void save_snapshot_state(SnapshotState &r_state) const;
+	void restore_snapshot_state(const SnapshotState &p_state);
+
+	_FORCE_INLINE_ GodotBody2D *get_body_A() const { return A; }
+	_FORCE_INLINE_ GodotBody2D *get_body_B() const { return B; }
+	_FORCE_INLINE_ int get_shape_A() const { return shape_A; }
+	_FORCE_INLINE_ int get_shape_B() const { return shape_B; }
+
 	GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B);
 	~GodotBodyPair2D();
 };
@@ -33,6 +33,7 @@
 #include "godot_collision_solver_2d.h"
 #include "godot_physics_server_2d.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/templates/pair.h"
 
@@ -114,16 +115,14 @@ int GodotPhysicsDirectSpaceState2D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+bool GodotPhysicsDirectSpaceState2D::_intersect_ray(const RayParameters &p_parameters, RayResult &r_result, GodotCollisionObject2D **r_cull_results, int *r_cull_subindex_results) const {
 	Vector2 begin, end;
 	Vector2 normal;
 	begin = p_parameters.from;
 	end = p_parameters.to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_segment(begin, end, r_cull_results, GodotSpace2D::INTERSECTION_QUERY_MAX, r_cull_subindex_results);
 
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
@@ -134,17 +133,17 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	real_t min_d = 1e10;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_cull_results[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject2D *col_obj = r_cull_results[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = r_cull_subindex_results[i];
 		Transform2Di inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector2 local_from = inv_xform.xform(begin);
@@ -204,6 +203,55 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
+bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
+
+	return _intersect_ray(p_parameters, r_result, space->intersection_query_results, space->intersection_query_subindex_results);
+}
+
+void GodotPhysicsDirectSpaceState2D::_intersect_ray_batch_chunk(uint32_t p_chunk, RayBatch *p_batch) {
+	// Each chunk has its own cull buffers, the ones of the space are only used by single queries.
+	LocalVector<GodotCollisionObject2D *> cull_results;
+	cull_results.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+	LocalVector<int> cull_subindex_results;
+	cull_subindex_results.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+
+	RayParameters parameters = *p_batch->parameters;
+	int from = p_chunk * RAY_BATCH_CHUNK_SIZE;
+	int to = MIN(from + RAY_BATCH_CHUNK_SIZE, p_batch->count);
+	for (int i = from; i < to; i++) {
+		parameters.from = p_batch->from[i];
+		parameters.to = p_batch->to[i];
+		p_batch->hits[i] = _intersect_ray(parameters, p_batch->results[i], cull_results.ptr(), cull_subindex_results.ptr());
+	}
+}
+
+void GodotPhysicsDirectSpaceState2D::intersect_ray_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	ERR_FAIL_COND(space->locked);
+
+	if (p_count <= 0) {
+		return;
+	}
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.results = r_results;
+	batch.hits = r_hits;
+	batch.count = p_count;
+
+	// The space can't be stepped or modified until all the rays are done, the broadphase is thread safe for culling.
+	uint32_t chunk_count = (p_count + RAY_BATCH_CHUNK_SIZE - 1) / RAY_BATCH_CHUNK_SIZE;
+	if (chunk_count == 1) {
+		_intersect_ray_batch_chunk(0, &batch);
+		return;
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState2D::_intersect_ray_batch_chunk, &batch, chunk_count, -1, true, SNAME("IntersectRayBatch"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
 int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
 	if (p_result_max <= 0) {
 		return 0;
@@ -1494,6 +1542,17 @@ void *GodotSpace2D::_broadphase_pair(GodotCollisionObject2D *A, int p_subindex_A
 
 	} else {
 		GodotBodyPair2D *b = memnew(GodotBodyPair2D(static_cast<GodotBody2D *>(A), p_subindex_A, static_cast<GodotBody2D *>(B), p_subindex_B));
+		self->body_pairs.insert(b);
+
+		if (!self->pending_pair_states.is_empty()) {
+			HashMap<SnapshotPairKey, GodotBodyPair2D::SnapshotState, SnapshotPairKey>::Iterator P = self->pending_pair_states.find(_get_pair_key(b));
+			if (P) {
+				// The pair existed in a restored snapshot.
+				b->restore_snapshot_state(P->value);
+				self->pending_pair_states.remove(P);
+			}
+		}
+
 		return b;
 	}
 }
@@ -1505,6 +1564,9 @@ void GodotSpace2D::_broadphase_unpair(GodotCollisionObject2D *A, int p_subindex_
 
 	GodotSpace2D *self = static_cast<GodotSpace2D *>(p_self);
 	self->collision_pairs--;
+	if (A->get_type() == GodotCollisionObject2D::TYPE_BODY && B->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+		self->body_pairs.erase(static_cast<GodotBodyPair2D *>(p_data));
+	}
 	GodotConstraint2D *c = static_cast<GodotConstraint2D *>(p_data);
 	memdelete(c);
 }
@@ -1600,6 +1662,118 @@ void GodotSpace2D::setup() {
 
 void GodotSpace2D::update() {
 	broadphase->update();
+
+	// Pairs of a restored snapshot that weren't paired again would have been removed by this update.
+	pending_pair_states.clear();
+}
+
+Vector<uint8_t> GodotSpace2D::save_state() const {
+	SnapshotHeader header;
+
+	LocalVector<const GodotBody2D *> bodies;
+	for (const GodotCollisionObject2D *object : objects) {
+		if (_is_snapshot_body(object)) {
+			bodies.push_back(static_cast<const GodotBody2D *>(object));
+		}
+	}
+	header.body_count = bodies.size();
+	header.pair_count = body_pairs.size() + pending_pair_states.size();
+
+	Vector<uint8_t> state;
+	state.resize(sizeof(SnapshotHeader) + header.body_count * sizeof(SnapshotBody) + header.pair_count * sizeof(SnapshotPair));
+	uint8_t *w = state.ptrw();
+	memcpy(w, &header, sizeof(SnapshotHeader));
+	w += sizeof(SnapshotHeader);
+
+	SnapshotBody *snapshot_bodies = reinterpret_cast<SnapshotBody *>(w);
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+		snapshot_bodies[i].body = bodies[i]->get_self().get_id();
+		bodies[i]->save_snapshot_state(snapshot_bodies[i].state);
+	}
+	w += header.body_count * sizeof(SnapshotBody);
+
+	SnapshotPair *snapshot_pairs = reinterpret_cast<SnapshotPair *>(w);
+	uint32_t pair_index = 0;
+	for (const GodotBodyPair2D *pair : body_pairs) {
+		SnapshotPair &snapshot_pair = snapshot_pairs[pair_index++];
+		snapshot_pair.key = _get_pair_key(pair);
+		pair->save_snapshot_state(snapshot_pair.state);
+	}
+	for (const KeyValue<SnapshotPairKey, GodotBodyPair2D::SnapshotState> &E : pending_pair_states) {
+		SnapshotPair &snapshot_pair = snapshot_pairs[pair_index++];
+		snapshot_pair.key = E.key;
+		snapshot_pair.state = E.value;
+	}
+
+	return state;
+}
+
+bool GodotSpace2D::restore_state(const Vector<uint8_t> &p_state) {
+	ERR_FAIL_COND_V_MSG(locked, false, "Can't restore the state of a space while it's being stepped.");
+	ERR_FAIL_COND_V(p_state.size() < (int64_t)sizeof(SnapshotHeader), false);
+
+	const uint8_t *r = p_state.ptr();
+	SnapshotHeader header;
+	memcpy(&header, r, sizeof(SnapshotHeader));
+	ERR_FAIL_COND_V_MSG(header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.real_size != sizeof(real_t), false, "Invalid space state, or saved by an incompatible build.");
+	ERR_FAIL_COND_V((uint64_t)p_state.size() != sizeof(SnapshotHeader) + (uint64_t)header.body_count * sizeof(SnapshotBody) + (uint64_t)header.pair_count * sizeof(SnapshotPair), false);
+	r += sizeof(SnapshotHeader);
+
+	// Bodies are usually saved in the same order as they are stored, only look them up when that's not the case.
+	const SnapshotBody *snapshot_bodies = reinterpret_cast<const SnapshotBody *>(r);
+	uint32_t body_index = 0;
+	for (GodotCollisionObject2D *object : objects) {
+		if (!_is_snapshot_body(object)) {
+			continue;
+		}
+		if (body_index == header.body_count || object->get_self().get_id() != snapshot_bodies[body_index].body) {
+			break;
+		}
+		static_cast<GodotBody2D *>(object)->restore_snapshot_state(snapshot_bodies[body_index].state);
+		body_index++;
+	}
+	if (body_index < header.body_count) {
+		HashMap<uint64_t, GodotBody2D *> body_map;
+		for (GodotCollisionObject2D *object : objects) {
+			if (object->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+				body_map.insert(object->get_self().get_id(), static_cast<GodotBody2D *>(object));
+			}
+		}
+		uint32_t missing_count = 0;
+		for (; body_index < header.body_count; body_index++) {
+			HashMap<uint64_t, GodotBody2D *>::Iterator E = body_map.find(snapshot_bodies[body_index].body);
+			if (E) {
+				E->value->restore_snapshot_state(snapshot_bodies[body_index].state);
+			} else {
+				missing_count++;
+			}
+		}
+		if (missing_count > 0) {
+			WARN_PRINT(vformat("%d bodies of the restored space state are no longer in the space.", missing_count));
+		}
+	}
+	r += header.body_count * sizeof(SnapshotBody);
+
+	// Saved pairs that the broadphase still has are restored right away, the others when they are paired again.
+	pending_pair_states.clear();
+	const SnapshotPair *snapshot_pairs = reinterpret_cast<const SnapshotPair *>(r);
+	for (uint32_t i = 0; i < header.pair_count; i++) {
+		pending_pair_states.insert(snapshot_pairs[i].key, snapshot_pairs[i].state);
+	}
+
+	// Pairs that weren't in the snapshot are reset, as if they had just been created.
+	GodotBodyPair2D::SnapshotState new_pair_state;
+	for (GodotBodyPair2D *pair : body_pairs) {
+		HashMap<SnapshotPairKey, GodotBodyPair2D::SnapshotState, SnapshotPairKey>::Iterator P = pending_pair_states.find(_get_pair_key(pair));
+		if (P) {
+			pair->restore_snapshot_state(P->value);
+			pending_pair_states.remove(P);
+		} else {
+			pair->restore_snapshot_state(new_pair_state);
+		}
+	}
+
+	return true;
 }
 
 void GodotSpace2D::set_param(PhysicsServer2D::SpaceParameter p_param, real_t p_value) {
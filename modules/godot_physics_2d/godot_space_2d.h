@@ -45,11 +45,28 @@
 class GodotPhysicsDirectSpaceState2D : public PhysicsDirectSpaceState2D {
 	GDCLASS(GodotPhysicsDirectSpaceState2D, PhysicsDirectSpaceState2D);
 
+	enum {
+		RAY_BATCH_CHUNK_SIZE = 64
+	};
+
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector2 *from = nullptr;
+		const Vector2 *to = nullptr;
+		RayResult *results = nullptr;
+		bool *hits = nullptr;
+		int count = 0;
+	};
+
+	bool _intersect_ray(const RayParameters &p_parameters, RayResult &r_result, GodotCollisionObject2D **r_cull_results, int *r_cull_subindex_results) const;
+	void _intersect_ray_batch_chunk(uint32_t p_chunk, RayBatch *p_batch);
+
 public:
 	GodotSpace2D *space = nullptr;
 
 	virtual int intersect_point(const PointParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
+	virtual void intersect_ray_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector2i *r_results, int p_result_max, int &r_result_count) override;
@@ -94,6 +111,62 @@ private:
 
 	HashSet<GodotCollisionObject2D *> objects;
 
+	// Snapshots, see save_state() and restore_state().
+	enum {
+		SNAPSHOT_MAGIC = 0x32535350, // "PSS2"
+		SNAPSHOT_VERSION = 1,
+	};
+
+	struct SnapshotHeader {
+		uint32_t magic = SNAPSHOT_MAGIC;
+		uint32_t version = SNAPSHOT_VERSION;
+		uint32_t real_size = sizeof(real_t);
+		uint32_t body_count = 0;
+		uint32_t pair_count = 0;
+		uint32_t padding = 0;
+	};
+
+	struct SnapshotPairKey {
+		uint64_t body_A = 0;
+		uint64_t body_B = 0;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+
+		static uint32_t hash(const SnapshotPairKey &p_key) {
+			uint32_t h = hash_murmur3_one_64(p_key.body_A);
+			h = hash_murmur3_one_64(p_key.body_B, h);
+			h = hash_murmur3_one_32(p_key.shape_A, h);
+			h = hash_murmur3_one_32(p_key.shape_B, h);
+			return hash_fmix32(h);
+		}
+
+		bool operator==(const SnapshotPairKey &p_key) const {
+			return body_A == p_key.body_A && body_B == p_key.body_B && shape_A == p_key.shape_A && shape_B == p_key.shape_B;
+		}
+	};
+
+	struct SnapshotBody {
+		uint64_t body = 0;
+		GodotBody2D::SnapshotState state;
+	};
+
+	struct SnapshotPair {
+		SnapshotPairKey key;
+		GodotBodyPair2D::SnapshotState state;
+	};
+
+	HashSet<GodotBodyPair2D *> body_pairs;
+	// Pairs of a restored snapshot that the broadphase hasn't paired again yet.
+	HashMap<SnapshotPairKey, GodotBodyPair2D::SnapshotState, SnapshotPairKey> pending_pair_states;
+
+	// Static bodies are only moved by the user.
+	static _FORCE_INLINE_ bool _is_snapshot_body(const GodotCollisionObject2D *p_object) {
+		return p_object->get_type() == GodotCollisionObject2D::TYPE_BODY && static_cast<const GodotBody2D *>(p_object)->get_mode() != PhysicsServer2D::BODY_MODE_STATIC;
+	}
+	static _FORCE_INLINE_ SnapshotPairKey _get_pair_key(const GodotBodyPair2D *p_pair) {
+		return { p_pair->get_body_A()->get_self().get_id(), p_pair->get_body_B()->get_self().get_id(), p_pair->get_shape_A(), p_pair->get_shape_B() };
+	}
+
 	GodotArea2D *area = nullptr;
 
 	int solver_iterations = 0;
@@ -172,6 +245,10 @@ public:
 	void setup();
 	void call_queries();
 
+	// Saves the state of the simulation, bodies and contacts, to a buffer that can be restored later for rollback.
+	Vector<uint8_t> save_state() const;
+	bool restore_state(const Vector<uint8_t> &p_state);
+
 	bool is_locked() const;
 	void lock();
 	void unlock();
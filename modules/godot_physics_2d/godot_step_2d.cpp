@@ -239,6 +239,9 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
 
+	// The narrow phase (contact generation and continuous collision casts) runs here on multiple threads.
+	// Each constraint only writes to its own state, anything touching the bodies is deferred to the pre-solve,
+	// which runs in island order so results don't depend on the number of threads.
 	uint32_t total_constraint_count = all_constraints.size();
 	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep2D::_setup_constraint, nullptr, total_constraint_count, -1, true, SNAME("Physics2DConstraintSetup"));
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
@@ -146,6 +146,8 @@ struct	MinkowskiDiff {
 	}
 
 	// i wonder how this could be sped up... if it can
+	// Not batched like the SAT box-box axes: each GJK/EPA iteration needs the support point of the
+	// previous one to pick its next direction, so there is no fixed set of directions to evaluate at once.
 	_FORCE_INLINE_ Vector3 Support0(const Vector3& d) const {
 		return transform_A.xform(get_support(m_shapes[0], transform_A.basis.xform_inv(d), margin_A));
 	}
@@ -229,7 +229,13 @@ struct AreaCMP {
 	GodotArea3D *area = nullptr;
 	int refCount = 0;
 	_FORCE_INLINE_ bool operator==(const AreaCMP &p_cmp) const { return area->get_self() == p_cmp.area->get_self(); }
-	_FORCE_INLINE_ bool operator<(const AreaCMP &p_cmp) const { return area->get_priority() < p_cmp.area->get_priority(); }
+	_FORCE_INLINE_ bool operator<(const AreaCMP &p_cmp) const {
+		// Areas with the same priority are kept in creation order, so overrides don't depend on the order they were entered.
+		if (area->get_priority() == p_cmp.area->get_priority()) {
+			return area->get_self() < p_cmp.area->get_self();
+		}
+		return area->get_priority() < p_cmp.area->get_priority();
+	}
 	_FORCE_INLINE_ AreaCMP() {}
 	_FORCE_INLINE_ AreaCMP(GodotArea3D *p_area) {
 		area = p_area;
@@ -473,12 +473,12 @@ bool GodotBody3D::is_axis_locked(PhysicsServer3D::BodyAxis p_axis) const {
 	return locked_axis & p_axis;
 }
 
-void GodotBody3D::integrate_forces(real_t p_step) {
+bool GodotBody3D::prepare_force_integration(real_t p_step, Vector3 &r_force, Vector3 &r_torque, real_t &r_linear_damp, real_t &r_angular_damp) {
 	if (mode == PhysicsServer3D::BODY_MODE_STATIC) {
-		return;
+		return false;
 	}
 
-	ERR_FAIL_NULL(get_space());
+	ERR_FAIL_NULL_V(get_space(), false);
 
 	int ac = areas.size();
 
@@ -566,7 +566,7 @@ void GodotBody3D::integrate_forces(real_t p_step) {
 	// Add default gravity and damping from space area.
 	if (!stopped) {
 		GodotArea3D *default_area = get_space()->get_default_area();
-		ERR_FAIL_NULL(default_area);
+		ERR_FAIL_NULL_V(default_area, false);
 
 		if (!gravity_done) {
 			Vector3 default_gravity;
@@ -608,13 +608,9 @@ void GodotBody3D::integrate_forces(real_t p_step) {
 	prev_linear_velocity = linear_velocity;
 	prev_angular_velocity = angular_velocity;
 
-	Vector3 motion;
-	bool do_motion = false;
-
 	if (mode == PhysicsServer3D::BODY_MODE_KINEMATIC) {
 		//compute motion, angular and etc. velocities from prev transform
-		motion = new_transform.origin - get_transform().origin;
-		do_motion = true;
+		Vector3 motion = new_transform.origin - get_transform().origin;
 		linear_velocity = constant_linear_velocity + motion / p_step;
 
 		//compute a FAKE angular velocity, not so easy
@@ -625,36 +621,48 @@ void GodotBody3D::integrate_forces(real_t p_step) {
 		rot.get_axis_angle(axis, angle);
 		axis.normalize();
 		angular_velocity = constant_angular_velocity + axis * (angle / p_step);
-	} else {
-		if (!omit_force_integration) {
-			//overridden by direct state query
 
-			Vector3 force = gravity * mass + applied_force + constant_force;
-			Vector3 torque = applied_torque + constant_torque;
+		//shapes temporarily extend for raycast
+		integration_motion = motion;
+		integration_angle = 0.0;
+		integration_pending |= INTEGRATION_PENDING_SHAPES_MOTION;
+		return false;
+	}
 
-			real_t damp = 1.0 - p_step * total_linear_damp;
+	if (omit_force_integration) {
+		//overridden by direct state query
+		return false;
+	}
 
-			if (damp < 0) { // reached zero in the given time
-				damp = 0;
-			}
+	r_force = gravity * mass + applied_force + constant_force;
+	r_torque = applied_torque + constant_torque;
 
-			real_t angular_damp_new = 1.0 - p_step * total_angular_damp;
+	r_linear_damp = 1.0 - p_step * total_linear_damp;
 
-			if (angular_damp_new < 0) { // reached zero in the given time
-				angular_damp_new = 0;
-			}
+	if (r_linear_damp < 0) { // reached zero in the given time
+		r_linear_damp = 0;
+	}
 
-			linear_velocity *= damp;
-			angular_velocity *= angular_damp_new;
+	r_angular_damp = 1.0 - p_step * total_angular_damp;
 
-			linear_velocity += _inv_mass * force * p_step;
-			angular_velocity += _inv_inertia_tensor.xform(torque) * p_step;
-		}
+	if (r_angular_damp < 0) { // reached zero in the given time
+		r_angular_damp = 0;
+	}
 
-		if (continuous_cd) {
-			motion = linear_velocity * p_step;
-			do_motion = true;
-		}
+	return true;
+}
+
+void GodotBody3D::finish_force_integration(real_t p_step) {
+	if (mode == PhysicsServer3D::BODY_MODE_STATIC) {
+		return;
+	}
+
+	if (mode != PhysicsServer3D::BODY_MODE_KINEMATIC && continuous_cd) {
+		//shapes temporarily extend for raycast
+		integration_motion = linear_velocity * p_step;
+		// Fast spinning shapes can also pass through others.
+		integration_angle = angular_velocity.length() * p_step;
+		integration_pending |= INTEGRATION_PENDING_SHAPES_MOTION;
 	}
 
 	applied_force = Vector3();
@@ -663,22 +671,18 @@ void GodotBody3D::integrate_forces(real_t p_step) {
 	biased_angular_velocity = Vector3();
 	biased_linear_velocity = Vector3();
 
-	if (do_motion) { //shapes temporarily extend for raycast
-		_update_shapes_with_motion(motion);
-	}
-
 	contact_count = 0;
 }
 
-void GodotBody3D::integrate_velocities(real_t p_step) {
+bool GodotBody3D::prepare_velocity_integration() {
 	if (mode == PhysicsServer3D::BODY_MODE_STATIC) {
-		return;
+		return false;
 	}
 
-	ERR_FAIL_NULL(get_space());
+	ERR_FAIL_NULL_V(get_space(), false);
 
 	if (fi_callback_data || body_state_callback.is_valid()) {
-		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+		integration_pending |= INTEGRATION_PENDING_STATE_QUERY;
 	}
 
 	//apply axis lock linear
@@ -701,39 +705,74 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 		_set_transform(new_transform, false);
 		_set_inv_transform(new_transform.affine_inverse());
 		if (contacts.size() == 0 && linear_velocity == Vector3() && angular_velocity == Vector3()) {
-			set_active(false); //stopped moving, deactivate
+			integration_pending |= INTEGRATION_PENDING_DEACTIVATE; //stopped moving, deactivate
 		}
 
-		return;
+		return false;
 	}
 
-	Vector3 total_angular_velocity = angular_velocity + biased_angular_velocity;
+	return true;
+}
+
+void GodotBody3D::finish_velocity_integration(const Transform3D &p_transform) {
+	_set_transform(p_transform, false);
+	_set_inv_transform(get_transform().inverse());
+	integration_pending |= INTEGRATION_PENDING_SHAPES;
 
-	real_t ang_vel = total_angular_velocity.length();
-	Transform3D transform_new = get_transform();
+	_update_transform_dependent();
+}
 
-	if (!Math::is_zero_approx(ang_vel)) {
-		Vector3 ang_vel_axis = total_angular_velocity / ang_vel;
-		Basis rot(ang_vel_axis, ang_vel * p_step);
-		Basis identity3(1, 0, 0, 0, 1, 0, 0, 0, 1);
-		transform_new.origin += ((identity3 - rot) * transform_new.basis).xform(center_of_mass_local);
-		transform_new.basis = rot * transform_new.basis;
-		transform_new.orthonormalize();
+void GodotBody3D::finish_integration() {
+	if (integration_pending & INTEGRATION_PENDING_SHAPES_MOTION) {
+		_update_shapes_with_motion(integration_motion, integration_angle, get_transform().origin + center_of_mass);
 	}
 
-	Vector3 total_linear_velocity = linear_velocity + biased_linear_velocity;
-	/*for(int i=0;i<3;i++) {
-		if (axis_lock&(1<<i)) {
-			transform_new.origin[i]=0.0;
-		}
-	}*/
+	if (integration_pending & INTEGRATION_PENDING_SHAPES) {
+		_update_shapes();
+	}
 
-	transform_new.origin += total_linear_velocity * p_step;
+	if (integration_pending & INTEGRATION_PENDING_STATE_QUERY) {
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	}
 
-	_set_transform(transform_new);
-	_set_inv_transform(get_transform().inverse());
+	if (integration_pending & INTEGRATION_PENDING_DEACTIVATE) {
+		set_active(false);
+	}
+
+	integration_pending = 0;
+}
+
+void GodotBody3D::save_snapshot_state(SnapshotState &r_state) const {
+	r_state.transform = get_transform();
+	r_state.inv_transform = get_inv_transform();
+	r_state.new_transform = new_transform;
+	r_state.linear_velocity = linear_velocity;
+	r_state.angular_velocity = angular_velocity;
+	r_state.prev_linear_velocity = prev_linear_velocity;
+	r_state.prev_angular_velocity = prev_angular_velocity;
+	r_state.biased_linear_velocity = biased_linear_velocity;
+	r_state.biased_angular_velocity = biased_angular_velocity;
+	r_state.applied_force = applied_force;
+	r_state.applied_torque = applied_torque;
+	r_state.still_time = still_time;
+	r_state.active = active;
+}
 
+void GodotBody3D::restore_snapshot_state(const SnapshotState &p_state) {
+	_set_transform(p_state.transform);
+	_set_inv_transform(p_state.inv_transform);
 	_update_transform_dependent();
+	new_transform = p_state.new_transform;
+	linear_velocity = p_state.linear_velocity;
+	angular_velocity = p_state.angular_velocity;
+	prev_linear_velocity = p_state.prev_linear_velocity;
+	prev_angular_velocity = p_state.prev_angular_velocity;
+	biased_linear_velocity = p_state.biased_linear_velocity;
+	biased_angular_velocity = p_state.biased_angular_velocity;
+	applied_force = p_state.applied_force;
+	applied_torque = p_state.applied_torque;
+	still_time = p_state.still_time;
+	set_active(p_state.active);
 }
 
 void GodotBody3D::wakeup_neighbours() {
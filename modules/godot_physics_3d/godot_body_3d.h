@@ -108,6 +108,18 @@ class GodotBody3D : public GodotCollisionObject3D {
 	bool can_sleep = true;
 	bool first_time_kinematic = false;
 
+	// Integration may run on multiple threads, anything touching the space is deferred to finish_integration().
+	enum {
+		INTEGRATION_PENDING_SHAPES_MOTION = 1 << 0,
+		INTEGRATION_PENDING_SHAPES = 1 << 1,
+		INTEGRATION_PENDING_STATE_QUERY = 1 << 2,
+		INTEGRATION_PENDING_DEACTIVATE = 1 << 3,
+	};
+
+	uint32_t integration_pending = 0;
+	Vector3 integration_motion;
+	real_t integration_angle = 0.0;
+
 	void _mass_properties_changed();
 	virtual void _shapes_changed() override;
 	Transform3D new_transform;
@@ -145,6 +157,7 @@ class GodotBody3D : public GodotCollisionObject3D {
 	GodotPhysicsDirectBodyState3D *direct_state = nullptr;
 
 	uint64_t island_step = 0;
+	uint64_t island_color_mask = 0;
 
 	void _update_transform_dependent();
 
@@ -195,6 +208,9 @@ public:
 	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
 	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
 
+	_FORCE_INLINE_ uint64_t get_island_color_mask() const { return island_color_mask; }
+	_FORCE_INLINE_ void set_island_color_mask(uint64_t p_mask) { island_color_mask = p_mask; }
+
 	_FORCE_INLINE_ void add_constraint(GodotConstraint3D *p_constraint, int p_pos) { constraint_map[p_constraint] = p_pos; }
 	_FORCE_INLINE_ void remove_constraint(GodotConstraint3D *p_constraint) { constraint_map.erase(p_constraint); }
 	const HashMap<GodotConstraint3D *, int> &get_constraint_map() const { return constraint_map; }
@@ -316,8 +332,33 @@ public:
 	void set_axis_lock(PhysicsServer3D::BodyAxis p_axis, bool lock);
 	bool is_axis_locked(PhysicsServer3D::BodyAxis p_axis) const;
 
-	void integrate_forces(real_t p_step);
-	void integrate_velocities(real_t p_step);
+	// Integration is split around the math on the state of the body, which GodotStep3D runs over dense arrays of all active bodies.
+	// The prepare functions return whether the body needs that math, for the others they already did everything.
+	bool prepare_force_integration(real_t p_step, Vector3 &r_force, Vector3 &r_torque, real_t &r_linear_damp, real_t &r_angular_damp);
+	void finish_force_integration(real_t p_step);
+	bool prepare_velocity_integration();
+	void finish_velocity_integration(const Transform3D &p_transform);
+	void finish_integration();
+
+	// Simulation state saved in space snapshots, the rest is either set by the user or derived from it.
+	struct SnapshotState {
+		Transform3D transform;
+		Transform3D inv_transform;
+		Transform3D new_transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 prev_linear_velocity;
+		Vector3 prev_angular_velocity;
+		Vector3 biased_linear_velocity;
+		Vector3 biased_angular_velocity;
+		Vector3 applied_force;
+		Vector3 applied_torque;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void save_snapshot_state(SnapshotState &r_state) const;
+	void restore_snapshot_state(const SnapshotState &p_state);
 
 	_FORCE_INLINE_ Vector3 get_velocity_in_local_point(const Vector3 &rel_pos) const {
 		return linear_velocity + angular_velocity.cross(rel_pos - center_of_mass);
@@ -37,6 +37,7 @@
 
 #define MIN_VELOCITY 0.0001
 #define MAX_BIAS_ROTATION (Math_PI / 8)
+#define TOI_MAX_ITERATIONS 32
 
 void GodotBodyPair3D::_contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal, void *p_userdata) {
 	GodotBodyPair3D *pair = static_cast<GodotBodyPair3D *>(p_userdata);
@@ -75,6 +76,9 @@ void GodotBodyPair3D::contact_added_callback(const Vector3 &p_point_A, int p_ind
 		}
 	}
 
+	// Not touching in the previous step, but it may have been touching a few steps ago.
+	_restore_cached_contact(contact);
+
 	// Figure out if the contact amount must be reduced to fit the new contact.
 	if (new_index == MAX_CONTACTS) {
 		// Remove the contact with the minimum depth.
@@ -149,7 +153,9 @@ void GodotBodyPair3D::validate_contacts() {
 		}
 
 		if (erase) {
-			// Contact no longer needed, remove.
+			// Contact no longer needed, keep its impulses in case it comes back.
+			_cache_contact(c, space->get_step_count() - 1);
+
 			if ((i + 1) < contact_count) {
 				// Swap with the last one.
 				SWAP(contacts[i], contacts[contact_count - 1]);
@@ -161,36 +167,363 @@ void GodotBodyPair3D::validate_contacts() {
 	}
 }
 
-// `_test_ccd` prevents tunneling by slowing down a high velocity body that is about to collide so
+void GodotBodyPair3D::_cache_contact(const Contact &p_contact, uint64_t p_step) {
+	if (space->get_contact_cache_steps() <= 0) {
+		return;
+	}
+
+	real_t contact_recycle_radius = space->get_contact_recycle_radius();
+
+	// Replace the cached contact of the same feature, or the oldest one if the cache is full.
+	int index = -1;
+	for (int i = 0; i < contact_cache.count; i++) {
+		const CachedContact &cc = contact_cache.contacts[i];
+		if (cc.index_A == p_contact.index_A && cc.index_B == p_contact.index_B &&
+				cc.local_A.distance_squared_to(p_contact.local_A) < (contact_recycle_radius * contact_recycle_radius) &&
+				cc.local_B.distance_squared_to(p_contact.local_B) < (contact_recycle_radius * contact_recycle_radius)) {
+			index = i;
+			break;
+		}
+		if (contact_cache.count == MAX_CONTACTS && (index == -1 || cc.step < contact_cache.contacts[index].step)) {
+			index = i;
+		}
+	}
+
+	if (index == -1) {
+		index = contact_cache.count++;
+	}
+
+	CachedContact &cc = contact_cache.contacts[index];
+	cc.local_A = p_contact.local_A;
+	cc.local_B = p_contact.local_B;
+	cc.index_A = p_contact.index_A;
+	cc.index_B = p_contact.index_B;
+	cc.acc_normal_impulse = p_contact.acc_normal_impulse;
+	cc.acc_tangent_impulse = p_contact.acc_tangent_impulse;
+	cc.acc_bias_impulse = p_contact.acc_bias_impulse;
+	cc.acc_bias_impulse_center_of_mass = p_contact.acc_bias_impulse_center_of_mass;
+	cc.step = p_step;
+}
+
+bool GodotBodyPair3D::_restore_cached_contact(Contact &r_contact) {
+	uint64_t step = space->get_step_count();
+	uint64_t max_age = space->get_contact_cache_steps();
+	real_t contact_recycle_radius = space->get_contact_recycle_radius();
+
+	for (int i = 0; i < contact_cache.count; i++) {
+		CachedContact &cc = contact_cache.contacts[i];
+		if (step - cc.step > max_age) {
+			// Expired.
+			contact_cache.contacts[i--] = contact_cache.contacts[--contact_cache.count];
+			continue;
+		}
+
+		if (cc.index_A == r_contact.index_A && cc.index_B == r_contact.index_B &&
+				cc.local_A.distance_squared_to(r_contact.local_A) < (contact_recycle_radius * contact_recycle_radius) &&
+				cc.local_B.distance_squared_to(r_contact.local_B) < (contact_recycle_radius * contact_recycle_radius)) {
+			r_contact.acc_normal_impulse = cc.acc_normal_impulse;
+			r_contact.acc_bias_impulse = cc.acc_bias_impulse;
+			r_contact.acc_bias_impulse_center_of_mass = cc.acc_bias_impulse_center_of_mass;
+			r_contact.acc_tangent_impulse = cc.acc_tangent_impulse;
+			contact_cache.contacts[i] = contact_cache.contacts[--contact_cache.count];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void GodotBodyPair3D::_store_contact_cache(const Contact *p_contacts, int p_contact_count, const ContactCache &p_cache, uint64_t p_step, ContactCache &r_cache) {
+	r_cache = p_cache;
+
+	// Contacts still touching replace the oldest cached ones.
+	uint64_t step = p_step;
+	for (int i = 0; i < p_contact_count; i++) {
+		const Contact &c = p_contacts[i];
+		int index = r_cache.count;
+		if (index == MAX_CONTACTS) {
+			index = 0;
+			for (int j = 1; j < r_cache.count; j++) {
+				if (r_cache.contacts[j].step < r_cache.contacts[index].step) {
+					index = j;
+				}
+			}
+			if (r_cache.contacts[index].step >= step) {
+				break;
+			}
+		} else {
+			r_cache.count++;
+		}
+
+		CachedContact &cc = r_cache.contacts[index];
+		cc.local_A = c.local_A;
+		cc.local_B = c.local_B;
+		cc.index_A = c.index_A;
+		cc.index_B = c.index_B;
+		cc.acc_normal_impulse = c.acc_normal_impulse;
+		cc.acc_tangent_impulse = c.acc_tangent_impulse;
+		cc.acc_bias_impulse = c.acc_bias_impulse;
+		cc.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
+		cc.step = step;
+	}
+}
+
+void GodotBodyPair3D::store_contact_cache(ContactCache &r_cache) const {
+	_store_contact_cache(contacts, contact_count, contact_cache, space->get_step_count(), r_cache);
+}
+
+void GodotBodyPair3D::load_contact_cache(const ContactCache &p_cache) {
+	contact_cache = p_cache;
+}
+
+void GodotBodyPair3D::_copy_contact(const Contact &p_from, Contact &r_to) {
+	r_to.position = p_from.position;
+	r_to.normal = p_from.normal;
+	r_to.index_A = p_from.index_A;
+	r_to.index_B = p_from.index_B;
+	r_to.local_A = p_from.local_A;
+	r_to.local_B = p_from.local_B;
+	r_to.acc_impulse = p_from.acc_impulse;
+	r_to.acc_normal_impulse = p_from.acc_normal_impulse;
+	r_to.acc_tangent_impulse = p_from.acc_tangent_impulse;
+	r_to.acc_bias_impulse = p_from.acc_bias_impulse;
+	r_to.acc_bias_impulse_center_of_mass = p_from.acc_bias_impulse_center_of_mass;
+	r_to.mass_normal = p_from.mass_normal;
+	r_to.bias = p_from.bias;
+	r_to.bounce = p_from.bounce;
+	r_to.depth = p_from.depth;
+	r_to.active = p_from.active;
+	r_to.used = p_from.used;
+	r_to.rA = p_from.rA;
+	r_to.rB = p_from.rB;
+}
+
+void GodotBodyPair3D::copy_contact_cache(const ContactCache &p_from, ContactCache &r_to) {
+	for (int i = 0; i < p_from.count; i++) {
+		const CachedContact &from = p_from.contacts[i];
+		CachedContact &to = r_to.contacts[i];
+		to.local_A = from.local_A;
+		to.local_B = from.local_B;
+		to.index_A = from.index_A;
+		to.index_B = from.index_B;
+		to.acc_normal_impulse = from.acc_normal_impulse;
+		to.acc_tangent_impulse = from.acc_tangent_impulse;
+		to.acc_bias_impulse = from.acc_bias_impulse;
+		to.acc_bias_impulse_center_of_mass = from.acc_bias_impulse_center_of_mass;
+		to.step = from.step;
+	}
+	r_to.count = p_from.count;
+}
+
+void GodotBodyPair3D::copy_snapshot_state(const SnapshotState &p_from, SnapshotState &r_to) {
+	for (int i = 0; i < p_from.contact_count; i++) {
+		_copy_contact(p_from.contacts[i], r_to.contacts[i]);
+	}
+	r_to.contact_count = p_from.contact_count;
+	r_to.sep_axis = p_from.sep_axis;
+	copy_contact_cache(p_from.contact_cache, r_to.contact_cache);
+}
+
+void GodotBodyPair3D::save_snapshot_state(SnapshotState &r_state) const {
+	for (int i = 0; i < contact_count; i++) {
+		_copy_contact(contacts[i], r_state.contacts[i]);
+	}
+	r_state.contact_count = contact_count;
+	r_state.sep_axis = sep_axis;
+	copy_contact_cache(contact_cache, r_state.contact_cache);
+}
+
+void GodotBodyPair3D::restore_snapshot_state(const SnapshotState &p_state) {
+	for (int i = 0; i < p_state.contact_count; i++) {
+		contacts[i] = p_state.contacts[i];
+	}
+	contact_count = p_state.contact_count;
+	sep_axis = p_state.sep_axis;
+	contact_cache = p_state.contact_cache;
+}
+
+void GodotBodyPair3D::store_snapshot_contact_cache(const SnapshotState &p_state, uint64_t p_step, ContactCache &r_cache) {
+	_store_contact_cache(p_state.contacts, p_state.contact_count, p_state.contact_cache, p_step, r_cache);
+}
+
+bool GodotBodyPair3D::_can_compute_toi(const GodotShape3D *p_shape) {
+	switch (p_shape->get_type()) {
+		case PhysicsServer3D::SHAPE_SPHERE:
+		case PhysicsServer3D::SHAPE_BOX:
+		case PhysicsServer3D::SHAPE_CAPSULE:
+		case PhysicsServer3D::SHAPE_CYLINDER:
+		case PhysicsServer3D::SHAPE_CONVEX_POLYGON:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Transform of a shape after moving its body by the given velocities for p_time seconds, rotating around the center of mass.
+static Transform3D _advance_shape_transform(const Transform3D &p_xform, const Vector3 &p_center_of_mass, const Vector3 &p_linear_velocity, const Vector3 &p_angular_velocity, real_t p_time) {
+	Transform3D xform = p_xform;
+
+	real_t angular_speed = p_angular_velocity.length();
+	if (!Math::is_zero_approx(angular_speed)) {
+		Basis rot(p_angular_velocity / angular_speed, angular_speed * p_time);
+		xform.basis = rot * xform.basis;
+		xform.origin = p_center_of_mass + rot.xform(xform.origin - p_center_of_mass);
+	}
+
+	xform.origin += p_linear_velocity * p_time;
+	return xform;
+}
+
+// Center of mass of the body owning a shape, in the same space as the shape transform used by the pair.
+static Vector3 _get_shape_center_of_mass(const GodotBody3D *p_body, int p_shape, const Transform3D &p_xform) {
+	return p_xform.origin - p_body->get_transform().basis.xform(p_body->get_shape_transform(p_shape).origin) + p_body->get_center_of_mass();
+}
+
+// Largest distance from the center of mass to any point of the shape.
+static real_t _get_shape_radius(const GodotShape3D *p_shape, const Transform3D &p_xform, const Vector3 &p_center_of_mass) {
+	AABB aabb = p_xform.xform(p_shape->get_aabb());
+	return (aabb.get_center() - p_center_of_mass).length() + aabb.size.length() * 0.5;
+}
+
+// Conservative advancement: move both shapes forward by the largest time that can't make them overlap,
+// according to their current distance and a bound on how fast any of their points approach each other,
+// until they are within p_tolerance. Unlike a ray cast, this also catches thin and rotating shapes.
+// r_toi is the fraction of the step at which the shapes touch, r_normal the direction from A to B when they do.
+// Shapes already touching at the start of the step are left to the regular contacts.
+bool GodotBodyPair3D::_compute_toi(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B, real_t p_tolerance, real_t &r_toi, Vector3 &r_normal) {
+	const GodotShape3D *shape_A_ptr = p_A->get_shape(p_shape_A);
+	const GodotShape3D *shape_B_ptr = p_B->get_shape(p_shape_B);
+
+	const Vector3 center_of_mass_A = _get_shape_center_of_mass(p_A, p_shape_A, p_xform_A);
+	const Vector3 center_of_mass_B = _get_shape_center_of_mass(p_B, p_shape_B, p_xform_B);
+
+	const Vector3 linear_velocity_A = p_A->get_linear_velocity();
+	const Vector3 linear_velocity_B = p_B->get_linear_velocity();
+	const Vector3 angular_velocity_A = p_A->get_angular_velocity();
+	const Vector3 angular_velocity_B = p_B->get_angular_velocity();
+
+	// Rotation can move points of a shape by at most its radius times the angular speed.
+	const real_t angular_bound = angular_velocity_A.length() * _get_shape_radius(shape_A_ptr, p_xform_A, center_of_mass_A) +
+			angular_velocity_B.length() * _get_shape_radius(shape_B_ptr, p_xform_B, center_of_mass_B);
+	const Vector3 relative_velocity = linear_velocity_A - linear_velocity_B;
+
+	real_t time = 0.0;
+	bool touching = false;
+	for (int i = 0; i < TOI_MAX_ITERATIONS && !touching; i++) {
+		Transform3D xform_A = _advance_shape_transform(p_xform_A, center_of_mass_A, linear_velocity_A, angular_velocity_A, time);
+		Transform3D xform_B = _advance_shape_transform(p_xform_B, center_of_mass_B, linear_velocity_B, angular_velocity_B, time);
+
+		Vector3 point_A, point_B;
+		if (!GodotCollisionSolver3D::solve_distance(shape_A_ptr, xform_A, shape_B_ptr, xform_B, point_A, point_B, AABB())) {
+			// Already overlapping.
+			touching = true;
+			break;
+		}
+
+		Vector3 separation = point_B - point_A;
+		real_t distance = separation.length();
+		if (distance < p_tolerance) {
+			touching = true;
+			break;
+		}
+
+		r_normal = separation / distance;
+		real_t approach_speed = relative_velocity.dot(r_normal) + angular_bound;
+		if (approach_speed <= CMP_EPSILON) {
+			return false; // Moving apart.
+		}
+
+		time += (distance - p_tolerance * 0.5) / approach_speed;
+		if (time > p_step) {
+			return false; // Not touching during this step.
+		}
+	}
+
+	if (!touching) {
+		// Still approaching after all iterations, which happens when sliding along B. The time reached is
+		// only a lower bound, stopping there would freeze A, so it's left to the next step.
+		return false;
+	}
+
+	if (time == 0.0) {
+		// Resting on or sliding along B, nothing can tunnel.
+		return false;
+	}
+
+	r_toi = time / p_step;
+	return true;
+}
+
+// `_cast_ccd` prevents tunneling by slowing down a high velocity body that is about to collide so
 // that next frame it will be at an appropriate location to collide (i.e. slight overlap).
 // WARNING: The way velocity is adjusted down to cause a collision means the momentum will be
 // weaker than it should for a bounce!
-// Process: Only proceed if body A's motion is high relative to its size.
+// Process: Only proceed if body A's motion, or the motion of its points from rotation, is high relative to its size.
 // Cast forward along motion vector to see if A is going to enter/pass B's collider next frame, only proceed if it does.
-// Adjust the velocity of A down so that it will just slightly intersect the collider instead of blowing right past it.
-bool GodotBodyPair3D::_test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B) {
+// Compute a velocity for A so that it will just slightly intersect the collider instead of blowing right past it.
+// The cast doesn't modify the bodies, so it can run during the setup; `_apply_ccd` sets the velocity afterwards.
+void GodotBodyPair3D::_cast_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B, CCDCast &r_cast) {
+	r_cast.computed = true;
+	r_cast.hit = false;
+	r_cast.linear_velocity_A = p_A->get_linear_velocity();
+	r_cast.angular_velocity_A = p_A->get_angular_velocity();
+	r_cast.linear_velocity_B = p_B->get_linear_velocity();
+
 	GodotShape3D *shape_A_ptr = p_A->get_shape(p_shape_A);
+	const bool can_compute_toi = _can_compute_toi(shape_A_ptr) && _can_compute_toi(p_B->get_shape(p_shape_B));
 
 	Vector3 motion = p_A->get_linear_velocity() * p_step;
 	real_t mlen = motion.length();
-	if (mlen < CMP_EPSILON) {
-		return false;
+
+	// Distance travelled by the farthest point of A because of its rotation, only handled by the time of impact.
+	real_t angular_motion = 0.0;
+	if (can_compute_toi) {
+		angular_motion = p_A->get_angular_velocity().length() * _get_shape_radius(shape_A_ptr, p_xform_A, _get_shape_center_of_mass(p_A, p_shape_A, p_xform_A)) * p_step;
 	}
 
-	Vector3 mnormal = motion / mlen;
+	if (mlen < CMP_EPSILON && angular_motion < CMP_EPSILON) {
+		return;
+	}
 
+	Vector3 mnormal;
 	real_t min = 0.0, max = 0.0;
-	shape_A_ptr->project_range(mnormal, p_xform_A, min, max);
+	if (mlen >= CMP_EPSILON) {
+		mnormal = motion / mlen;
+		shape_A_ptr->project_range(mnormal, p_xform_A, min, max);
+	}
 
 	// Did it move enough in this direction to even attempt raycast?
 	// Let's say it should move more than 1/3 the size of the object in that axis.
-	bool fast_object = mlen > (max - min) * 0.3;
+	real_t size = max - min;
+	bool fast_object = mlen >= CMP_EPSILON && mlen > size * 0.3;
+	if (!fast_object && angular_motion >= CMP_EPSILON) {
+		// Rotation can carry a thin part of A through B even when A barely moves, compare with its thinnest side.
+		size = p_xform_A.xform(shape_A_ptr->get_aabb()).get_shortest_axis_size();
+		fast_object = angular_motion > size * 0.3;
+	}
 	if (!fast_object) {
-		return false; // moving slow enough that there's no chance of tunneling.
+		return; // moving slow enough that there's no chance of tunneling.
 	}
 
 	// A is moving fast enough that tunneling might occur. See if it's really about to collide.
 
+	if (can_compute_toi) {
+		// Convex pairs find the exact time of impact, taking rotation and the motion of B into account.
+		real_t toi = 0.0;
+		Vector3 normal;
+		if (_compute_toi(p_step, p_A, p_shape_A, p_xform_A, p_B, p_shape_B, p_xform_B, size * 0.01, toi, normal)) {
+			// Same as below, slow A down so it travels until the time of impact plus 1% of its size and arrives just within B.
+			// Only the approach towards B is slowed down, so A keeps sliding along B. Rotation can't be split that way and is scaled as a whole.
+			const real_t scale = MIN(toi + size * 0.01 / (mlen + angular_motion), (real_t)1.0);
+			const Vector3 linear_velocity = p_A->get_linear_velocity();
+			const real_t approach_speed = (linear_velocity - p_B->get_linear_velocity()).dot(normal);
+			r_cast.hit = true;
+			r_cast.new_linear_velocity = approach_speed > 0.0 ? linear_velocity - normal * (approach_speed * (1.0 - scale)) : linear_velocity;
+			r_cast.new_angular_velocity = p_A->get_angular_velocity() * scale;
+		}
+		return;
+	}
+
 	// Roughly predict body B's position in the next frame (ignoring collisions).
 	Transform3D predicted_xform_B = p_xform_B.translated(p_B->get_linear_velocity() * p_step);
 
@@ -236,7 +569,7 @@ bool GodotBodyPair3D::_test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A,
 	if (segment_support_idx == -1) {
 		// There was no hit. Since the segment is the length of per-frame motion, this means the bodies will not
 		// actually collide yet on next frame. We'll probably check again next frame once they're closer.
-		return false;
+		return;
 	}
 
 	Vector3 hitpos = predicted_xform_B.xform(segment_hit_local);
@@ -247,9 +580,23 @@ bool GodotBodyPair3D::_test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A,
 	newlen += (max - min) * 0.01;
 	// FIXME: This doesn't always work well when colliding with a triangle face of a trimesh shape.
 
-	p_A->set_linear_velocity((mnormal * newlen) / p_step);
+	r_cast.hit = true;
+	r_cast.new_linear_velocity = (mnormal * newlen) / p_step;
+	r_cast.new_angular_velocity = p_A->get_angular_velocity();
+}
 
-	return true;
+void GodotBodyPair3D::_apply_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B, CCDCast &r_cast) {
+	if (!r_cast.computed || r_cast.linear_velocity_A != p_A->get_linear_velocity() || r_cast.angular_velocity_A != p_A->get_angular_velocity() || r_cast.linear_velocity_B != p_B->get_linear_velocity()) {
+		// The velocities were modified by the pre-solve of another pair since the setup, cast again to get the same result as a serial step.
+		_cast_ccd(p_step, p_A, p_shape_A, p_xform_A, p_B, p_shape_B, p_xform_B, r_cast);
+	}
+
+	if (r_cast.hit) {
+		p_A->set_linear_velocity(r_cast.new_linear_velocity);
+		p_A->set_angular_velocity(r_cast.new_angular_velocity);
+	}
+
+	r_cast.computed = false;
 }
 
 real_t combine_bounce(GodotBody3D *A, GodotBody3D *B) {
@@ -262,6 +609,8 @@ real_t combine_friction(GodotBody3D *A, GodotBody3D *B) {
 
 bool GodotBodyPair3D::setup(real_t p_step) {
 	check_ccd = false;
+	ccd_casts[0].computed = false;
+	ccd_casts[1].computed = false;
 
 	if (!A->interacts_with(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self())) {
 		collided = false;
@@ -300,16 +649,16 @@ bool GodotBodyPair3D::setup(real_t p_step) {
 
 	if (!collided) {
 		if (A->is_continuous_collision_detection_enabled() && collide_A) {
+			_cast_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B, ccd_casts[0]);
 			check_ccd = true;
-			return true;
 		}
 
 		if (B->is_continuous_collision_detection_enabled() && collide_B) {
+			_cast_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A, ccd_casts[1]);
 			check_ccd = true;
-			return true;
 		}
 
-		return false;
+		return check_ccd;
 	}
 
 	return true;
@@ -327,11 +676,11 @@ bool GodotBodyPair3D::pre_solve(real_t p_step) {
 			Transform3D xform_B = xform_Bu * B->get_shape_transform(shape_B);
 
 			if (A->is_continuous_collision_detection_enabled() && collide_A) {
-				_test_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B);
+				_apply_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B, ccd_casts[0]);
 			}
 
 			if (B->is_continuous_collision_detection_enabled() && collide_B) {
-				_test_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A);
+				_apply_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A, ccd_casts[1]);
 			}
 		}
 
@@ -97,18 +97,84 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 	Contact contacts[MAX_CONTACTS];
 	int contact_count = 0;
 
+	// Continuous collision casts are computed during the setup, which runs on multiple threads, and applied during the pre-solve.
+	struct CCDCast {
+		bool computed = false;
+		bool hit = false;
+		Vector3 linear_velocity_A; // Velocities the cast was computed with.
+		Vector3 angular_velocity_A;
+		Vector3 linear_velocity_B;
+		Vector3 new_linear_velocity;
+		Vector3 new_angular_velocity;
+	};
+
+	CCDCast ccd_casts[2];
+
+public:
+	// Contacts that stopped touching, kept with their accumulated impulses for a few steps so they can
+	// warm start the solver again if the same features touch. Outlives the pair through the space.
+	struct CachedContact {
+		Vector3 local_A, local_B;
+		int index_A = 0, index_B = 0;
+		real_t acc_normal_impulse = 0.0;
+		Vector3 acc_tangent_impulse;
+		real_t acc_bias_impulse = 0.0;
+		real_t acc_bias_impulse_center_of_mass = 0.0;
+		uint64_t step = 0; // Last step the contact was touching.
+	};
+
+	struct ContactCache {
+		CachedContact contacts[MAX_CONTACTS];
+		int count = 0;
+	};
+
+	// State carried over from one step to the next, saved in space snapshots.
+	struct SnapshotState {
+		Contact contacts[MAX_CONTACTS];
+		int contact_count = 0;
+		Vector3 sep_axis;
+		ContactCache contact_cache;
+	};
+
+private:
+	ContactCache contact_cache;
+
+	static void _copy_contact(const Contact &p_from, Contact &r_to);
+	static void _store_contact_cache(const Contact *p_contacts, int p_contact_count, const ContactCache &p_cache, uint64_t p_step, ContactCache &r_cache);
+	void _cache_contact(const Contact &p_contact, uint64_t p_step);
+	bool _restore_cached_contact(Contact &r_contact);
+
 	static void _contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal);
 
 	void validate_contacts();
-	bool _test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B);
+	static bool _can_compute_toi(const GodotShape3D *p_shape);
+	static bool _compute_toi(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B, real_t p_tolerance, real_t &r_toi, Vector3 &r_normal);
+	static void _cast_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B, CCDCast &r_cast);
+	static void _apply_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B, CCDCast &r_cast);
 
 public:
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	void store_contact_cache(ContactCache &r_cache) const;
+	void load_contact_cache(const ContactCache &p_cache);
+
+	void save_snapshot_state(SnapshotState &r_state) const;
+	void restore_snapshot_state(const SnapshotState &p_state);
+	// Same contacts as a pair that would have been unpaired from this state at the given step.
+	static void store_snapshot_contact_cache(const SnapshotState &p_state, uint64_t p_step, ContactCache &r_cache);
+	// Copy member by member, so the padding of a zeroed destination stays zeroed and saved snapshots are reproducible byte for byte.
+	static void copy_snapshot_state(const SnapshotState &p_from, SnapshotState &r_to);
+	static void copy_contact_cache(const ContactCache &p_from, ContactCache &r_to);
+
+	_FORCE_INLINE_ GodotBody3D *get_body_A() const { return A; }
+	_FORCE_INLINE_ GodotBody3D *get_body_B() const { return B; }
+	_FORCE_INLINE_ int get_shape_A() const { return shape_A; }
+	_FORCE_INLINE_ int get_shape_B() const { return shape_B; }
+
 	GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B);
 	~GodotBodyPair3D();
 };
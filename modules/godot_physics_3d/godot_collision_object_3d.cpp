@@ -182,7 +182,7 @@ void GodotCollisionObject3D::_update_shapes() {
 	}
 }
 
-void GodotCollisionObject3D::_update_shapes_with_motion(const Vector3 &p_motion) {
+void GodotCollisionObject3D::_update_shapes_with_motion(const Vector3 &p_motion, real_t p_angle, const Vector3 &p_pivot) {
 	if (!space) {
 		return;
 	}
@@ -197,6 +197,14 @@ void GodotCollisionObject3D::_update_shapes_with_motion(const Vector3 &p_motion)
 		AABB shape_aabb = s.shape->get_aabb();
 		Transform3D xform = transform * s.xform;
 		shape_aabb = xform.xform(shape_aabb);
+		if (p_angle > 0.0) {
+			// Rotating by p_angle around the pivot moves points by at most their distance to it times the angle,
+			// and never more than twice that distance.
+			const real_t radius = (shape_aabb.get_center() - p_pivot).length() + shape_aabb.size.length() * 0.5;
+			const real_t sweep = radius * MIN(p_angle, (real_t)2.0);
+			shape_aabb.position -= Vector3(sweep, sweep, sweep);
+			shape_aabb.size += Vector3(sweep, sweep, sweep) * 2.0;
+		}
 		shape_aabb.merge_with(AABB(shape_aabb.position + p_motion, shape_aabb.size)); //use motion
 		s.aabb_cache = shape_aabb;
 
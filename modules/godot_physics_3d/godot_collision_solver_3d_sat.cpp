@@ -612,6 +612,130 @@ static void _generate_contacts_from_supports(const Vector3 *p_points_A, int p_po
 	contacts_func(points_A, pointcount_A, points_B, pointcount_B, p_callback);
 }
 
+// Checks a pair of projected ranges along one axis, keeping track of the axis with the smallest depth.
+// Returns false if the ranges don't overlap.
+static _FORCE_INLINE_ bool _test_axis_range(const Vector3 &p_axis, real_t p_min_A, real_t p_max_A, real_t p_min_B, real_t p_max_B, real_t &r_best_depth, Vector3 &r_best_axis) {
+	p_min_B -= (p_max_A - p_min_A) * 0.5;
+	p_max_B += (p_max_A - p_min_A) * 0.5;
+
+	p_min_B -= (p_min_A + p_max_A) * 0.5;
+	p_max_B -= (p_min_A + p_max_A) * 0.5;
+
+	if (p_min_B > 0.0 || p_max_B < 0.0) {
+		return false; // doesn't contain 0
+	}
+
+	//use the smallest depth
+
+	if (p_min_B < 0.0) { // could be +0.0, we don't want it to become -0.0
+		p_min_B = -p_min_B;
+	}
+
+	if (p_max_B < p_min_B) {
+		if (p_max_B < r_best_depth) {
+			r_best_depth = p_max_B;
+			r_best_axis = p_axis;
+		}
+	} else {
+		if (p_min_B < r_best_depth) {
+			r_best_depth = p_min_B;
+			r_best_axis = -p_axis; // keep it as A axis
+		}
+	}
+
+	return true;
+}
+
+// All the candidate separating axes of a box pair (3 faces of A, 3 faces of B and 9 edge pairs), stored as a
+// structure of arrays so both boxes can be projected onto every axis in a single loop the compiler vectorizes.
+struct _BoxBoxAxes {
+	static const int AXIS_COUNT = 15;
+
+	real_t x[AXIS_COUNT];
+	real_t y[AXIS_COUNT];
+	real_t z[AXIS_COUNT];
+	real_t min_A[AXIS_COUNT];
+	real_t max_A[AXIS_COUNT];
+	real_t min_B[AXIS_COUNT];
+	real_t max_B[AXIS_COUNT];
+	bool valid[AXIS_COUNT];
+
+	_FORCE_INLINE_ Vector3 get_axis(int p_index) const {
+		return Vector3(x[p_index], y[p_index], z[p_index]);
+	}
+
+	_FORCE_INLINE_ void set_axis(int p_index, const Vector3 &p_axis, bool p_valid) {
+		x[p_index] = p_axis.x;
+		y[p_index] = p_axis.y;
+		z[p_index] = p_axis.z;
+		valid[p_index] = p_valid;
+	}
+
+	void build(const Transform3D &p_transform_A, const Transform3D &p_transform_B) {
+		for (int i = 0; i < 3; i++) {
+			Vector3 axis = p_transform_A.basis.get_column(i).normalized();
+			if (axis.is_zero_approx()) {
+				// strange case, try an upwards separator
+				axis = Vector3(0.0, 1.0, 0.0);
+			}
+			set_axis(i, axis, true);
+		}
+
+		for (int i = 0; i < 3; i++) {
+			Vector3 axis = p_transform_B.basis.get_column(i).normalized();
+			if (axis.is_zero_approx()) {
+				axis = Vector3(0.0, 1.0, 0.0);
+			}
+			set_axis(3 + i, axis, true);
+		}
+
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				Vector3 axis = p_transform_A.basis.get_column(i).cross(p_transform_B.basis.get_column(j));
+				bool is_valid = !Math::is_zero_approx(axis.length_squared());
+				if (is_valid) {
+					axis.normalize();
+				}
+				set_axis(6 + i * 3 + j, axis, is_valid);
+			}
+		}
+	}
+
+	// Same math as GodotBoxShape3D::project_range(), for all the axes at once.
+	static _FORCE_INLINE_ void _project(const Transform3D &p_transform, const Vector3 &p_half_extents, const real_t *p_x, const real_t *p_y, const real_t *p_z, real_t *r_min, real_t *r_max) {
+		const Basis &b = p_transform.basis;
+		const real_t b00 = b.rows[0][0], b01 = b.rows[0][1], b02 = b.rows[0][2];
+		const real_t b10 = b.rows[1][0], b11 = b.rows[1][1], b12 = b.rows[1][2];
+		const real_t b20 = b.rows[2][0], b21 = b.rows[2][1], b22 = b.rows[2][2];
+		const real_t ox = p_transform.origin.x, oy = p_transform.origin.y, oz = p_transform.origin.z;
+		const real_t hx = p_half_extents.x, hy = p_half_extents.y, hz = p_half_extents.z;
+
+		for (int i = 0; i < AXIS_COUNT; i++) {
+			const real_t lx = (b00 * p_x[i]) + (b10 * p_y[i]) + (b20 * p_z[i]);
+			const real_t ly = (b01 * p_x[i]) + (b11 * p_y[i]) + (b21 * p_z[i]);
+			const real_t lz = (b02 * p_x[i]) + (b12 * p_y[i]) + (b22 * p_z[i]);
+			const real_t length = Math::abs(lx) * hx + Math::abs(ly) * hy + Math::abs(lz) * hz;
+			const real_t distance = p_x[i] * ox + p_y[i] * oy + p_z[i] * oz;
+			r_min[i] = distance - length;
+			r_max[i] = distance + length;
+		}
+	}
+
+	_FORCE_INLINE_ void project(const Transform3D &p_transform_A, const Vector3 &p_half_extents_A, const Transform3D &p_transform_B, const Vector3 &p_half_extents_B) {
+		_project(p_transform_A, p_half_extents_A, x, y, z, min_A, max_A);
+		_project(p_transform_B, p_half_extents_B, x, y, z, min_B, max_B);
+	}
+
+	_FORCE_INLINE_ void add_margins(real_t p_margin_A, real_t p_margin_B) {
+		for (int i = 0; i < AXIS_COUNT; i++) {
+			min_A[i] -= p_margin_A;
+			max_A[i] += p_margin_A;
+			min_B[i] -= p_margin_B;
+			max_B[i] += p_margin_B;
+		}
+	}
+};
+
 template <typename ShapeA, typename ShapeB, bool withMargin = false>
 class SeparatorAxisTest {
 	const ShapeA *shape_A = nullptr;
@@ -655,35 +779,15 @@ public:
 			max_B += margin_B;
 		}
 
-		min_B -= (max_A - min_A) * 0.5;
-		max_B += (max_A - min_A) * 0.5;
-
-		min_B -= (min_A + max_A) * 0.5;
-		max_B -= (min_A + max_A) * 0.5;
-
-		if (min_B > 0.0 || max_B < 0.0) {
-			separator_axis = axis;
-			return false; // doesn't contain 0
-		}
-
-		//use the smallest depth
-
-		if (min_B < 0.0) { // could be +0.0, we don't want it to become -0.0
-			min_B = -min_B;
-		}
+		return test_axis_range(axis, min_A, max_A, min_B, max_B);
+	}
 
-		if (max_B < min_B) {
-			if (max_B < best_depth) {
-				best_depth = max_B;
-				best_axis = axis;
-			}
-		} else {
-			if (min_B < best_depth) {
-				best_depth = min_B;
-				best_axis = -axis; // keep it as A axis
-			}
+	// Like test_axis(), for ranges that were already projected (and expanded by the margins).
+	_FORCE_INLINE_ bool test_axis_range(const Vector3 &p_axis, real_t p_min_A, real_t p_max_A, real_t p_min_B, real_t p_max_B) {
+		if (!_test_axis_range(p_axis, p_min_A, p_max_A, p_min_B, p_max_B, best_depth, best_axis)) {
+			separator_axis = p_axis;
+			return false;
 		}
-
 		return true;
 	}
 
@@ -1079,39 +1183,22 @@ static void _collision_box_box(const GodotShape3D *p_a, const Transform3D &p_tra
 		return;
 	}
 
-	// test faces of A
-
-	for (int i = 0; i < 3; i++) {
-		Vector3 axis = p_transform_a.basis.get_column(i).normalized();
+	// test faces of A, faces of B and combined edges, projecting on all of them at once
 
-		if (!separator.test_axis(axis)) {
-			return;
-		}
+	_BoxBoxAxes axes;
+	axes.build(p_transform_a, p_transform_b);
+	axes.project(p_transform_a, box_A->get_half_extents(), p_transform_b, box_B->get_half_extents());
+	if (withMargin) {
+		axes.add_margins(p_margin_a, p_margin_b);
 	}
 
-	// test faces of B
-
-	for (int i = 0; i < 3; i++) {
-		Vector3 axis = p_transform_b.basis.get_column(i).normalized();
-
-		if (!separator.test_axis(axis)) {
-			return;
+	for (int i = 0; i < _BoxBoxAxes::AXIS_COUNT; i++) {
+		if (!axes.valid[i]) {
+			continue;
 		}
-	}
 
-	// test combined edges
-	for (int i = 0; i < 3; i++) {
-		for (int j = 0; j < 3; j++) {
-			Vector3 axis = p_transform_a.basis.get_column(i).cross(p_transform_b.basis.get_column(j));
-
-			if (Math::is_zero_approx(axis.length_squared())) {
-				continue;
-			}
-			axis.normalize();
-
-			if (!separator.test_axis(axis)) {
-				return;
-			}
+		if (!separator.test_axis_range(axes.get_axis(i), axes.min_A[i], axes.max_A[i], axes.min_B[i], axes.max_B[i])) {
+			return;
 		}
 	}
 
@@ -2289,6 +2376,49 @@ static void _collision_convex_polygon_face(const GodotShape3D *p_a, const Transf
 	separator.generate_contacts();
 }
 
+void sat_box_box_batch(const SATBoxBoxBatch &p_batch) {
+	ERR_FAIL_COND(p_batch.count > 0 && (!p_batch.transforms_A || !p_batch.half_extents_A || !p_batch.transforms_B || !p_batch.half_extents_B || !p_batch.r_overlap));
+
+	_BoxBoxAxes axes;
+	for (uint32_t i = 0; i < p_batch.count; i++) {
+		const Transform3D &transform_A = p_batch.transforms_A[i];
+		const Transform3D &transform_B = p_batch.transforms_B[i];
+
+		axes.build(transform_A, transform_B);
+		axes.project(transform_A, p_batch.half_extents_A[i], transform_B, p_batch.half_extents_B[i]);
+		if (p_batch.margin_A != 0.0 || p_batch.margin_B != 0.0) {
+			axes.add_margins(p_batch.margin_A, p_batch.margin_B);
+		}
+
+		// Separation is checked for all the axes before picking the shallowest one, so the
+		// common case of separated pairs is resolved without any branching per axis.
+		bool separated = false;
+		for (int j = 0; j < _BoxBoxAxes::AXIS_COUNT; j++) {
+			const real_t half_A = (axes.max_A[j] - axes.min_A[j]) * 0.5;
+			const real_t center_A = (axes.min_A[j] + axes.max_A[j]) * 0.5;
+			separated |= axes.valid[j] & ((axes.min_B[j] - half_A - center_A > 0.0) | (axes.max_B[j] + half_A - center_A < 0.0));
+		}
+
+		real_t best_depth = 1e15;
+		Vector3 best_axis;
+		if (!separated) {
+			for (int j = 0; j < _BoxBoxAxes::AXIS_COUNT; j++) {
+				if (axes.valid[j]) {
+					_test_axis_range(axes.get_axis(j), axes.min_A[j], axes.max_A[j], axes.min_B[j], axes.max_B[j], best_depth, best_axis);
+				}
+			}
+		}
+
+		p_batch.r_overlap[i] = !separated;
+		if (p_batch.r_normals) {
+			p_batch.r_normals[i] = separated ? Vector3() : best_axis;
+		}
+		if (p_batch.r_depths) {
+			p_batch.r_depths[i] = separated ? 0.0 : best_depth;
+		}
+	}
+}
+
 bool sat_calculate_penetration(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, void *p_userdata, bool p_swap, Vector3 *r_prev_axis, real_t p_margin_a, real_t p_margin_b) {
 	PhysicsServer3D::ShapeType type_A = p_shape_A->get_type();
 
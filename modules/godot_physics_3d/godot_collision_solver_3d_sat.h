@@ -33,6 +33,24 @@
 
 #include "godot_collision_solver_3d.h"
 
+// Input and output arrays for sat_box_box_batch(), one entry per box pair.
+struct SATBoxBoxBatch {
+	uint32_t count = 0;
+	const Transform3D *transforms_A = nullptr;
+	const Vector3 *half_extents_A = nullptr;
+	const Transform3D *transforms_B = nullptr;
+	const Vector3 *half_extents_B = nullptr;
+	real_t margin_A = 0.0;
+	real_t margin_B = 0.0;
+
+	bool *r_overlap = nullptr;
+	Vector3 *r_normals = nullptr; // Optional, axis of least penetration as reported by sat_calculate_penetration().
+	real_t *r_depths = nullptr; // Optional.
+};
+
+// Tests the separating axes of many box pairs in a single call. No contacts are generated.
+void sat_box_box_batch(const SATBoxBoxBatch &p_batch);
+
 bool sat_calculate_penetration(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, void *p_userdata, bool p_swap = false, Vector3 *r_prev_axis = nullptr, real_t p_margin_a = 0, real_t p_margin_b = 0);
 
 #endif // GODOT_COLLISION_SOLVER_3D_SAT_H
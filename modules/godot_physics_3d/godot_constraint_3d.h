@@ -41,6 +41,9 @@ class GodotConstraint3D {
 	int priority;
 	bool disabled_collisions_between_bodies;
 
+	// Canonical solving order in deterministic mode, which doesn't depend on when the constraint was created.
+	uint64_t order_key[2];
+
 	RID self;
 
 protected:
@@ -50,12 +53,37 @@ protected:
 		island_step = 0;
 		priority = 1;
 		disabled_collisions_between_bodies = true;
+		order_key[0] = 0;
+		order_key[1] = 0;
 	}
 
 public:
-	_FORCE_INLINE_ void set_self(const RID &p_self) { self = p_self; }
+	// RID validators are allocated in increasing order, so they number objects by creation.
+	static _FORCE_INLINE_ uint32_t get_creation_index(const RID &p_rid) { return uint32_t(p_rid.get_id() >> 32); }
+
+	_FORCE_INLINE_ void set_self(const RID &p_self) {
+		self = p_self;
+		// Joints go before contacts, which always have a non-zero object in the high bits.
+		order_key[0] = get_creation_index(p_self);
+		order_key[1] = 0;
+	}
 	_FORCE_INLINE_ RID get_self() const { return self; }
 
+	// Pairs are ordered by the creation index of both objects, then by their shape indices.
+	_FORCE_INLINE_ void set_pair_order_key(const RID &p_object_A, int p_shape_A, const RID &p_object_B, int p_shape_B) {
+		order_key[0] = (uint64_t(get_creation_index(p_object_A)) << 32) | get_creation_index(p_object_B);
+		order_key[1] = (uint64_t(uint32_t(p_shape_A)) << 32) | uint32_t(p_shape_B);
+	}
+
+	struct OrderComparator {
+		_FORCE_INLINE_ bool operator()(const GodotConstraint3D *p_a, const GodotConstraint3D *p_b) const {
+			if (p_a->order_key[0] != p_b->order_key[0]) {
+				return p_a->order_key[0] < p_b->order_key[0];
+			}
+			return p_a->order_key[1] < p_b->order_key[1];
+		}
+	};
+
 	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
 	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
 
@@ -127,6 +127,15 @@ Variant GodotPhysicsServer3D::shape_get_data(RID p_shape) const {
 	return shape->get_data();
 };
 
+Vector<uint8_t> GodotPhysicsServer3D::shape_get_bvh_data(RID p_shape) const {
+	const GodotShape3D *shape = shape_owner.get_or_null(p_shape);
+	ERR_FAIL_NULL_V(shape, Vector<uint8_t>());
+	if (shape->get_type() != SHAPE_CONCAVE_POLYGON) {
+		return Vector<uint8_t>();
+	}
+	return static_cast<const GodotConcavePolygonShape3D *>(shape)->get_bvh_data();
+}
+
 void GodotPhysicsServer3D::shape_set_margin(RID p_shape, real_t p_margin) {
 }
 
@@ -214,6 +223,18 @@ int GodotPhysicsServer3D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+Vector<uint8_t> GodotPhysicsServer3D::space_save_state(RID p_space) const {
+	const GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, Vector<uint8_t>());
+	return space->save_state();
+}
+
+void GodotPhysicsServer3D::space_restore_state(RID p_space, const Vector<uint8_t> &p_state) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL(space);
+	space->restore_state(p_state);
+}
+
 RID GodotPhysicsServer3D::area_create() {
 	GodotArea3D *area = memnew(GodotArea3D);
 	RID rid = area_owner.make_rid(area);
@@ -95,6 +95,7 @@ public:
 
 	virtual ShapeType shape_get_type(RID p_shape) const override;
 	virtual Variant shape_get_data(RID p_shape) const override;
+	virtual Vector<uint8_t> shape_get_bvh_data(RID p_shape) const override;
 
 	virtual void shape_set_margin(RID p_shape, real_t p_margin) override;
 	virtual real_t shape_get_margin(RID p_shape) const override;
@@ -117,6 +118,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	virtual Vector<uint8_t> space_save_state(RID p_space) const override;
+	virtual void space_restore_state(RID p_space, const Vector<uint8_t> &p_state) override;
+
 	/* AREA API */
 
 	virtual RID area_create() override;
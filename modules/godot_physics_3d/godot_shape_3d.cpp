@@ -1345,15 +1345,33 @@ Vector3 GodotConcavePolygonShape3D::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
+void GodotConcavePolygonShape3D::_quantize(const AABB &p_aabb, uint16_t r_min[3], uint16_t r_max[3]) const {
+	Vector3 from = (p_aabb.position - bvh_origin) * bvh_inv_scale;
+	Vector3 to = (p_aabb.position + p_aabb.size - bvh_origin) * bvh_inv_scale;
+	for (int i = 0; i < 3; i++) {
+		r_min[i] = (uint16_t)CLAMP(Math::floor(from[i]), (real_t)0.0, (real_t)BVH_QUANTIZE_MAX);
+		r_max[i] = (uint16_t)CLAMP(Math::ceil(to[i]), (real_t)0.0, (real_t)BVH_QUANTIZE_MAX);
+	}
+}
+
+void GodotConcavePolygonShape3D::_set_bvh_bounds(const AABB &p_aabb) {
+	bvh_origin = p_aabb.position;
+	bvh_scale = p_aabb.size / (real_t)BVH_QUANTIZE_MAX;
+	for (int i = 0; i < 3; i++) {
+		bvh_inv_scale[i] = bvh_scale[i] > 0.0 ? 1.0 / bvh_scale[i] : 0.0;
+	}
+}
+
 void GodotConcavePolygonShape3D::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
+	const BVHNode *params_bvh = &p_params->bvh[p_idx];
 
-	if (!params_bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
+	if (!_get_bvh_node_aabb(*params_bvh).intersects_segment(p_params->from, p_params->to)) {
 		return;
 	}
 
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
+	if (params_bvh->right_or_face < 0) {
+		int face_index = -1 - params_bvh->right_or_face;
+		const Face *f = &p_params->faces[face_index];
 		GodotFaceShape3D *face = p_params->face;
 		face->normal = f->normal;
 		face->vertex[0] = p_params->vertices[f->indices[0]];
@@ -1362,7 +1380,6 @@ void GodotConcavePolygonShape3D::_cull_segment(int p_idx, _SegmentCullParams *p_
 
 		Vector3 res;
 		Vector3 normal;
-		int face_index = params_bvh->face_index;
 		if (face->intersect_segment(p_params->from, p_params->to, res, normal, face_index, true)) {
 			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
 			if ((d > 0) && (d < p_params->min_d)) {
@@ -1374,12 +1391,8 @@ void GodotConcavePolygonShape3D::_cull_segment(int p_idx, _SegmentCullParams *p_
 			}
 		}
 	} else {
-		if (params_bvh->left >= 0) {
-			_cull_segment(params_bvh->left, p_params);
-		}
-		if (params_bvh->right >= 0) {
-			_cull_segment(params_bvh->right, p_params);
-		}
+		_cull_segment(p_idx + 1, p_params);
+		_cull_segment(params_bvh->right_or_face, p_params);
 	}
 }
 
@@ -1391,7 +1404,7 @@ bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const
 	// unlock data
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
+	const BVHNode *br = _get_bvh_nodes();
 
 	GodotFaceShape3D face;
 	face.backface_collision = backface_collision && p_hit_back_faces;
@@ -1429,14 +1442,17 @@ Vector3 GodotConcavePolygonShape3D::get_closest_point_to(const Vector3 &p_point)
 }
 
 bool GodotConcavePolygonShape3D::_cull(int p_idx, _CullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
+	const BVHNode *params_bvh = &p_params->bvh[p_idx];
 
-	if (!p_params->aabb.intersects(params_bvh->aabb)) {
-		return false;
+	// Both boxes are quantized outwards, so comparing them is conservative.
+	for (int i = 0; i < 3; i++) {
+		if (params_bvh->min[i] > p_params->max[i] || params_bvh->max[i] < p_params->min[i]) {
+			return false;
+		}
 	}
 
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
+	if (params_bvh->right_or_face < 0) {
+		const Face *f = &p_params->faces[-1 - params_bvh->right_or_face];
 		GodotFaceShape3D *face = p_params->face;
 		face->normal = f->normal;
 		face->vertex[0] = p_params->vertices[f->indices[0]];
@@ -1446,16 +1462,12 @@ bool GodotConcavePolygonShape3D::_cull(int p_idx, _CullParams *p_params) const {
 			return true;
 		}
 	} else {
-		if (params_bvh->left >= 0) {
-			if (_cull(params_bvh->left, p_params)) {
-				return true;
-			}
+		if (_cull(p_idx + 1, p_params)) {
+			return true;
 		}
 
-		if (params_bvh->right >= 0) {
-			if (_cull(params_bvh->right, p_params)) {
-				return true;
-			}
+		if (_cull(params_bvh->right_or_face, p_params)) {
+			return true;
 		}
 	}
 
@@ -1469,11 +1481,14 @@ void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_
 	}
 
 	AABB local_aabb = p_local_aabb;
+	if (!local_aabb.intersects(get_aabb())) {
+		return;
+	}
 
 	// unlock data
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
+	const BVHNode *br = _get_bvh_nodes();
 
 	GodotFaceShape3D face; // use this to send in the callback
 	face.backface_collision = backface_collision;
@@ -1481,6 +1496,7 @@ void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_
 
 	_CullParams params;
 	params.aabb = local_aabb;
+	_quantize(local_aabb, params.min, params.max);
 	params.face = &face;
 	params.faces = fr;
 	params.vertices = vr;
@@ -1583,35 +1599,70 @@ _Volume_BVH *_volume_build_bvh(_Volume_BVH_Element *p_elements, int p_size, int
 	return bvh;
 }
 
-void GodotConcavePolygonShape3D::_fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
+void GodotConcavePolygonShape3D::_fill_bvh(_Volume_BVH *p_bvh_tree, BVHNode *p_bvh_array, int &p_idx) {
 	int idx = p_idx;
 
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
+	_quantize(p_bvh_tree->aabb, p_bvh_array[idx].min, p_bvh_array[idx].max);
 
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
+	if (p_bvh_tree->face_index >= 0) {
+		// Leaf.
+		p_bvh_array[idx].right_or_face = -1 - p_bvh_tree->face_index;
+	} else {
+		// Branches always have both children, the left one is stored right after this node.
+		++p_idx;
 		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
 
-	} else {
-		p_bvh_array[p_idx].left = -1;
+		p_bvh_array[idx].right_or_face = ++p_idx;
+		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
 	}
 
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
+	memdelete(p_bvh_tree);
+}
 
-	} else {
-		p_bvh_array[p_idx].right = -1;
+bool GodotConcavePolygonShape3D::_load_bvh(const Vector<uint8_t> &p_bvh_data, uint32_t p_face_count, uint32_t p_face_hash) {
+	if (p_bvh_data.size() < (int64_t)sizeof(BVHHeader)) {
+		return false;
 	}
 
-	memdelete(p_bvh_tree);
+	const BVHHeader *header = reinterpret_cast<const BVHHeader *>(p_bvh_data.ptr());
+	if (header->magic != BVH_MAGIC || header->version != BVH_VERSION) {
+		// Also rejects data saved with a different byte order.
+		return false;
+	}
+	if (header->face_count != p_face_count || header->face_hash != p_face_hash) {
+		// Built for other faces.
+		return false;
+	}
+	uint32_t node_count = header->node_count;
+	if (node_count != p_face_count * 2 - 1 || (uint64_t)p_bvh_data.size() != sizeof(BVHHeader) + (uint64_t)node_count * sizeof(BVHNode)) {
+		return false;
+	}
+
+	// Child indices must point forward and faces must exist, so traversal can't run away on corrupt data.
+	const BVHNode *nodes = reinterpret_cast<const BVHNode *>(p_bvh_data.ptr() + sizeof(BVHHeader));
+	for (uint32_t i = 0; i < node_count; i++) {
+		int32_t right_or_face = nodes[i].right_or_face;
+		if (right_or_face < 0) {
+			if ((uint32_t)(-1 - right_or_face) >= p_face_count) {
+				return false;
+			}
+		} else if ((uint32_t)right_or_face <= i + 1 || (uint32_t)right_or_face >= node_count) {
+			return false;
+		}
+	}
+
+	bvh_data = p_bvh_data;
+	_set_bvh_bounds(AABB(Vector3(header->aabb_position[0], header->aabb_position[1], header->aabb_position[2]), Vector3(header->aabb_size[0], header->aabb_size[1], header->aabb_size[2])));
+
+	return true;
 }
 
-void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_backface_collision) {
+void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_backface_collision, const Vector<uint8_t> &p_bvh_data) {
 	int src_face_count = p_faces.size();
 	if (src_face_count == 0) {
+		faces.clear();
+		vertices.clear();
+		bvh_data.clear();
 		configure(AABB());
 		return;
 	}
@@ -1620,8 +1671,14 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 
 	const Vector3 *facesr = p_faces.ptr();
 
+	// With a valid saved BVH, the elements to build one are not needed.
+	const uint32_t face_hash = hash_murmur3_buffer(facesr, p_faces.size() * sizeof(Vector3));
+	const bool bvh_loaded = _load_bvh(p_bvh_data, src_face_count, face_hash);
+
 	Vector<_Volume_BVH_Element> bvh_array;
-	bvh_array.resize(src_face_count);
+	if (!bvh_loaded) {
+		bvh_array.resize(src_face_count);
+	}
 
 	_Volume_BVH_Element *bvh_arrayw = bvh_array.ptrw();
 
@@ -1637,9 +1694,12 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 	for (int i = 0; i < src_face_count; i++) {
 		Face3 face(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]);
 
-		bvh_arrayw[i].aabb = face.get_aabb();
-		bvh_arrayw[i].center = bvh_arrayw[i].aabb.get_center();
-		bvh_arrayw[i].face_index = i;
+		const AABB face_aabb = face.get_aabb();
+		if (!bvh_loaded) {
+			bvh_arrayw[i].aabb = face_aabb;
+			bvh_arrayw[i].center = face_aabb.get_center();
+			bvh_arrayw[i].face_index = i;
+		}
 		facesw[i].indices[0] = i * 3 + 0;
 		facesw[i].indices[1] = i * 3 + 1;
 		facesw[i].indices[2] = i * 3 + 2;
@@ -1648,23 +1708,46 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 		verticesw[i * 3 + 1] = face.vertex[1];
 		verticesw[i * 3 + 2] = face.vertex[2];
 		if (i == 0) {
-			_aabb = bvh_arrayw[i].aabb;
+			_aabb = face_aabb;
 		} else {
-			_aabb.merge_with(bvh_arrayw[i].aabb);
+			_aabb.merge_with(face_aabb);
 		}
 	}
 
-	int count = 0;
-	_Volume_BVH *bvh_tree = _volume_build_bvh(bvh_arrayw, src_face_count, count);
+	backface_collision = p_backface_collision;
 
-	bvh.resize(count + 1);
+	if (!bvh_loaded) {
+		int count = 0;
+		_Volume_BVH *bvh_tree = _volume_build_bvh(bvh_arrayw, src_face_count, count);
 
-	BVH *bvh_arrayw2 = bvh.ptrw();
+		BVHHeader header;
+		header.face_count = src_face_count;
+		header.node_count = count;
+		header.face_hash = face_hash;
+		for (int i = 0; i < 3; i++) {
+			// Round outwards, so the stored bounds still enclose all faces with double precision.
+			real_t end = _aabb.position[i] + _aabb.size[i];
+			float position = (float)_aabb.position[i];
+			if ((real_t)position > _aabb.position[i]) {
+				position = nextafterf(position, -INFINITY);
+			}
+			float size = (float)(end - position);
+			if ((real_t)position + (real_t)size < end) {
+				size = nextafterf(size, INFINITY);
+			}
+			header.aabb_position[i] = position;
+			header.aabb_size[i] = size;
+		}
+		// Use the bounds as they will be read back, so quantization matches on load.
+		_set_bvh_bounds(AABB(Vector3(header.aabb_position[0], header.aabb_position[1], header.aabb_position[2]), Vector3(header.aabb_size[0], header.aabb_size[1], header.aabb_size[2])));
 
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+		bvh_data.resize(sizeof(BVHHeader) + count * sizeof(BVHNode));
+		uint8_t *bvh_dataw = bvh_data.ptrw();
+		memcpy(bvh_dataw, &header, sizeof(BVHHeader));
 
-	backface_collision = p_backface_collision;
+		int idx = 0;
+		_fill_bvh(bvh_tree, reinterpret_cast<BVHNode *>(bvh_dataw + sizeof(BVHHeader)), idx);
+	}
 
 	configure(_aabb); // this type of shape has no margin
 }
@@ -1673,13 +1756,15 @@ void GodotConcavePolygonShape3D::set_data(const Variant &p_data) {
 	Dictionary d = p_data;
 	ERR_FAIL_COND(!d.has("faces"));
 
-	_setup(d["faces"], d["backface_collision"]);
+	// Without a BVH from the resource, try the current one, it's still valid if only the flags changed.
+	_setup(d["faces"], d["backface_collision"], d.get("bvh", bvh_data));
 }
 
 Variant GodotConcavePolygonShape3D::get_data() const {
 	Dictionary d;
 	d["faces"] = get_faces();
 	d["backface_collision"] = backface_collision;
+	d["bvh"] = bvh_data;
 
 	return d;
 }
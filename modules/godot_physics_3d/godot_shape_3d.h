@@ -316,23 +316,47 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 	Vector<Face> faces;
 	Vector<Vector3> vertices;
 
-	struct BVH {
-		AABB aabb;
-		int left = 0;
-		int right = 0;
+	// The BVH is kept in a single flat buffer (a header followed by the nodes), so it can be
+	// returned by get_data(), saved along with the shape resource and reused as-is on load.
+	enum {
+		BVH_MAGIC = 0x48564243, // "CBVH"
+		BVH_VERSION = 1,
+		BVH_QUANTIZE_MAX = 0xFFFF,
+	};
+
+	struct BVHHeader {
+		uint32_t magic = BVH_MAGIC;
+		uint32_t version = BVH_VERSION;
+		uint32_t face_count = 0;
+		uint32_t node_count = 0;
+		uint32_t face_hash = 0;
+		float aabb_position[3] = {};
+		float aabb_size[3] = {};
+		uint32_t padding = 0;
+	};
 
-		int face_index = 0;
+	// Bounds are quantized to 16 bits relative to the shape AABB, rounded outwards.
+	// Nodes are stored depth-first, so the left child of an internal node always follows it.
+	struct BVHNode {
+		uint16_t min[3] = {};
+		uint16_t max[3] = {};
+		int32_t right_or_face = 0; // Right child index, or -1 - face index for leaves.
 	};
 
-	Vector<BVH> bvh;
+	Vector<uint8_t> bvh_data;
+	Vector3 bvh_origin;
+	Vector3 bvh_scale;
+	Vector3 bvh_inv_scale;
 
 	struct _CullParams {
 		AABB aabb;
+		uint16_t min[3] = {};
+		uint16_t max[3] = {};
 		QueryCallback callback = nullptr;
 		void *userdata = nullptr;
 		const Face *faces = nullptr;
 		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
+		const BVHNode *bvh = nullptr;
 		GodotFaceShape3D *face = nullptr;
 	};
 
@@ -342,7 +366,7 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 		Vector3 dir;
 		const Face *faces = nullptr;
 		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
+		const BVHNode *bvh = nullptr;
 		GodotFaceShape3D *face = nullptr;
 
 		Vector3 result;
@@ -357,12 +381,23 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
 	bool _cull(int p_idx, _CullParams *p_params) const;
 
-	void _fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
+	_FORCE_INLINE_ const BVHNode *_get_bvh_nodes() const { return reinterpret_cast<const BVHNode *>(bvh_data.ptr() + sizeof(BVHHeader)); }
+	_FORCE_INLINE_ AABB _get_bvh_node_aabb(const BVHNode &p_node) const {
+		Vector3 from(p_node.min[0], p_node.min[1], p_node.min[2]);
+		Vector3 to(p_node.max[0], p_node.max[1], p_node.max[2]);
+		return AABB(bvh_origin + from * bvh_scale, (to - from) * bvh_scale);
+	}
+	void _quantize(const AABB &p_aabb, uint16_t r_min[3], uint16_t r_max[3]) const;
+	void _set_bvh_bounds(const AABB &p_aabb);
+
+	void _fill_bvh(_Volume_BVH *p_bvh_tree, BVHNode *p_bvh_array, int &p_idx);
+	bool _load_bvh(const Vector<uint8_t> &p_bvh_data, uint32_t p_face_count, uint32_t p_face_hash);
 
-	void _setup(const Vector<Vector3> &p_faces, bool p_backface_collision);
+	void _setup(const Vector<Vector3> &p_faces, bool p_backface_collision, const Vector<uint8_t> &p_bvh_data = Vector<uint8_t>());
 
 public:
 	Vector<Vector3> get_faces() const;
+	const Vector<uint8_t> &get_bvh_data() const { return bvh_data; }
 
 	virtual PhysicsServer3D::ShapeType get_type() const override { return PhysicsServer3D::SHAPE_CONCAVE_POLYGON; }
 
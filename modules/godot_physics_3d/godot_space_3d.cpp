@@ -34,6 +34,7 @@
 #include "godot_physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
@@ -105,16 +106,14 @@ int GodotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+bool GodotPhysicsDirectSpaceState3D::_intersect_ray(const RayParameters &p_parameters, RayResult &r_result, GodotCollisionObject3D **r_cull_results, int *r_cull_subindex_results) const {
 	Vector3 begin, end;
 	Vector3 normal;
 	begin = p_parameters.from;
 	end = p_parameters.to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_segment(begin, end, r_cull_results, GodotSpace3D::INTERSECTION_QUERY_MAX, r_cull_subindex_results);
 
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
@@ -126,21 +125,21 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	real_t min_d = 1e10;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
+		if (p_parameters.pick_ray && !(r_cull_results[i]->is_ray_pickable())) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_cull_results[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject3D *col_obj = r_cull_results[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = r_cull_subindex_results[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -205,6 +204,55 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
+bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
+
+	return _intersect_ray(p_parameters, r_result, space->intersection_query_results, space->intersection_query_subindex_results);
+}
+
+void GodotPhysicsDirectSpaceState3D::_intersect_ray_batch_chunk(uint32_t p_chunk, RayBatch *p_batch) {
+	// Each chunk has its own cull buffers, the ones of the space are only used by single queries.
+	LocalVector<GodotCollisionObject3D *> cull_results;
+	cull_results.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+	LocalVector<int> cull_subindex_results;
+	cull_subindex_results.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+
+	RayParameters parameters = *p_batch->parameters;
+	int from = p_chunk * RAY_BATCH_CHUNK_SIZE;
+	int to = MIN(from + RAY_BATCH_CHUNK_SIZE, p_batch->count);
+	for (int i = from; i < to; i++) {
+		parameters.from = p_batch->from[i];
+		parameters.to = p_batch->to[i];
+		p_batch->hits[i] = _intersect_ray(parameters, p_batch->results[i], cull_results.ptr(), cull_subindex_results.ptr());
+	}
+}
+
+void GodotPhysicsDirectSpaceState3D::intersect_ray_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	ERR_FAIL_COND(space->locked);
+
+	if (p_count <= 0) {
+		return;
+	}
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.results = r_results;
+	batch.hits = r_hits;
+	batch.count = p_count;
+
+	// The space can't be stepped or modified until all the rays are done, the broadphase is thread safe for culling.
+	uint32_t chunk_count = (p_count + RAY_BATCH_CHUNK_SIZE - 1) / RAY_BATCH_CHUNK_SIZE;
+	if (chunk_count == 1) {
+		_intersect_ray_batch_chunk(0, &batch);
+		return;
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState3D::_intersect_ray_batch_chunk, &batch, chunk_count, -1, true, SNAME("IntersectRayBatch"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
 int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
 	if (p_result_max <= 0) {
 		return 0;
@@ -1039,36 +1087,58 @@ void *GodotSpace3D::_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A
 
 	GodotSpace3D *self = static_cast<GodotSpace3D *>(p_self);
 
+	if (self->deterministic) {
+		_sort_pair(A, p_subindex_A, B, p_subindex_B);
+	}
+
 	self->collision_pairs++;
 
+	GodotConstraint3D *constraint = nullptr;
+
 	if (type_A == GodotCollisionObject3D::TYPE_AREA) {
 		GodotArea3D *area = static_cast<GodotArea3D *>(A);
 		if (type_B == GodotCollisionObject3D::TYPE_AREA) {
 			GodotArea3D *area_b = static_cast<GodotArea3D *>(B);
-			GodotArea2Pair3D *area2_pair = memnew(GodotArea2Pair3D(area_b, p_subindex_B, area, p_subindex_A));
-			return area2_pair;
+			constraint = memnew(GodotArea2Pair3D(area_b, p_subindex_B, area, p_subindex_A));
 		} else if (type_B == GodotCollisionObject3D::TYPE_SOFT_BODY) {
 			GodotSoftBody3D *softbody = static_cast<GodotSoftBody3D *>(B);
-			GodotAreaSoftBodyPair3D *soft_area_pair = memnew(GodotAreaSoftBodyPair3D(softbody, p_subindex_B, area, p_subindex_A));
-			return soft_area_pair;
+			constraint = memnew(GodotAreaSoftBodyPair3D(softbody, p_subindex_B, area, p_subindex_A));
 		} else {
 			GodotBody3D *body = static_cast<GodotBody3D *>(B);
-			GodotAreaPair3D *area_pair = memnew(GodotAreaPair3D(body, p_subindex_B, area, p_subindex_A));
-			return area_pair;
+			constraint = memnew(GodotAreaPair3D(body, p_subindex_B, area, p_subindex_A));
 		}
 	} else if (type_A == GodotCollisionObject3D::TYPE_BODY) {
 		if (type_B == GodotCollisionObject3D::TYPE_SOFT_BODY) {
-			GodotBodySoftBodyPair3D *soft_pair = memnew(GodotBodySoftBodyPair3D(static_cast<GodotBody3D *>(A), p_subindex_A, static_cast<GodotSoftBody3D *>(B)));
-			return soft_pair;
+			constraint = memnew(GodotBodySoftBodyPair3D(static_cast<GodotBody3D *>(A), p_subindex_A, static_cast<GodotSoftBody3D *>(B)));
 		} else {
 			GodotBodyPair3D *b = memnew(GodotBodyPair3D(static_cast<GodotBody3D *>(A), p_subindex_A, static_cast<GodotBody3D *>(B), p_subindex_B));
-			return b;
+			self->body_pairs.insert(b);
+
+			ContactCacheKey key = { A->get_self(), B->get_self(), p_subindex_A, p_subindex_B };
+			HashMap<ContactCacheKey, GodotBodyPair3D::SnapshotState, ContactCacheKey>::Iterator P = self->pending_pair_states.find(key);
+			if (P) {
+				// The pair existed in a restored snapshot.
+				b->restore_snapshot_state(P->value);
+				self->pending_pair_states.remove(P);
+			} else if (!self->contact_cache.is_empty()) {
+				HashMap<ContactCacheKey, CachedPair, ContactCacheKey>::Iterator E = self->contact_cache.find(key);
+				if (E) {
+					b->load_contact_cache(E->value.contacts);
+					self->contact_cache.remove(E);
+				}
+			}
+
+			constraint = b;
 		}
 	} else {
 		// Soft Body/Soft Body, not supported.
 	}
 
-	return nullptr;
+	if (constraint) {
+		constraint->set_pair_order_key(A->get_self(), p_subindex_A, B->get_self(), p_subindex_B);
+	}
+
+	return constraint;
 }
 
 void GodotSpace3D::_broadphase_unpair(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_data, void *p_self) {
@@ -1078,6 +1148,22 @@ void GodotSpace3D::_broadphase_unpair(GodotCollisionObject3D *A, int p_subindex_
 
 	GodotSpace3D *self = static_cast<GodotSpace3D *>(p_self);
 	self->collision_pairs--;
+
+	if (A->get_type() == GodotCollisionObject3D::TYPE_BODY && B->get_type() == GodotCollisionObject3D::TYPE_BODY) {
+		GodotBodyPair3D *pair = static_cast<GodotBodyPair3D *>(p_data);
+		self->body_pairs.erase(pair);
+		self->pending_new_pairs.erase(pair);
+
+		if (self->contact_cache_steps > 0) {
+			CachedPair cached;
+			pair->store_contact_cache(cached.contacts);
+			if (cached.contacts.count > 0) {
+				cached.step = self->step_count;
+				self->contact_cache.insert(_get_pair_key(pair), cached);
+			}
+		}
+	}
+
 	GodotConstraint3D *c = static_cast<GodotConstraint3D *>(p_data);
 	memdelete(c);
 }
@@ -1176,6 +1262,20 @@ void GodotSpace3D::call_queries() {
 
 void GodotSpace3D::setup() {
 	contact_debug_count = 0;
+
+	step_count++;
+	if (!contact_cache.is_empty()) {
+		LocalVector<ContactCacheKey> expired;
+		for (const KeyValue<ContactCacheKey, CachedPair> &E : contact_cache) {
+			if (step_count - E.value.step > (uint64_t)contact_cache_steps) {
+				expired.push_back(E.key);
+			}
+		}
+		for (const ContactCacheKey &key : expired) {
+			contact_cache.erase(key);
+		}
+	}
+
 	while (mass_properties_update_list.first()) {
 		mass_properties_update_list.first()->self()->update_mass_properties();
 		mass_properties_update_list.remove(mass_properties_update_list.first());
@@ -1184,6 +1284,175 @@ void GodotSpace3D::setup() {
 
 void GodotSpace3D::update() {
 	broadphase->update();
+
+	if (!pending_new_pairs.is_empty() || !pending_pair_states.is_empty()) {
+		_finish_restore_state();
+	}
+}
+
+void GodotSpace3D::_finish_restore_state() {
+	// Pairs that still exist would have been created by this update, with their contacts from the cache.
+	for (GodotBodyPair3D *pair : pending_new_pairs) {
+		HashMap<ContactCacheKey, CachedPair, ContactCacheKey>::Iterator E = contact_cache.find(_get_pair_key(pair));
+		if (E) {
+			pair->load_contact_cache(E->value.contacts);
+			contact_cache.remove(E);
+		}
+	}
+	pending_new_pairs.clear();
+
+	// Pairs that weren't paired again would have been removed by this update.
+	if (contact_cache_steps > 0) {
+		for (const KeyValue<ContactCacheKey, GodotBodyPair3D::SnapshotState> &E : pending_pair_states) {
+			CachedPair cached;
+			GodotBodyPair3D::store_snapshot_contact_cache(E.value, step_count, cached.contacts);
+			if (cached.contacts.count > 0) {
+				cached.step = step_count;
+				contact_cache.insert(E.key, cached);
+			}
+		}
+	}
+	pending_pair_states.clear();
+}
+
+Vector<uint8_t> GodotSpace3D::save_state() const {
+	SnapshotHeader header;
+	header.step_count = step_count;
+
+	LocalVector<const GodotBody3D *> bodies;
+	for (const GodotCollisionObject3D *object : objects) {
+		if (_is_snapshot_body(object)) {
+			bodies.push_back(static_cast<const GodotBody3D *>(object));
+		}
+	}
+	header.body_count = bodies.size();
+
+	// Pairs waiting for the next update to be completed are saved as they will be.
+	header.pair_count = body_pairs.size() - pending_new_pairs.size() + pending_pair_states.size();
+	header.cached_pair_count = contact_cache.size();
+
+	Vector<uint8_t> state;
+	state.resize(sizeof(SnapshotHeader) + header.body_count * sizeof(SnapshotBody) + header.pair_count * sizeof(SnapshotPair) + header.cached_pair_count * sizeof(SnapshotCachedPair));
+	uint8_t *w = state.ptrw();
+	// Structs are filled member by member, zeroing first keeps their padding from leaking memory contents into the snapshot.
+	memset(w, 0, state.size());
+	memcpy(w, &header, sizeof(SnapshotHeader));
+	w += sizeof(SnapshotHeader);
+
+	SnapshotBody *snapshot_bodies = reinterpret_cast<SnapshotBody *>(w);
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+		snapshot_bodies[i].body = bodies[i]->get_self().get_id();
+		bodies[i]->save_snapshot_state(snapshot_bodies[i].state);
+	}
+	w += header.body_count * sizeof(SnapshotBody);
+
+	SnapshotPair *snapshot_pairs = reinterpret_cast<SnapshotPair *>(w);
+	uint32_t pair_index = 0;
+	for (const GodotBodyPair3D *pair : body_pairs) {
+		if (pending_new_pairs.has(const_cast<GodotBodyPair3D *>(pair))) {
+			continue;
+		}
+		SnapshotPair &snapshot_pair = snapshot_pairs[pair_index++];
+		snapshot_pair.key = { pair->get_body_A()->get_self().get_id(), pair->get_body_B()->get_self().get_id(), pair->get_shape_A(), pair->get_shape_B() };
+		pair->save_snapshot_state(snapshot_pair.state);
+	}
+	for (const KeyValue<ContactCacheKey, GodotBodyPair3D::SnapshotState> &E : pending_pair_states) {
+		SnapshotPair &snapshot_pair = snapshot_pairs[pair_index++];
+		snapshot_pair.key = { E.key.body_A.get_id(), E.key.body_B.get_id(), E.key.shape_A, E.key.shape_B };
+		GodotBodyPair3D::copy_snapshot_state(E.value, snapshot_pair.state);
+	}
+	w += header.pair_count * sizeof(SnapshotPair);
+
+	SnapshotCachedPair *snapshot_cached_pairs = reinterpret_cast<SnapshotCachedPair *>(w);
+	uint32_t cached_pair_index = 0;
+	for (const KeyValue<ContactCacheKey, CachedPair> &E : contact_cache) {
+		SnapshotCachedPair &snapshot_cached_pair = snapshot_cached_pairs[cached_pair_index++];
+		snapshot_cached_pair.key = { E.key.body_A.get_id(), E.key.body_B.get_id(), E.key.shape_A, E.key.shape_B };
+		GodotBodyPair3D::copy_contact_cache(E.value.contacts, snapshot_cached_pair.cached.contacts);
+		snapshot_cached_pair.cached.step = E.value.step;
+	}
+
+	return state;
+}
+
+bool GodotSpace3D::restore_state(const Vector<uint8_t> &p_state) {
+	ERR_FAIL_COND_V_MSG(locked, false, "Can't restore the state of a space while it's being stepped.");
+	ERR_FAIL_COND_V(p_state.size() < (int64_t)sizeof(SnapshotHeader), false);
+
+	const uint8_t *r = p_state.ptr();
+	SnapshotHeader header;
+	memcpy(&header, r, sizeof(SnapshotHeader));
+	ERR_FAIL_COND_V_MSG(header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.real_size != sizeof(real_t), false, "Invalid space state, or saved by an incompatible build.");
+	ERR_FAIL_COND_V((uint64_t)p_state.size() != sizeof(SnapshotHeader) + (uint64_t)header.body_count * sizeof(SnapshotBody) + (uint64_t)header.pair_count * sizeof(SnapshotPair) + (uint64_t)header.cached_pair_count * sizeof(SnapshotCachedPair), false);
+	r += sizeof(SnapshotHeader);
+
+	// Bodies are usually saved in the same order as they are stored, only look them up when that's not the case.
+	const SnapshotBody *snapshot_bodies = reinterpret_cast<const SnapshotBody *>(r);
+	HashMap<uint64_t, GodotBody3D *> body_map;
+	uint32_t body_index = 0;
+	for (GodotCollisionObject3D *object : objects) {
+		if (!_is_snapshot_body(object)) {
+			continue;
+		}
+		if (body_index == header.body_count || object->get_self().get_id() != snapshot_bodies[body_index].body) {
+			break;
+		}
+		static_cast<GodotBody3D *>(object)->restore_snapshot_state(snapshot_bodies[body_index].state);
+		body_index++;
+	}
+	if (body_index < header.body_count) {
+		for (GodotCollisionObject3D *object : objects) {
+			if (object->get_type() == GodotCollisionObject3D::TYPE_BODY) {
+				body_map.insert(object->get_self().get_id(), static_cast<GodotBody3D *>(object));
+			}
+		}
+		uint32_t missing_count = 0;
+		for (; body_index < header.body_count; body_index++) {
+			HashMap<uint64_t, GodotBody3D *>::Iterator E = body_map.find(snapshot_bodies[body_index].body);
+			if (E) {
+				E->value->restore_snapshot_state(snapshot_bodies[body_index].state);
+			} else {
+				missing_count++;
+			}
+		}
+		if (missing_count > 0) {
+			WARN_PRINT(vformat("%d bodies of the restored space state are no longer in the space.", missing_count));
+		}
+	}
+	r += header.body_count * sizeof(SnapshotBody);
+
+	step_count = header.step_count;
+
+	// Saved pairs that the broadphase still has are restored right away, the others when they are paired again.
+	pending_pair_states.clear();
+	pending_new_pairs.clear();
+	const SnapshotPair *snapshot_pairs = reinterpret_cast<const SnapshotPair *>(r);
+	for (uint32_t i = 0; i < header.pair_count; i++) {
+		const SnapshotPairKey &key = snapshot_pairs[i].key;
+		pending_pair_states.insert({ RID::from_uint64(key.body_A), RID::from_uint64(key.body_B), key.shape_A, key.shape_B }, snapshot_pairs[i].state);
+	}
+	r += header.pair_count * sizeof(SnapshotPair);
+
+	const GodotBodyPair3D::SnapshotState new_pair_state;
+	for (GodotBodyPair3D *pair : body_pairs) {
+		HashMap<ContactCacheKey, GodotBodyPair3D::SnapshotState, ContactCacheKey>::Iterator P = pending_pair_states.find(_get_pair_key(pair));
+		if (P) {
+			pair->restore_snapshot_state(P->value);
+			pending_pair_states.remove(P);
+		} else {
+			pair->restore_snapshot_state(new_pair_state);
+			pending_new_pairs.insert(pair);
+		}
+	}
+
+	contact_cache.clear();
+	const SnapshotCachedPair *snapshot_cached_pairs = reinterpret_cast<const SnapshotCachedPair *>(r);
+	for (uint32_t i = 0; i < header.cached_pair_count; i++) {
+		const SnapshotPairKey &key = snapshot_cached_pairs[i].key;
+		contact_cache.insert({ RID::from_uint64(key.body_A), RID::from_uint64(key.body_B), key.shape_A, key.shape_B }, snapshot_cached_pairs[i].cached);
+	}
+
+	return true;
 }
 
 void GodotSpace3D::set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_value) {
@@ -1258,6 +1527,14 @@ GodotSpace3D::GodotSpace3D() {
 	body_angular_velocity_sleep_threshold = GLOBAL_GET("physics/3d/sleep_threshold_angular");
 	body_time_to_sleep = GLOBAL_GET("physics/3d/time_before_sleep");
 	solver_iterations = GLOBAL_GET("physics/3d/solver/solver_iterations");
+	solver_max_threads = GLOBAL_GET("physics/3d/solver/max_threads");
+	if (solver_max_threads <= 0) {
+		// Worker thread pool group tasks never finish with no threads, anything that isn't a thread count means all of them.
+		solver_max_threads = -1;
+	}
+	island_split_threshold = GLOBAL_GET("physics/3d/solver/island_split_threshold");
+	contact_cache_steps = GLOBAL_GET("physics/3d/solver/contact_cache_steps");
+	deterministic = GLOBAL_GET("physics/3d/solver/deterministic");
 	contact_recycle_radius = GLOBAL_GET("physics/3d/solver/contact_recycle_radius");
 	contact_max_separation = GLOBAL_GET("physics/3d/solver/contact_max_separation");
 	contact_max_allowed_penetration = GLOBAL_GET("physics/3d/solver/contact_max_allowed_penetration");
@@ -46,11 +46,28 @@
 class GodotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	GDCLASS(GodotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	enum {
+		RAY_BATCH_CHUNK_SIZE = 64
+	};
+
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector3 *from = nullptr;
+		const Vector3 *to = nullptr;
+		RayResult *results = nullptr;
+		bool *hits = nullptr;
+		int count = 0;
+	};
+
+	bool _intersect_ray(const RayParameters &p_parameters, RayResult &r_result, GodotCollisionObject3D **r_cull_results, int *r_cull_subindex_results) const;
+	void _intersect_ray_batch_chunk(uint32_t p_chunk, RayBatch *p_batch);
+
 public:
 	GodotSpace3D *space = nullptr;
 
 	virtual int intersect_point(const PointParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
+	virtual void intersect_ray_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info = nullptr) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) override;
@@ -89,11 +106,104 @@ private:
 	static void *_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_self);
 	static void _broadphase_unpair(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_data, void *p_self);
 
+	// Puts two objects of the same type in creation order, instead of the order the broadphase found them in.
+	static _FORCE_INLINE_ void _sort_pair(GodotCollisionObject3D *&r_A, int &r_subindex_A, GodotCollisionObject3D *&r_B, int &r_subindex_B) {
+		if (r_A->get_type() == r_B->get_type() && GodotConstraint3D::get_creation_index(r_A->get_self()) > GodotConstraint3D::get_creation_index(r_B->get_self())) {
+			SWAP(r_A, r_B);
+			SWAP(r_subindex_A, r_subindex_B);
+		}
+	}
+
 	HashSet<GodotCollisionObject3D *> objects;
 
+	// Contacts of body pairs removed by the broadphase, so that pairs separating for a few steps keep warm starting the solver.
+	struct ContactCacheKey {
+		RID body_A;
+		RID body_B;
+		int shape_A = 0;
+		int shape_B = 0;
+
+		static uint32_t hash(const ContactCacheKey &p_key) {
+			uint32_t h = hash_murmur3_one_64(p_key.body_A.get_id());
+			h = hash_murmur3_one_64(p_key.body_B.get_id(), h);
+			h = hash_murmur3_one_32(p_key.shape_A, h);
+			h = hash_murmur3_one_32(p_key.shape_B, h);
+			return hash_fmix32(h);
+		}
+
+		bool operator==(const ContactCacheKey &p_key) const {
+			return body_A == p_key.body_A && body_B == p_key.body_B && shape_A == p_key.shape_A && shape_B == p_key.shape_B;
+		}
+	};
+
+	struct CachedPair {
+		GodotBodyPair3D::ContactCache contacts;
+		uint64_t step = 0;
+	};
+
+	HashMap<ContactCacheKey, CachedPair, ContactCacheKey> contact_cache;
+	uint64_t step_count = 0;
+
+	// Snapshots, see save_state() and restore_state().
+	enum {
+		SNAPSHOT_MAGIC = 0x33535350, // "PSS3"
+		SNAPSHOT_VERSION = 1,
+	};
+
+	struct SnapshotHeader {
+		uint32_t magic = SNAPSHOT_MAGIC;
+		uint32_t version = SNAPSHOT_VERSION;
+		uint32_t real_size = sizeof(real_t);
+		uint32_t body_count = 0;
+		uint32_t pair_count = 0;
+		uint32_t cached_pair_count = 0;
+		uint64_t step_count = 0;
+	};
+
+	struct SnapshotPairKey {
+		uint64_t body_A = 0;
+		uint64_t body_B = 0;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+	};
+
+	struct SnapshotBody {
+		uint64_t body = 0;
+		GodotBody3D::SnapshotState state;
+	};
+
+	struct SnapshotPair {
+		SnapshotPairKey key;
+		GodotBodyPair3D::SnapshotState state;
+	};
+
+	struct SnapshotCachedPair {
+		SnapshotPairKey key;
+		CachedPair cached;
+	};
+
+	HashSet<GodotBodyPair3D *> body_pairs;
+	// Pairs of a restored snapshot that the broadphase hasn't paired again yet.
+	HashMap<ContactCacheKey, GodotBodyPair3D::SnapshotState, ContactCacheKey> pending_pair_states;
+	// Pairs that weren't in a restored snapshot, they are completed in the next update as if they had just been created.
+	HashSet<GodotBodyPair3D *> pending_new_pairs;
+
+	// Static bodies are only moved by the user.
+	static _FORCE_INLINE_ bool _is_snapshot_body(const GodotCollisionObject3D *p_object) {
+		return p_object->get_type() == GodotCollisionObject3D::TYPE_BODY && static_cast<const GodotBody3D *>(p_object)->get_mode() != PhysicsServer3D::BODY_MODE_STATIC;
+	}
+	static _FORCE_INLINE_ ContactCacheKey _get_pair_key(const GodotBodyPair3D *p_pair) {
+		return { p_pair->get_body_A()->get_self(), p_pair->get_body_B()->get_self(), p_pair->get_shape_A(), p_pair->get_shape_B() };
+	}
+	void _finish_restore_state();
+
 	GodotArea3D *area = nullptr;
 
 	int solver_iterations = 0;
+	int solver_max_threads = -1;
+	int island_split_threshold = 0;
+	int contact_cache_steps = 0;
+	bool deterministic = false;
 
 	real_t contact_recycle_radius = 0.0;
 	real_t contact_max_separation = 0.0;
@@ -161,6 +271,11 @@ public:
 	const HashSet<GodotCollisionObject3D *> &get_objects() const;
 
 	_FORCE_INLINE_ int get_solver_iterations() const { return solver_iterations; }
+	_FORCE_INLINE_ int get_solver_max_threads() const { return solver_max_threads; }
+	_FORCE_INLINE_ int get_island_split_threshold() const { return island_split_threshold; }
+	_FORCE_INLINE_ int get_contact_cache_steps() const { return contact_cache_steps; }
+	_FORCE_INLINE_ bool is_deterministic() const { return deterministic; }
+	_FORCE_INLINE_ uint64_t get_step_count() const { return step_count; }
 	_FORCE_INLINE_ real_t get_contact_recycle_radius() const { return contact_recycle_radius; }
 	_FORCE_INLINE_ real_t get_contact_max_separation() const { return contact_max_separation; }
 	_FORCE_INLINE_ real_t get_contact_max_allowed_penetration() const { return contact_max_allowed_penetration; }
@@ -173,6 +288,10 @@ public:
 	void setup();
 	void call_queries();
 
+	// Saves the state of the simulation, bodies and contacts, to a buffer that can be restored later for rollback.
+	Vector<uint8_t> save_state() const;
+	bool restore_state(const Vector<uint8_t> &p_state);
+
 	bool is_locked() const;
 	void lock();
 	void unlock();
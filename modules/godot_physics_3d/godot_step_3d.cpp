@@ -40,6 +40,12 @@
 #define ISLAND_COUNT_RESERVE 128
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
+// Constraints of a split island are distributed among this many colors at most, the rest are solved serially.
+#define ISLAND_COLOR_MAX 64
+// Colors with fewer constraints than this aren't worth dispatching to the worker threads.
+#define ISLAND_COLOR_PARALLEL_MIN 32
+// Below this many active bodies, integration runs on the calling thread.
+#define INTEGRATION_PARALLEL_MIN 256
 
 void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
@@ -131,6 +137,11 @@ void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constrai
 }
 
 void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
+	if (split_islands[p_island_index]) {
+		// Solved separately in `_solve_split_island`.
+		return;
+	}
+
 	LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[p_island_index];
 
 	int current_priority = 1;
@@ -158,6 +169,119 @@ void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	}
 }
 
+bool GodotStep3D::_can_split_island(const LocalVector<GodotConstraint3D *> &p_constraint_island) const {
+	if (island_split_threshold == 0 || p_constraint_island.size() < island_split_threshold) {
+		return false;
+	}
+
+	for (const GodotConstraint3D *constraint : p_constraint_island) {
+		if (constraint->get_soft_body_count() > 0) {
+			// Soft body nodes aren't tracked by the coloring.
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void GodotStep3D::_color_island(const LocalVector<GodotConstraint3D *> &p_constraint_island) {
+	for (uint32_t color_index = 0; color_index < constraint_color_count; ++color_index) {
+		constraint_colors[color_index].clear();
+	}
+	constraint_colors[ISLAND_COLOR_MAX].clear();
+	constraint_color_count = 0;
+
+	for (const GodotConstraint3D *constraint : p_constraint_island) {
+		for (int i = 0; i < constraint->get_body_count(); i++) {
+			constraint->get_body_ptr()[i]->set_island_color_mask(0);
+		}
+	}
+
+	// Greedy coloring in island order, so the batches are the same regardless of the number of threads.
+	// Only dynamic bodies are written to while solving, so static and kinematic bodies can be shared within a color.
+	for (GodotConstraint3D *constraint : p_constraint_island) {
+		GodotBody3D *const *bodies = constraint->get_body_ptr();
+		uint64_t used_colors = 0;
+		for (int i = 0; i < constraint->get_body_count(); i++) {
+			if (bodies[i]->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+				used_colors |= bodies[i]->get_island_color_mask();
+			}
+		}
+
+		uint32_t color_index = 0;
+		while (color_index < ISLAND_COLOR_MAX && (used_colors & (uint64_t(1) << color_index))) {
+			color_index++;
+		}
+
+		if (color_index < ISLAND_COLOR_MAX) {
+			for (int i = 0; i < constraint->get_body_count(); i++) {
+				if (bodies[i]->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+					bodies[i]->set_island_color_mask(bodies[i]->get_island_color_mask() | (uint64_t(1) << color_index));
+				}
+			}
+			constraint_color_count = MAX(constraint_color_count, color_index + 1);
+		}
+
+		constraint_colors[color_index].push_back(constraint);
+	}
+}
+
+void GodotStep3D::_solve_color_constraint(uint32_t p_constraint_index, void *p_userdata) {
+	solving_constraint_color[p_constraint_index]->solve(delta);
+}
+
+void GodotStep3D::_solve_color(uint32_t p_color_index) {
+	LocalVector<GodotConstraint3D *> &constraint_color = constraint_colors[p_color_index];
+	uint32_t constraint_count = constraint_color.size();
+
+	if (p_color_index == ISLAND_COLOR_MAX || constraint_count < ISLAND_COLOR_PARALLEL_MIN) {
+		// Constraints that didn't fit in any color may share bodies, so they are always solved serially.
+		for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+			constraint_color[constraint_index]->solve(delta);
+		}
+		return;
+	}
+
+	solving_constraint_color = constraint_color.ptr();
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_color_constraint, nullptr, constraint_count, max_threads, true, SNAME("Physics3DConstraintSolveColor"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	solving_constraint_color = nullptr;
+}
+
+void GodotStep3D::_solve_split_island(const LocalVector<GodotConstraint3D *> &p_constraint_island) {
+	_color_island(p_constraint_island);
+
+	int current_priority = 1;
+
+	uint32_t constraint_count = p_constraint_island.size();
+	while (constraint_count > 0) {
+		for (int i = 0; i < iterations; i++) {
+			// Go through all iterations, one color after another.
+			for (uint32_t color_index = 0; color_index < constraint_color_count; ++color_index) {
+				_solve_color(color_index);
+			}
+			_solve_color(ISLAND_COLOR_MAX);
+		}
+
+		// Check priority to keep only higher priority constraints.
+		constraint_count = 0;
+		++current_priority;
+		for (uint32_t color_index = 0; color_index <= ISLAND_COLOR_MAX; ++color_index) {
+			LocalVector<GodotConstraint3D *> &constraint_color = constraint_colors[color_index];
+			uint32_t priority_constraint_count = 0;
+			for (uint32_t constraint_index = 0; constraint_index < constraint_color.size(); ++constraint_index) {
+				GodotConstraint3D *constraint = constraint_color[constraint_index];
+				if (constraint->get_priority() >= current_priority) {
+					// Keep this constraint for the next iteration.
+					constraint_color[priority_constraint_count++] = constraint;
+				}
+			}
+			constraint_color.resize(priority_constraint_count);
+			constraint_count += priority_constraint_count;
+		}
+	}
+}
+
 void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const {
 	bool can_sleep = true;
 
@@ -182,6 +306,124 @@ void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island
 	}
 }
 
+void GodotStep3D::IntegrationArrays::resize(uint32_t p_size) {
+	integrated.resize(p_size);
+	transforms.resize(p_size);
+	linear_velocities.resize(p_size);
+	angular_velocities.resize(p_size);
+	forces.resize(p_size);
+	torques.resize(p_size);
+	linear_damps.resize(p_size);
+	angular_damps.resize(p_size);
+	inv_masses.resize(p_size);
+	inv_inertia_tensors.resize(p_size);
+	centers_of_mass_local.resize(p_size);
+}
+
+void GodotStep3D::_gather_active_bodies(const SelfList<GodotBody3D>::List *p_body_list) {
+	active_bodies.clear();
+	const SelfList<GodotBody3D> *b = p_body_list->first();
+	while (b) {
+		active_bodies.push_back(b->self());
+		b = b->next();
+	}
+	integration.resize(active_bodies.size());
+}
+
+void GodotStep3D::_gather_forces(uint32_t p_body_index, void *p_userdata) {
+	GodotBody3D *body = active_bodies[p_body_index];
+	const bool integrated = body->prepare_force_integration(delta, integration.forces[p_body_index], integration.torques[p_body_index], integration.linear_damps[p_body_index], integration.angular_damps[p_body_index]);
+	integration.integrated[p_body_index] = integrated;
+	if (integrated) {
+		integration.linear_velocities[p_body_index] = body->get_linear_velocity();
+		integration.angular_velocities[p_body_index] = body->get_angular_velocity();
+		integration.inv_masses[p_body_index] = body->get_inv_mass();
+		integration.inv_inertia_tensors[p_body_index] = body->get_inv_inertia_tensor();
+	}
+}
+
+void GodotStep3D::_integrate_forces(uint32_t p_body_index, void *p_userdata) {
+	if (!integration.integrated[p_body_index]) {
+		return;
+	}
+
+	Vector3 &linear_velocity = integration.linear_velocities[p_body_index];
+	Vector3 &angular_velocity = integration.angular_velocities[p_body_index];
+
+	linear_velocity *= integration.linear_damps[p_body_index];
+	angular_velocity *= integration.angular_damps[p_body_index];
+
+	linear_velocity += integration.inv_masses[p_body_index] * integration.forces[p_body_index] * delta;
+	angular_velocity += integration.inv_inertia_tensors[p_body_index].xform(integration.torques[p_body_index]) * delta;
+}
+
+void GodotStep3D::_apply_forces(uint32_t p_body_index, void *p_userdata) {
+	GodotBody3D *body = active_bodies[p_body_index];
+	if (integration.integrated[p_body_index]) {
+		body->set_linear_velocity(integration.linear_velocities[p_body_index]);
+		body->set_angular_velocity(integration.angular_velocities[p_body_index]);
+	}
+	body->finish_force_integration(delta);
+}
+
+void GodotStep3D::_gather_velocities(uint32_t p_body_index, void *p_userdata) {
+	GodotBody3D *body = active_bodies[p_body_index];
+	const bool integrated = body->prepare_velocity_integration();
+	integration.integrated[p_body_index] = integrated;
+	if (integrated) {
+		integration.transforms[p_body_index] = body->get_transform();
+		integration.linear_velocities[p_body_index] = body->get_linear_velocity() + body->get_biased_linear_velocity();
+		integration.angular_velocities[p_body_index] = body->get_angular_velocity() + body->get_biased_angular_velocity();
+		integration.centers_of_mass_local[p_body_index] = body->get_center_of_mass_local();
+	}
+}
+
+void GodotStep3D::_integrate_velocities(uint32_t p_body_index, void *p_userdata) {
+	if (!integration.integrated[p_body_index]) {
+		return;
+	}
+
+	Transform3D &transform = integration.transforms[p_body_index];
+	const Vector3 &total_angular_velocity = integration.angular_velocities[p_body_index];
+
+	real_t ang_vel = total_angular_velocity.length();
+	if (!Math::is_zero_approx(ang_vel)) {
+		Vector3 ang_vel_axis = total_angular_velocity / ang_vel;
+		Basis rot(ang_vel_axis, ang_vel * delta);
+		Basis identity3(1, 0, 0, 0, 1, 0, 0, 0, 1);
+		transform.origin += ((identity3 - rot) * transform.basis).xform(integration.centers_of_mass_local[p_body_index]);
+		transform.basis = rot * transform.basis;
+		transform.orthonormalize();
+	}
+
+	transform.origin += integration.linear_velocities[p_body_index] * delta;
+}
+
+void GodotStep3D::_apply_velocities(uint32_t p_body_index, void *p_userdata) {
+	if (integration.integrated[p_body_index]) {
+		active_bodies[p_body_index]->finish_velocity_integration(integration.transforms[p_body_index]);
+	}
+}
+
+void GodotStep3D::_run_body_pass(void (GodotStep3D::*p_method)(uint32_t, void *), const StringName &p_description) {
+	uint32_t body_count = active_bodies.size();
+	if (body_count < INTEGRATION_PARALLEL_MIN) {
+		for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
+			(this->*p_method)(body_index, nullptr);
+		}
+	} else {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, p_method, nullptr, body_count, max_threads, true, p_description);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	}
+}
+
+void GodotStep3D::_finish_integration() {
+	// Broadphase and list updates, in the same order as the active list.
+	for (GodotBody3D *body : active_bodies) {
+		body->finish_integration();
+	}
+}
+
 void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	p_space->lock(); // can't access space during this
 
@@ -191,6 +433,9 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	iterations = p_space->get_solver_iterations();
 	delta = p_delta;
+	max_threads = p_space->get_solver_max_threads();
+	island_split_threshold = MAX(p_space->get_island_split_threshold(), 0);
+	deterministic = p_space->is_deterministic();
 
 	const SelfList<GodotBody3D>::List *body_list = &p_space->get_active_body_list();
 
@@ -201,14 +446,13 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	uint64_t profile_begtime = OS::get_singleton()->get_ticks_usec();
 	uint64_t profile_endtime = 0;
 
-	int active_count = 0;
+	_gather_active_bodies(body_list);
+	_run_body_pass(&GodotStep3D::_gather_forces, SNAME("Physics3DGatherForces"));
+	_run_body_pass(&GodotStep3D::_integrate_forces, SNAME("Physics3DIntegrateForces"));
+	_run_body_pass(&GodotStep3D::_apply_forces, SNAME("Physics3DApplyForces"));
+	_finish_integration();
 
-	const SelfList<GodotBody3D> *b = body_list->first();
-	while (b) {
-		b->self()->integrate_forces(p_delta);
-		b = b->next();
-		active_count++;
-	}
+	int active_count = active_bodies.size();
 
 	/* UPDATE SOFT BODY MOTION */
 
@@ -260,7 +504,7 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE RIGID BODIES */
 
-	b = body_list->first();
+	const SelfList<GodotBody3D> *b = body_list->first();
 
 	uint32_t body_island_count = 0;
 
@@ -343,8 +587,11 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
 
+	// The narrow phase (contact generation and continuous collision casts) runs here on multiple threads.
+	// Each constraint only writes to its own state, anything touching the bodies is deferred to the pre-solve,
+	// which runs in island order so results don't depend on the number of threads.
 	uint32_t total_constraint_count = all_constraints.size();
-	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_setup_constraint, nullptr, total_constraint_count, -1, true, SNAME("Physics3DConstraintSetup"));
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_setup_constraint, nullptr, total_constraint_count, max_threads, true, SNAME("Physics3DConstraintSetup"));
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
 	{ //profile
@@ -356,17 +603,30 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	/* PRE-SOLVE CONSTRAINT ISLANDS */
 
 	// WARNING: This doesn't run on threads, because it involves thread-unsafe processing.
+	split_islands.resize(island_count);
 	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+		if (deterministic) {
+			// Islands are gathered in the order the broadphase created the pairs, which depends on the history of the space.
+			constraint_islands[island_index].sort_custom<GodotConstraint3D::OrderComparator>();
+		}
 		_pre_solve_island(constraint_islands[island_index]);
+		split_islands[island_index] = _can_split_island(constraint_islands[island_index]);
 	}
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
 	// WARNING: `_solve_island` modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
-	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_island, nullptr, island_count, -1, true, SNAME("Physics3DConstraintSolveIslands"));
+	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_island, nullptr, island_count, max_threads, true, SNAME("Physics3DConstraintSolveIslands"));
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
+	// Large islands would keep a single thread busy, so their constraints are solved in parallel batches instead.
+	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+		if (split_islands[island_index]) {
+			_solve_split_island(constraint_islands[island_index]);
+		}
+	}
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_SOLVE_CONSTRAINTS, profile_endtime - profile_begtime);
@@ -375,12 +635,11 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* INTEGRATE VELOCITIES */
 
-	b = body_list->first();
-	while (b) {
-		const SelfList<GodotBody3D> *n = b->next();
-		b->self()->integrate_velocities(p_delta);
-		b = n;
-	}
+	_gather_active_bodies(body_list);
+	_run_body_pass(&GodotStep3D::_gather_velocities, SNAME("Physics3DGatherVelocities"));
+	_run_body_pass(&GodotStep3D::_integrate_velocities, SNAME("Physics3DIntegrateVelocities"));
+	_run_body_pass(&GodotStep3D::_apply_velocities, SNAME("Physics3DApplyVelocities"));
+	_finish_integration();
 
 	/* SLEEP / WAKE UP ISLANDS */
 
@@ -412,6 +671,7 @@ GodotStep3D::GodotStep3D() {
 	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
+	constraint_colors.resize(ISLAND_COLOR_MAX + 1);
 }
 
 GodotStep3D::~GodotStep3D() {
@@ -40,17 +40,62 @@ class GodotStep3D {
 
 	int iterations = 0;
 	real_t delta = 0.0;
+	int max_threads = -1;
+	uint32_t island_split_threshold = 0;
+	bool deterministic = false;
 
 	LocalVector<LocalVector<GodotBody3D *>> body_islands;
 	LocalVector<LocalVector<GodotConstraint3D *>> constraint_islands;
 	LocalVector<GodotConstraint3D *> all_constraints;
 
+	// Active bodies gathered in a dense array, so integration can be split across threads.
+	LocalVector<GodotBody3D *> active_bodies;
+
+	// State of the active bodies that is integrated, one entry per active body in each array.
+	// Integration runs in passes: gather from the bodies, integrate the arrays, apply back to the bodies.
+	struct IntegrationArrays {
+		LocalVector<uint8_t> integrated; // Whether the entry is used, the body did all of its integration otherwise.
+		LocalVector<Transform3D> transforms;
+		LocalVector<Vector3> linear_velocities;
+		LocalVector<Vector3> angular_velocities;
+		LocalVector<Vector3> forces;
+		LocalVector<Vector3> torques;
+		LocalVector<real_t> linear_damps;
+		LocalVector<real_t> angular_damps;
+		LocalVector<real_t> inv_masses;
+		LocalVector<Basis> inv_inertia_tensors;
+		LocalVector<Vector3> centers_of_mass_local;
+
+		void resize(uint32_t p_size);
+	};
+	IntegrationArrays integration;
+
+	// Islands large enough to be split are solved one at a time, in batches of constraints (colors) that don't share any dynamic body.
+	LocalVector<bool> split_islands;
+	LocalVector<LocalVector<GodotConstraint3D *>> constraint_colors;
+	uint32_t constraint_color_count = 0;
+	GodotConstraint3D *const *solving_constraint_color = nullptr;
+
 	void _populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
 	void _populate_island_soft_body(GodotSoftBody3D *p_soft_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
 	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
 	void _pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island) const;
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
+	bool _can_split_island(const LocalVector<GodotConstraint3D *> &p_constraint_island) const;
+	void _color_island(const LocalVector<GodotConstraint3D *> &p_constraint_island);
+	void _solve_color_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
+	void _solve_color(uint32_t p_color_index);
+	void _solve_split_island(const LocalVector<GodotConstraint3D *> &p_constraint_island);
 	void _check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const;
+	void _gather_active_bodies(const SelfList<GodotBody3D>::List *p_body_list);
+	void _gather_forces(uint32_t p_body_index, void *p_userdata = nullptr);
+	void _integrate_forces(uint32_t p_body_index, void *p_userdata = nullptr);
+	void _apply_forces(uint32_t p_body_index, void *p_userdata = nullptr);
+	void _gather_velocities(uint32_t p_body_index, void *p_userdata = nullptr);
+	void _integrate_velocities(uint32_t p_body_index, void *p_userdata = nullptr);
+	void _apply_velocities(uint32_t p_body_index, void *p_userdata = nullptr);
+	void _run_body_pass(void (GodotStep3D::*p_method)(uint32_t, void *), const StringName &p_description);
+	void _finish_integration();
 
 public:
 	void step(GodotSpace3D *p_space, real_t p_delta);
@@ -0,0 +1,182 @@
+/**************************************************************************/
+/*  test_godot_collision_solver_3d.h                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_COLLISION_SOLVER_3D_H
+#define TEST_GODOT_COLLISION_SOLVER_3D_H
+
+#include "../godot_collision_solver_3d_sat.h"
+
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotCollisionSolver3D {
+
+static Transform3D random_transform(RandomNumberGenerator &p_rng, real_t p_spread) {
+	Vector3 axis = Vector3(p_rng.randf_range(-1, 1), p_rng.randf_range(-1, 1), p_rng.randf_range(-1, 1));
+	if (axis.is_zero_approx()) {
+		axis = Vector3(0, 1, 0);
+	}
+	Basis basis(axis.normalized(), p_rng.randf_range(-Math_PI, Math_PI));
+	return Transform3D(basis, Vector3(p_rng.randf_range(-p_spread, p_spread), p_rng.randf_range(-p_spread, p_spread), p_rng.randf_range(-p_spread, p_spread)));
+}
+
+static void count_contact(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal, void *p_userdata) {
+	(*(int *)p_userdata)++;
+}
+
+// Runs the SAT solver on random placements of a shape pair, returns the time per pair.
+static double benchmark_pair(const GodotShape3D *p_shape_A, const GodotShape3D *p_shape_B, int p_pair_count) {
+	RandomNumberGenerator rng;
+	rng.set_seed(1234);
+
+	LocalVector<Transform3D> transforms;
+	transforms.resize(p_pair_count * 2);
+	for (Transform3D &transform : transforms) {
+		transform = random_transform(rng, 1.5);
+	}
+
+	int contacts = 0;
+	const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_pair_count; i++) {
+		sat_calculate_penetration(p_shape_A, transforms[i * 2], p_shape_B, transforms[i * 2 + 1], count_contact, &contacts);
+	}
+	const uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+	CHECK(contacts > 0);
+	return double(usec) * 1000.0 / p_pair_count;
+}
+
+TEST_CASE("[Physics][GodotCollisionSolver3D] Batched box-box test matches the SAT solver") {
+	GodotBoxShape3D box_A;
+	box_A.set_data(Vector3(0.5, 1.0, 0.75));
+	GodotBoxShape3D box_B;
+	box_B.set_data(Vector3(1.0, 0.25, 0.5));
+
+	RandomNumberGenerator rng;
+	rng.set_seed(42);
+
+	const int pair_count = 512;
+	LocalVector<Transform3D> transforms_A;
+	LocalVector<Transform3D> transforms_B;
+	LocalVector<Vector3> half_extents_A;
+	LocalVector<Vector3> half_extents_B;
+	for (int i = 0; i < pair_count; i++) {
+		transforms_A.push_back(random_transform(rng, 1.5));
+		// Also include pairs with parallel edges, where some of the edge axes are degenerate.
+		transforms_B.push_back(i % 4 == 0 ? Transform3D(transforms_A[i].basis, transforms_A[i].origin + Vector3(0.5, 0.5, 0.5)) : random_transform(rng, 1.5));
+		half_extents_A.push_back(box_A.get_half_extents());
+		half_extents_B.push_back(box_B.get_half_extents());
+	}
+
+	LocalVector<bool> overlap;
+	overlap.resize(pair_count);
+	LocalVector<Vector3> normals;
+	normals.resize(pair_count);
+
+	SATBoxBoxBatch batch;
+	batch.count = pair_count;
+	batch.transforms_A = transforms_A.ptr();
+	batch.half_extents_A = half_extents_A.ptr();
+	batch.transforms_B = transforms_B.ptr();
+	batch.half_extents_B = half_extents_B.ptr();
+	batch.r_overlap = overlap.ptr();
+	batch.r_normals = normals.ptr();
+	sat_box_box_batch(batch);
+
+	int overlapping = 0;
+	bool matches = true;
+	for (int i = 0; i < pair_count; i++) {
+		Vector3 axis;
+		const bool collided = sat_calculate_penetration(&box_A, transforms_A[i], &box_B, transforms_B[i], nullptr, nullptr, false, &axis);
+		matches = matches && collided == overlap[i];
+		if (collided) {
+			matches = matches && axis.is_equal_approx(normals[i]);
+			overlapping++;
+		}
+	}
+	CHECK_MESSAGE(matches, "Batched results should match the ones of sat_calculate_penetration().");
+	CHECK_MESSAGE(overlapping > 0, "Some of the pairs should overlap.");
+	CHECK_MESSAGE(overlapping < pair_count, "Some of the pairs should be separated.");
+}
+
+TEST_CASE("[Physics][GodotCollisionSolver3D][Benchmark] SAT shape pairs") {
+	const int pair_count = 20000;
+
+	GodotBoxShape3D box;
+	box.set_data(Vector3(0.5, 0.5, 0.5));
+
+	GodotCapsuleShape3D capsule;
+	Dictionary capsule_data;
+	capsule_data["radius"] = 0.4;
+	capsule_data["height"] = 1.5;
+	capsule.set_data(capsule_data);
+
+	GodotConvexPolygonShape3D convex;
+	Vector<Vector3> points;
+	for (int i = 0; i < 16; i++) {
+		const real_t angle = Math_TAU * i / 16;
+		points.push_back(Vector3(Math::cos(angle) * 0.5, (i % 2) ? 0.5 : -0.5, Math::sin(angle) * 0.5));
+	}
+	convex.set_data(points);
+
+	MESSAGE("Box-box: ", String::num(benchmark_pair(&box, &box, pair_count), 1), " nsec per pair.");
+	MESSAGE("Box-capsule: ", String::num(benchmark_pair(&box, &capsule, pair_count), 1), " nsec per pair.");
+	MESSAGE("Capsule-capsule: ", String::num(benchmark_pair(&capsule, &capsule, pair_count), 1), " nsec per pair.");
+	MESSAGE("Convex-convex: ", String::num(benchmark_pair(&convex, &convex, pair_count), 1), " nsec per pair.");
+
+	RandomNumberGenerator rng;
+	rng.set_seed(1234);
+	LocalVector<Transform3D> transforms;
+	LocalVector<Vector3> half_extents;
+	for (int i = 0; i < pair_count * 2; i++) {
+		transforms.push_back(random_transform(rng, 1.5));
+		half_extents.push_back(box.get_half_extents());
+	}
+	LocalVector<bool> overlap;
+	overlap.resize(pair_count);
+
+	SATBoxBoxBatch batch;
+	batch.count = pair_count;
+	batch.transforms_A = transforms.ptr();
+	batch.half_extents_A = half_extents.ptr();
+	batch.transforms_B = transforms.ptr() + pair_count;
+	batch.half_extents_B = half_extents.ptr() + pair_count;
+	batch.r_overlap = overlap.ptr();
+
+	const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	sat_box_box_batch(batch);
+	const uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+	MESSAGE("Box-box batch: ", String::num(double(usec) * 1000.0 / pair_count, 1), " nsec per pair.");
+}
+
+} // namespace TestGodotCollisionSolver3D
+
+#endif // TEST_GODOT_COLLISION_SOLVER_3D_H
@@ -0,0 +1,230 @@
+/**************************************************************************/
+/*  test_godot_shape_3d.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_SHAPE_3D_H
+#define TEST_GODOT_SHAPE_3D_H
+
+#include "../godot_physics_server_3d.h"
+#include "../godot_shape_3d.h"
+
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotShape3D {
+
+// Bumpy terrain of p_size * p_size quads.
+static Vector<Vector3> make_terrain(int p_size, uint64_t p_seed) {
+	RandomNumberGenerator rng;
+	rng.set_seed(p_seed);
+
+	LocalVector<real_t> heights;
+	heights.resize((p_size + 1) * (p_size + 1));
+	for (real_t &height : heights) {
+		height = rng.randf_range(-1, 1);
+	}
+
+	Vector<Vector3> faces;
+	faces.resize(p_size * p_size * 6);
+	Vector3 *facesw = faces.ptrw();
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			Vector3 a(x, heights[z * (p_size + 1) + x], z);
+			Vector3 b(x + 1, heights[z * (p_size + 1) + x + 1], z);
+			Vector3 c(x, heights[(z + 1) * (p_size + 1) + x], z + 1);
+			Vector3 d(x + 1, heights[(z + 1) * (p_size + 1) + x + 1], z + 1);
+			Vector3 *quad = &facesw[(z * p_size + x) * 6];
+			quad[0] = a;
+			quad[1] = b;
+			quad[2] = c;
+			quad[3] = b;
+			quad[4] = d;
+			quad[5] = c;
+		}
+	}
+	return faces;
+}
+
+static Dictionary make_data(const Vector<Vector3> &p_faces, const Variant &p_bvh = Variant()) {
+	Dictionary d;
+	d["faces"] = p_faces;
+	d["backface_collision"] = false;
+	if (p_bvh.get_type() != Variant::NIL) {
+		d["bvh"] = p_bvh;
+	}
+	return d;
+}
+
+struct CullCount {
+	AABB aabb;
+	int count = 0;
+};
+
+static bool count_face(void *p_userdata, GodotShape3D *p_shape) {
+	CullCount *cull_count = (CullCount *)p_userdata;
+	const GodotFaceShape3D *face = (const GodotFaceShape3D *)p_shape;
+	AABB face_aabb(face->vertex[0], Vector3());
+	face_aabb.expand_to(face->vertex[1]);
+	face_aabb.expand_to(face->vertex[2]);
+	if (face_aabb.intersects(cull_count->aabb)) {
+		cull_count->count++;
+	}
+	return false;
+}
+
+// Checks culling and segments against brute force over all faces.
+static bool matches_brute_force(const GodotConcavePolygonShape3D &p_shape, const Vector<Vector3> &p_faces, int p_size) {
+	RandomNumberGenerator rng;
+	rng.set_seed(5);
+
+	for (int i = 0; i < 200; i++) {
+		Vector3 position(rng.randf_range(-1, p_size), rng.randf_range(-2, 1), rng.randf_range(-1, p_size));
+		AABB aabb(position, Vector3(rng.randf_range(0, 2), rng.randf_range(0, 2), rng.randf_range(0, 2)));
+
+		int expected = 0;
+		for (int j = 0; j < p_faces.size(); j += 3) {
+			if (Face3(p_faces[j], p_faces[j + 1], p_faces[j + 2]).get_aabb().intersects(aabb)) {
+				expected++;
+			}
+		}
+
+		CullCount cull_count;
+		cull_count.aabb = aabb;
+		p_shape.cull(aabb, count_face, &cull_count, false);
+		if (cull_count.count != expected) {
+			return false;
+		}
+
+		Vector3 from(rng.randf_range(0, p_size), 5, rng.randf_range(0, p_size));
+		Vector3 to(rng.randf_range(0, p_size), -5, rng.randf_range(0, p_size));
+		real_t expected_distance = 1e20;
+		for (int j = 0; j < p_faces.size(); j += 3) {
+			Vector3 hit;
+			if (Face3(p_faces[j], p_faces[j + 1], p_faces[j + 2]).intersects_segment(from, to, &hit)) {
+				expected_distance = MIN(expected_distance, from.distance_to(hit));
+			}
+		}
+
+		Vector3 result;
+		Vector3 normal;
+		int face_index = -1;
+		if (p_shape.intersect_segment(from, to, result, normal, face_index, false)) {
+			if (!Math::is_equal_approx(from.distance_to(result), expected_distance, (real_t)0.001)) {
+				return false;
+			}
+		} else if (expected_distance < 1e20) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+TEST_CASE("[Physics][GodotShape3D] Concave polygon BVH round trip") {
+	const int size = 24;
+	Vector<Vector3> faces = make_terrain(size, 3);
+
+	GodotConcavePolygonShape3D built;
+	built.set_data(make_data(faces));
+	Vector<uint8_t> bvh_data = ((Dictionary)built.get_data())["bvh"];
+	REQUIRE_FALSE(bvh_data.is_empty());
+	CHECK_MESSAGE(matches_brute_force(built, faces, size), "Queries on the built BVH should find the same faces as brute force.");
+
+	GodotConcavePolygonShape3D loaded;
+	loaded.set_data(make_data(faces, bvh_data));
+	CHECK_MESSAGE(loaded.get_bvh_data().ptr() == bvh_data.ptr(), "A valid BVH should be adopted without being copied or rebuilt.");
+	CHECK_MESSAGE(matches_brute_force(loaded, faces, size), "Queries on the loaded BVH should find the same faces as brute force.");
+
+	loaded.set_data(make_data(faces));
+	CHECK_MESSAGE(loaded.get_bvh_data().ptr() == bvh_data.ptr(), "Setting the same faces again should keep the current BVH.");
+
+	Vector<Vector3> moved_faces = faces;
+	moved_faces.write[0].y += 10.0;
+	GodotConcavePolygonShape3D stale;
+	stale.set_data(make_data(moved_faces, bvh_data));
+	CHECK_MESSAGE(stale.get_bvh_data().ptr() != bvh_data.ptr(), "A BVH built for other faces should be rebuilt.");
+	CHECK_MESSAGE(matches_brute_force(stale, moved_faces, size), "Queries on the rebuilt BVH should find the same faces as brute force.");
+
+	Vector<uint8_t> truncated = bvh_data;
+	truncated.resize(truncated.size() - 1);
+	GodotConcavePolygonShape3D corrupt;
+	corrupt.set_data(make_data(faces, truncated));
+	CHECK_MESSAGE(corrupt.get_bvh_data().size() == bvh_data.size(), "A truncated BVH should be rebuilt.");
+	CHECK_MESSAGE(matches_brute_force(corrupt, faces, size), "Queries on the rebuilt BVH should find the same faces as brute force.");
+}
+
+TEST_CASE("[Physics][GodotShape3D] The server returns the BVH of concave polygon shapes without copying it") {
+	GodotPhysicsServer3D *server = memnew(GodotPhysicsServer3D);
+	server->init();
+
+	RID concave_shape = server->concave_polygon_shape_create();
+	server->shape_set_data(concave_shape, make_data(make_terrain(8, 5)));
+	const Vector<uint8_t> bvh_data = server->shape_get_bvh_data(concave_shape);
+	CHECK_FALSE(bvh_data.is_empty());
+	CHECK_MESSAGE(bvh_data.ptr() == server->shape_get_bvh_data(concave_shape).ptr(), "The BVH should be shared with the shape.");
+
+	RID box_shape = server->box_shape_create();
+	server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+	CHECK(server->shape_get_bvh_data(box_shape).is_empty());
+
+	server->free(box_shape);
+	server->free(concave_shape);
+
+	server->finish();
+	memdelete(server);
+}
+
+TEST_CASE("[Physics][GodotShape3D][Benchmark] Concave polygon BVH build and load") {
+	const int size = 256;
+	Vector<Vector3> faces = make_terrain(size, 9);
+	const int face_count = faces.size() / 3;
+
+	GodotConcavePolygonShape3D built;
+	uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	built.set_data(make_data(faces));
+	const uint64_t build_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+	Vector<uint8_t> bvh_data = built.get_bvh_data();
+
+	GodotConcavePolygonShape3D loaded;
+	begin_usec = OS::get_singleton()->get_ticks_usec();
+	loaded.set_data(make_data(faces, bvh_data));
+	const uint64_t load_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+	// Size of the previous node layout: an AABB and three indices.
+	const int64_t unquantized_size = (face_count * 2 - 1) * int64_t(sizeof(AABB) + sizeof(int) * 3);
+	MESSAGE(face_count, " faces: ", build_usec, " usec to build, ", load_usec, " usec to load (", String::num(double(build_usec) / MAX(load_usec, uint64_t(1)), 2), "x).");
+	MESSAGE("BVH: ", bvh_data.size(), " bytes, ", unquantized_size, " bytes unquantized (", String::num(double(unquantized_size) / bvh_data.size(), 2), "x).");
+	CHECK(loaded.get_bvh_data().ptr() == bvh_data.ptr());
+}
+
+} // namespace TestGodotShape3D
+
+#endif // TEST_GODOT_SHAPE_3D_H
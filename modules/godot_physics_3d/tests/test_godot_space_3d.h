@@ -0,0 +1,114 @@
+/**************************************************************************/
+/*  test_godot_space_3d.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_SPACE_3D_H
+#define TEST_GODOT_SPACE_3D_H
+
+#include "../godot_physics_server_3d.h"
+
+#include "core/math/random_number_generator.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotSpace3D {
+
+TEST_CASE("[Physics][GodotSpace3D] Batched rays match single rays") {
+	GodotPhysicsServer3D *server = memnew(GodotPhysicsServer3D);
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	RID box_shape = server->box_shape_create();
+	server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+	LocalVector<RID> boxes;
+	for (int z = 0; z < 8; z++) {
+		for (int x = 0; x < 8; x++) {
+			RID box = server->body_create();
+			server->body_set_mode(box, PhysicsServer3D::BODY_MODE_STATIC);
+			server->body_add_shape(box, box_shape);
+			server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(x * 2, (x + z) % 3, z * 2)));
+			server->body_set_space(box, space);
+			boxes.push_back(box);
+		}
+	}
+	server->step(1.0 / 60.0);
+
+	RandomNumberGenerator rng;
+	rng.set_seed(7);
+	const int ray_count = 1000;
+	PackedVector3Array from;
+	PackedVector3Array to;
+	for (int i = 0; i < ray_count; i++) {
+		from.push_back(Vector3(rng.randf_range(-1, 15), 5, rng.randf_range(-1, 15)));
+		to.push_back(Vector3(rng.randf_range(-1, 15), -5, rng.randf_range(-1, 15)));
+	}
+
+	PhysicsDirectSpaceState3D *state = server->space_get_direct_state(space);
+	Ref<PhysicsRayQueryParameters3D> parameters;
+	parameters.instantiate();
+	Dictionary batch = state->call("intersect_ray_batch", parameters, from, to);
+
+	PackedByteArray hits = batch["hit"];
+	PackedVector3Array positions = batch["position"];
+	PackedInt64Array collider_ids = batch["collider_id"];
+	REQUIRE(hits.size() == ray_count);
+
+	int hit_count = 0;
+	bool matches = true;
+	for (int i = 0; i < ray_count; i++) {
+		PhysicsDirectSpaceState3D::RayParameters ray;
+		ray.from = from[i];
+		ray.to = to[i];
+		PhysicsDirectSpaceState3D::RayResult result;
+		bool hit = state->intersect_ray(ray, result);
+		matches = matches && hit == bool(hits[i]);
+		if (hit) {
+			matches = matches && result.position == positions[i] && int64_t(result.collider_id) == collider_ids[i];
+			hit_count++;
+		}
+	}
+	CHECK_MESSAGE(matches, "Batched rays should give the same results as single rays.");
+	CHECK(hit_count > 0);
+	CHECK(hit_count < ray_count);
+
+	for (const RID &box : boxes) {
+		server->free(box);
+	}
+	server->free(box_shape);
+	server->free(space);
+
+	server->finish();
+	memdelete(server);
+}
+
+} // namespace TestGodotSpace3D
+
+#endif // TEST_GODOT_SPACE_3D_H
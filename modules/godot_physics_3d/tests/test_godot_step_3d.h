@@ -0,0 +1,545 @@
+/**************************************************************************/
+/*  test_godot_step_3d.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_STEP_3D_H
+#define TEST_GODOT_STEP_3D_H
+
+#include "../godot_physics_server_3d.h"
+
+#include "core/config/project_settings.h"
+#include "core/math/random_number_generator.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+#include "core/templates/pair.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotStep3D {
+
+// Physics server with an active space, for a single simulation.
+// The given project settings are applied before the server starts, and restored when it is destroyed
+// along with everything created through it.
+class TestSpace {
+	LocalVector<Pair<String, Variant>> previous_settings;
+	LocalVector<RID> owned;
+
+public:
+	GodotPhysicsServer3D *server = nullptr;
+	RID space;
+
+	GodotPhysicsServer3D *operator->() const { return server; }
+
+	RID own(const RID &p_rid) {
+		owned.push_back(p_rid);
+		return p_rid;
+	}
+
+	RID create_box_shape(const Vector3 &p_half_extents) {
+		RID shape = own(server->box_shape_create());
+		server->shape_set_data(shape, p_half_extents);
+		return shape;
+	}
+
+	RID create_sphere_shape(real_t p_radius) {
+		RID shape = own(server->sphere_shape_create());
+		server->shape_set_data(shape, p_radius);
+		return shape;
+	}
+
+	// The body isn't added to the space, so that it can be set up first.
+	RID create_body(PhysicsServer3D::BodyMode p_mode, const RID &p_shape, const Transform3D &p_transform) {
+		RID body = own(server->body_create());
+		server->body_set_mode(body, p_mode);
+		server->body_add_shape(body, p_shape);
+		server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, p_transform);
+		return body;
+	}
+
+	// Static box with its top at the origin.
+	RID create_floor(const Vector3 &p_half_extents) {
+		RID floor = create_body(PhysicsServer3D::BODY_MODE_STATIC, create_box_shape(p_half_extents), Transform3D(Basis(), Vector3(0, -p_half_extents.y, 0)));
+		server->body_set_space(floor, space);
+		return floor;
+	}
+
+	void step(int p_steps) {
+		for (int i = 0; i < p_steps; i++) {
+			server->step(1.0 / 60.0);
+		}
+	}
+
+	TestSpace(std::initializer_list<Pair<String, Variant>> p_settings = {}) {
+		ProjectSettings *project_settings = ProjectSettings::get_singleton();
+		for (const Pair<String, Variant> &setting : p_settings) {
+			previous_settings.push_back(Pair<String, Variant>(setting.first, project_settings->get_setting(setting.first)));
+			project_settings->set_setting(setting.first, setting.second);
+		}
+
+		server = memnew(GodotPhysicsServer3D);
+		server->init();
+
+		space = server->space_create();
+		server->space_set_active(space, true);
+	}
+
+	~TestSpace() {
+		// Bodies are freed before their shapes.
+		for (int i = owned.size() - 1; i >= 0; i--) {
+			server->free(owned[i]);
+		}
+		server->free(space);
+
+		server->finish();
+		memdelete(server);
+
+		ProjectSettings *project_settings = ProjectSettings::get_singleton();
+		for (const Pair<String, Variant> &setting : previous_settings) {
+			project_settings->set_setting(setting.first, setting.second);
+		}
+	}
+};
+
+struct StackResult {
+	LocalVector<Transform3D> transforms;
+	int island_count = 0;
+	uint64_t step_usec = 0;
+};
+
+// Simulates a single pile of boxes touching each other, which the solver sees as one large island.
+static StackResult simulate_stack(int p_max_threads, int p_size, int p_height, int p_steps) {
+	TestSpace test_space({ { "physics/3d/solver/max_threads", p_max_threads } });
+	test_space.create_floor(Vector3(p_size * 2, 0.5, p_size * 2));
+
+	RID box_shape = test_space.create_box_shape(Vector3(0.5, 0.5, 0.5));
+	LocalVector<RID> boxes;
+	for (int y = 0; y < p_height; y++) {
+		for (int z = 0; z < p_size; z++) {
+			for (int x = 0; x < p_size; x++) {
+				// Boxes slightly overlap their neighbors so that the whole pile is a single island.
+				RID box = test_space.create_body(PhysicsServer3D::BODY_MODE_RIGID, box_shape, Transform3D(Basis(), Vector3(x * 0.99, 0.5 + y * 0.99, z * 0.99)));
+				test_space->body_set_space(box, test_space.space);
+				boxes.push_back(box);
+			}
+		}
+	}
+
+	StackResult result;
+	const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	test_space.step(p_steps);
+	result.step_usec = (OS::get_singleton()->get_ticks_usec() - begin_usec) / p_steps;
+	result.island_count = test_space->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT);
+
+	for (const RID &box : boxes) {
+		result.transforms.push_back(test_space->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM));
+	}
+	return result;
+}
+
+static bool transforms_identical(const LocalVector<Transform3D> &p_a, const LocalVector<Transform3D> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (uint32_t i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+struct FreeFallResult {
+	LocalVector<Transform3D> transforms;
+	LocalVector<Vector3> linear_velocities;
+	uint64_t step_usec = 0;
+};
+
+// Simulates bodies falling without touching anything, so the step is dominated by integration.
+static FreeFallResult simulate_free_fall(int p_max_threads, int p_body_count, int p_steps) {
+	TestSpace test_space({ { "physics/3d/solver/max_threads", p_max_threads } });
+
+	RID sphere_shape = test_space.create_sphere_shape(0.5);
+	LocalVector<RID> bodies;
+	const int side = Math::ceil(Math::sqrt((double)p_body_count));
+	for (int i = 0; i < p_body_count; i++) {
+		RID body = test_space.create_body(PhysicsServer3D::BODY_MODE_RIGID, sphere_shape, Transform3D(Basis(), Vector3((i % side) * 2, 100, (i / side) * 2)));
+		test_space->body_set_space(body, test_space.space);
+		bodies.push_back(body);
+	}
+
+	// The first step registers all the bodies in the broadphase.
+	test_space.step(1);
+
+	const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	test_space.step(p_steps);
+	FreeFallResult result;
+	result.step_usec = (OS::get_singleton()->get_ticks_usec() - begin_usec) / p_steps;
+
+	for (const RID &body : bodies) {
+		result.transforms.push_back(test_space->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM));
+		result.linear_velocities.push_back(test_space->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY));
+	}
+	return result;
+}
+
+// Hashes the exact bits of the state of the bodies.
+static uint32_t hash_bodies(PhysicsServer3D *p_server, const LocalVector<RID> &p_bodies) {
+	uint32_t h = HASH_MURMUR3_SEED;
+	for (const RID &body : p_bodies) {
+		Transform3D transform = p_server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		Vector3 linear_velocity = p_server->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+		Vector3 angular_velocity = p_server->body_get_state(body, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY);
+		h = hash_murmur3_buffer(&transform, sizeof(Transform3D), h);
+		h = hash_murmur3_buffer(&linear_velocity, sizeof(Vector3), h);
+		h = hash_murmur3_buffer(&angular_velocity, sizeof(Vector3), h);
+	}
+	return h;
+}
+
+// Drops piles of boxes and spheres in deterministic mode, returns the hash of the final state.
+// Bodies are always created in the same order, but can be added to the space in reverse order,
+// which changes the order in which the broadphase finds the pairs.
+static uint32_t simulate_deterministic(int p_max_threads, bool p_reverse_insertion, int p_steps) {
+	TestSpace test_space({ { "physics/3d/solver/max_threads", p_max_threads }, { "physics/3d/solver/deterministic", true } });
+	test_space.create_floor(Vector3(50, 0.5, 50));
+
+	RID box_shape = test_space.create_box_shape(Vector3(0.5, 0.5, 0.5));
+	RID sphere_shape = test_space.create_sphere_shape(0.5);
+
+	RandomNumberGenerator rng;
+	rng.set_seed(11);
+	LocalVector<RID> bodies;
+	for (int pile = 0; pile < 4; pile++) {
+		// The last pile is large enough to be split and solved in parallel batches.
+		const int size = pile == 3 ? 6 : 3;
+		const Vector3 origin(pile * 12 - 18, 0, 0);
+		for (int y = 0; y < 3; y++) {
+			for (int z = 0; z < size; z++) {
+				for (int x = 0; x < size; x++) {
+					Basis basis(Vector3(0, 1, 0), rng.randf_range(-0.3, 0.3));
+					bodies.push_back(test_space.create_body(PhysicsServer3D::BODY_MODE_RIGID, (x + y + z) % 3 ? box_shape : sphere_shape, Transform3D(basis, origin + Vector3(x * 0.99, 0.5 + y * 0.99, z * 0.99))));
+				}
+			}
+		}
+	}
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+		test_space->body_set_space(bodies[p_reverse_insertion ? bodies.size() - 1 - i : i], test_space.space);
+	}
+
+	test_space.step(p_steps);
+	return hash_bodies(test_space.server, bodies);
+}
+
+struct RollbackResult {
+	uint32_t hash = 0;
+	uint32_t rollback_hash = 0;
+	int state_size = 0;
+	bool state_reproducible = false;
+	uint64_t save_usec = 0;
+	uint64_t restore_usec = 0;
+	uint64_t resimulate_usec = 0;
+};
+
+// Lets a pile of boxes settle, saves the state, simulates some frames, then rolls back and simulates them again.
+static RollbackResult simulate_rollback(int p_size, int p_height, int p_frames) {
+	TestSpace test_space({ { "physics/3d/solver/deterministic", true } });
+	test_space.create_floor(Vector3(p_size + 10, 0.5, p_size + 10));
+
+	RID box_shape = test_space.create_box_shape(Vector3(0.5, 0.5, 0.5));
+	LocalVector<RID> bodies;
+	for (int y = 0; y < p_height; y++) {
+		for (int z = 0; z < p_size; z++) {
+			for (int x = 0; x < p_size; x++) {
+				RID body = test_space.create_body(PhysicsServer3D::BODY_MODE_RIGID, box_shape, Transform3D(Basis(), Vector3(x - p_size * 0.5, 0.5 + y * 1.01, z - p_size * 0.5)));
+				test_space->body_set_space(body, test_space.space);
+				bodies.push_back(body);
+			}
+		}
+	}
+
+	test_space.step(20);
+	// Push a corner of the pile, so that contacts are created and removed while rolling back.
+	test_space->body_set_state(bodies[bodies.size() - 1], PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(-4, 2, -4));
+
+	RollbackResult result;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	const Vector<uint8_t> state = test_space->space_save_state(test_space.space);
+	result.save_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	result.state_size = state.size();
+	result.state_reproducible = test_space->space_save_state(test_space.space) == state;
+
+	test_space.step(p_frames);
+	result.hash = hash_bodies(test_space.server, bodies);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	test_space->space_restore_state(test_space.space, state);
+	result.restore_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	test_space.step(p_frames);
+	result.resimulate_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	result.rollback_hash = hash_bodies(test_space.server, bodies);
+	return result;
+}
+
+struct LiftedStackResult {
+	real_t restored_impulse = 0.0;
+	int settle_iterations = 0;
+};
+
+// Lets a stack of boxes come to rest on the floor, then lifts the whole stack so that it falls back on the same features.
+// Measures the impulses the boxes start with when they touch again, and the solver iterations until the stack rests again.
+static LiftedStackResult simulate_lifted_stack(int p_contact_cache_steps, int p_height, int p_solver_iterations) {
+	TestSpace test_space({ { "physics/3d/solver/contact_cache_steps", p_contact_cache_steps } });
+	GodotPhysicsServer3D *server = test_space.server;
+	server->space_set_param(test_space.space, PhysicsServer3D::SPACE_PARAM_SOLVER_ITERATIONS, p_solver_iterations);
+	RID floor = test_space.create_floor(Vector3(5, 0.5, 5));
+
+	RID box_shape = test_space.create_box_shape(Vector3(0.5, 0.5, 0.5));
+	LocalVector<RID> boxes;
+	for (int y = 0; y < p_height; y++) {
+		RID box = test_space.create_body(PhysicsServer3D::BODY_MODE_RIGID, box_shape, Transform3D(Basis(), Vector3(0, 0.5 + y, 0)));
+		server->body_set_max_contacts_reported(box, 8);
+		server->body_set_state(box, PhysicsServer3D::BODY_STATE_CAN_SLEEP, false);
+		server->body_set_space(box, test_space.space);
+		boxes.push_back(box);
+	}
+
+	test_space.step(120);
+
+	// Higher than the allowed penetration, so that every contact with the floor breaks.
+	for (const RID &box : boxes) {
+		Transform3D transform = server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		transform.origin.y += 0.03;
+		server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, transform);
+		server->body_set_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3());
+		server->body_set_state(box, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY, Vector3());
+	}
+
+	LiftedStackResult result;
+	bool landed = false;
+	for (int i = 0; i < 300; i++) {
+		server->step(1.0 / 60.0);
+		result.settle_iterations += p_solver_iterations;
+
+		PhysicsDirectBodyState3D *bottom = server->body_get_direct_state(boxes[0]);
+		bool touching_floor = false;
+		for (int j = 0; j < bottom->get_contact_count(); j++) {
+			if (bottom->get_contact_collider(j) == floor) {
+				touching_floor = true;
+				if (!landed) {
+					// Contacts report their impulses before solving, which is what they were warm started with.
+					result.restored_impulse += bottom->get_contact_impulse(j).length();
+				}
+			}
+		}
+		landed = landed || touching_floor;
+
+		bool resting = landed && touching_floor;
+		for (const RID &box : boxes) {
+			const Vector3 linear_velocity = server->body_get_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+			resting = resting && linear_velocity.length() < 0.01;
+		}
+		if (resting) {
+			break;
+		}
+	}
+	return result;
+}
+
+// Spins a thin plank in place next to a thin wall, half a turn per step, so that it never overlaps the wall at the end of a step.
+static real_t simulate_spinning_plank(bool p_continuous_collision_detection, int p_steps) {
+	TestSpace test_space;
+	GodotPhysicsServer3D *server = test_space.server;
+
+	RID wall = test_space.create_body(PhysicsServer3D::BODY_MODE_STATIC, test_space.create_box_shape(Vector3(0.02, 2, 2)), Transform3D(Basis(), Vector3(0.3, 0, 0)));
+	server->body_set_space(wall, test_space.space);
+
+	RID plank = test_space.create_body(PhysicsServer3D::BODY_MODE_RIGID, test_space.create_box_shape(Vector3(0.02, 0.1, 0.5)), Transform3D());
+	server->body_set_param(plank, PhysicsServer3D::BODY_PARAM_GRAVITY_SCALE, 0.0);
+	server->body_set_enable_continuous_collision_detection(plank, p_continuous_collision_detection);
+	server->body_set_state(plank, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(0.01, 0, 0));
+	server->body_set_state(plank, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY, Vector3(0, Math_PI * 60.0, 0));
+	server->body_set_space(plank, test_space.space);
+
+	test_space.step(p_steps);
+
+	const Vector3 angular_velocity = server->body_get_state(plank, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY);
+	return angular_velocity.length();
+}
+
+TEST_CASE("[Physics][GodotStep3D] Split islands are solved the same with any number of threads") {
+	const StackResult serial = simulate_stack(1, 6, 3, 20);
+	CHECK(serial.island_count == 1);
+
+	const int thread_count = WorkerThreadPool::get_singleton()->get_thread_count();
+	for (int threads = 2; threads <= MAX(thread_count, 2); threads *= 2) {
+		const StackResult parallel = simulate_stack(threads, 6, 3, 20);
+		CHECK_MESSAGE(transforms_identical(serial.transforms, parallel.transforms), "Results with ", threads, " threads should be identical to the results with a single thread.");
+	}
+}
+
+TEST_CASE("[Physics][GodotStep3D] Continuous collision detection stops fast spinning bodies at thin walls") {
+	TestSpace test_space;
+	GodotPhysicsServer3D *server = test_space.server;
+
+	RID wall = test_space.create_body(PhysicsServer3D::BODY_MODE_STATIC, test_space.create_box_shape(Vector3(0.05, 2, 2)), Transform3D());
+	server->body_set_space(wall, test_space.space);
+
+	// A thin plank, moving several times its length per step and spinning.
+	RID plank = test_space.create_body(PhysicsServer3D::BODY_MODE_RIGID, test_space.create_box_shape(Vector3(0.5, 0.02, 0.1)), Transform3D(Basis(), Vector3(-5, 0, 0)));
+	server->body_set_param(plank, PhysicsServer3D::BODY_PARAM_GRAVITY_SCALE, 0.0);
+	server->body_set_enable_continuous_collision_detection(plank, true);
+	server->body_set_state(plank, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(300, 0, 0));
+	server->body_set_state(plank, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY, Vector3(0, 20, 0));
+	server->body_set_space(plank, test_space.space);
+
+	test_space.step(10);
+
+	Transform3D transform = server->body_get_state(plank, PhysicsServer3D::BODY_STATE_TRANSFORM);
+	CHECK_MESSAGE(transform.origin.x < 0.0, "The plank should not go through the wall.");
+}
+
+TEST_CASE("[Physics][GodotStep3D] Free falling bodies are integrated the same with any number of threads") {
+	// Enough bodies for the integration to be split across threads.
+	const FreeFallResult serial = simulate_free_fall(1, 1024, 10);
+	const FreeFallResult parallel = simulate_free_fall(4, 1024, 10);
+	REQUIRE(serial.transforms.size() == 1024);
+	REQUIRE(parallel.transforms.size() == serial.transforms.size());
+
+	bool identical = true;
+	bool all_falling = true;
+	for (uint32_t i = 0; i < serial.transforms.size(); i++) {
+		identical = identical && serial.transforms[i] == parallel.transforms[i] && serial.linear_velocities[i] == parallel.linear_velocities[i];
+		all_falling = all_falling && serial.transforms[i].origin.y < 100.0 && serial.linear_velocities[i].y < 0.0;
+		all_falling = all_falling && serial.linear_velocities[i] == serial.linear_velocities[0];
+	}
+	CHECK_MESSAGE(all_falling, "Every body should have been integrated the same way.");
+	CHECK_MESSAGE(identical, "Results with 4 threads should be identical to the results with a single thread.");
+}
+
+TEST_CASE("[Physics][GodotStep3D] Continuous collision detection stops bodies spinning in place at thin walls") {
+	const real_t initial_speed = Math_PI * 60.0;
+	CHECK_MESSAGE(simulate_spinning_plank(false, 4) > initial_speed * 0.9, "Without continuous collision detection, the plank should spin through the wall.");
+	CHECK_MESSAGE(simulate_spinning_plank(true, 4) < initial_speed * 0.5, "The rotation of the plank should be stopped by the wall.");
+}
+
+TEST_CASE("[Physics][GodotStep3D] Continuous collision detection doesn't slow down fast bodies sliding on others") {
+	TestSpace test_space;
+	GodotPhysicsServer3D *server = test_space.server;
+
+	RID floor = test_space.create_floor(Vector3(500, 0.5, 5));
+	server->body_set_param(floor, PhysicsServer3D::BODY_PARAM_FRICTION, 0.0);
+
+	RID box = test_space.create_body(PhysicsServer3D::BODY_MODE_RIGID, test_space.create_box_shape(Vector3(0.25, 0.25, 0.25)), Transform3D(Basis(), Vector3(-450, 0.25, 0)));
+	server->body_set_param(box, PhysicsServer3D::BODY_PARAM_FRICTION, 0.0);
+	server->body_set_param(box, PhysicsServer3D::BODY_PARAM_LINEAR_DAMP_MODE, PhysicsServer3D::BODY_DAMP_MODE_REPLACE);
+	server->body_set_param(box, PhysicsServer3D::BODY_PARAM_LINEAR_DAMP, 0.0);
+	server->body_set_enable_continuous_collision_detection(box, true);
+	server->body_set_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(50, 0, 0));
+	server->body_set_space(box, test_space.space);
+
+	real_t min_speed = 50.0;
+	for (int i = 0; i < 60; i++) {
+		server->step(1.0 / 60.0);
+		const Vector3 linear_velocity = server->body_get_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+		min_speed = MIN(min_speed, linear_velocity.x);
+	}
+
+	const Transform3D transform = server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+	CHECK_MESSAGE(min_speed > 45.0, "The box should keep sliding at full speed, its slowest speed was ", min_speed, ".");
+	CHECK_MESSAGE(transform.origin.y > 0.0, "The box should stay on the floor.");
+}
+
+TEST_CASE("[Physics][GodotStep3D] Contacts touching again are warm started from the contact cache") {
+	const LiftedStackResult cached = simulate_lifted_stack(8, 1, 16);
+	CHECK_MESSAGE(cached.restored_impulse > 0.0, "Contacts with the floor should get their accumulated impulses back when touching again.");
+
+	const LiftedStackResult uncached = simulate_lifted_stack(0, 1, 16);
+	CHECK_MESSAGE(uncached.restored_impulse == 0.0, "Without the contact cache, contacts touching again should start without impulses.");
+}
+
+TEST_CASE("[Physics][GodotStep3D] Stacks touching again settle in fewer solver iterations with the contact cache") {
+	const LiftedStackResult cached = simulate_lifted_stack(8, 4, 4);
+	const LiftedStackResult uncached = simulate_lifted_stack(0, 4, 4);
+	CHECK(cached.restored_impulse > 0.0);
+	CHECK_MESSAGE(cached.settle_iterations < uncached.settle_iterations, "Warm started contacts should need ", cached.settle_iterations, " solver iterations to rest, fewer than the ", uncached.settle_iterations, " without the cache.");
+}
+
+TEST_CASE("[Physics][GodotStep3D] Deterministic mode gives the same state regardless of threads and insertion order") {
+	const uint32_t serial_hash = simulate_deterministic(1, false, 60);
+
+	for (int threads : { 2, 8 }) {
+		CHECK_MESSAGE(simulate_deterministic(threads, false, 60) == serial_hash, "State hash with ", threads, " threads should match the one with a single thread.");
+	}
+	CHECK_MESSAGE(simulate_deterministic(1, true, 60) == serial_hash, "State hash should not depend on the order bodies were added to the space.");
+	CHECK_MESSAGE(simulate_deterministic(8, true, 60) == serial_hash, "State hash should not depend on the order bodies were added to the space.");
+}
+
+TEST_CASE("[Physics][GodotStep3D] Restoring a saved space state re-simulates the same frames") {
+	const RollbackResult result = simulate_rollback(6, 3, 30);
+	CHECK(result.state_size > 0);
+	CHECK_MESSAGE(result.state_reproducible, "Saving the same state twice should give the same bytes.");
+	CHECK_MESSAGE(result.rollback_hash == result.hash, "State hash after rolling back and re-simulating should match the original one.");
+}
+
+TEST_CASE("[Physics][GodotStep3D][Benchmark] Stacking scales with the number of threads") {
+	const int thread_count = WorkerThreadPool::get_singleton()->get_thread_count();
+	const StackResult serial = simulate_stack(1, 16, 4, 60);
+	const uint64_t serial_usec = serial.step_usec;
+	CHECK(serial.island_count == 1);
+	MESSAGE("Stack of 1024 boxes with 1 thread: ", serial_usec, " usec per step.");
+
+	for (int threads = 2; threads <= thread_count; threads *= 2) {
+		const StackResult parallel = simulate_stack(threads, 16, 4, 60);
+		const uint64_t usec = parallel.step_usec;
+		CHECK_MESSAGE(transforms_identical(serial.transforms, parallel.transforms), "Results with ", threads, " threads should be identical to the results with a single thread.");
+		MESSAGE("Stack of 1024 boxes with ", threads, " threads: ", usec, " usec per step (", String::num(double(serial_usec) / MAX(usec, uint64_t(1)), 2), "x).");
+	}
+}
+
+TEST_CASE("[Physics][GodotStep3D][Benchmark] Integration of free falling bodies") {
+	const int thread_count = WorkerThreadPool::get_singleton()->get_thread_count();
+	const uint64_t serial_usec = simulate_free_fall(1, 100000, 10).step_usec;
+	MESSAGE("100000 free falling bodies with 1 thread: ", serial_usec, " usec per step.");
+
+	const uint64_t parallel_usec = simulate_free_fall(-1, 100000, 10).step_usec;
+	MESSAGE("100000 free falling bodies with ", thread_count, " threads: ", parallel_usec, " usec per step (", String::num(double(serial_usec) / MAX(parallel_usec, uint64_t(1)), 2), "x).");
+}
+
+TEST_CASE("[Physics][GodotStep3D][Benchmark] Rolling back 8 frames") {
+	const RollbackResult result = simulate_rollback(26, 3, 8);
+	CHECK(result.state_size > 0);
+	CHECK_MESSAGE(result.rollback_hash == result.hash, "State hash after rolling back and re-simulating should match the original one.");
+	MESSAGE("Rolling back 2028 bodies: ", result.state_size, " bytes of state, saved in ", result.save_usec, " usec, restored in ", result.restore_usec, " usec, 8 frames re-simulated in ", result.resimulate_usec, " usec.");
+}
+
+} // namespace TestGodotStep3D
+
+#endif // TEST_GODOT_STEP_3D_H
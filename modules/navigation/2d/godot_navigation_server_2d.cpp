@@ -265,6 +265,10 @@ uint32_t GodotNavigationServer2D::map_get_iteration_id(RID p_map) const {
 	return NavigationServer3D::get_singleton()->map_get_iteration_id(p_map);
 }
 
+Dictionary GodotNavigationServer2D::map_get_profile(RID p_map) const {
+	return NavigationServer3D::get_singleton()->map_get_profile(p_map);
+}
+
 void FORWARD_2(map_set_cell_size, RID, p_map, real_t, p_cell_size, rid_to_rid, real_to_real);
 real_t FORWARD_1_C(map_get_cell_size, RID, p_map, rid_to_rid);
 
@@ -468,6 +472,44 @@ void GodotNavigationServer2D::query_path(const Ref<NavigationPathQueryParameters
 	p_query_result->set_path_owner_ids(_query_result.path_owner_ids);
 }
 
+struct PathQueryBatch2D : public NavigationUtilities::PathQueryBatch {
+	TypedArray<NavigationPathQueryResult2D> query_results;
+	Callable callback;
+
+	virtual void finish() override {
+		for (uint32_t i = 0; i < results.size(); i++) {
+			Ref<NavigationPathQueryResult2D> query_result = query_results[i];
+			query_result->set_path(vector_v3_to_v2(results[i].path));
+			query_result->set_path_types(results[i].path_types);
+			query_result->set_path_rids(results[i].path_rids);
+			query_result->set_path_owner_ids(results[i].path_owner_ids);
+		}
+		if (callback.is_valid()) {
+			callback.call();
+		}
+	}
+};
+
+void GodotNavigationServer2D::query_path_batch(const TypedArray<NavigationPathQueryParameters2D> &p_query_parameters, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback) {
+	ERR_FAIL_COND_MSG(p_query_parameters.size() != p_query_results.size(), "The number of query parameters and query results must match.");
+
+	PathQueryBatch2D *batch = memnew(PathQueryBatch2D);
+	batch->parameters.resize(p_query_parameters.size());
+	for (int i = 0; i < p_query_parameters.size(); i++) {
+		Ref<NavigationPathQueryParameters2D> query_parameters = p_query_parameters[i];
+		Ref<NavigationPathQueryResult2D> query_result = p_query_results[i];
+		if (query_parameters.is_null() || query_result.is_null()) {
+			memdelete(batch);
+			ERR_FAIL_MSG(vformat("Invalid query parameters or result at index %d.", i));
+		}
+		batch->parameters[i] = query_parameters->get_parameters();
+	}
+	batch->query_results = p_query_results;
+	batch->callback = p_callback;
+
+	NavigationServer3D::get_singleton()->_query_path_batch(batch, p_callback.is_valid());
+}
+
 RID GodotNavigationServer2D::source_geometry_parser_create() {
 #ifdef CLIPPER2_ENABLED
 	if (navmesh_generator_2d) {
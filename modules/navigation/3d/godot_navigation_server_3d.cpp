@@ -35,6 +35,7 @@
 
 #ifndef _3D_DISABLED
 #include "nav_mesh_generator_3d.h"
+#include "nav_mesh_tiles_3d.h"
 #endif // _3D_DISABLED
 
 using namespace NavigationUtilities;
@@ -244,6 +245,30 @@ Vector<Vector3> GodotNavigationServer3D::map_get_path(RID p_map, Vector3 p_origi
 	return map->get_path(p_origin, p_destination, p_optimize, p_navigation_layers, nullptr, nullptr, nullptr);
 }
 
+Vector3 GodotNavigationServer3D::map_get_flow_direction(RID p_map, const Vector3 &p_target, const Vector3 &p_position, uint32_t p_navigation_layers) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, Vector3());
+
+	Vector3 direction;
+	real_t cost = 0.0;
+	if (!map->get_flow(p_target, p_position, p_navigation_layers, direction, cost)) {
+		return Vector3();
+	}
+	return direction;
+}
+
+real_t GodotNavigationServer3D::map_get_flow_cost(RID p_map, const Vector3 &p_target, const Vector3 &p_position, uint32_t p_navigation_layers) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, INFINITY);
+
+	Vector3 direction;
+	real_t cost = 0.0;
+	if (!map->get_flow(p_target, p_position, p_navigation_layers, direction, cost)) {
+		return INFINITY;
+	}
+	return cost;
+}
+
 Vector3 GodotNavigationServer3D::map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	const NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_NULL_V(map, Vector3());
@@ -1169,7 +1194,73 @@ bool GodotNavigationServer3D::is_baking_navigation_mesh(Ref<NavigationMesh> p_na
 #endif // _3D_DISABLED
 }
 
+void GodotNavigationServer3D::map_bake_tiles(RID p_map, const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, real_t p_tile_size, const AABB &p_dirty_aabb, const Callable &p_callback) {
+#ifndef _3D_DISABLED
+	ERR_FAIL_COND_MSG(!map_owner.owns(p_map), "Invalid navigation map.");
+	ERR_FAIL_COND_MSG(!p_navigation_mesh.is_valid(), "Invalid navigation mesh.");
+	ERR_FAIL_COND_MSG(!p_source_geometry_data.is_valid(), "Invalid NavigationMeshSourceGeometryData3D.");
+
+	MutexLock lock(map_tiles_mutex);
+	NavMeshTiles3D **tiles = map_tiles.getptr(p_map);
+	if (tiles == nullptr) {
+		tiles = &map_tiles.insert(p_map, memnew(NavMeshTiles3D(p_map)))->value;
+	}
+	(*tiles)->bake(p_navigation_mesh, p_source_geometry_data, p_tile_size, p_dirty_aabb, p_callback);
+#endif // _3D_DISABLED
+}
+
+bool GodotNavigationServer3D::map_is_baking_tiles(RID p_map) const {
+#ifdef _3D_DISABLED
+	return false;
+#else
+	MutexLock lock(map_tiles_mutex);
+	NavMeshTiles3D *const *tiles = map_tiles.getptr(p_map);
+	return tiles != nullptr && (*tiles)->is_baking();
+#endif // _3D_DISABLED
+}
+
+TypedArray<RID> GodotNavigationServer3D::map_get_tile_regions(RID p_map) const {
+	TypedArray<RID> regions_rids;
+#ifndef _3D_DISABLED
+	MutexLock lock(map_tiles_mutex);
+	NavMeshTiles3D *const *tiles = map_tiles.getptr(p_map);
+	if (tiles == nullptr) {
+		return regions_rids;
+	}
+
+	for (const KeyValue<Vector2i, RID> &E : (*tiles)->get_tile_regions()) {
+		regions_rids.push_back(E.value);
+	}
+#endif // _3D_DISABLED
+	return regions_rids;
+}
+
+#ifndef _3D_DISABLED
+void GodotNavigationServer3D::_sync_map_tiles() {
+	MutexLock lock(map_tiles_mutex);
+
+	LocalVector<RID> freed_maps;
+	for (KeyValue<RID, NavMeshTiles3D *> &E : map_tiles) {
+		// The tiles of a freed map are cleaned up here rather than in the free command,
+		// since freeing their regions queues more commands.
+		if (!map_owner.owns(E.key)) {
+			freed_maps.push_back(E.key);
+			continue;
+		}
+		E.value->sync(false);
+	}
+
+	for (const RID &map : freed_maps) {
+		memdelete(map_tiles[map]);
+		map_tiles.erase(map);
+	}
+}
+#endif // _3D_DISABLED
+
 COMMAND_1(free, RID, p_object) {
+	// Batches running on worker threads may use the object.
+	_finish_path_query_batches(true);
+
 	if (map_owner.owns(p_object)) {
 		NavMap *map = map_owner.get_or_null(p_object);
 
@@ -1305,11 +1396,21 @@ uint32_t GodotNavigationServer3D::map_get_iteration_id(RID p_map) const {
 	return map->get_iteration_id();
 }
 
+Dictionary GodotNavigationServer3D::map_get_profile(RID p_map) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, Dictionary());
+
+	return map->get_profiler().get_profile();
+}
+
 void GodotNavigationServer3D::sync() {
+	_finish_path_query_batches(false);
+
 #ifndef _3D_DISABLED
 	if (navmesh_generator_3d) {
 		navmesh_generator_3d->sync();
 	}
+	_sync_map_tiles();
 #endif // _3D_DISABLED
 }
 
@@ -1330,6 +1431,8 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 	int _new_pm_edge_free_count = 0;
 	int _new_pm_obstacle_count = 0;
 
+	NavMapProfiler::Histogram stage_histograms[NavMapProfiler::STAGE_MAX];
+
 	// In c++ we can't be sure that this is performed in the main thread
 	// even with mutable functions.
 	MutexLock lock(operations_mutex);
@@ -1348,6 +1451,10 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 		_new_pm_edge_free_count += active_maps[i]->get_pm_edge_free_count();
 		_new_pm_obstacle_count += active_maps[i]->get_pm_obstacle_count();
 
+		for (int stage = 0; stage < NavMapProfiler::STAGE_MAX; stage++) {
+			stage_histograms[stage].merge(active_maps[i]->get_profiler().get_histogram(NavMapProfiler::Stage(stage)));
+		}
+
 		// Emit a signal if a map changed.
 		const uint32_t new_map_iteration_id = active_maps[i]->get_iteration_id();
 		if (new_map_iteration_id != active_maps_iteration_id[i]) {
@@ -1365,6 +1472,17 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 	pm_edge_connection_count = _new_pm_edge_connection_count;
 	pm_edge_free_count = _new_pm_edge_free_count;
 	pm_obstacle_count = _new_pm_obstacle_count;
+
+	const NavMapProfiler::Histogram &path_query_histogram = stage_histograms[NavMapProfiler::STAGE_PATH_QUERY];
+	const NavMapProfiler::Histogram &searched_polygons_histogram = stage_histograms[NavMapProfiler::STAGE_PATH_QUERY_SEARCHED_POLYGONS];
+	pm_sync_time = stage_histograms[NavMapProfiler::STAGE_SYNC].get_percentile(0.99);
+	pm_avoidance_time = stage_histograms[NavMapProfiler::STAGE_AVOIDANCE].get_percentile(0.99);
+	pm_callbacks_time = stage_histograms[NavMapProfiler::STAGE_CALLBACKS].get_percentile(0.99);
+	pm_path_query_count = path_query_histogram.count;
+	pm_path_query_time_p50 = path_query_histogram.get_percentile(0.5);
+	pm_path_query_time_p99 = path_query_histogram.get_percentile(0.99);
+	pm_path_query_searched_polygons_p50 = searched_polygons_histogram.get_percentile(0.5);
+	pm_path_query_searched_polygons_p99 = searched_polygons_histogram.get_percentile(0.99);
 }
 
 void GodotNavigationServer3D::init() {
@@ -1375,7 +1493,15 @@ void GodotNavigationServer3D::init() {
 
 void GodotNavigationServer3D::finish() {
 	flush_queries();
+	_finish_path_query_batches(true);
 #ifndef _3D_DISABLED
+	{
+		MutexLock lock(map_tiles_mutex);
+		for (KeyValue<RID, NavMeshTiles3D *> &E : map_tiles) {
+			memdelete(E.value);
+		}
+		map_tiles.clear();
+	}
 	if (navmesh_generator_3d) {
 		navmesh_generator_3d->finish();
 		memdelete(navmesh_generator_3d);
@@ -1385,33 +1511,112 @@ void GodotNavigationServer3D::finish() {
 }
 
 PathQueryResult GodotNavigationServer3D::_query_path(const PathQueryParameters &p_parameters) const {
+	return _query_path(map_owner.get_or_null(p_parameters.map), p_parameters, nullptr);
+}
+
+void GodotNavigationServer3D::_query_path_batch_thread(void *p_task, uint32_t p_worker) {
+	PathQueryBatchTask *task = static_cast<PathQueryBatchTask *>(p_task);
+	NavigationUtilities::PathQueryBatch *batch = task->batch;
+
+	// Each worker takes the next query until there are none left, reusing its search buffers.
+	gd::PathSearchBuffers buffers;
+	for (uint32_t i = task->next_query.postincrement(); i < batch->parameters.size(); i = task->next_query.postincrement()) {
+		batch->results[i] = task->server->_query_path(task->maps[i], batch->parameters[i], &buffers);
+	}
+}
+
+void GodotNavigationServer3D::_query_path_batch(PathQueryBatch *p_batch, bool p_async) {
+	ERR_FAIL_NULL(p_batch);
+
+	p_batch->results.resize(p_batch->parameters.size());
+	if (p_batch->parameters.is_empty()) {
+		p_batch->finish();
+		memdelete(p_batch);
+		return;
+	}
+
+	PathQueryBatchTask *task = memnew(PathQueryBatchTask);
+	task->server = this;
+	task->batch = p_batch;
+	// Maps can't be freed while the batch runs, free() waits for the batches to finish.
+	task->maps.resize(p_batch->parameters.size());
+	for (uint32_t i = 0; i < p_batch->parameters.size(); i++) {
+		task->maps[i] = map_owner.get_or_null(p_batch->parameters[i].map);
+	}
+
+	const uint32_t worker_count = MIN(uint32_t(MAX(WorkerThreadPool::get_singleton()->get_thread_count(), 1)), p_batch->parameters.size());
+	const WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_native_group_task(&GodotNavigationServer3D::_query_path_batch_thread, task, worker_count, worker_count, false, SNAME("NavigationServerPathQueryBatch"));
+
+	if (!p_async) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+		p_batch->finish();
+		memdelete(p_batch);
+		memdelete(task);
+		return;
+	}
+
+	MutexLock lock(path_query_batch_mutex);
+	path_query_batch_tasks.insert(group_id, task);
+}
+
+void GodotNavigationServer3D::_finish_path_query_batches(bool p_wait) {
+	LocalVector<PathQueryBatchTask *> finished_tasks;
+	{
+		MutexLock lock(path_query_batch_mutex);
+		if (path_query_batch_tasks.is_empty()) {
+			return;
+		}
+
+		LocalVector<WorkerThreadPool::GroupID> finished_group_ids;
+		for (const KeyValue<WorkerThreadPool::GroupID, PathQueryBatchTask *> &E : path_query_batch_tasks) {
+			if (p_wait || WorkerThreadPool::get_singleton()->is_group_task_completed(E.key)) {
+				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(E.key);
+				finished_group_ids.push_back(E.key);
+				finished_tasks.push_back(E.value);
+			}
+		}
+		for (WorkerThreadPool::GroupID group_id : finished_group_ids) {
+			path_query_batch_tasks.erase(group_id);
+		}
+	}
+
+	// The callbacks may start new batches.
+	for (PathQueryBatchTask *task : finished_tasks) {
+		task->batch->finish();
+		memdelete(task->batch);
+		memdelete(task);
+	}
+}
+
+PathQueryResult GodotNavigationServer3D::_query_path(const NavMap *p_map, const PathQueryParameters &p_parameters, gd::PathSearchBuffers *p_buffers) const {
 	PathQueryResult r_query_result;
 
-	const NavMap *map = map_owner.get_or_null(p_parameters.map);
-	ERR_FAIL_NULL_V(map, r_query_result);
+	ERR_FAIL_NULL_V(p_map, r_query_result);
 
 	// run the pathfinding
 
 	if (p_parameters.pathfinding_algorithm == PathfindingAlgorithm::PATHFINDING_ALGORITHM_ASTAR) {
 		// while postprocessing is still part of map.get_path() need to check and route it here for the correct "optimize" post-processing
 		if (p_parameters.path_postprocessing == PathPostProcessing::PATH_POSTPROCESSING_CORRIDORFUNNEL) {
-			r_query_result.path = map->get_path(
+			r_query_result.path = p_map->get_path(
 					p_parameters.start_position,
 					p_parameters.target_position,
 					true,
 					p_parameters.navigation_layers,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_TYPES) ? &r_query_result.path_types : nullptr,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_RIDS) ? &r_query_result.path_rids : nullptr,
-					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr);
+					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr,
+					nullptr, p_buffers);
 		} else if (p_parameters.path_postprocessing == PathPostProcessing::PATH_POSTPROCESSING_EDGECENTERED) {
-			r_query_result.path = map->get_path(
+			r_query_result.path = p_map->get_path(
 					p_parameters.start_position,
 					p_parameters.target_position,
 					false,
 					p_parameters.navigation_layers,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_TYPES) ? &r_query_result.path_types : nullptr,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_RIDS) ? &r_query_result.path_rids : nullptr,
-					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr);
+					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr,
+					nullptr, p_buffers);
 		}
 	} else {
 		return r_query_result;
@@ -1602,6 +1807,30 @@ int GodotNavigationServer3D::get_process_info(ProcessInfo p_info) const {
 		case INFO_OBSTACLE_COUNT: {
 			return pm_obstacle_count;
 		} break;
+		case INFO_SYNC_TIME: {
+			return pm_sync_time;
+		} break;
+		case INFO_AVOIDANCE_TIME: {
+			return pm_avoidance_time;
+		} break;
+		case INFO_CALLBACKS_TIME: {
+			return pm_callbacks_time;
+		} break;
+		case INFO_PATH_QUERY_COUNT: {
+			return pm_path_query_count;
+		} break;
+		case INFO_PATH_QUERY_TIME_P50: {
+			return pm_path_query_time_p50;
+		} break;
+		case INFO_PATH_QUERY_TIME_P99: {
+			return pm_path_query_time_p99;
+		} break;
+		case INFO_PATH_QUERY_SEARCHED_POLYGONS_P50: {
+			return pm_path_query_searched_polygons_p50;
+		} break;
+		case INFO_PATH_QUERY_SEARCHED_POLYGONS_P99: {
+			return pm_path_query_searched_polygons_p99;
+		} break;
 	}
 
 	return 0;
@@ -58,6 +58,7 @@
 class GodotNavigationServer3D;
 #ifndef _3D_DISABLED
 class NavMeshGenerator3D;
+class NavMeshTiles3D;
 #endif // _3D_DISABLED
 
 struct SetCommand {
@@ -84,6 +85,12 @@ class GodotNavigationServer3D : public NavigationServer3D {
 
 #ifndef _3D_DISABLED
 	NavMeshGenerator3D *navmesh_generator_3d = nullptr;
+
+	/// Tiled navigation meshes baked with `map_bake_tiles`.
+	mutable Mutex map_tiles_mutex;
+	HashMap<RID, NavMeshTiles3D *> map_tiles;
+
+	void _sync_map_tiles();
 #endif // _3D_DISABLED
 
 	// Performance Monitor
@@ -96,6 +103,31 @@ class GodotNavigationServer3D : public NavigationServer3D {
 	int pm_edge_connection_count = 0;
 	int pm_edge_free_count = 0;
 	int pm_obstacle_count = 0;
+	// Timings in microseconds, over the last second of all active maps.
+	int pm_sync_time = 0;
+	int pm_avoidance_time = 0;
+	int pm_callbacks_time = 0;
+	int pm_path_query_count = 0;
+	int pm_path_query_time_p50 = 0;
+	int pm_path_query_time_p99 = 0;
+	int pm_path_query_searched_polygons_p50 = 0;
+	int pm_path_query_searched_polygons_p99 = 0;
+
+	/// Path query batches running on worker threads.
+	struct PathQueryBatchTask {
+		const GodotNavigationServer3D *server = nullptr;
+		NavigationUtilities::PathQueryBatch *batch = nullptr;
+		// Resolved on the calling thread, as the map owner is not safe to read from the workers.
+		LocalVector<const NavMap *> maps;
+		SafeNumeric<uint32_t> next_query;
+	};
+	Mutex path_query_batch_mutex;
+	HashMap<WorkerThreadPool::GroupID, PathQueryBatchTask *> path_query_batch_tasks;
+
+	static void _query_path_batch_thread(void *p_task, uint32_t p_worker);
+	void _finish_path_query_batches(bool p_wait);
+
+	NavigationUtilities::PathQueryResult _query_path(const NavMap *p_map, const NavigationUtilities::PathQueryParameters &p_parameters, gd::PathSearchBuffers *p_buffers) const;
 
 public:
 	GodotNavigationServer3D();
@@ -131,6 +163,8 @@ public:
 	virtual real_t map_get_link_connection_radius(RID p_map) const override;
 
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const override;
+	virtual Vector3 map_get_flow_direction(RID p_map, const Vector3 &p_target, const Vector3 &p_position, uint32_t p_navigation_layers = 1) const override;
+	virtual real_t map_get_flow_cost(RID p_map, const Vector3 &p_target, const Vector3 &p_position, uint32_t p_navigation_layers = 1) const override;
 
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const override;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const override;
@@ -144,6 +178,7 @@ public:
 
 	virtual void map_force_update(RID p_map) override;
 	virtual uint32_t map_get_iteration_id(RID p_map) const override;
+	virtual Dictionary map_get_profile(RID p_map) const override;
 
 	virtual Vector3 map_get_random_point(RID p_map, uint32_t p_navigation_layers, bool p_uniformly) const override;
 
@@ -267,6 +302,9 @@ public:
 	virtual void bake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override;
 	virtual void bake_from_source_geometry_data_async(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override;
 	virtual bool is_baking_navigation_mesh(Ref<NavigationMesh> p_navigation_mesh) const override;
+	virtual void map_bake_tiles(RID p_map, const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, real_t p_tile_size, const AABB &p_dirty_aabb = AABB(), const Callable &p_callback = Callable()) override;
+	virtual bool map_is_baking_tiles(RID p_map) const override;
+	virtual TypedArray<RID> map_get_tile_regions(RID p_map) const override;
 
 	virtual RID source_geometry_parser_create() override;
 	virtual void source_geometry_parser_set_callback(RID p_parser, const Callable &p_callback) override;
@@ -289,6 +327,7 @@ public:
 	virtual void finish() override;
 
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const override;
+	virtual void _query_path_batch(NavigationUtilities::PathQueryBatch *p_batch, bool p_async) override;
 
 	int get_process_info(ProcessInfo p_info) const override;
 
@@ -0,0 +1,327 @@
+/**************************************************************************/
+/*  nav_mesh_flow_field_3d.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef _3D_DISABLED
+
+#include "nav_mesh_flow_field_3d.h"
+
+#include "../nav_base.h"
+
+#include "core/math/face3.h"
+#include "core/math/geometry_3d.h"
+
+struct FlowFieldNode {
+	real_t cost = 0.0;
+	uint32_t polygon = 0;
+};
+
+struct FlowFieldNodeCostGreaterThan {
+	bool operator()(const FlowFieldNode &p_node_a, const FlowFieldNode &p_node_b) const {
+		return p_node_a.cost > p_node_b.cost;
+	}
+};
+
+struct FlowFieldConnection {
+	uint32_t polygon = 0;
+	Vector3 pathway_start;
+	Vector3 pathway_end;
+};
+
+void NavMeshFlowField3D::_build_grid(uint32_t p_polygon_count) {
+	grid_cell_offsets.clear();
+	grid_polygons.clear();
+
+	bool first_point = true;
+	real_t min_x = 0.0;
+	real_t max_x = 0.0;
+	real_t min_z = 0.0;
+	real_t max_z = 0.0;
+	uint32_t polygon_count = 0;
+	for (uint32_t i = 0; i < p_polygon_count; i++) {
+		const gd::Polygon *polygon = polygons[i];
+		if ((navigation_layers & polygon->owner->get_navigation_layers()) == 0) {
+			continue;
+		}
+		polygon_count++;
+		for (const gd::Point &point : polygon->points) {
+			if (first_point) {
+				first_point = false;
+				min_x = max_x = point.pos.x;
+				min_z = max_z = point.pos.z;
+			} else {
+				min_x = MIN(min_x, point.pos.x);
+				max_x = MAX(max_x, point.pos.x);
+				min_z = MIN(min_z, point.pos.z);
+				max_z = MAX(max_z, point.pos.z);
+			}
+		}
+	}
+
+	if (polygon_count == 0) {
+		grid_size = Vector2i();
+		return;
+	}
+
+	// Cells of about four polygons.
+	grid_cell_size = MAX(Math::sqrt((max_x - min_x) * (max_z - min_z) / polygon_count) * 2.0, (real_t)0.1);
+	grid_begin = Vector2i((int)Math::floor(min_x / grid_cell_size), (int)Math::floor(min_z / grid_cell_size));
+	grid_size = Vector2i((int)Math::floor(max_x / grid_cell_size), (int)Math::floor(max_z / grid_cell_size)) - grid_begin + Vector2i(1, 1);
+
+	// Counts the polygons of each cell first, then fills the cells.
+	grid_cell_offsets.resize(grid_size.x * grid_size.y + 1);
+	for (uint32_t &offset : grid_cell_offsets) {
+		offset = 0;
+	}
+
+	for (int pass = 0; pass < 2; pass++) {
+		for (uint32_t i = 0; i < p_polygon_count; i++) {
+			const gd::Polygon *polygon = polygons[i];
+			if ((navigation_layers & polygon->owner->get_navigation_layers()) == 0) {
+				continue;
+			}
+
+			real_t polygon_min_x = polygon->points[0].pos.x;
+			real_t polygon_max_x = polygon_min_x;
+			real_t polygon_min_z = polygon->points[0].pos.z;
+			real_t polygon_max_z = polygon_min_z;
+			for (const gd::Point &point : polygon->points) {
+				polygon_min_x = MIN(polygon_min_x, point.pos.x);
+				polygon_max_x = MAX(polygon_max_x, point.pos.x);
+				polygon_min_z = MIN(polygon_min_z, point.pos.z);
+				polygon_max_z = MAX(polygon_max_z, point.pos.z);
+			}
+
+			const int begin_x = (int)Math::floor(polygon_min_x / grid_cell_size) - grid_begin.x;
+			const int end_x = (int)Math::floor(polygon_max_x / grid_cell_size) - grid_begin.x;
+			const int begin_z = (int)Math::floor(polygon_min_z / grid_cell_size) - grid_begin.y;
+			const int end_z = (int)Math::floor(polygon_max_z / grid_cell_size) - grid_begin.y;
+			for (int z = begin_z; z <= end_z; z++) {
+				for (int x = begin_x; x <= end_x; x++) {
+					const uint32_t cell = z * grid_size.x + x;
+					if (pass == 0) {
+						grid_cell_offsets[cell + 1]++;
+					} else {
+						grid_polygons[grid_cell_offsets[cell]++] = i;
+					}
+				}
+			}
+		}
+
+		if (pass == 0) {
+			for (uint32_t cell = 1; cell < grid_cell_offsets.size(); cell++) {
+				grid_cell_offsets[cell] += grid_cell_offsets[cell - 1];
+			}
+			grid_polygons.resize(grid_cell_offsets[grid_cell_offsets.size() - 1]);
+		}
+	}
+
+	// Filling moved each offset to the start of the next cell.
+	for (uint32_t cell = grid_cell_offsets.size() - 1; cell > 0; cell--) {
+		grid_cell_offsets[cell] = grid_cell_offsets[cell - 1];
+	}
+	grid_cell_offsets[0] = 0;
+}
+
+const gd::Polygon *NavMeshFlowField3D::_find_polygon(const Vector3 &p_position, Vector3 &r_point) const {
+	const int x = (int)Math::floor(p_position.x / grid_cell_size) - grid_begin.x;
+	const int z = (int)Math::floor(p_position.z / grid_cell_size) - grid_begin.y;
+	if (x < 0 || z < 0 || x >= grid_size.x || z >= grid_size.y) {
+		return nullptr;
+	}
+
+	const gd::Polygon *closest_polygon = nullptr;
+	real_t closest_distance = FLT_MAX;
+	const uint32_t cell = z * grid_size.x + x;
+	for (uint32_t i = grid_cell_offsets[cell]; i < grid_cell_offsets[cell + 1]; i++) {
+		const gd::Polygon *polygon = polygons[grid_polygons[i]];
+		for (uint32_t point_id = 2; point_id < polygon->points.size(); point_id++) {
+			const Face3 face(polygon->points[0].pos, polygon->points[point_id - 1].pos, polygon->points[point_id].pos);
+			const Vector3 point = face.get_closest_point_to(p_position);
+			const real_t distance = point.distance_to(p_position);
+			if (distance < closest_distance) {
+				closest_distance = distance;
+				closest_polygon = polygon;
+				r_point = point;
+			}
+		}
+	}
+	return closest_polygon;
+}
+
+void NavMeshFlowField3D::build(const LocalVector<gd::Polygon> &p_polygons, const LocalVector<gd::Polygon> &p_link_polygons, uint32_t p_link_polygon_count, const Vector3 &p_target, uint32_t p_navigation_layers) {
+	ERR_FAIL_COND(p_link_polygon_count > p_link_polygons.size());
+	navigation_layers = p_navigation_layers;
+	target = p_target;
+
+	const uint32_t polygon_count = p_polygons.size() + p_link_polygon_count;
+	polygons.resize(polygon_count);
+	for (uint32_t i = 0; i < p_polygons.size(); i++) {
+		polygons[i] = &p_polygons[i];
+	}
+	for (uint32_t i = 0; i < p_link_polygon_count; i++) {
+		polygons[p_polygons.size() + i] = &p_link_polygons[i];
+	}
+	flow.resize(polygon_count);
+	for (FlowPolygon &flow_polygon : flow) {
+		flow_polygon = FlowPolygon();
+	}
+
+	// Link polygons are not part of the grid, positions are never on them.
+	_build_grid(p_polygons.size());
+
+	Vector3 target_point;
+	const gd::Polygon *target_polygon = _find_polygon(p_target, target_point);
+	if (target_polygon == nullptr) {
+		// Outside of the grid, take the closest polygon like path queries do.
+		real_t closest_distance = FLT_MAX;
+		for (const gd::Polygon &polygon : p_polygons) {
+			if ((navigation_layers & polygon.owner->get_navigation_layers()) == 0) {
+				continue;
+			}
+			for (uint32_t point_id = 2; point_id < polygon.points.size(); point_id++) {
+				const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
+				const Vector3 point = face.get_closest_point_to(p_target);
+				const real_t distance = point.distance_to(p_target);
+				if (distance < closest_distance) {
+					closest_distance = distance;
+					target_polygon = &polygon;
+					target_point = point;
+				}
+			}
+		}
+	}
+	if (target_polygon == nullptr) {
+		return;
+	}
+
+	// The field is searched from the target, so each polygon needs the connections leading into it.
+	LocalVector<uint32_t> connection_offsets;
+	connection_offsets.resize(polygon_count + 1);
+	for (uint32_t &offset : connection_offsets) {
+		offset = 0;
+	}
+	for (const gd::Polygon *polygon : polygons) {
+		if ((navigation_layers & polygon->owner->get_navigation_layers()) == 0) {
+			continue;
+		}
+		for (const gd::Edge &edge : polygon->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				if ((navigation_layers & connection.polygon->owner->get_navigation_layers()) != 0) {
+					connection_offsets[connection.polygon->id + 1]++;
+				}
+			}
+		}
+	}
+	for (uint32_t i = 1; i < connection_offsets.size(); i++) {
+		connection_offsets[i] += connection_offsets[i - 1];
+	}
+
+	LocalVector<FlowFieldConnection> connections;
+	connections.resize(connection_offsets[polygon_count]);
+	LocalVector<uint32_t> connection_cursors = connection_offsets;
+	for (const gd::Polygon *polygon : polygons) {
+		if ((navigation_layers & polygon->owner->get_navigation_layers()) == 0) {
+			continue;
+		}
+		for (const gd::Edge &edge : polygon->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				if ((navigation_layers & connection.polygon->owner->get_navigation_layers()) != 0) {
+					FlowFieldConnection &incoming = connections[connection_cursors[connection.polygon->id]++];
+					incoming.polygon = polygon->id;
+					incoming.pathway_start = connection.pathway_start;
+					incoming.pathway_end = connection.pathway_end;
+				}
+			}
+		}
+	}
+
+	// Dijkstra search, with the same travel and enter costs as path queries. Each polygon is left
+	// through the point of the pathway closest to the exit of the polygon it leads to.
+	FlowPolygon &target_flow = flow[target_polygon->id];
+	target_flow.cost = 0.0;
+	target_flow.exit = target_point;
+
+	gd::Heap<FlowFieldNode, FlowFieldNodeCostGreaterThan> open;
+	open.push({ 0.0, target_polygon->id });
+
+	while (!open.is_empty()) {
+		const FlowFieldNode node = open.pop();
+		const FlowPolygon &current = flow[node.polygon];
+		if (node.cost > current.cost) {
+			// Reached again with a lower cost after it was added.
+			continue;
+		}
+
+		const NavBase *owner = polygons[node.polygon]->owner;
+		const real_t travel_cost = owner->get_travel_cost();
+		for (uint32_t i = connection_offsets[node.polygon]; i < connection_offsets[node.polygon + 1]; i++) {
+			const FlowFieldConnection &connection = connections[i];
+			const Vector3 pathway[2] = { connection.pathway_start, connection.pathway_end };
+			const Vector3 exit = Geometry3D::get_closest_point_to_segment(current.exit, pathway);
+
+			real_t cost = current.cost + exit.distance_to(current.exit) * travel_cost;
+			if (polygons[connection.polygon]->owner != owner) {
+				cost += owner->get_enter_cost();
+			}
+
+			FlowPolygon &previous = flow[connection.polygon];
+			if (cost < previous.cost) {
+				previous.cost = cost;
+				previous.exit = exit;
+				previous.next = node.polygon;
+				open.push({ cost, connection.polygon });
+			}
+		}
+	}
+}
+
+bool NavMeshFlowField3D::get_flow(const Vector3 &p_position, Vector3 &r_direction, real_t &r_cost) const {
+	Vector3 point;
+	const gd::Polygon *polygon = _find_polygon(p_position, point);
+	if (polygon == nullptr) {
+		return false;
+	}
+
+	const FlowPolygon *flow_polygon = &flow[polygon->id];
+	if (flow_polygon->cost == FLT_MAX) {
+		return false;
+	}
+
+	r_cost = flow_polygon->cost + point.distance_to(flow_polygon->exit) * polygon->owner->get_travel_cost();
+
+	// On the exit of a polygon, follow the exit of the next one.
+	while (point.is_equal_approx(flow_polygon->exit) && flow_polygon->next != UINT32_MAX) {
+		flow_polygon = &flow[flow_polygon->next];
+	}
+	r_direction = (flow_polygon->exit - point).normalized();
+	return true;
+}
+
+#endif // _3D_DISABLED
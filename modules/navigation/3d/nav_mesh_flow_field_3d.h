@@ -0,0 +1,100 @@
+/**************************************************************************/
+/*  nav_mesh_flow_field_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_MESH_FLOW_FIELD_3D_H
+#define NAV_MESH_FLOW_FIELD_3D_H
+
+#ifndef _3D_DISABLED
+
+#include "../nav_utils.h"
+
+#include "core/math/vector2i.h"
+#include "core/templates/safe_refcount.h"
+
+/**
+ * Travel costs from all polygons of a map to a single target.
+ *
+ * A Dijkstra search from the target polygon over the reversed polygon
+ * connections gives each polygon the point on its border that leads towards
+ * the target, and the travel cost from that point. Any number of agents going
+ * to the same target then sample the field instead of running their own path
+ * query. The polygon at a position is found through a grid on the XZ plane.
+ *
+ * The field points into the polygons of the map it was built from, it is only
+ * valid until the next map synchronization.
+ */
+class NavMeshFlowField3D {
+	struct FlowPolygon {
+		/// Travel cost from `exit` to the target, FLT_MAX when the target can't be reached.
+		real_t cost = FLT_MAX;
+		/// Point on the polygon border that leads to the target, the target itself in the target polygon.
+		Vector3 exit;
+		uint32_t next = UINT32_MAX;
+	};
+
+	/// As requested, the flow leads to the closest point on the map.
+	Vector3 target;
+	uint32_t navigation_layers = 0;
+
+	/// Polygons and link polygons of the map, by id.
+	LocalVector<const gd::Polygon *> polygons;
+	LocalVector<FlowPolygon> flow;
+
+	/// Polygons overlapping each cell of a grid on the XZ plane.
+	real_t grid_cell_size = 1.0;
+	Vector2i grid_begin;
+	Vector2i grid_size;
+	LocalVector<uint32_t> grid_cell_offsets;
+	LocalVector<uint32_t> grid_polygons;
+
+	/// Value of the use counter of the map when the field was last sampled, to find the least recently used field.
+	mutable SafeNumeric<uint64_t> last_use;
+
+	void _build_grid(uint32_t p_polygon_count);
+	const gd::Polygon *_find_polygon(const Vector3 &p_position, Vector3 &r_point) const;
+
+public:
+	/// Only the first `p_link_polygon_count` link polygons are in use, the others are left over from disabled or unconnected links.
+	void build(const LocalVector<gd::Polygon> &p_polygons, const LocalVector<gd::Polygon> &p_link_polygons, uint32_t p_link_polygon_count, const Vector3 &p_target, uint32_t p_navigation_layers);
+
+	const Vector3 &get_target() const { return target; }
+	uint32_t get_navigation_layers() const { return navigation_layers; }
+
+	void set_last_use(uint64_t p_use) const { last_use.set(p_use); }
+	uint64_t get_last_use() const { return last_use.get(); }
+
+	/// Gives the direction towards the target and the remaining travel cost at a position.
+	/// Returns false when the position is outside the map or can't reach the target.
+	bool get_flow(const Vector3 &p_position, Vector3 &r_direction, real_t &r_cost) const;
+};
+
+#endif // _3D_DISABLED
+
+#endif // NAV_MESH_FLOW_FIELD_3D_H
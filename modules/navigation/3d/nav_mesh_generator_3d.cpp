@@ -239,6 +239,101 @@ bool NavMeshGenerator3D::is_baking(Ref<NavigationMesh> p_navigation_mesh) {
 	return baking_navmeshes.has(p_navigation_mesh);
 }
 
+void NavMeshGenerator3D::bake_tile_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const AABB &p_tile_aabb) {
+	ERR_FAIL_COND(!p_navigation_mesh.is_valid());
+	ERR_FAIL_COND(!p_source_geometry_data.is_valid());
+
+	p_navigation_mesh->clear();
+
+	// Recast drops the border cells of the heightfield, so the tile is baked with a border wide
+	// enough for the agent radius erosion. The polygons then end exactly on the tile edges and
+	// merge with the polygons of the neighbor tiles on the navigation map.
+	const real_t cell_size = p_navigation_mesh->get_cell_size();
+	const real_t border_size = (Math::ceil(p_navigation_mesh->get_agent_radius() / cell_size) + 3) * cell_size;
+
+	AABB baking_aabb = p_tile_aabb;
+	baking_aabb.position.x -= border_size;
+	baking_aabb.position.z -= border_size;
+	baking_aabb.size.x += border_size * 2.0;
+	baking_aabb.size.z += border_size * 2.0;
+
+	p_navigation_mesh->set_border_size(border_size);
+	p_navigation_mesh->set_filter_baking_aabb(baking_aabb);
+	p_navigation_mesh->set_filter_baking_aabb_offset(Vector3());
+
+	Vector<float> source_geometry_vertices;
+	Vector<int> source_geometry_indices;
+	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
+
+	p_source_geometry_data->get_data(
+			source_geometry_vertices,
+			source_geometry_indices,
+			projected_obstructions);
+
+	// Only rasterize the triangles that touch the baking area.
+	const float *vertices = source_geometry_vertices.ptr();
+	const int *indices = source_geometry_indices.ptr();
+	const int index_count = source_geometry_indices.size() - source_geometry_indices.size() % 3;
+
+	LocalVector<int> tile_vertex_index;
+	tile_vertex_index.resize(source_geometry_vertices.size() / 3);
+	for (int &index : tile_vertex_index) {
+		index = -1;
+	}
+
+	Vector<float> tile_vertices;
+	Vector<int> tile_indices;
+	tile_vertices.resize(source_geometry_vertices.size());
+	tile_indices.resize(index_count);
+	float *tile_vertices_ptrw = tile_vertices.ptrw();
+	int *tile_indices_ptrw = tile_indices.ptrw();
+	int tile_vertex_count = 0;
+	int tile_index_count = 0;
+
+	const Vector3 baking_begin = baking_aabb.position;
+	const Vector3 baking_end = baking_aabb.get_end();
+
+	for (int i = 0; i < index_count; i += 3) {
+		float min_x = FLT_MAX;
+		float max_x = -FLT_MAX;
+		float min_z = FLT_MAX;
+		float max_z = -FLT_MAX;
+		for (int j = 0; j < 3; j++) {
+			const float *v = &vertices[indices[i + j] * 3];
+			min_x = MIN(min_x, v[0]);
+			max_x = MAX(max_x, v[0]);
+			min_z = MIN(min_z, v[2]);
+			max_z = MAX(max_z, v[2]);
+		}
+		if (max_x < baking_begin.x || min_x > baking_end.x || max_z < baking_begin.z || min_z > baking_end.z) {
+			continue;
+		}
+
+		for (int j = 0; j < 3; j++) {
+			const int index = indices[i + j];
+			if (tile_vertex_index[index] < 0) {
+				tile_vertex_index[index] = tile_vertex_count;
+				memcpy(&tile_vertices_ptrw[tile_vertex_count * 3], &vertices[index * 3], sizeof(float) * 3);
+				tile_vertex_count++;
+			}
+			tile_indices_ptrw[tile_index_count++] = tile_vertex_index[index];
+		}
+	}
+
+	if (tile_index_count == 0) {
+		return;
+	}
+
+	tile_vertices.resize(tile_vertex_count * 3);
+	tile_indices.resize(tile_index_count);
+
+	Ref<NavigationMeshSourceGeometryData3D> tile_source_geometry_data;
+	tile_source_geometry_data.instantiate();
+	tile_source_geometry_data->set_data(tile_vertices, tile_indices, projected_obstructions);
+
+	generator_bake_from_source_geometry_data(p_navigation_mesh, tile_source_geometry_data);
+}
+
 void NavMeshGenerator3D::generator_thread_bake(void *p_arg) {
 	NavMeshGeneratorTask3D *generator_task = static_cast<NavMeshGeneratorTask3D *>(p_arg);
 
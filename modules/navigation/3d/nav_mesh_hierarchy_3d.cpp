@@ -0,0 +1,485 @@
+/**************************************************************************/
+/*  nav_mesh_hierarchy_3d.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef _3D_DISABLED
+
+#include "nav_mesh_hierarchy_3d.h"
+
+#include "../nav_base.h"
+
+#include "core/math/geometry_3d.h"
+
+struct PortalGroupKey {
+	uint32_t from_cluster = 0;
+	uint32_t from_component = 0;
+	uint32_t to_cluster = 0;
+	uint32_t to_component = 0;
+
+	static uint32_t hash(const PortalGroupKey &p_key) {
+		uint32_t h = hash_murmur3_one_32(p_key.from_cluster);
+		h = hash_murmur3_one_32(p_key.from_component, h);
+		h = hash_murmur3_one_32(p_key.to_cluster, h);
+		h = hash_murmur3_one_32(p_key.to_component, h);
+		return hash_fmix32(h);
+	}
+
+	bool operator==(const PortalGroupKey &p_key) const {
+		return from_cluster == p_key.from_cluster && from_component == p_key.from_component && to_cluster == p_key.to_cluster && to_component == p_key.to_component;
+	}
+};
+
+void NavMeshHierarchy3D::_search_cluster(uint32_t p_cluster, uint32_t p_from_polygon, const Vector3 &p_from_point, LocalVector<real_t> &r_costs, LocalVector<Vector3> &r_entries) const {
+	const Cluster &cluster = clusters[p_cluster];
+	r_costs.resize(cluster.polygons.size());
+	r_entries.resize(cluster.polygons.size());
+	for (real_t &cost : r_costs) {
+		cost = FLT_MAX;
+	}
+
+	const uint32_t from_index = polygon_cluster_indices[p_from_polygon];
+	r_costs[from_index] = 0.0;
+	r_entries[from_index] = p_from_point;
+
+	// Dijkstra over the polygons of the cluster, entering each polygon at the closest point of the crossed edge like the path queries do.
+	gd::Heap<SearchCost, SearchCostGreaterThan> open;
+	open.push({ 0.0, from_index });
+	while (!open.is_empty()) {
+		const SearchCost current = open.pop();
+		if (current.cost > r_costs[current.index]) {
+			continue;
+		}
+
+		const gd::Polygon *polygon = polygons[cluster.polygons[current.index]];
+		const real_t travel_cost = polygon->owner->get_travel_cost();
+		for (const gd::Edge &edge : polygon->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				const uint32_t neighbor_id = connection.polygon->id;
+				if (polygon_clusters[neighbor_id] != p_cluster) {
+					continue;
+				}
+
+				Vector3 pathway[2] = { connection.pathway_start, connection.pathway_end };
+				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(r_entries[current.index], pathway);
+				real_t new_cost = current.cost + r_entries[current.index].distance_to(new_entry) * travel_cost;
+				if (connection.polygon->owner != polygon->owner) {
+					new_cost += connection.polygon->owner->get_enter_cost();
+				}
+
+				const uint32_t neighbor_index = polygon_cluster_indices[neighbor_id];
+				if (new_cost < r_costs[neighbor_index]) {
+					r_costs[neighbor_index] = new_cost;
+					r_entries[neighbor_index] = new_entry;
+					open.push({ new_cost, neighbor_index });
+				}
+			}
+		}
+	}
+}
+
+real_t NavMeshHierarchy3D::_get_exit_cost(const LocalVector<real_t> &p_costs, const LocalVector<Vector3> &p_entries, uint32_t p_polygon, const Vector3 &p_point) const {
+	const uint32_t index = polygon_cluster_indices[p_polygon];
+	if (p_costs[index] == FLT_MAX) {
+		return FLT_MAX;
+	}
+	return p_costs[index] + p_entries[index].distance_to(p_point) * polygons[p_polygon]->owner->get_travel_cost();
+}
+
+bool NavMeshHierarchy3D::_can_reuse_costs(const Cluster &p_cluster, const Cluster &p_old_cluster, const LocalVector<Portal> &p_old_portals, const HashSet<const NavBase *> &p_changed_owners) const {
+	if (p_cluster.polygon_keys.size() != p_old_cluster.polygon_keys.size() || p_cluster.entries.size() != p_old_cluster.entries.size() || p_cluster.exits.size() != p_old_cluster.exits.size()) {
+		return false;
+	}
+	for (uint32_t i = 0; i < p_cluster.polygon_keys.size(); i++) {
+		if (p_cluster.polygon_keys[i] != p_old_cluster.polygon_keys[i]) {
+			return false;
+		}
+	}
+	if (!p_changed_owners.is_empty()) {
+		for (const PolygonKey &key : p_cluster.polygon_keys) {
+			if (p_changed_owners.has(key.owner)) {
+				return false;
+			}
+		}
+	}
+
+	// The portals also depend on the neighbor clusters.
+	for (uint32_t i = 0; i < p_cluster.entries.size(); i++) {
+		const Portal &portal = portals[p_cluster.entries[i]];
+		const Portal &old_portal = p_old_portals[p_old_cluster.entries[i]];
+		if (portal.from_key != old_portal.from_key || portal.to_key != old_portal.to_key || portal.position != old_portal.position) {
+			return false;
+		}
+	}
+	for (uint32_t i = 0; i < p_cluster.exits.size(); i++) {
+		const Portal &portal = portals[p_cluster.exits[i]];
+		const Portal &old_portal = p_old_portals[p_old_cluster.exits[i]];
+		if (portal.from_key != old_portal.from_key || portal.to_key != old_portal.to_key || portal.position != old_portal.position) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void NavMeshHierarchy3D::build(const LocalVector<const gd::Polygon *> &p_polygons, real_t p_cluster_size, const HashSet<const NavBase *> &p_changed_owners, bool p_rebuild_all) {
+	ERR_FAIL_COND(p_cluster_size <= 0.0);
+
+	bool rebuild_all = p_rebuild_all || cluster_size != p_cluster_size;
+	cluster_size = p_cluster_size;
+
+	// Owners whose costs changed invalidate their clusters, like a change of their polygons does.
+	HashSet<const NavBase *> changed_owners = p_changed_owners;
+	HashMap<const NavBase *, OwnerCosts> new_owner_costs;
+	min_travel_cost = FLT_MAX;
+	for (const gd::Polygon *polygon : p_polygons) {
+		if (new_owner_costs.has(polygon->owner)) {
+			continue;
+		}
+		OwnerCosts costs;
+		costs.enter_cost = polygon->owner->get_enter_cost();
+		costs.travel_cost = polygon->owner->get_travel_cost();
+		new_owner_costs.insert(polygon->owner, costs);
+		min_travel_cost = MIN(min_travel_cost, costs.travel_cost);
+
+		HashMap<const NavBase *, OwnerCosts>::ConstIterator E = owner_costs.find(polygon->owner);
+		if (E && (E->value.enter_cost != costs.enter_cost || E->value.travel_cost != costs.travel_cost)) {
+			changed_owners.insert(polygon->owner);
+		}
+	}
+	if (min_travel_cost == FLT_MAX) {
+		min_travel_cost = 1.0;
+	}
+	owner_costs = new_owner_costs;
+
+	const LocalVector<Cluster> old_clusters = clusters;
+	const HashMap<Vector3i, uint32_t> old_cell_clusters = cell_clusters;
+	const LocalVector<Portal> old_portals = portals;
+	clusters.clear();
+	cell_clusters.clear();
+	portals.clear();
+
+	// Put the polygons in the clusters of the grid cells their centers are in.
+	polygons = p_polygons;
+	polygon_clusters.resize(polygons.size());
+	polygon_cluster_indices.resize(polygons.size());
+	const NavBase *key_owner = nullptr;
+	uint32_t key_index = 0;
+	for (uint32_t i = 0; i < polygons.size(); i++) {
+		const gd::Polygon *polygon = polygons[i];
+		ERR_FAIL_COND_MSG(polygon->id != i, "Navigation polygons must be ordered by id.");
+
+		if (polygon->owner != key_owner) {
+			key_owner = polygon->owner;
+			key_index = 0;
+		}
+
+		Vector3 center;
+		if (polygon->owner->get_type() == NavigationUtilities::PathSegmentType::PATH_SEGMENT_TYPE_LINK) {
+			// Links belong to the cluster they start from.
+			center = polygon->points[0].pos;
+		} else {
+			for (const gd::Point &point : polygon->points) {
+				center += point.pos;
+			}
+			center /= polygon->points.size();
+		}
+		const Vector3i cell = Vector3i((center / cluster_size).floor());
+
+		uint32_t cluster_index;
+		HashMap<Vector3i, uint32_t>::Iterator E = cell_clusters.find(cell);
+		if (E) {
+			cluster_index = E->value;
+		} else {
+			cluster_index = clusters.size();
+			cell_clusters.insert(cell, cluster_index);
+			clusters.push_back(Cluster());
+			clusters[cluster_index].cell = cell;
+		}
+
+		Cluster &cluster = clusters[cluster_index];
+		polygon_clusters[i] = cluster_index;
+		polygon_cluster_indices[i] = cluster.polygons.size();
+		cluster.polygons.push_back(i);
+		cluster.polygon_keys.push_back({ polygon->owner, key_index++ });
+	}
+
+	// Find the connected parts of each cluster, so that separate passages between two clusters get their own portal.
+	LocalVector<uint32_t> polygon_components;
+	polygon_components.resize(polygons.size());
+	for (uint32_t &component : polygon_components) {
+		component = UINT32_MAX;
+	}
+	LocalVector<uint32_t> stack;
+	for (uint32_t cluster_index = 0; cluster_index < clusters.size(); cluster_index++) {
+		uint32_t component_count = 0;
+		for (uint32_t polygon_id : clusters[cluster_index].polygons) {
+			if (polygon_components[polygon_id] != UINT32_MAX) {
+				continue;
+			}
+			polygon_components[polygon_id] = component_count;
+			stack.push_back(polygon_id);
+			while (!stack.is_empty()) {
+				const gd::Polygon *polygon = polygons[stack[stack.size() - 1]];
+				stack.resize(stack.size() - 1);
+				for (const gd::Edge &edge : polygon->edges) {
+					for (const gd::Edge::Connection &connection : edge.connections) {
+						const uint32_t neighbor_id = connection.polygon->id;
+						if (polygon_clusters[neighbor_id] == cluster_index && polygon_components[neighbor_id] == UINT32_MAX) {
+							polygon_components[neighbor_id] = component_count;
+							stack.push_back(neighbor_id);
+						}
+					}
+				}
+			}
+			component_count++;
+		}
+	}
+
+	// Group the connections crossing clusters by the parts they connect, each group becomes a portal.
+	struct Crossing {
+		uint32_t from_polygon = 0;
+		uint32_t to_polygon = 0;
+		Vector3 position;
+		uint32_t group = 0;
+	};
+	LocalVector<Crossing> crossings;
+	HashMap<PortalGroupKey, uint32_t, PortalGroupKey> group_indices;
+	LocalVector<Vector3> group_centers;
+	LocalVector<uint32_t> group_sizes;
+	for (const gd::Polygon *polygon : polygons) {
+		const uint32_t from_cluster = polygon_clusters[polygon->id];
+		for (const gd::Edge &edge : polygon->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				const uint32_t to_cluster = polygon_clusters[connection.polygon->id];
+				if (to_cluster == from_cluster) {
+					continue;
+				}
+
+				const PortalGroupKey group_key = { from_cluster, polygon_components[polygon->id], to_cluster, polygon_components[connection.polygon->id] };
+				uint32_t group;
+				HashMap<PortalGroupKey, uint32_t, PortalGroupKey>::Iterator E = group_indices.find(group_key);
+				if (E) {
+					group = E->value;
+				} else {
+					group = group_centers.size();
+					group_indices.insert(group_key, group);
+					group_centers.push_back(Vector3());
+					group_sizes.push_back(0);
+				}
+
+				Crossing crossing;
+				crossing.from_polygon = polygon->id;
+				crossing.to_polygon = connection.polygon->id;
+				crossing.position = (connection.pathway_start + connection.pathway_end) * 0.5;
+				crossing.group = group;
+				crossings.push_back(crossing);
+				group_centers[group] += crossing.position;
+				group_sizes[group]++;
+			}
+		}
+	}
+
+	// Each portal goes through the crossing of its group closest to the middle of the group.
+	LocalVector<uint32_t> group_crossings;
+	LocalVector<real_t> group_distances;
+	group_crossings.resize(group_centers.size());
+	group_distances.resize(group_centers.size());
+	for (uint32_t group = 0; group < group_centers.size(); group++) {
+		group_centers[group] /= group_sizes[group];
+		group_distances[group] = FLT_MAX;
+	}
+	for (uint32_t i = 0; i < crossings.size(); i++) {
+		const real_t distance = crossings[i].position.distance_squared_to(group_centers[crossings[i].group]);
+		if (distance < group_distances[crossings[i].group]) {
+			group_distances[crossings[i].group] = distance;
+			group_crossings[crossings[i].group] = i;
+		}
+	}
+
+	portals.resize(group_centers.size());
+	for (uint32_t group = 0; group < group_centers.size(); group++) {
+		const Crossing &crossing = crossings[group_crossings[group]];
+		Portal &portal = portals[group];
+		portal.from_cluster = polygon_clusters[crossing.from_polygon];
+		portal.to_cluster = polygon_clusters[crossing.to_polygon];
+		portal.from_polygon = crossing.from_polygon;
+		portal.to_polygon = crossing.to_polygon;
+		portal.from_key = clusters[portal.from_cluster].polygon_keys[polygon_cluster_indices[crossing.from_polygon]];
+		portal.to_key = clusters[portal.to_cluster].polygon_keys[polygon_cluster_indices[crossing.to_polygon]];
+		portal.position = crossing.position;
+
+		Cluster &from_cluster = clusters[portal.from_cluster];
+		portal.exit_index = from_cluster.exits.size();
+		from_cluster.exits.push_back(group);
+		Cluster &to_cluster = clusters[portal.to_cluster];
+		portal.entry_index = to_cluster.entries.size();
+		to_cluster.entries.push_back(group);
+	}
+
+	// Compute the costs between the portals of the clusters that changed.
+	rebuilt_cluster_count = 0;
+	LocalVector<real_t> costs;
+	LocalVector<Vector3> entries;
+	for (uint32_t cluster_index = 0; cluster_index < clusters.size(); cluster_index++) {
+		Cluster &cluster = clusters[cluster_index];
+
+		if (!rebuild_all) {
+			HashMap<Vector3i, uint32_t>::ConstIterator E = old_cell_clusters.find(cluster.cell);
+			if (E && _can_reuse_costs(cluster, old_clusters[E->value], old_portals, changed_owners)) {
+				cluster.costs = old_clusters[E->value].costs;
+				continue;
+			}
+		}
+
+		rebuilt_cluster_count++;
+		cluster.costs.resize(cluster.entries.size() * cluster.exits.size());
+		for (uint32_t entry = 0; entry < cluster.entries.size(); entry++) {
+			const Portal &entry_portal = portals[cluster.entries[entry]];
+			_search_cluster(cluster_index, entry_portal.to_polygon, entry_portal.position, costs, entries);
+			for (uint32_t exit = 0; exit < cluster.exits.size(); exit++) {
+				const Portal &exit_portal = portals[cluster.exits[exit]];
+				cluster.costs[entry * cluster.exits.size() + exit] = _get_exit_cost(costs, entries, exit_portal.from_polygon, exit_portal.position);
+			}
+		}
+	}
+}
+
+void NavMeshHierarchy3D::clear() {
+	clusters.clear();
+	cell_clusters.clear();
+	portals.clear();
+	polygons.clear();
+	polygon_clusters.clear();
+	polygon_cluster_indices.clear();
+	owner_costs.clear();
+	rebuilt_cluster_count = 0;
+}
+
+bool NavMeshHierarchy3D::can_search(uint32_t p_navigation_layers) const {
+	// The cluster costs are computed through all polygons, so they are only valid when every polygon can be used.
+	for (const KeyValue<const NavBase *, OwnerCosts> &E : owner_costs) {
+		if ((p_navigation_layers & E.key->get_navigation_layers()) == 0) {
+			return false;
+		}
+	}
+	return !clusters.is_empty();
+}
+
+bool NavMeshHierarchy3D::get_corridor(const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, LocalVector<uint8_t> &r_corridor) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_begin_poly->id, polygon_clusters.size(), false);
+	ERR_FAIL_UNSIGNED_INDEX_V(p_end_poly->id, polygon_clusters.size(), false);
+
+	const uint32_t begin_cluster = polygon_clusters[p_begin_poly->id];
+	const uint32_t end_cluster = polygon_clusters[p_end_poly->id];
+	if (begin_cluster == end_cluster) {
+		return false;
+	}
+
+	const uint32_t portal_count = portals.size();
+	LocalVector<real_t> portal_costs;
+	LocalVector<uint32_t> previous_portals;
+	LocalVector<uint8_t> closed;
+	portal_costs.resize(portal_count);
+	previous_portals.resize(portal_count);
+	closed.resize(portal_count);
+	for (uint32_t i = 0; i < portal_count; i++) {
+		portal_costs[i] = FLT_MAX;
+		previous_portals[i] = UINT32_MAX;
+		closed[i] = 0;
+	}
+
+	// A* over the portals. Heap entries past the portals are the end point, reached through the portal at `index - portal_count`.
+	gd::Heap<SearchCost, SearchCostGreaterThan> open;
+	LocalVector<real_t> costs;
+	LocalVector<Vector3> entries;
+
+	_search_cluster(begin_cluster, p_begin_poly->id, p_begin_point, costs, entries);
+	for (uint32_t exit : clusters[begin_cluster].exits) {
+		const real_t cost = _get_exit_cost(costs, entries, portals[exit].from_polygon, portals[exit].position);
+		if (cost < portal_costs[exit]) {
+			portal_costs[exit] = cost;
+			open.push({ cost + portals[exit].position.distance_to(p_end_point) * min_travel_cost, exit });
+		}
+	}
+
+	uint32_t last_portal = UINT32_MAX;
+	while (!open.is_empty()) {
+		const SearchCost current = open.pop();
+		if (current.index >= portal_count) {
+			last_portal = current.index - portal_count;
+			break;
+		}
+		if (closed[current.index]) {
+			continue;
+		}
+		closed[current.index] = 1;
+
+		const Portal &portal = portals[current.index];
+		const real_t portal_cost = portal_costs[current.index];
+
+		if (portal.to_cluster == end_cluster) {
+			_search_cluster(end_cluster, portal.to_polygon, portal.position, costs, entries);
+			const uint32_t end_index = polygon_cluster_indices[p_end_poly->id];
+			if (costs[end_index] != FLT_MAX) {
+				const real_t cost = portal_cost + costs[end_index] + entries[end_index].distance_to(p_end_point) * p_end_poly->owner->get_travel_cost();
+				open.push({ cost, portal_count + current.index });
+			}
+		}
+
+		const Cluster &cluster = clusters[portal.to_cluster];
+		const real_t *exit_costs = cluster.costs.ptr() + portal.entry_index * cluster.exits.size();
+		for (uint32_t exit = 0; exit < cluster.exits.size(); exit++) {
+			const uint32_t next = cluster.exits[exit];
+			if (exit_costs[exit] == FLT_MAX || closed[next]) {
+				continue;
+			}
+			const real_t cost = portal_cost + exit_costs[exit];
+			if (cost < portal_costs[next]) {
+				portal_costs[next] = cost;
+				previous_portals[next] = current.index;
+				open.push({ cost + portals[next].position.distance_to(p_end_point) * min_travel_cost, next });
+			}
+		}
+	}
+
+	if (last_portal == UINT32_MAX) {
+		return false;
+	}
+
+	r_corridor.resize(clusters.size());
+	memset(r_corridor.ptr(), 0, r_corridor.size());
+	r_corridor[begin_cluster] = 1;
+	r_corridor[end_cluster] = 1;
+	for (uint32_t portal = last_portal; portal != UINT32_MAX; portal = previous_portals[portal]) {
+		r_corridor[portals[portal].from_cluster] = 1;
+		r_corridor[portals[portal].to_cluster] = 1;
+	}
+	return true;
+}
+
+#endif // _3D_DISABLED
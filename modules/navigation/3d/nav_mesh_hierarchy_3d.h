@@ -0,0 +1,150 @@
+/**************************************************************************/
+/*  nav_mesh_hierarchy_3d.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_MESH_HIERARCHY_3D_H
+#define NAV_MESH_HIERARCHY_3D_H
+
+#ifndef _3D_DISABLED
+
+#include "../nav_utils.h"
+
+#include "core/math/vector3i.h"
+#include "core/templates/hash_set.h"
+
+/**
+ * Abstract graph used to speed up path queries on large maps (HPA*).
+ *
+ * The polygons of the map are grouped in clusters on a regular grid. Each
+ * cluster has portals, where connections lead to a neighbor cluster, and
+ * stores the travel cost between the portals leading into it and the ones
+ * leading out of it. Path queries search this much smaller graph first, then
+ * only search the polygons of the clusters that the abstract path goes through.
+ */
+class NavMeshHierarchy3D {
+public:
+	/// Identifies a polygon across map synchronizations, where the ids of the polygons change.
+	struct PolygonKey {
+		const NavBase *owner = nullptr;
+		uint32_t index = 0;
+
+		bool operator==(const PolygonKey &p_key) const {
+			return owner == p_key.owner && index == p_key.index;
+		}
+		bool operator!=(const PolygonKey &p_key) const {
+			return !(*this == p_key);
+		}
+	};
+
+	struct Portal {
+		/// Cluster left and cluster entered through this portal.
+		uint32_t from_cluster = 0;
+		uint32_t to_cluster = 0;
+		/// Index of this portal in the exits of `from_cluster` and in the entries of `to_cluster`.
+		uint32_t exit_index = 0;
+		uint32_t entry_index = 0;
+
+		uint32_t from_polygon = 0;
+		uint32_t to_polygon = 0;
+		PolygonKey from_key;
+		PolygonKey to_key;
+
+		Vector3 position;
+	};
+
+	struct Cluster {
+		Vector3i cell;
+		LocalVector<uint32_t> polygons;
+		LocalVector<PolygonKey> polygon_keys;
+
+		LocalVector<uint32_t> entries;
+		LocalVector<uint32_t> exits;
+		/// Travel cost from each entry to each exit, `entries.size()` rows of `exits.size()` costs.
+		LocalVector<real_t> costs;
+	};
+
+private:
+	real_t cluster_size = 0.0;
+
+	LocalVector<Cluster> clusters;
+	HashMap<Vector3i, uint32_t> cell_clusters;
+	LocalVector<Portal> portals;
+
+	/// Polygons of the map by id, including link polygons, with their cluster and index in the cluster.
+	LocalVector<const gd::Polygon *> polygons;
+	LocalVector<uint32_t> polygon_clusters;
+	LocalVector<uint32_t> polygon_cluster_indices;
+
+	/// Owners of the polygons, with the costs the cluster costs were computed with.
+	struct OwnerCosts {
+		real_t enter_cost = 0.0;
+		real_t travel_cost = 1.0;
+	};
+	HashMap<const NavBase *, OwnerCosts> owner_costs;
+	real_t min_travel_cost = 1.0;
+
+	uint32_t rebuilt_cluster_count = 0;
+
+	struct SearchCost {
+		real_t cost = 0.0;
+		uint32_t index = 0;
+	};
+	struct SearchCostGreaterThan {
+		bool operator()(const SearchCost &p_a, const SearchCost &p_b) const {
+			return p_a.cost > p_b.cost;
+		}
+	};
+
+	void _search_cluster(uint32_t p_cluster, uint32_t p_from_polygon, const Vector3 &p_from_point, LocalVector<real_t> &r_costs, LocalVector<Vector3> &r_entries) const;
+	real_t _get_exit_cost(const LocalVector<real_t> &p_costs, const LocalVector<Vector3> &p_entries, uint32_t p_polygon, const Vector3 &p_point) const;
+	bool _can_reuse_costs(const Cluster &p_cluster, const Cluster &p_old_cluster, const LocalVector<Portal> &p_old_portals, const HashSet<const NavBase *> &p_changed_owners) const;
+
+public:
+	/// Builds the graph for the polygons of the map, keeping the costs of the clusters that didn't change since the last build.
+	/// `p_polygons` holds the polygons of the map by id, they must stay valid until the next build.
+	void build(const LocalVector<const gd::Polygon *> &p_polygons, real_t p_cluster_size, const HashSet<const NavBase *> &p_changed_owners, bool p_rebuild_all);
+	void clear();
+
+	bool is_empty() const { return clusters.is_empty(); }
+	bool can_search(uint32_t p_navigation_layers) const;
+
+	/// Searches the abstract graph, and marks the clusters a path from the begin to the end point should be searched in.
+	/// Returns `false` when the begin and end polygons are in the same cluster or no path was found.
+	bool get_corridor(const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, LocalVector<uint8_t> &r_corridor) const;
+
+	_FORCE_INLINE_ const LocalVector<uint32_t> &get_polygon_clusters() const { return polygon_clusters; }
+	uint32_t get_cluster_count() const { return clusters.size(); }
+	uint32_t get_portal_count() const { return portals.size(); }
+	/// Number of clusters whose costs were computed again during the last build.
+	uint32_t get_rebuilt_cluster_count() const { return rebuilt_cluster_count; }
+};
+
+#endif // _3D_DISABLED
+
+#endif // NAV_MESH_HIERARCHY_3D_H
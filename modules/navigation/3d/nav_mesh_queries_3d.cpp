@@ -127,7 +127,11 @@ Vector3 NavMeshQueries3D::polygons_get_random_point(const LocalVector<gd::Polygo
 	}
 }
 
-Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size) {
+Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size, const NavMeshHierarchy3D *p_hierarchy, uint32_t *r_searched_polygon_count, gd::PathSearchBuffers *p_buffers) {
+	if (r_searched_polygon_count) {
+		*r_searched_polygon_count = 0;
+	}
+
 	// Clear metadata outputs.
 	if (r_path_types) {
 		r_path_types->clear();
@@ -205,22 +209,39 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 		return path;
 	}
 
-	// List of all reachable navigation polys.
-	LocalVector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.resize(p_polygons.size() + p_link_polygons_size);
+	// Reuse the memory of previous searches when buffers are given.
+	gd::PathSearchBuffers local_buffers;
+	gd::PathSearchBuffers &buffers = p_buffers ? *p_buffers : local_buffers;
+	buffers.begin_search(p_polygons.size() + p_link_polygons_size);
+
+	// List of all reachable navigation polys, only valid where `search_id` matches the search.
+	LocalVector<gd::NavigationPoly> &navigation_polys = buffers.navigation_polys;
 
 	// Initialize the matching navigation polygon.
 	gd::NavigationPoly &begin_navigation_poly = navigation_polys[begin_poly->id];
 	begin_navigation_poly.poly = begin_poly;
+	begin_navigation_poly.search_id = buffers.search_id;
+	begin_navigation_poly.traversable_poly_index = UINT32_MAX;
+	begin_navigation_poly.back_navigation_poly_id = -1;
+	begin_navigation_poly.back_navigation_edge = -1;
 	begin_navigation_poly.entry = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
+	begin_navigation_poly.traveled_distance = 0.0;
+	begin_navigation_poly.distance_to_destination = 0.0;
 
 	// Heap of polygons to travel next.
-	gd::Heap<gd::NavigationPoly *, gd::NavPolyTravelCostGreaterThan, gd::NavPolyHeapIndexer>
-			traversable_polys;
+	gd::Heap<gd::NavigationPoly *, gd::NavPolyTravelCostGreaterThan, gd::NavPolyHeapIndexer> &traversable_polys = buffers.traversable_polys;
 	traversable_polys.reserve(p_polygons.size() * 0.25);
 
+	// On large maps, search the abstract graph of clusters first and only search the polygons
+	// of the clusters the abstract path goes through.
+	LocalVector<uint8_t> corridor;
+	const uint32_t *polygon_clusters = nullptr;
+	if (p_hierarchy && p_hierarchy->get_corridor(begin_poly, begin_point, end_poly, end_point, corridor)) {
+		polygon_clusters = p_hierarchy->get_polygon_clusters().ptr();
+	}
+
 	// This is an implementation of the A* algorithm.
 	int least_cost_id = begin_poly->id;
 	int prev_least_cost_id = -1;
@@ -242,6 +263,10 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 					continue;
 				}
 
+				if (polygon_clusters && !corridor[polygon_clusters[connection.polygon->id]]) {
+					continue;
+				}
+
 				const gd::NavigationPoly &least_cost_poly = navigation_polys[least_cost_id];
 				real_t poly_enter_cost = 0.0;
 				real_t poly_travel_cost = least_cost_poly.poly->owner->get_travel_cost();
@@ -257,7 +282,7 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 
 				// Check if the neighbor polygon has already been processed.
 				gd::NavigationPoly &neighbor_poly = navigation_polys[connection.polygon->id];
-				if (neighbor_poly.poly != nullptr) {
+				if (neighbor_poly.search_id == buffers.search_id) {
 					// If the neighbor polygon hasn't been traversed yet and the new path leading to
 					// it is shorter, update the polygon.
 					if (neighbor_poly.traversable_poly_index < traversable_polys.size() &&
@@ -278,6 +303,7 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 				} else {
 					// Initialize the matching navigation polygon.
 					neighbor_poly.poly = connection.polygon;
+					neighbor_poly.search_id = buffers.search_id;
 					neighbor_poly.back_navigation_poly_id = least_cost_id;
 					neighbor_poly.back_navigation_edge = connection.edge;
 					neighbor_poly.back_navigation_edge_pathway_start = connection.pathway_start;
@@ -296,6 +322,20 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 
 		// When the heap of traversable polygons is empty at this point it means the end polygon is
 		// unreachable.
+		if (traversable_polys.is_empty() && polygon_clusters) {
+			// Not through the clusters of the abstract path, which shouldn't happen. Search all polygons instead.
+			polygon_clusters = nullptr;
+			buffers.restart_search();
+			navigation_polys[begin_poly->id].search_id = buffers.search_id;
+
+			least_cost_id = begin_poly->id;
+			prev_least_cost_id = -1;
+
+			reachable_end = nullptr;
+			distance_to_reachable_end = FLT_MAX;
+
+			continue;
+		}
 		if (traversable_polys.is_empty()) {
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
@@ -358,10 +398,8 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 				return path;
 			}
 
-			for (gd::NavigationPoly &nav_poly : navigation_polys) {
-				nav_poly.poly = nullptr;
-			}
-			navigation_polys[begin_poly->id].poly = begin_poly;
+			buffers.restart_search();
+			navigation_polys[begin_poly->id].search_id = buffers.search_id;
 
 			least_cost_id = begin_poly->id;
 			prev_least_cost_id = -1;
@@ -373,6 +411,9 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 
 		// Pop the polygon with the lowest travel cost from the heap of traversable polygons.
 		least_cost_id = traversable_polys.pop()->poly->id;
+		if (r_searched_polygon_count) {
+			(*r_searched_polygon_count)++;
+		}
 
 		// Store the farthest reachable end polygon in case our goal is not reachable.
 		if (is_reachable) {
@@ -0,0 +1,228 @@
+/**************************************************************************/
+/*  nav_mesh_tiles_3d.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef _3D_DISABLED
+
+#include "nav_mesh_tiles_3d.h"
+
+#include "nav_mesh_generator_3d.h"
+
+#include "core/config/project_settings.h"
+#include "core/templates/hash_set.h"
+#include "servers/navigation_server_3d.h"
+
+NavMeshTiles3D::~NavMeshTiles3D() {
+	if (tile_bake) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(tile_bake_group_id);
+		memdelete(tile_bake);
+		tile_bake = nullptr;
+	}
+
+	NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+	for (const KeyValue<Vector2i, RID> &E : tile_regions) {
+		navigation_server->free(E.value);
+	}
+	tile_regions.clear();
+}
+
+void NavMeshTiles3D::bake(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, real_t p_tile_size, const AABB &p_dirty_aabb, const Callable &p_callback) {
+	ERR_FAIL_COND(!p_navigation_mesh.is_valid());
+	ERR_FAIL_COND(!p_source_geometry_data.is_valid());
+	ERR_FAIL_COND_MSG(p_tile_size <= 0.0, "Tile size must be positive.");
+
+	if (tile_bake == nullptr) {
+		BakeRequest request;
+		request.navigation_mesh = p_navigation_mesh;
+		request.source_geometry_data = p_source_geometry_data;
+		request.tile_size = p_tile_size;
+		request.dirty_aabb = p_dirty_aabb;
+		request.callbacks.push_back(p_callback);
+		_start_bake(request);
+		return;
+	}
+
+	// Collapse all requests made while baking into one, with the latest geometry.
+	if (!has_pending_request) {
+		has_pending_request = true;
+		pending_request.dirty_aabb = p_dirty_aabb;
+	} else if (pending_request.dirty_aabb.size != Vector3() && p_dirty_aabb.size != Vector3()) {
+		pending_request.dirty_aabb.merge_with(p_dirty_aabb);
+	} else {
+		pending_request.dirty_aabb = AABB();
+	}
+	pending_request.navigation_mesh = p_navigation_mesh;
+	pending_request.source_geometry_data = p_source_geometry_data;
+	pending_request.tile_size = p_tile_size;
+	pending_request.callbacks.push_back(p_callback);
+}
+
+void NavMeshTiles3D::_get_tile_range(const AABB &p_aabb, Vector2i &r_begin, Vector2i &r_end) const {
+	const Vector3 end = p_aabb.get_end();
+	r_begin = Vector2i((int)Math::floor(p_aabb.position.x / tile_size), (int)Math::floor(p_aabb.position.z / tile_size));
+	r_end = Vector2i((int)Math::floor(end.x / tile_size), (int)Math::floor(end.z / tile_size));
+}
+
+void NavMeshTiles3D::_start_bake(const BakeRequest &p_request) {
+	const Ref<NavigationMesh> &navigation_mesh = p_request.navigation_mesh;
+	const real_t cell_size = navigation_mesh->get_cell_size();
+	const real_t cell_height = navigation_mesh->get_cell_height();
+
+	// Tiles are a whole number of cells wide, so that the cells of neighbor tiles line up.
+	const real_t request_tile_size = MAX(Math::round(p_request.tile_size / cell_size), (real_t)1.0) * cell_size;
+	const bool bake_all = p_request.dirty_aabb.size == Vector3() || request_tile_size != tile_size;
+	tile_size = request_tile_size;
+
+	// Copy the geometry, it may change while the tiles bake.
+	Vector<float> vertices;
+	Vector<int> indices;
+	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
+	p_request.source_geometry_data->get_data(vertices, indices, projected_obstructions);
+
+	tile_bake = memnew(TileBake);
+	tile_bake->source_geometry_data.instantiate();
+	tile_bake->source_geometry_data->set_data(vertices, indices, projected_obstructions);
+	tile_bake->callbacks = p_request.callbacks;
+
+	// A change affects the tiles within the baking border of the changed area.
+	const real_t border_size = (Math::ceil(navigation_mesh->get_agent_radius() / cell_size) + 3) * cell_size;
+	Vector2i dirty_begin;
+	Vector2i dirty_end;
+	if (!bake_all) {
+		_get_tile_range(p_request.dirty_aabb.grow(border_size), dirty_begin, dirty_end);
+	}
+
+	HashSet<Vector2i> tile_coords;
+
+	// Tiles of removed geometry are baked empty, which removes their regions.
+	for (const KeyValue<Vector2i, RID> &E : tile_regions) {
+		if (bake_all || (E.key.x >= dirty_begin.x && E.key.x <= dirty_end.x && E.key.y >= dirty_begin.y && E.key.y <= dirty_end.y)) {
+			tile_coords.insert(E.key);
+		}
+	}
+
+	AABB bounds;
+	if (tile_bake->source_geometry_data->has_data()) {
+		bounds = tile_bake->source_geometry_data->get_bounds();
+
+		Vector2i begin;
+		Vector2i end;
+		_get_tile_range(bounds, begin, end);
+		if (!bake_all) {
+			begin = begin.max(dirty_begin);
+			end = end.min(dirty_end);
+		}
+		for (int z = begin.y; z <= end.y; z++) {
+			for (int x = begin.x; x <= end.x; x++) {
+				tile_coords.insert(Vector2i(x, z));
+			}
+		}
+	}
+
+	// All tiles share the vertical extent, snapped to cells so that tiles baked at different times line up.
+	const real_t bottom = Math::floor(bounds.position.y / cell_height) * cell_height - cell_height;
+	const real_t top = Math::ceil(bounds.get_end().y / cell_height) * cell_height + cell_height;
+
+	tile_bake->tiles.resize(tile_coords.size());
+	uint32_t tile_index = 0;
+	for (const Vector2i &coords : tile_coords) {
+		Tile &tile = tile_bake->tiles[tile_index++];
+		tile.coords = coords;
+		tile.aabb = AABB(Vector3(coords.x * tile_size, bottom, coords.y * tile_size), Vector3(tile_size, top - bottom, tile_size));
+		tile.navigation_mesh = navigation_mesh->duplicate();
+	}
+
+	if (tile_bake->tiles.is_empty()) {
+		tile_bake_group_id = -1;
+		return;
+	}
+
+	const bool use_multiple_threads = GLOBAL_GET("navigation/baking/thread_model/baking_use_multiple_threads");
+	const bool use_high_priority_threads = GLOBAL_GET("navigation/baking/thread_model/baking_use_high_priority_threads");
+	tile_bake_group_id = WorkerThreadPool::get_singleton()->add_native_group_task(&NavMeshTiles3D::_bake_tile, tile_bake, tile_bake->tiles.size(), use_multiple_threads ? -1 : 1, use_high_priority_threads, SNAME("NavMeshTileBake3D"));
+}
+
+void NavMeshTiles3D::_bake_tile(void *p_tile_bake, uint32_t p_index) {
+	TileBake *tile_bake = static_cast<TileBake *>(p_tile_bake);
+	Tile &tile = tile_bake->tiles[p_index];
+	NavMeshGenerator3D::bake_tile_from_source_geometry_data(tile.navigation_mesh, tile_bake->source_geometry_data, tile.aabb);
+}
+
+void NavMeshTiles3D::sync(bool p_wait) {
+	if (tile_bake == nullptr) {
+		return;
+	}
+
+	if (tile_bake_group_id != -1) {
+		WorkerThreadPool *worker_thread_pool = WorkerThreadPool::get_singleton();
+		if (!p_wait && !worker_thread_pool->is_group_task_completed(tile_bake_group_id)) {
+			return;
+		}
+		worker_thread_pool->wait_for_group_task_completion(tile_bake_group_id);
+		tile_bake_group_id = -1;
+	}
+
+	NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+	for (const Tile &tile : tile_bake->tiles) {
+		RID *region = tile_regions.getptr(tile.coords);
+
+		if (tile.navigation_mesh->get_polygon_count() == 0) {
+			if (region) {
+				navigation_server->free(*region);
+				tile_regions.erase(tile.coords);
+			}
+			continue;
+		}
+
+		if (!region) {
+			RID new_region = navigation_server->region_create();
+			navigation_server->region_set_map(new_region, map);
+			region = &tile_regions.insert(tile.coords, new_region)->value;
+		}
+		navigation_server->region_set_navigation_mesh(*region, tile.navigation_mesh);
+	}
+
+	LocalVector<Callable> callbacks = tile_bake->callbacks;
+	memdelete(tile_bake);
+	tile_bake = nullptr;
+
+	if (has_pending_request) {
+		has_pending_request = false;
+		_start_bake(pending_request);
+		pending_request = BakeRequest();
+	}
+
+	for (const Callable &callback : callbacks) {
+		if (callback.is_valid()) {
+			callback.call();
+		}
+	}
+}
+
+#endif // _3D_DISABLED
@@ -0,0 +1,110 @@
+/**************************************************************************/
+/*  nav_mesh_tiles_3d.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_MESH_TILES_3D_H
+#define NAV_MESH_TILES_3D_H
+
+#ifndef _3D_DISABLED
+
+#include "core/math/aabb.h"
+#include "core/math/vector2i.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/rid.h"
+#include "core/variant/callable.h"
+#include "scene/resources/3d/navigation_mesh_source_geometry_data_3d.h"
+#include "scene/resources/navigation_mesh.h"
+
+/**
+ * Tiled navigation mesh of a navigation map.
+ *
+ * The source geometry is split into square tiles on the XZ plane. Each tile is
+ * baked on its own worker thread into its own region on the map, and the map
+ * merges the edges that the tiles share. After a local change of the source
+ * geometry only the tiles around the changed area are baked again.
+ *
+ * Baked tiles are applied to their regions in `sync()`, on the main thread.
+ */
+class NavMeshTiles3D {
+	struct Tile {
+		Vector2i coords;
+		AABB aabb;
+		Ref<NavigationMesh> navigation_mesh;
+	};
+
+	struct BakeRequest {
+		Ref<NavigationMesh> navigation_mesh;
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry_data;
+		real_t tile_size = 0.0;
+		/// Empty to bake all tiles.
+		AABB dirty_aabb;
+		LocalVector<Callable> callbacks;
+	};
+
+	struct TileBake {
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry_data;
+		LocalVector<Tile> tiles;
+		LocalVector<Callable> callbacks;
+	};
+
+	RID map;
+	real_t tile_size = 0.0;
+	HashMap<Vector2i, RID> tile_regions;
+
+	TileBake *tile_bake = nullptr;
+	WorkerThreadPool::GroupID tile_bake_group_id = -1;
+
+	/// Requested while tiles were baking, started as soon as they are done.
+	bool has_pending_request = false;
+	BakeRequest pending_request;
+
+	static void _bake_tile(void *p_tile_bake, uint32_t p_index);
+
+	void _start_bake(const BakeRequest &p_request);
+	void _get_tile_range(const AABB &p_aabb, Vector2i &r_begin, Vector2i &r_end) const;
+
+public:
+	void bake(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, real_t p_tile_size, const AABB &p_dirty_aabb, const Callable &p_callback);
+	bool is_baking() const { return tile_bake != nullptr || has_pending_request; }
+
+	/// Applies the baked tiles to their regions. Returns early if the tiles are still baking, unless `p_wait` is set.
+	void sync(bool p_wait);
+
+	const HashMap<Vector2i, RID> &get_tile_regions() const { return tile_regions; }
+
+	NavMeshTiles3D(RID p_map) :
+			map(p_map) {}
+	~NavMeshTiles3D();
+};
+
+#endif // _3D_DISABLED
+
+#endif // NAV_MESH_TILES_3D_H
@@ -0,0 +1,142 @@
+/**************************************************************************/
+/*  nav_avoidance_grid.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_avoidance_grid.h"
+
+void NavAvoidanceGrid::set_cell_size(float p_cell_size) {
+	p_cell_size = MAX(p_cell_size, 0.1f);
+	if (p_cell_size == cell_size) {
+		return;
+	}
+
+	// All agents change cells, they are added again with their next position.
+	cell_size = p_cell_size;
+	const uint32_t agent_count = agent_cells.size();
+	clear();
+	resize(agent_count);
+}
+
+void NavAvoidanceGrid::resize(uint32_t p_agent_count) {
+	for (uint32_t i = p_agent_count; i < agent_cells.size(); i++) {
+		_remove_agent(i);
+	}
+
+	const uint32_t old_agent_count = agent_cells.size();
+	agent_cells.resize(p_agent_count);
+	agent_cell_indices.resize(p_agent_count);
+	for (uint32_t i = old_agent_count; i < p_agent_count; i++) {
+		agent_cells[i] = UINT32_MAX;
+		agent_cell_indices[i] = UINT32_MAX;
+	}
+}
+
+void NavAvoidanceGrid::_remove_agent(uint32_t p_agent) {
+	const uint32_t cell_index = agent_cells[p_agent];
+	if (cell_index == UINT32_MAX) {
+		return;
+	}
+
+	// Moves the last agent of the cell into the place of the removed one.
+	Cell &cell = cells[cell_index];
+	const uint32_t index = agent_cell_indices[p_agent];
+	const uint32_t last = cell.agents.size() - 1;
+	if (index != last) {
+		cell.agents[index] = cell.agents[last];
+		cell.x[index] = cell.x[last];
+		cell.y[index] = cell.y[last];
+		cell.z[index] = cell.z[last];
+		agent_cell_indices[cell.agents[index]] = index;
+	}
+	cell.agents.resize(last);
+	cell.x.resize(last);
+	cell.y.resize(last);
+	cell.z.resize(last);
+
+	agent_cells[p_agent] = UINT32_MAX;
+	agent_cell_indices[p_agent] = UINT32_MAX;
+}
+
+void NavAvoidanceGrid::set_agent_position(uint32_t p_agent, const Vector3 &p_position) {
+	ERR_FAIL_UNSIGNED_INDEX(p_agent, agent_cells.size());
+
+	const float y = flat ? 0.0f : (float)p_position.y;
+	const Vector3i coords = _get_cell_coords(p_position.x, y, p_position.z);
+
+	uint32_t cell_index = agent_cells[p_agent];
+	if (cell_index != UINT32_MAX && cells[cell_index].coords == coords) {
+		const uint32_t index = agent_cell_indices[p_agent];
+		Cell &cell = cells[cell_index];
+		cell.x[index] = p_position.x;
+		cell.y[index] = y;
+		cell.z[index] = p_position.z;
+		return;
+	}
+
+	_remove_agent(p_agent);
+
+	// Empty cells are kept, agents usually come back to them.
+	HashMap<Vector3i, uint32_t>::Iterator E = cell_indices.find(coords);
+	if (E) {
+		cell_index = E->value;
+	} else {
+		cell_index = cells.size();
+		cells.resize(cell_index + 1);
+		cells[cell_index].coords = coords;
+		cell_indices.insert(coords, cell_index);
+	}
+
+	Cell &cell = cells[cell_index];
+	agent_cells[p_agent] = cell_index;
+	agent_cell_indices[p_agent] = cell.agents.size();
+	cell.agents.push_back(p_agent);
+	cell.x.push_back(p_position.x);
+	cell.y.push_back(y);
+	cell.z.push_back(p_position.z);
+}
+
+Vector3 NavAvoidanceGrid::get_agent_position(uint32_t p_agent) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_agent, agent_cells.size(), Vector3());
+
+	const uint32_t cell_index = agent_cells[p_agent];
+	if (cell_index == UINT32_MAX) {
+		return Vector3();
+	}
+
+	const Cell &cell = cells[cell_index];
+	const uint32_t index = agent_cell_indices[p_agent];
+	return Vector3(cell.x[index], cell.y[index], cell.z[index]);
+}
+
+void NavAvoidanceGrid::clear() {
+	cell_indices.clear();
+	cells.clear();
+	agent_cells.clear();
+	agent_cell_indices.clear();
+}
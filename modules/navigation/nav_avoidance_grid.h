@@ -0,0 +1,146 @@
+/**************************************************************************/
+/*  nav_avoidance_grid.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_AVOIDANCE_GRID_H
+#define NAV_AVOIDANCE_GRID_H
+
+#include "core/math/vector3.h"
+#include "core/math/vector3i.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+/**
+ * Uniform grid used to find the avoidance neighbors of the agents.
+ *
+ * Agents are identified by their index in the list of avoidance agents of the
+ * map. The grid is updated with the positions of the agents on each step, and
+ * an agent only moves between cells when it leaves its cell, so there is no
+ * rebuild. The positions are stored per cell as separate coordinate arrays,
+ * which keeps the distance tests of a query in tight loops the compiler can
+ * vectorize.
+ *
+ * Queries only read the grid, so they can run on several threads at once.
+ */
+class NavAvoidanceGrid {
+	struct Cell {
+		Vector3i coords;
+		LocalVector<uint32_t> agents;
+		LocalVector<float> x;
+		LocalVector<float> y;
+		LocalVector<float> z;
+	};
+
+	/// Ignore the height of the positions, for 2D avoidance.
+	bool flat = false;
+	float cell_size = 1.0;
+
+	HashMap<Vector3i, uint32_t> cell_indices;
+	LocalVector<Cell> cells;
+
+	/// Cell of each agent and index of the agent in that cell, UINT32_MAX when not in the grid yet.
+	LocalVector<uint32_t> agent_cells;
+	LocalVector<uint32_t> agent_cell_indices;
+
+	_FORCE_INLINE_ Vector3i _get_cell_coords(float p_x, float p_y, float p_z) const {
+		return Vector3i((int)Math::floor(p_x / cell_size), flat ? 0 : (int)Math::floor(p_y / cell_size), (int)Math::floor(p_z / cell_size));
+	}
+
+	void _remove_agent(uint32_t p_agent);
+
+public:
+	/// Number of agents tested in one pass of a query.
+	static const uint32_t QUERY_CHUNK_SIZE = 64;
+
+	void set_cell_size(float p_cell_size);
+	float get_cell_size() const { return cell_size; }
+
+	void resize(uint32_t p_agent_count);
+	uint32_t get_agent_count() const { return agent_cells.size(); }
+
+	void set_agent_position(uint32_t p_agent, const Vector3 &p_position);
+	Vector3 get_agent_position(uint32_t p_agent) const;
+
+	/// Calls `p_insert(agent, r_range_sq)` for each agent within the range of `p_agent`, in no particular order.
+	/// `p_insert` may reduce `r_range_sq`, the following agents are then tested against the new range.
+	template <typename F>
+	void query(uint32_t p_agent, float &r_range_sq, F p_insert) const;
+
+	void clear();
+
+	NavAvoidanceGrid(bool p_flat) :
+			flat(p_flat) {}
+};
+
+template <typename F>
+void NavAvoidanceGrid::query(uint32_t p_agent, float &r_range_sq, F p_insert) const {
+	const Vector3 position = get_agent_position(p_agent);
+	const float range = Math::sqrt(r_range_sq);
+	const Vector3i begin = _get_cell_coords(position.x - range, position.y - range, position.z - range);
+	const Vector3i end = _get_cell_coords(position.x + range, position.y + range, position.z + range);
+
+	float distances_sq[QUERY_CHUNK_SIZE];
+
+	for (int cell_y = begin.y; cell_y <= end.y; cell_y++) {
+		for (int cell_z = begin.z; cell_z <= end.z; cell_z++) {
+			for (int cell_x = begin.x; cell_x <= end.x; cell_x++) {
+				const uint32_t *cell_index = cell_indices.getptr(Vector3i(cell_x, cell_y, cell_z));
+				if (cell_index == nullptr) {
+					continue;
+				}
+
+				const Cell &cell = cells[*cell_index];
+				const uint32_t *agents = cell.agents.ptr();
+				const float *x = cell.x.ptr();
+				const float *y = cell.y.ptr();
+				const float *z = cell.z.ptr();
+				const uint32_t agent_count = cell.agents.size();
+
+				for (uint32_t chunk_begin = 0; chunk_begin < agent_count; chunk_begin += QUERY_CHUNK_SIZE) {
+					const uint32_t chunk_size = MIN(agent_count - chunk_begin, QUERY_CHUNK_SIZE);
+
+					for (uint32_t i = 0; i < chunk_size; i++) {
+						const float dx = x[chunk_begin + i] - position.x;
+						const float dy = y[chunk_begin + i] - position.y;
+						const float dz = z[chunk_begin + i] - position.z;
+						distances_sq[i] = dx * dx + dy * dy + dz * dz;
+					}
+
+					for (uint32_t i = 0; i < chunk_size; i++) {
+						if (distances_sq[i] < r_range_sq && agents[chunk_begin + i] != p_agent) {
+							p_insert(agents[chunk_begin + i], r_range_sq);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+#endif // NAV_AVOIDANCE_GRID_H
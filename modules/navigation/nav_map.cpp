@@ -39,6 +39,8 @@
 
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+#include "core/templates/sort_array.h"
 
 #include <Obstacle2d.h>
 
@@ -92,6 +94,7 @@ void NavMap::set_use_edge_connections(bool p_enabled) {
 	}
 	use_edge_connections = p_enabled;
 	regenerate_links = true;
+	regenerate_hierarchy = true;
 }
 
 void NavMap::set_edge_connection_margin(real_t p_edge_connection_margin) {
@@ -100,6 +103,7 @@ void NavMap::set_edge_connection_margin(real_t p_edge_connection_margin) {
 	}
 	edge_connection_margin = p_edge_connection_margin;
 	regenerate_links = true;
+	regenerate_hierarchy = true;
 }
 
 void NavMap::set_link_connection_radius(real_t p_link_connection_radius) {
@@ -108,6 +112,24 @@ void NavMap::set_link_connection_radius(real_t p_link_connection_radius) {
 	}
 	link_connection_radius = p_link_connection_radius;
 	regenerate_links = true;
+	regenerate_hierarchy = true;
+}
+
+void NavMap::set_use_hierarchical_pathfinding(bool p_enabled) {
+	if (use_hierarchical_pathfinding == p_enabled) {
+		return;
+	}
+	use_hierarchical_pathfinding = p_enabled;
+	regenerate_hierarchy = true;
+}
+
+void NavMap::set_hierarchical_pathfinding_cluster_size(int p_cluster_size) {
+	ERR_FAIL_COND(p_cluster_size < 1);
+	if (hierarchical_pathfinding_cluster_size == p_cluster_size) {
+		return;
+	}
+	hierarchical_pathfinding_cluster_size = p_cluster_size;
+	regenerate_hierarchy = true;
 }
 
 gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
@@ -123,16 +145,103 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 	return p;
 }
 
-Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
+Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, uint32_t *r_searched_polygon_count, gd::PathSearchBuffers *p_buffers) const {
 	RWLockRead read_lock(map_rwlock);
 	if (iteration_id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return Vector<Vector3>();
 	}
 
-	return NavMeshQueries3D::polygons_get_path(
+	// Queries may run on several threads at once, each takes its own buffers from the pool.
+	gd::PathSearchBuffers *buffers = p_buffers;
+	if (!buffers) {
+		MutexLock lock(path_search_buffers_mutex);
+		if (path_search_buffers_pool.is_empty()) {
+			buffers = memnew(gd::PathSearchBuffers);
+		} else {
+			buffers = path_search_buffers_pool[path_search_buffers_pool.size() - 1];
+			path_search_buffers_pool.remove_at(path_search_buffers_pool.size() - 1);
+		}
+	}
+
+	const uint64_t query_begin_usec = OS::get_singleton()->get_ticks_usec();
+	uint32_t searched_polygon_count = 0;
+	const Vector<Vector3> path = NavMeshQueries3D::polygons_get_path(
 			polygons, p_origin, p_destination, p_optimize, p_navigation_layers,
-			r_path_types, r_path_rids, r_path_owners, up, link_polygons.size());
+			r_path_types, r_path_rids, r_path_owners, up, link_polygons.size(),
+			use_hierarchical_pathfinding && hierarchy.can_search(p_navigation_layers) ? &hierarchy : nullptr, &searched_polygon_count, buffers);
+	profiler.record(NavMapProfiler::STAGE_PATH_QUERY, OS::get_singleton()->get_ticks_usec() - query_begin_usec);
+	profiler.record(NavMapProfiler::STAGE_PATH_QUERY_SEARCHED_POLYGONS, searched_polygon_count);
+	if (r_searched_polygon_count) {
+		*r_searched_polygon_count = searched_polygon_count;
+	}
+
+	if (!p_buffers) {
+		MutexLock lock(path_search_buffers_mutex);
+		path_search_buffers_pool.push_back(buffers);
+	}
+	return path;
+}
+
+bool NavMap::get_flow(const Vector3 &p_target, const Vector3 &p_position, uint32_t p_navigation_layers, Vector3 &r_direction, real_t &r_cost) const {
+	RWLockRead read_lock(map_rwlock);
+	if (iteration_id == 0) {
+		NAVMAP_ITERATION_ZERO_ERROR_MSG();
+		return false;
+	}
+
+	{
+		RWLockRead flow_fields_read_lock(flow_fields_rwlock);
+		const NavMeshFlowField3D *flow_field = _find_flow_field(p_target, p_navigation_layers);
+		if (flow_field) {
+			flow_field->set_last_use(flow_fields_use_counter.increment());
+			return flow_field->get_flow(p_position, r_direction, r_cost);
+		}
+	}
+
+	// Built without holding the cache, threads asking for the same new target at once may each build it, only the first one is kept.
+	NavMeshFlowField3D *new_flow_field = memnew(NavMeshFlowField3D);
+	new_flow_field->build(polygons, link_polygons, link_polygon_count, p_target, p_navigation_layers);
+
+	RWLockWrite flow_fields_write_lock(flow_fields_rwlock);
+	NavMeshFlowField3D *flow_field = _find_flow_field(p_target, p_navigation_layers);
+	if (flow_field) {
+		memdelete(new_flow_field);
+	} else {
+		if (flow_fields.size() >= MAX_FLOW_FIELDS) {
+			uint32_t least_recently_used = 0;
+			for (uint32_t i = 1; i < flow_fields.size(); i++) {
+				if (flow_fields[i]->get_last_use() < flow_fields[least_recently_used]->get_last_use()) {
+					least_recently_used = i;
+				}
+			}
+			memdelete(flow_fields[least_recently_used]);
+			flow_fields.remove_at_unordered(least_recently_used);
+		}
+		flow_field = new_flow_field;
+		flow_fields.push_back(flow_field);
+	}
+
+	flow_field->set_last_use(flow_fields_use_counter.increment());
+	return flow_field->get_flow(p_position, r_direction, r_cost);
+}
+
+NavMeshFlowField3D *NavMap::_find_flow_field(const Vector3 &p_target, uint32_t p_navigation_layers) const {
+	for (NavMeshFlowField3D *flow_field : flow_fields) {
+		// Targets closer than a cell share their field.
+		if (flow_field->get_navigation_layers() == p_navigation_layers && flow_field->get_target().distance_squared_to(p_target) <= cell_size * cell_size) {
+			return flow_field;
+		}
+	}
+	return nullptr;
+}
+
+void NavMap::_clear_flow_fields() {
+	RWLockWrite flow_fields_write_lock(flow_fields_rwlock);
+	for (NavMeshFlowField3D *flow_field : flow_fields) {
+		memdelete(flow_field);
+	}
+	flow_fields.clear();
 }
 
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
@@ -196,14 +305,16 @@ void NavMap::remove_region(NavRegion *p_region) {
 
 void NavMap::add_link(NavLink *p_link) {
 	links.push_back(p_link);
-	regenerate_links = true;
+	regenerate_link_polygons = true;
+	regenerate_hierarchy = true;
 }
 
 void NavMap::remove_link(NavLink *p_link) {
 	int64_t link_index = links.find(p_link);
 	if (link_index >= 0) {
 		links.remove_at_unordered(link_index);
-		regenerate_links = true;
+		regenerate_link_polygons = true;
+		regenerate_hierarchy = true;
 	}
 }
 
@@ -354,7 +465,8 @@ Vector3 NavMap::get_random_point(uint32_t p_navigation_layers, bool p_uniformly)
 }
 
 void NavMap::sync() {
-	RWLockWrite write_lock(map_rwlock);
+	const uint64_t sync_begin_usec = OS::get_singleton()->get_ticks_usec();
+	profiler.update(sync_begin_usec);
 
 	// Performance Monitor
 	int _new_pm_region_count = regions.size();
@@ -373,280 +485,78 @@ void NavMap::sync() {
 			region->scratch_polygons();
 		}
 		regenerate_links = true;
+		regenerate_hierarchy = true;
 	}
 
+	// The regions own their polygons, so they are updated before locking the map for the queries.
+	HashSet<const NavBase *> changed_regions;
 	for (NavRegion *region : regions) {
 		if (region->sync()) {
-			regenerate_links = true;
+			changed_regions.insert(region);
 		}
 	}
 
 	for (NavLink *link : links) {
 		if (link->check_dirty()) {
-			regenerate_links = true;
+			regenerate_link_polygons = true;
+			regenerate_hierarchy = true;
 		}
 	}
 
-	if (regenerate_links) {
-		_new_pm_polygon_count = 0;
-		_new_pm_edge_count = 0;
-		_new_pm_edge_merge_count = 0;
-		_new_pm_edge_connection_count = 0;
-		_new_pm_edge_free_count = 0;
-
-		// Remove regions connections.
-		region_external_connections.clear();
-		for (NavRegion *region : regions) {
-			region_external_connections[region] = LocalVector<gd::Edge::Connection>();
-		}
+	// The new polygons and their connections are built from the current ones without locking the map, only this
+	// function changes them. Queries keep running meanwhile, and the result is swapped in under the write lock.
+	PolygonsUpdate polygons_update;
+	LocalVector<gd::Polygon> new_polygons;
 
-		// Resize the polygon count.
-		int polygon_count = 0;
-		for (const NavRegion *region : regions) {
-			if (!region->get_enabled()) {
-				continue;
-			}
-			polygon_count += region->get_polygons().size();
-		}
-		polygons.resize(polygon_count);
+	// Only reconnect the changed regions when the polygon ids of the others stay the same.
+	if (!regenerate_links && !changed_regions.is_empty() && !_build_changed_regions_update(changed_regions, _new_pm_edge_merge_count, polygons_update)) {
+		regenerate_links = true;
+	}
 
-		// Copy all region polygons in the map.
-		polygon_count = 0;
-		for (const NavRegion *region : regions) {
-			if (!region->get_enabled()) {
-				continue;
-			}
-			const LocalVector<gd::Polygon> &polygons_source = region->get_polygons();
-			for (uint32_t n = 0; n < polygons_source.size(); n++) {
-				polygons[polygon_count] = polygons_source[n];
-				polygons[polygon_count].id = polygon_count;
-				polygon_count++;
-			}
-		}
+	if (regenerate_links) {
+		_new_pm_edge_merge_count = _build_polygons(new_polygons);
+	}
 
-		_new_pm_polygon_count = polygon_count;
+	RWLockWrite write_lock(map_rwlock);
 
-		// Group all edges per key.
-		HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey> connections;
-		for (gd::Polygon &poly : polygons) {
-			for (uint32_t p = 0; p < poly.points.size(); p++) {
-				int next_point = (p + 1) % poly.points.size();
-				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+	if (regenerate_links) {
+		// Moving keeps the polygons at the addresses their connections point to.
+		polygons = std::move(new_polygons);
+
+		// The link connections point to the previous polygons.
+		link_endpoints.clear();
+		regenerate_link_polygons = true;
+	} else if (!changed_regions.is_empty()) {
+		_apply_polygons_update(polygons_update);
+	}
 
-				HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey>::Iterator connection = connections.find(ek);
-				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
-					_new_pm_edge_count += 1;
-				}
-				if (connections[ek].size() <= 1) {
-					// Add the polygon/edge tuple to this key.
-					gd::Edge::Connection new_connection;
-					new_connection.polygon = &poly;
-					new_connection.edge = p;
-					new_connection.pathway_start = poly.points[p].pos;
-					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
-				} else {
-					// The edge is already connected with another edge, skip.
-					ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
-				}
-			}
-		}
+	if (regenerate_links || regenerate_link_polygons || !changed_regions.is_empty()) {
+		_new_pm_edge_connection_count = _update_region_external_connections();
+		_sync_link_polygons(changed_regions, regenerate_link_polygons);
 
-		Vector<gd::Edge::Connection> free_edges;
-		for (KeyValue<gd::EdgeKey, Vector<gd::Edge::Connection>> &E : connections) {
-			if (E.value.size() == 2) {
-				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E.value.write[0];
-				gd::Edge::Connection &c2 = E.value.write[1];
-				c1.polygon->edges[c1.edge].connections.push_back(c2);
-				c2.polygon->edges[c2.edge].connections.push_back(c1);
-				// Note: The pathway_start/end are full for those connection and do not need to be modified.
-				_new_pm_edge_merge_count += 1;
-			} else {
-				CRASH_COND_MSG(E.value.size() != 1, vformat("Number of connection != 1. Found: %d", E.value.size()));
-				if (use_edge_connections && E.value[0].polygon->owner->get_use_edge_connections()) {
-					free_edges.push_back(E.value[0]);
-				}
-			}
-		}
-
-		// Find the compatible near edges.
-		//
-		// Note:
-		// Considering that the edges must be compatible (for obvious reasons)
-		// to be connected, create new polygons to remove that small gap is
-		// not really useful and would result in wasteful computation during
-		// connection, integration and path finding.
+		_new_pm_polygon_count = polygons.size();
+		_new_pm_edge_count = edge_connections.size();
 		_new_pm_edge_free_count = free_edges.size();
 
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
-
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
-				}
-
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
-
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-					continue;
-				}
-
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other1.distance_to(self1) > edge_connection_margin) {
-					continue;
-				}
-
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other2.distance_to(self2) > edge_connection_margin) {
-					continue;
-				}
+		// Some code treats 0 as a failure case, so we avoid returning 0 and modulo wrap UINT32_MAX manually.
+		iteration_id = iteration_id % UINT32_MAX + 1;
 
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
+		// The flow fields point into the old polygons.
+		_clear_flow_fields();
+	}
 
-				// Add the connection to the region_connection map.
-				region_external_connections[(NavRegion *)free_edge.polygon->owner].push_back(new_connection);
-				_new_pm_edge_connection_count += 1;
-			}
+	if (!use_hierarchical_pathfinding) {
+		hierarchy.clear();
+	} else if (regenerate_links || regenerate_hierarchy || !changed_regions.is_empty()) {
+		LocalVector<const gd::Polygon *> hierarchy_polygons;
+		hierarchy_polygons.resize(polygons.size() + link_polygon_count);
+		for (uint32_t i = 0; i < polygons.size(); i++) {
+			hierarchy_polygons[i] = &polygons[i];
 		}
-
-		uint32_t link_poly_idx = 0;
-		link_polygons.resize(links.size());
-
-		// Search for polygons within range of a nav link.
-		for (const NavLink *link : links) {
-			if (!link->get_enabled()) {
-				continue;
-			}
-			const Vector3 start = link->get_start_position();
-			const Vector3 end = link->get_end_position();
-
-			gd::Polygon *closest_start_polygon = nullptr;
-			real_t closest_start_distance = link_connection_radius;
-			Vector3 closest_start_point;
-
-			gd::Polygon *closest_end_polygon = nullptr;
-			real_t closest_end_distance = link_connection_radius;
-			Vector3 closest_end_point;
-
-			// Create link to any polygons within the search radius of the start point.
-			for (uint32_t start_index = 0; start_index < polygons.size(); start_index++) {
-				gd::Polygon &start_poly = polygons[start_index];
-
-				// For each face check the distance to the start
-				for (uint32_t start_point_id = 2; start_point_id < start_poly.points.size(); start_point_id += 1) {
-					const Face3 start_face(start_poly.points[0].pos, start_poly.points[start_point_id - 1].pos, start_poly.points[start_point_id].pos);
-					const Vector3 start_point = start_face.get_closest_point_to(start);
-					const real_t start_distance = start_point.distance_to(start);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (start_distance <= link_connection_radius && start_distance < closest_start_distance) {
-						closest_start_distance = start_distance;
-						closest_start_point = start_point;
-						closest_start_polygon = &start_poly;
-					}
-				}
-			}
-
-			// Find any polygons within the search radius of the end point.
-			for (gd::Polygon &end_poly : polygons) {
-				// For each face check the distance to the end
-				for (uint32_t end_point_id = 2; end_point_id < end_poly.points.size(); end_point_id += 1) {
-					const Face3 end_face(end_poly.points[0].pos, end_poly.points[end_point_id - 1].pos, end_poly.points[end_point_id].pos);
-					const Vector3 end_point = end_face.get_closest_point_to(end);
-					const real_t end_distance = end_point.distance_to(end);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (end_distance <= link_connection_radius && end_distance < closest_end_distance) {
-						closest_end_distance = end_distance;
-						closest_end_point = end_point;
-						closest_end_polygon = &end_poly;
-					}
-				}
-			}
-
-			// If we have both a start and end point, then create a synthetic polygon to route through.
-			if (closest_start_polygon && closest_end_polygon) {
-				gd::Polygon &new_polygon = link_polygons[link_poly_idx++];
-				new_polygon.id = polygon_count++;
-				new_polygon.owner = link;
-
-				new_polygon.edges.clear();
-				new_polygon.edges.resize(4);
-				new_polygon.points.clear();
-				new_polygon.points.reserve(4);
-
-				// Build a set of vertices that create a thin polygon going from the start to the end point.
-				new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
-				new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
-				new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
-				new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
-
-				// Setup connections to go forward in the link.
-				{
-					gd::Edge::Connection entry_connection;
-					entry_connection.polygon = &new_polygon;
-					entry_connection.edge = -1;
-					entry_connection.pathway_start = new_polygon.points[0].pos;
-					entry_connection.pathway_end = new_polygon.points[1].pos;
-					closest_start_polygon->edges[0].connections.push_back(entry_connection);
-
-					gd::Edge::Connection exit_connection;
-					exit_connection.polygon = closest_end_polygon;
-					exit_connection.edge = -1;
-					exit_connection.pathway_start = new_polygon.points[2].pos;
-					exit_connection.pathway_end = new_polygon.points[3].pos;
-					new_polygon.edges[2].connections.push_back(exit_connection);
-				}
-
-				// If the link is bi-directional, create connections from the end to the start.
-				if (link->is_bidirectional()) {
-					gd::Edge::Connection entry_connection;
-					entry_connection.polygon = &new_polygon;
-					entry_connection.edge = -1;
-					entry_connection.pathway_start = new_polygon.points[2].pos;
-					entry_connection.pathway_end = new_polygon.points[3].pos;
-					closest_end_polygon->edges[0].connections.push_back(entry_connection);
-
-					gd::Edge::Connection exit_connection;
-					exit_connection.polygon = closest_start_polygon;
-					exit_connection.edge = -1;
-					exit_connection.pathway_start = new_polygon.points[0].pos;
-					exit_connection.pathway_end = new_polygon.points[1].pos;
-					new_polygon.edges[0].connections.push_back(exit_connection);
-				}
-			}
+		for (uint32_t i = 0; i < link_polygon_count; i++) {
+			hierarchy_polygons[polygons.size() + i] = &link_polygons[i];
 		}
-
-		// Some code treats 0 as a failure case, so we avoid returning 0 and modulo wrap UINT32_MAX manually.
-		iteration_id = iteration_id % UINT32_MAX + 1;
+		hierarchy.build(hierarchy_polygons, hierarchical_pathfinding_cluster_size * cell_size, changed_regions, regenerate_hierarchy);
 	}
 
 	// Do we have modified obstacle positions?
@@ -669,6 +579,8 @@ void NavMap::sync() {
 
 	regenerate_polygons = false;
 	regenerate_links = false;
+	regenerate_link_polygons = false;
+	regenerate_hierarchy = false;
 	obstacles_dirty = false;
 	agents_dirty = false;
 
@@ -682,6 +594,8 @@ void NavMap::sync() {
 	pm_edge_connection_count = _new_pm_edge_connection_count;
 	pm_edge_free_count = _new_pm_edge_free_count;
 	pm_obstacle_count = _new_pm_obstacle_count;
+
+	profiler.record(NavMapProfiler::STAGE_SYNC, OS::get_singleton()->get_ticks_usec() - sync_begin_usec);
 }
 
 void NavMap::_update_rvo_obstacles_tree_2d() {
@@ -762,86 +676,128 @@ void NavMap::_update_rvo_obstacles_tree_2d() {
 	rvo_simulation_2d.kdTree_->buildObstacleTree(raw_obstacles);
 }
 
-void NavMap::_update_rvo_agents_tree_2d() {
-	// Cannot use LocalVector here as RVO library expects std::vector to build KdTree.
-	std::vector<RVO2D::Agent2D *> raw_agents;
-	raw_agents.reserve(active_2d_avoidance_agents.size());
-	for (NavAgent *agent : active_2d_avoidance_agents) {
-		raw_agents.push_back(agent->get_rvo_agent_2d());
+float NavMap::_get_median_neighbor_distance(LocalVector<float> &p_neighbor_distances) {
+	const int64_t median = p_neighbor_distances.size() / 2;
+	SortArray<float> sorter;
+	sorter.nth_element(0, p_neighbor_distances.size(), median, p_neighbor_distances.ptr());
+	return p_neighbor_distances[median];
+}
+
+void NavMap::_update_avoidance_grid_2d() {
+	// Cells as large as the typical neighbor distance, so that most queries visit 3x3 cells.
+	// Agents with a larger range visit more cells, rather than making every query test more agents.
+	LocalVector<float> neighbor_distances;
+	neighbor_distances.resize(active_2d_avoidance_agents.size());
+	for (uint32_t i = 0; i < active_2d_avoidance_agents.size(); i++) {
+		neighbor_distances[i] = active_2d_avoidance_agents[i]->get_rvo_agent_2d()->neighborDist_;
+	}
+	avoidance_grid_2d.set_cell_size(_get_median_neighbor_distance(neighbor_distances));
+	avoidance_grid_2d.resize(active_2d_avoidance_agents.size());
+
+	for (uint32_t i = 0; i < active_2d_avoidance_agents.size(); i++) {
+		const RVO2D::Vector2 &position = active_2d_avoidance_agents[i]->get_rvo_agent_2d()->position_;
+		avoidance_grid_2d.set_agent_position(i, Vector3(position.x(), 0.0, position.y()));
 	}
-	rvo_simulation_2d.kdTree_->buildAgentTree(raw_agents);
 }
 
-void NavMap::_update_rvo_agents_tree_3d() {
-	// Cannot use LocalVector here as RVO library expects std::vector to build KdTree.
-	std::vector<RVO3D::Agent3D *> raw_agents;
-	raw_agents.reserve(active_3d_avoidance_agents.size());
-	for (NavAgent *agent : active_3d_avoidance_agents) {
-		raw_agents.push_back(agent->get_rvo_agent_3d());
+void NavMap::_update_avoidance_grid_3d() {
+	LocalVector<float> neighbor_distances;
+	neighbor_distances.resize(active_3d_avoidance_agents.size());
+	for (uint32_t i = 0; i < active_3d_avoidance_agents.size(); i++) {
+		neighbor_distances[i] = active_3d_avoidance_agents[i]->get_rvo_agent_3d()->neighborDist_;
+	}
+	avoidance_grid_3d.set_cell_size(_get_median_neighbor_distance(neighbor_distances));
+	avoidance_grid_3d.resize(active_3d_avoidance_agents.size());
+
+	for (uint32_t i = 0; i < active_3d_avoidance_agents.size(); i++) {
+		const RVO3D::Vector3 &position = active_3d_avoidance_agents[i]->get_rvo_agent_3d()->position_;
+		avoidance_grid_3d.set_agent_position(i, Vector3(position.x(), position.y(), position.z()));
 	}
-	rvo_simulation_3d.kdTree_->buildAgentTree(raw_agents);
 }
 
 void NavMap::_update_rvo_simulation() {
 	if (obstacles_dirty) {
 		_update_rvo_obstacles_tree_2d();
 	}
-	if (agents_dirty) {
-		_update_rvo_agents_tree_2d();
-		_update_rvo_agents_tree_3d();
-	}
 }
 
 void NavMap::compute_single_avoidance_step_2d(uint32_t index, NavAgent **agent) {
-	(*(agent + index))->get_rvo_agent_2d()->computeNeighbors(&rvo_simulation_2d);
-	(*(agent + index))->get_rvo_agent_2d()->computeNewVelocity(&rvo_simulation_2d);
-	(*(agent + index))->get_rvo_agent_2d()->update(&rvo_simulation_2d);
-	(*(agent + index))->update();
+	RVO2D::Agent2D *rvo_agent = agent[index]->get_rvo_agent_2d();
+
+	// Same as `Agent2D::computeNeighbors()`, with the agent neighbors from the grid instead of the KdTree.
+	rvo_agent->obstacleNeighbors_.clear();
+	const float obstacle_range = rvo_agent->timeHorizonObst_ * rvo_agent->maxSpeed_ + rvo_agent->radius_;
+	rvo_simulation_2d.kdTree_->computeObstacleNeighbors(rvo_agent, obstacle_range * obstacle_range);
+
+	rvo_agent->agentNeighbors_.clear();
+	if (rvo_agent->maxNeighbors_ > 0) {
+		float range_sq = rvo_agent->neighborDist_ * rvo_agent->neighborDist_;
+		avoidance_grid_2d.query(index, range_sq, [rvo_agent, agent](uint32_t p_neighbor, float &r_range_sq) {
+			rvo_agent->insertAgentNeighbor(agent[p_neighbor]->get_rvo_agent_2d(), r_range_sq);
+		});
+	}
+
+	rvo_agent->computeNewVelocity(&rvo_simulation_2d);
+	rvo_agent->update(&rvo_simulation_2d);
+	agent[index]->update();
 }
 
 void NavMap::compute_single_avoidance_step_3d(uint32_t index, NavAgent **agent) {
-	(*(agent + index))->get_rvo_agent_3d()->computeNeighbors(&rvo_simulation_3d);
-	(*(agent + index))->get_rvo_agent_3d()->computeNewVelocity(&rvo_simulation_3d);
-	(*(agent + index))->get_rvo_agent_3d()->update(&rvo_simulation_3d);
-	(*(agent + index))->update();
+	RVO3D::Agent3D *rvo_agent = agent[index]->get_rvo_agent_3d();
+
+	rvo_agent->agentNeighbors_.clear();
+	if (rvo_agent->maxNeighbors_ > 0) {
+		float range_sq = rvo_agent->neighborDist_ * rvo_agent->neighborDist_;
+		avoidance_grid_3d.query(index, range_sq, [rvo_agent, agent](uint32_t p_neighbor, float &r_range_sq) {
+			rvo_agent->insertAgentNeighbor(agent[p_neighbor]->get_rvo_agent_3d(), r_range_sq);
+		});
+	}
+
+	rvo_agent->computeNewVelocity(&rvo_simulation_3d);
+	rvo_agent->update(&rvo_simulation_3d);
+	agent[index]->update();
 }
 
 void NavMap::step(real_t p_deltatime) {
+	const uint64_t step_begin_usec = OS::get_singleton()->get_ticks_usec();
 	deltatime = p_deltatime;
 
 	rvo_simulation_2d.setTimeStep(float(deltatime));
 	rvo_simulation_3d.setTimeStep(float(deltatime));
 
 	if (active_2d_avoidance_agents.size() > 0) {
+		// The agents move during the step, the grid keeps the positions they had before it.
+		_update_avoidance_grid_2d();
+
 		if (use_threads && avoidance_use_multiple_threads) {
 			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_avoidance_step_2d, active_2d_avoidance_agents.ptr(), active_2d_avoidance_agents.size(), -1, true, SNAME("RVOAvoidanceAgents2D"));
 			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 		} else {
-			for (NavAgent *agent : active_2d_avoidance_agents) {
-				agent->get_rvo_agent_2d()->computeNeighbors(&rvo_simulation_2d);
-				agent->get_rvo_agent_2d()->computeNewVelocity(&rvo_simulation_2d);
-				agent->get_rvo_agent_2d()->update(&rvo_simulation_2d);
-				agent->update();
+			for (uint32_t i = 0; i < active_2d_avoidance_agents.size(); i++) {
+				compute_single_avoidance_step_2d(i, active_2d_avoidance_agents.ptr());
 			}
 		}
 	}
 
 	if (active_3d_avoidance_agents.size() > 0) {
+		_update_avoidance_grid_3d();
+
 		if (use_threads && avoidance_use_multiple_threads) {
 			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_avoidance_step_3d, active_3d_avoidance_agents.ptr(), active_3d_avoidance_agents.size(), -1, true, SNAME("RVOAvoidanceAgents3D"));
 			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 		} else {
-			for (NavAgent *agent : active_3d_avoidance_agents) {
-				agent->get_rvo_agent_3d()->computeNeighbors(&rvo_simulation_3d);
-				agent->get_rvo_agent_3d()->computeNewVelocity(&rvo_simulation_3d);
-				agent->get_rvo_agent_3d()->update(&rvo_simulation_3d);
-				agent->update();
+			for (uint32_t i = 0; i < active_3d_avoidance_agents.size(); i++) {
+				compute_single_avoidance_step_3d(i, active_3d_avoidance_agents.ptr());
 			}
 		}
 	}
+
+	profiler.record(NavMapProfiler::STAGE_AVOIDANCE, OS::get_singleton()->get_ticks_usec() - step_begin_usec);
 }
 
 void NavMap::dispatch_callbacks() {
+	const uint64_t dispatch_begin_usec = OS::get_singleton()->get_ticks_usec();
+
 	for (NavAgent *agent : active_2d_avoidance_agents) {
 		agent->dispatch_avoidance_callback();
 	}
@@ -849,6 +805,475 @@ void NavMap::dispatch_callbacks() {
 	for (NavAgent *agent : active_3d_avoidance_agents) {
 		agent->dispatch_avoidance_callback();
 	}
+
+	profiler.record(NavMapProfiler::STAGE_CALLBACKS, OS::get_singleton()->get_ticks_usec() - dispatch_begin_usec);
+}
+
+void NavMap::_add_edge_connection(const gd::Polygon &p_polygon, gd::Polygon *p_map_polygon, uint32_t p_edge) {
+	const uint32_t next_point = (p_edge + 1) % p_polygon.points.size();
+	const gd::EdgeKey ek(p_polygon.points[p_edge].key, p_polygon.points[next_point].key);
+
+	HashMap<gd::EdgeKey, LocalVector<gd::Edge::Connection>, gd::EdgeKey>::Iterator connection = edge_connections.find(ek);
+	if (!connection) {
+		connection = edge_connections.insert(ek, LocalVector<gd::Edge::Connection>());
+	}
+	if (connection->value.size() <= 1) {
+		// Add the polygon/edge tuple to this key.
+		gd::Edge::Connection new_connection;
+		new_connection.polygon = p_map_polygon;
+		new_connection.edge = p_edge;
+		new_connection.pathway_start = p_polygon.points[p_edge].pos;
+		new_connection.pathway_end = p_polygon.points[next_point].pos;
+		connection->value.push_back(new_connection);
+	} else {
+		// The edge is already connected with another edge, skip.
+		ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
+	}
+}
+
+bool NavMap::_connect_free_edges(const gd::Edge::Connection &p_free_edge, const gd::Edge::Connection &p_other_edge, gd::Edge::Connection &r_connection) const {
+	// The pathway of a free edge is the whole edge, see _add_edge_connection(). The polygons it points to may not be updated yet.
+	const Vector3 edge_p1 = p_free_edge.pathway_start;
+	const Vector3 edge_p2 = p_free_edge.pathway_end;
+	const Vector3 other_edge_p1 = p_other_edge.pathway_start;
+	const Vector3 other_edge_p2 = p_other_edge.pathway_end;
+
+	// Compute the projection of the opposite edge on the current one
+	Vector3 edge_vector = edge_p2 - edge_p1;
+	real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
+	real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
+	if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+		return false;
+	}
+
+	// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+	Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other1;
+	if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+		other1 = other_edge_p1;
+	} else {
+		other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other1.distance_to(self1) > edge_connection_margin) {
+		return false;
+	}
+
+	Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other2;
+	if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+		other2 = other_edge_p2;
+	} else {
+		other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other2.distance_to(self2) > edge_connection_margin) {
+		return false;
+	}
+
+	// The edges can now be connected.
+	r_connection = p_other_edge;
+	r_connection.pathway_start = (self1 + other1) / 2.0;
+	r_connection.pathway_end = (self2 + other2) / 2.0;
+	return true;
+}
+
+int NavMap::_build_polygons(LocalVector<gd::Polygon> &r_polygons) {
+	int edge_merge_count = 0;
+
+	// Resize the polygon count.
+	int polygon_count = 0;
+	for (const NavRegion *region : regions) {
+		if (!region->get_enabled()) {
+			continue;
+		}
+		polygon_count += region->get_polygons().size();
+	}
+	r_polygons.resize(polygon_count);
+
+	// Copy all region polygons in the map.
+	polygon_count = 0;
+	region_polygon_ranges.clear();
+	for (const NavRegion *region : regions) {
+		RegionPolygons &region_range = region_polygon_ranges[region];
+		region_range.offset = polygon_count;
+		if (!region->get_enabled()) {
+			continue;
+		}
+		const LocalVector<gd::Polygon> &polygons_source = region->get_polygons();
+		for (uint32_t n = 0; n < polygons_source.size(); n++) {
+			r_polygons[polygon_count] = polygons_source[n];
+			r_polygons[polygon_count].id = polygon_count;
+			polygon_count++;
+		}
+		region_range.count = polygons_source.size();
+	}
+
+	// Group all edges per key.
+	edge_connections.clear();
+	for (gd::Polygon &poly : r_polygons) {
+		for (uint32_t p = 0; p < poly.points.size(); p++) {
+			_add_edge_connection(poly, &poly, p);
+		}
+	}
+
+	free_edges.clear();
+	for (KeyValue<gd::EdgeKey, LocalVector<gd::Edge::Connection>> &E : edge_connections) {
+		if (E.value.size() == 2) {
+			// Connect edge that are shared in different polygons.
+			gd::Edge::Connection &c1 = E.value[0];
+			gd::Edge::Connection &c2 = E.value[1];
+			c1.polygon->edges[c1.edge].connections.push_back(c2);
+			c2.polygon->edges[c2.edge].connections.push_back(c1);
+			// Note: The pathway_start/end are full for those connection and do not need to be modified.
+			edge_merge_count += 1;
+		} else {
+			CRASH_COND_MSG(E.value.size() != 1, vformat("Number of connection != 1. Found: %d", E.value.size()));
+			if (use_edge_connections && E.value[0].polygon->owner->get_use_edge_connections()) {
+				free_edges.push_back(E.value[0]);
+			}
+		}
+	}
+
+	// Find the compatible near edges.
+	//
+	// Note:
+	// Considering that the edges must be compatible (for obvious reasons)
+	// to be connected, create new polygons to remove that small gap is
+	// not really useful and would result in wasteful computation during
+	// connection, integration and path finding.
+	for (uint32_t i = 0; i < free_edges.size(); i++) {
+		const gd::Edge::Connection &free_edge = free_edges[i];
+		for (uint32_t j = 0; j < free_edges.size(); j++) {
+			const gd::Edge::Connection &other_edge = free_edges[j];
+			if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
+				continue;
+			}
+
+			gd::Edge::Connection new_connection;
+			if (_connect_free_edges(free_edge, other_edge, new_connection)) {
+				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
+			}
+		}
+	}
+
+	return edge_merge_count;
+}
+
+Vector<gd::Edge::Connection> &NavMap::_get_updated_connections(PolygonsUpdate &r_update, const gd::Edge::Connection &p_edge) {
+	const uint32_t *polygon_index = r_update.polygon_indices.getptr(p_edge.polygon->id);
+	if (polygon_index) {
+		return r_update.polygons[*polygon_index].edges[p_edge.edge].connections;
+	}
+
+	// Other edges start from their current connections.
+	const uint64_t edge_id = _get_edge_id(p_edge);
+	HashMap<uint64_t, PolygonsUpdate::EdgeConnections>::Iterator E = r_update.edges.find(edge_id);
+	if (!E) {
+		PolygonsUpdate::EdgeConnections edge;
+		edge.polygon = p_edge.polygon;
+		edge.edge = p_edge.edge;
+		edge.connections = p_edge.polygon->edges[p_edge.edge].connections;
+		E = r_update.edges.insert(edge_id, edge);
+	}
+	return E->value.connections;
+}
+
+bool NavMap::_build_changed_regions_update(const HashSet<const NavBase *> &p_changed_regions, int &r_edge_merge_count, PolygonsUpdate &r_update) {
+	// The polygons of a changed region replace the previous ones at the same ids, which keeps the ids and the
+	// connections of all other polygons valid as long as its polygon count doesn't change.
+	for (const NavBase *owner : p_changed_regions) {
+		const NavRegion *region = static_cast<const NavRegion *>(owner);
+		const RegionPolygons *region_range = region_polygon_ranges.getptr(owner);
+		const uint32_t polygon_count = region->get_enabled() ? region->get_polygons().size() : 0;
+		if (!region_range || region_range->count != polygon_count) {
+			return false;
+		}
+	}
+
+	// Remove the previous edges of the changed regions from their keys.
+	HashSet<gd::EdgeKey, gd::EdgeKey> changed_keys;
+	for (const NavBase *owner : p_changed_regions) {
+		const RegionPolygons &region_range = region_polygon_ranges[owner];
+		for (uint32_t i = region_range.offset; i < region_range.offset + region_range.count; i++) {
+			const gd::Polygon &poly = polygons[i];
+			for (uint32_t p = 0; p < poly.points.size(); p++) {
+				const gd::EdgeKey ek(poly.points[p].key, poly.points[(p + 1) % poly.points.size()].key);
+				HashMap<gd::EdgeKey, LocalVector<gd::Edge::Connection>, gd::EdgeKey>::Iterator connection = edge_connections.find(ek);
+				if (!connection) {
+					continue;
+				}
+				if (!changed_keys.has(ek)) {
+					changed_keys.insert(ek);
+					if (connection->value.size() == 2) {
+						r_edge_merge_count -= 1;
+					}
+				}
+				for (uint32_t c = 0; c < connection->value.size(); c++) {
+					if (connection->value[c].polygon == &poly && connection->value[c].edge == int(p)) {
+						connection->value.remove_at(c);
+						break;
+					}
+				}
+				if (connection->value.is_empty()) {
+					edge_connections.erase(ek);
+				}
+			}
+		}
+	}
+
+	// Copy the new polygons of the changed regions and add their edges, pointing to the map polygons they replace.
+	for (const NavBase *owner : p_changed_regions) {
+		const RegionPolygons &region_range = region_polygon_ranges[owner];
+		const LocalVector<gd::Polygon> &polygons_source = static_cast<const NavRegion *>(owner)->get_polygons();
+		for (uint32_t n = 0; n < region_range.count; n++) {
+			const uint32_t id = region_range.offset + n;
+			r_update.polygon_indices.insert(id, r_update.polygons.size());
+			r_update.polygons.push_back(polygons_source[n]);
+			gd::Polygon &poly = r_update.polygons[r_update.polygons.size() - 1];
+			poly.id = id;
+			for (uint32_t p = 0; p < poly.points.size(); p++) {
+				const gd::EdgeKey ek(poly.points[p].key, poly.points[(p + 1) % poly.points.size()].key);
+				if (!changed_keys.has(ek)) {
+					changed_keys.insert(ek);
+					const LocalVector<gd::Edge::Connection> *connections = edge_connections.getptr(ek);
+					if (connections && connections->size() == 2) {
+						r_edge_merge_count -= 1;
+					}
+				}
+				_add_edge_connection(poly, &polygons[id], p);
+			}
+		}
+	}
+
+	// All edges of a changed key are reconnected, the unchanged ones may have lost or gained a
+	// merged edge.
+	HashSet<uint64_t> changed_edges;
+	for (const gd::EdgeKey &ek : changed_keys) {
+		LocalVector<gd::Edge::Connection> *connections = edge_connections.getptr(ek);
+		if (!connections) {
+			continue;
+		}
+		for (const gd::Edge::Connection &connection : *connections) {
+			changed_edges.insert(_get_edge_id(connection));
+			_get_updated_connections(r_update, connection).clear();
+		}
+		if (connections->size() == 2) {
+			gd::Edge::Connection &c1 = (*connections)[0];
+			gd::Edge::Connection &c2 = (*connections)[1];
+			_get_updated_connections(r_update, c1).push_back(c2);
+			_get_updated_connections(r_update, c2).push_back(c1);
+			r_edge_merge_count += 1;
+		}
+	}
+
+	// Keep the unchanged free edges, without their connections to the changed edges.
+	uint32_t unchanged_free_edge_count = 0;
+	for (uint32_t i = 0; i < free_edges.size(); i++) {
+		const gd::Edge::Connection free_edge = free_edges[i];
+		if (p_changed_regions.has(free_edge.polygon->owner) || changed_edges.has(_get_edge_id(free_edge))) {
+			continue;
+		}
+		const Vector<gd::Edge::Connection> &current_connections = free_edge.polygon->edges[free_edge.edge].connections;
+		for (int c = current_connections.size() - 1; c >= 0; c--) {
+			const gd::Edge::Connection &connection = current_connections[c];
+			if (connection.edge != -1 && (p_changed_regions.has(connection.polygon->owner) || changed_edges.has(_get_edge_id(connection)))) {
+				Vector<gd::Edge::Connection> &connections = _get_updated_connections(r_update, free_edge);
+				connections.remove_at(c);
+			}
+		}
+		free_edges[unchanged_free_edge_count++] = free_edge;
+	}
+	free_edges.resize(unchanged_free_edge_count);
+
+	for (const gd::EdgeKey &ek : changed_keys) {
+		const LocalVector<gd::Edge::Connection> *connections = edge_connections.getptr(ek);
+		if (connections && connections->size() == 1 && use_edge_connections && (*connections)[0].polygon->owner->get_use_edge_connections()) {
+			free_edges.push_back((*connections)[0]);
+		}
+	}
+
+	// Only the changed free edges need to be compared with all others.
+	for (uint32_t i = unchanged_free_edge_count; i < free_edges.size(); i++) {
+		const gd::Edge::Connection &free_edge = free_edges[i];
+		for (uint32_t j = 0; j < free_edges.size(); j++) {
+			const gd::Edge::Connection &other_edge = free_edges[j];
+			if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
+				continue;
+			}
+
+			gd::Edge::Connection new_connection;
+			if (_connect_free_edges(free_edge, other_edge, new_connection)) {
+				_get_updated_connections(r_update, free_edge).push_back(new_connection);
+			}
+			if (j < unchanged_free_edge_count && _connect_free_edges(other_edge, free_edge, new_connection)) {
+				_get_updated_connections(r_update, other_edge).push_back(new_connection);
+			}
+		}
+	}
+
+	return true;
+}
+
+void NavMap::_apply_polygons_update(PolygonsUpdate &r_update) {
+	for (gd::Polygon &poly : r_update.polygons) {
+		polygons[poly.id] = std::move(poly);
+	}
+	for (KeyValue<uint64_t, PolygonsUpdate::EdgeConnections> &E : r_update.edges) {
+		E.value.polygon->edges[E.value.edge].connections = E.value.connections;
+	}
+}
+
+int NavMap::_update_region_external_connections() {
+	region_external_connections.clear();
+	for (NavRegion *region : regions) {
+		region_external_connections[region] = LocalVector<gd::Edge::Connection>();
+	}
+
+	// Free edges are not merged with another edge, so all their connections use the edge connection margin.
+	int connection_count = 0;
+	for (const gd::Edge::Connection &free_edge : free_edges) {
+		LocalVector<gd::Edge::Connection> &region_connections = region_external_connections[(NavRegion *)free_edge.polygon->owner];
+		for (const gd::Edge::Connection &connection : free_edge.polygon->edges[free_edge.edge].connections) {
+			// Skip the links.
+			if (connection.edge == -1) {
+				continue;
+			}
+			region_connections.push_back(connection);
+			connection_count += 1;
+		}
+	}
+	return connection_count;
+}
+
+void NavMap::_find_link_polygon(const Vector3 &p_position, uint32_t p_begin, uint32_t p_end, LinkEndpoint &r_endpoint) {
+	for (uint32_t i = p_begin; i < p_end; i++) {
+		gd::Polygon &poly = polygons[i];
+
+		// For each face check the distance to the position.
+		for (uint32_t point_id = 2; point_id < poly.points.size(); point_id += 1) {
+			const Face3 face(poly.points[0].pos, poly.points[point_id - 1].pos, poly.points[point_id].pos);
+			const Vector3 point = face.get_closest_point_to(p_position);
+			const real_t distance = point.distance_to(p_position);
+
+			// Pick the polygon that is within our radius and is closer than anything we've seen yet.
+			if (distance <= link_connection_radius && distance < r_endpoint.distance) {
+				r_endpoint.distance = distance;
+				r_endpoint.point = point;
+				r_endpoint.polygon = &poly;
+			}
+		}
+	}
+}
+
+void NavMap::_update_link_endpoint(const Vector3 &p_position, const HashSet<const NavBase *> &p_changed_regions, bool p_search_all, LinkEndpoint &r_endpoint) {
+	if (p_search_all || (r_endpoint.polygon && p_changed_regions.has(r_endpoint.polygon->owner))) {
+		r_endpoint = LinkEndpoint();
+		_find_link_polygon(p_position, 0, polygons.size(), r_endpoint);
+		return;
+	}
+
+	// Only the polygons of the changed regions can be closer than before.
+	for (const NavBase *owner : p_changed_regions) {
+		const RegionPolygons &region_range = region_polygon_ranges[owner];
+		_find_link_polygon(p_position, region_range.offset, region_range.offset + region_range.count, r_endpoint);
+	}
+}
+
+void NavMap::_sync_link_polygons(const HashSet<const NavBase *> &p_changed_regions, bool p_search_all) {
+	// Remove the connections to the previous link polygons.
+	for (const LinkEndpoint &endpoint : link_endpoints) {
+		if (!endpoint.polygon || endpoint.polygon->edges.is_empty()) {
+			continue;
+		}
+		Vector<gd::Edge::Connection> &connections = endpoint.polygon->edges[0].connections;
+		for (int c = connections.size() - 1; c >= 0; c--) {
+			if (connections[c].edge == -1) {
+				connections.remove_at(c);
+			}
+		}
+	}
+
+	if (link_endpoints.size() != links.size() * 2) {
+		p_search_all = true;
+		link_endpoints.resize(links.size() * 2);
+	}
+
+	uint32_t polygon_count = polygons.size();
+	uint32_t link_poly_idx = 0;
+	link_polygons.resize(links.size());
+
+	// Search for polygons within range of a nav link.
+	for (uint32_t link_index = 0; link_index < links.size(); link_index++) {
+		const NavLink *link = links[link_index];
+		LinkEndpoint &start = link_endpoints[link_index * 2];
+		LinkEndpoint &end = link_endpoints[link_index * 2 + 1];
+		if (!link->get_enabled()) {
+			start = LinkEndpoint();
+			end = LinkEndpoint();
+			continue;
+		}
+
+		_update_link_endpoint(link->get_start_position(), p_changed_regions, p_search_all, start);
+		_update_link_endpoint(link->get_end_position(), p_changed_regions, p_search_all, end);
+
+		// If we have both a start and end point, then create a synthetic polygon to route through.
+		if (start.polygon && end.polygon) {
+			gd::Polygon *closest_start_polygon = start.polygon;
+			gd::Polygon *closest_end_polygon = end.polygon;
+			const Vector3 closest_start_point = start.point;
+			const Vector3 closest_end_point = end.point;
+
+			gd::Polygon &new_polygon = link_polygons[link_poly_idx++];
+			new_polygon.id = polygon_count++;
+			new_polygon.owner = link;
+
+			new_polygon.edges.clear();
+			new_polygon.edges.resize(4);
+			new_polygon.points.clear();
+			new_polygon.points.reserve(4);
+
+			// Build a set of vertices that create a thin polygon going from the start to the end point.
+			new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
+			new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
+			new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
+			new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
+
+			// Setup connections to go forward in the link.
+			{
+				gd::Edge::Connection entry_connection;
+				entry_connection.polygon = &new_polygon;
+				entry_connection.edge = -1;
+				entry_connection.pathway_start = new_polygon.points[0].pos;
+				entry_connection.pathway_end = new_polygon.points[1].pos;
+				closest_start_polygon->edges[0].connections.push_back(entry_connection);
+
+				gd::Edge::Connection exit_connection;
+				exit_connection.polygon = closest_end_polygon;
+				exit_connection.edge = -1;
+				exit_connection.pathway_start = new_polygon.points[2].pos;
+				exit_connection.pathway_end = new_polygon.points[3].pos;
+				new_polygon.edges[2].connections.push_back(exit_connection);
+			}
+
+			// If the link is bi-directional, create connections from the end to the start.
+			if (link->is_bidirectional()) {
+				gd::Edge::Connection entry_connection;
+				entry_connection.polygon = &new_polygon;
+				entry_connection.edge = -1;
+				entry_connection.pathway_start = new_polygon.points[2].pos;
+				entry_connection.pathway_end = new_polygon.points[3].pos;
+				closest_end_polygon->edges[0].connections.push_back(entry_connection);
+
+				gd::Edge::Connection exit_connection;
+				exit_connection.polygon = closest_start_polygon;
+				exit_connection.edge = -1;
+				exit_connection.pathway_start = new_polygon.points[0].pos;
+				exit_connection.pathway_end = new_polygon.points[1].pos;
+				new_polygon.edges[0].connections.push_back(exit_connection);
+			}
+		}
+	}
+
+	link_polygon_count = link_poly_idx;
 }
 
 void NavMap::_update_merge_rasterizer_cell_dimensions() {
@@ -893,7 +1318,13 @@ Vector3 NavMap::get_region_connection_pathway_end(NavRegion *p_region, int p_con
 NavMap::NavMap() {
 	avoidance_use_multiple_threads = GLOBAL_GET("navigation/avoidance/thread_model/avoidance_use_multiple_threads");
 	avoidance_use_high_priority_threads = GLOBAL_GET("navigation/avoidance/thread_model/avoidance_use_high_priority_threads");
+	use_hierarchical_pathfinding = GLOBAL_GET("navigation/pathfinding/use_hierarchical_pathfinding");
+	hierarchical_pathfinding_cluster_size = MAX(int(GLOBAL_GET("navigation/pathfinding/hierarchical_pathfinding_cluster_size")), 1);
 }
 
 NavMap::~NavMap() {
+	for (gd::PathSearchBuffers *buffers : path_search_buffers_pool) {
+		memdelete(buffers);
+	}
+	_clear_flow_fields();
 }
@@ -31,10 +31,15 @@
 #ifndef NAV_MAP_H
 #define NAV_MAP_H
 
+#include "3d/nav_mesh_flow_field_3d.h"
+#include "3d/nav_mesh_hierarchy_3d.h"
+#include "nav_avoidance_grid.h"
+#include "nav_map_profiler.h"
 #include "nav_rid.h"
 #include "nav_utils.h"
 
 #include "core/math/math_defs.h"
+#include "core/os/mutex.h"
 #include "core/object/worker_thread_pool.h"
 #include "servers/navigation/navigation_globals.h"
 
@@ -74,6 +79,7 @@ class NavMap : public NavRid {
 
 	bool regenerate_polygons = true;
 	bool regenerate_links = true;
+	bool regenerate_link_polygons = true;
 
 	/// Map regions
 	LocalVector<NavRegion *> regions;
@@ -84,6 +90,63 @@ class NavMap : public NavRid {
 
 	/// Map polygons
 	LocalVector<gd::Polygon> polygons;
+	uint32_t link_polygon_count = 0;
+
+	/// Range of the polygons of each region in `polygons`.
+	struct RegionPolygons {
+		uint32_t offset = 0;
+		uint32_t count = 0;
+	};
+	HashMap<const NavBase *, RegionPolygons> region_polygon_ranges;
+
+	/// Polygon edges grouped by key, and the edges that are not merged with another one.
+	/// Kept between syncs to only reconnect the regions that changed.
+	HashMap<gd::EdgeKey, LocalVector<gd::Edge::Connection>, gd::EdgeKey> edge_connections;
+	LocalVector<gd::Edge::Connection> free_edges;
+
+	/// Reconnection of the changed regions, built without locking the map and applied to it at once.
+	/// Only `sync()` changes the polygons, so it can read them meanwhile.
+	struct PolygonsUpdate {
+		/// New polygons of the changed regions, with their connections, replacing the polygons with the same id.
+		LocalVector<gd::Polygon> polygons;
+		HashMap<uint32_t, uint32_t> polygon_indices;
+
+		/// New connections of the edges of the other polygons.
+		struct EdgeConnections {
+			gd::Polygon *polygon = nullptr;
+			int edge = -1;
+			Vector<gd::Edge::Connection> connections;
+		};
+		HashMap<uint64_t, EdgeConnections> edges;
+	};
+
+	/// Closest polygon to the start and end of each link.
+	struct LinkEndpoint {
+		gd::Polygon *polygon = nullptr;
+		Vector3 point;
+		real_t distance = FLT_MAX;
+	};
+	LocalVector<LinkEndpoint> link_endpoints;
+
+	/// Abstract graph for path queries on large maps.
+	bool use_hierarchical_pathfinding = false;
+	int hierarchical_pathfinding_cluster_size = 64;
+	bool regenerate_hierarchy = true;
+	NavMeshHierarchy3D hierarchy;
+
+	/// Search buffers of finished path queries, reused by the next queries.
+	mutable BinaryMutex path_search_buffers_mutex;
+	mutable LocalVector<gd::PathSearchBuffers *> path_search_buffers_pool;
+
+	/// Flow fields of the last queried targets. Cleared when the map changes.
+	/// Fields are sampled under the read lock, so agents on several threads sample them at once.
+	static const uint32_t MAX_FLOW_FIELDS = 16;
+	mutable RWLock flow_fields_rwlock;
+	mutable LocalVector<NavMeshFlowField3D *> flow_fields;
+	mutable SafeNumeric<uint64_t> flow_fields_use_counter;
+
+	NavMeshFlowField3D *_find_flow_field(const Vector3 &p_target, uint32_t p_navigation_layers) const;
+	void _clear_flow_fields();
 
 	/// RVO avoidance worlds
 	RVO2D::RVOSimulator2D rvo_simulation_2d;
@@ -93,6 +156,10 @@ class NavMap : public NavRid {
 	LocalVector<NavAgent *> active_2d_avoidance_agents;
 	LocalVector<NavAgent *> active_3d_avoidance_agents;
 
+	/// Neighbor search of the avoidance controlled agents, by index in the lists above.
+	NavAvoidanceGrid avoidance_grid_2d = NavAvoidanceGrid(true);
+	NavAvoidanceGrid avoidance_grid_3d = NavAvoidanceGrid(false);
+
 	/// dirty flag when one of the agent's arrays are modified
 	bool agents_dirty = true;
 
@@ -126,6 +193,9 @@ class NavMap : public NavRid {
 	int pm_edge_free_count = 0;
 	int pm_obstacle_count = 0;
 
+	// Path queries are const and may run on several threads, they record themselves too.
+	mutable NavMapProfiler profiler;
+
 	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>> region_external_connections;
 
 public:
@@ -167,9 +237,25 @@ public:
 		return link_connection_radius;
 	}
 
+	void set_use_hierarchical_pathfinding(bool p_enabled);
+	bool get_use_hierarchical_pathfinding() const {
+		return use_hierarchical_pathfinding;
+	}
+
+	/// Size of the clusters of the abstract graph, in cells.
+	void set_hierarchical_pathfinding_cluster_size(int p_cluster_size);
+	int get_hierarchical_pathfinding_cluster_size() const {
+		return hierarchical_pathfinding_cluster_size;
+	}
+
+	const NavMeshHierarchy3D &get_hierarchy() const {
+		return hierarchy;
+	}
+
 	gd::PointKey get_point_key(const Vector3 &p_pos) const;
 
-	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
+	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, uint32_t *r_searched_polygon_count = nullptr, gd::PathSearchBuffers *p_buffers = nullptr) const;
+	bool get_flow(const Vector3 &p_target, const Vector3 &p_position, uint32_t p_navigation_layers, Vector3 &r_direction, real_t &r_cost) const;
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const;
 	Vector3 get_closest_point(const Vector3 &p_point) const;
 	Vector3 get_closest_point_normal(const Vector3 &p_point) const;
@@ -222,6 +308,9 @@ public:
 	int get_pm_edge_free_count() const { return pm_edge_free_count; }
 	int get_pm_obstacle_count() const { return pm_obstacle_count; }
 
+	NavMapProfiler &get_profiler() { return profiler; }
+	const NavMapProfiler &get_profiler() const { return profiler; }
+
 	int get_region_connections_count(NavRegion *p_region) const;
 	Vector3 get_region_connection_pathway_start(NavRegion *p_region, int p_connection_id) const;
 	Vector3 get_region_connection_pathway_end(NavRegion *p_region, int p_connection_id) const;
@@ -234,10 +323,25 @@ private:
 
 	void _update_rvo_simulation();
 	void _update_rvo_obstacles_tree_2d();
-	void _update_rvo_agents_tree_2d();
-	void _update_rvo_agents_tree_3d();
+	static float _get_median_neighbor_distance(LocalVector<float> &p_neighbor_distances);
+	void _update_avoidance_grid_2d();
+	void _update_avoidance_grid_3d();
 
 	void _update_merge_rasterizer_cell_dimensions();
+
+	static uint64_t _get_edge_id(const gd::Edge::Connection &p_connection) {
+		return (uint64_t(p_connection.polygon->id) << 32) | uint32_t(p_connection.edge);
+	}
+	void _add_edge_connection(const gd::Polygon &p_polygon, gd::Polygon *p_map_polygon, uint32_t p_edge);
+	bool _connect_free_edges(const gd::Edge::Connection &p_free_edge, const gd::Edge::Connection &p_other_edge, gd::Edge::Connection &r_connection) const;
+	int _build_polygons(LocalVector<gd::Polygon> &r_polygons);
+	static Vector<gd::Edge::Connection> &_get_updated_connections(PolygonsUpdate &r_update, const gd::Edge::Connection &p_edge);
+	bool _build_changed_regions_update(const HashSet<const NavBase *> &p_changed_regions, int &r_edge_merge_count, PolygonsUpdate &r_update);
+	void _apply_polygons_update(PolygonsUpdate &r_update);
+	int _update_region_external_connections();
+	void _find_link_polygon(const Vector3 &p_position, uint32_t p_begin, uint32_t p_end, LinkEndpoint &r_endpoint);
+	void _update_link_endpoint(const Vector3 &p_position, const HashSet<const NavBase *> &p_changed_regions, bool p_search_all, LinkEndpoint &r_endpoint);
+	void _sync_link_polygons(const HashSet<const NavBase *> &p_changed_regions, bool p_search_all);
 };
 
 #endif // NAV_MAP_H
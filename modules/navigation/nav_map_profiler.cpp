@@ -0,0 +1,151 @@
+/**************************************************************************/
+/*  nav_map_profiler.cpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_map_profiler.h"
+
+#include "core/variant/variant.h"
+
+uint64_t NavMapProfiler::Histogram::get_percentile(double p_fraction) const {
+	if (count == 0) {
+		return 0;
+	}
+
+	const uint64_t rank = MAX(uint64_t(Math::ceil(p_fraction * count)), uint64_t(1));
+	uint64_t seen = 0;
+	for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+		seen += buckets[i];
+		if (seen >= rank) {
+			const uint64_t bucket_end = i == 0 ? 0 : (uint64_t(1) << i) - 1;
+			return MIN(bucket_end, max);
+		}
+	}
+	return max;
+}
+
+void NavMapProfiler::Histogram::merge(const Histogram &p_histogram) {
+	for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+		buckets[i] += p_histogram.buckets[i];
+	}
+	count += p_histogram.count;
+	total += p_histogram.total;
+	max = MAX(max, p_histogram.max);
+	last += p_histogram.last;
+}
+
+Dictionary NavMapProfiler::Histogram::to_dictionary() const {
+	PackedInt64Array bucket_counts;
+	bucket_counts.resize(BUCKET_COUNT);
+	int64_t *w = bucket_counts.ptrw();
+	for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+		w[i] = buckets[i];
+	}
+
+	Dictionary histogram;
+	histogram["count"] = count;
+	histogram["total"] = total;
+	histogram["max"] = max;
+	histogram["last"] = last;
+	histogram["p50"] = get_percentile(0.5);
+	histogram["p99"] = get_percentile(0.99);
+	histogram["histogram"] = bucket_counts;
+	return histogram;
+}
+
+uint32_t NavMapProfiler::get_bucket(uint64_t p_value) {
+	// nearest_shift() only looks at the 31 lower bits, larger values all go to the last bucket.
+	return MIN(nearest_shift(uint32_t(MIN(p_value, uint64_t(INT32_MAX)))), BUCKET_COUNT - 1);
+}
+
+const char *NavMapProfiler::get_stage_name(Stage p_stage) {
+	static const char *names[STAGE_MAX] = {
+		"sync",
+		"avoidance",
+		"callbacks",
+		"path_query",
+		"path_query_searched_polygons",
+	};
+	ERR_FAIL_INDEX_V(p_stage, STAGE_MAX, "");
+	return names[p_stage];
+}
+
+void NavMapProfiler::record(Stage p_stage, uint64_t p_value) {
+	SafeHistogram &histogram = current[p_stage];
+	histogram.buckets[get_bucket(p_value)].increment();
+	histogram.count.increment();
+	histogram.total.add(p_value);
+	histogram.max.exchange_if_greater(p_value);
+	histogram.last.set(p_value);
+}
+
+void NavMapProfiler::update(uint64_t p_now_usec, bool p_force) {
+	if (window_begin_usec == 0) {
+		window_begin_usec = p_now_usec;
+	}
+	if (!p_force && p_now_usec - window_begin_usec < WINDOW_USEC) {
+		return;
+	}
+
+	// Values recorded by other threads while the window is copied may land in either window, this is fine for statistics.
+	MutexLock lock(last_window_mutex);
+	for (uint32_t stage = 0; stage < STAGE_MAX; stage++) {
+		SafeHistogram &from = current[stage];
+		Histogram &to = last_window[stage];
+		for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+			to.buckets[i] = from.buckets[i].get();
+			from.buckets[i].set(0);
+		}
+		to.count = from.count.get();
+		from.count.set(0);
+		to.total = from.total.get();
+		from.total.set(0);
+		to.max = from.max.get();
+		from.max.set(0);
+		// The last value is kept, the stage may not run again in the next window.
+		to.last = from.last.get();
+	}
+	last_window_usec = p_now_usec - window_begin_usec;
+	window_begin_usec = p_now_usec;
+}
+
+NavMapProfiler::Histogram NavMapProfiler::get_histogram(Stage p_stage) const {
+	ERR_FAIL_INDEX_V(p_stage, STAGE_MAX, Histogram());
+	MutexLock lock(last_window_mutex);
+	return last_window[p_stage];
+}
+
+Dictionary NavMapProfiler::get_profile() const {
+	MutexLock lock(last_window_mutex);
+	Dictionary profile;
+	profile["window_usec"] = last_window_usec;
+	for (uint32_t stage = 0; stage < STAGE_MAX; stage++) {
+		profile[get_stage_name(Stage(stage))] = last_window[stage].to_dictionary();
+	}
+	return profile;
+}
@@ -0,0 +1,106 @@
+/**************************************************************************/
+/*  nav_map_profiler.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_MAP_PROFILER_H
+#define NAV_MAP_PROFILER_H
+
+#include "core/os/mutex.h"
+#include "core/templates/safe_refcount.h"
+#include "core/variant/dictionary.h"
+
+/**
+ * Timings and search sizes of a navigation map.
+ *
+ * Each stage of the map update and each path query adds its value to a
+ * histogram with power of two buckets: bucket 0 counts the zero values and
+ * bucket `i` the values in `[2^(i-1), 2^i)`. Adding a value only takes a few
+ * atomic operations, so path queries can record themselves from any thread.
+ *
+ * The histograms are collected over windows of one second, the reported
+ * values are those of the last complete window.
+ */
+class NavMapProfiler {
+public:
+	enum Stage {
+		STAGE_SYNC,
+		STAGE_AVOIDANCE,
+		STAGE_CALLBACKS,
+		STAGE_PATH_QUERY,
+		/// Not a time, the number of polygons searched by each path query.
+		STAGE_PATH_QUERY_SEARCHED_POLYGONS,
+		STAGE_MAX,
+	};
+
+	static const uint32_t BUCKET_COUNT = 32;
+	static const uint64_t WINDOW_USEC = 1000000;
+
+	struct Histogram {
+		uint64_t buckets[BUCKET_COUNT] = {};
+		uint64_t count = 0;
+		uint64_t total = 0;
+		uint64_t max = 0;
+		uint64_t last = 0;
+
+		/// Upper bound of the bucket holding the given fraction of the values, clamped to the largest value.
+		uint64_t get_percentile(double p_fraction) const;
+		void merge(const Histogram &p_histogram);
+		Dictionary to_dictionary() const;
+	};
+
+private:
+	struct SafeHistogram {
+		SafeNumeric<uint64_t> buckets[BUCKET_COUNT];
+		SafeNumeric<uint64_t> count;
+		SafeNumeric<uint64_t> total;
+		SafeNumeric<uint64_t> max;
+		SafeNumeric<uint64_t> last;
+	};
+
+	SafeHistogram current[STAGE_MAX];
+	uint64_t window_begin_usec = 0;
+
+	mutable BinaryMutex last_window_mutex;
+	Histogram last_window[STAGE_MAX];
+	uint64_t last_window_usec = 0;
+
+public:
+	static uint32_t get_bucket(uint64_t p_value);
+	static const char *get_stage_name(Stage p_stage);
+
+	void record(Stage p_stage, uint64_t p_value);
+
+	/// Ends the current window if it is older than `WINDOW_USEC`, or always when `p_force` is set.
+	void update(uint64_t p_now_usec, bool p_force = false);
+
+	Histogram get_histogram(Stage p_stage) const;
+	Dictionary get_profile() const;
+};
+
+#endif // NAV_MAP_PROFILER_H
@@ -117,6 +117,9 @@ struct NavigationPoly {
 	/// This poly.
 	const Polygon *poly = nullptr;
 
+	/// The search that reached this poly, the data is stale when it isn't the current one.
+	uint32_t search_id = 0;
+
 	/// Index in the heap of traversable polygons.
 	uint32_t traversable_poly_index = UINT32_MAX;
 
@@ -298,6 +301,40 @@ private:
 		}
 	}
 };
+
+/**
+ * Memory used by path searches, kept to be reused by the next search.
+ */
+struct PathSearchBuffers {
+	LocalVector<NavigationPoly> navigation_polys;
+	Heap<NavigationPoly *, NavPolyTravelCostGreaterThan, NavPolyHeapIndexer> traversable_polys;
+
+	/// Navigation polys with another `search_id` have not been reached by the current search.
+	uint32_t search_id = 0;
+
+	/// Prepares the buffers for a search over `p_polygon_count` polygons. Only the polygons
+	/// reached by the search are initialized, so its cost doesn't depend on the map size.
+	void begin_search(uint32_t p_polygon_count) {
+		// The heap may still point to the polygons of the previous search.
+		traversable_polys.clear();
+		if (navigation_polys.size() < p_polygon_count) {
+			navigation_polys.resize(p_polygon_count);
+		}
+		restart_search();
+	}
+
+	/// Marks all navigation polys as not reached.
+	void restart_search() {
+		search_id++;
+		if (unlikely(search_id == 0)) {
+			// Polygons stamped before the wrap around could be taken for reached ones.
+			for (NavigationPoly &navigation_poly : navigation_polys) {
+				navigation_poly.search_id = 0;
+			}
+			search_id = 1;
+		}
+	}
+};
 } // namespace gd
 
 #endif // NAV_UTILS_H
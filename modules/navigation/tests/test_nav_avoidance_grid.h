@@ -0,0 +1,208 @@
+/**************************************************************************/
+/*  test_nav_avoidance_grid.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_NAV_AVOIDANCE_GRID_H
+#define TEST_NAV_AVOIDANCE_GRID_H
+
+#include "../nav_agent.h"
+#include "../nav_avoidance_grid.h"
+#include "../nav_map.h"
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+#include <vector>
+
+namespace TestNavAvoidanceGrid {
+
+TEST_CASE("[Navigation][NavAvoidanceGrid] Neighbors match the RVO KdTree") {
+	RandomPCG rng(42);
+	RVO2D::RVOSimulator2D simulation;
+	std::vector<RVO2D::Agent2D> rvo_agents(500);
+	std::vector<RVO2D::Agent2D *> raw_agents;
+	NavAvoidanceGrid grid(true);
+	grid.set_cell_size(5.0);
+	grid.resize(rvo_agents.size());
+
+	for (uint32_t i = 0; i < rvo_agents.size(); i++) {
+		RVO2D::Agent2D &rvo_agent = rvo_agents[i];
+		rvo_agent.position_ = RVO2D::Vector2(rng.randf() * 50.0, rng.randf() * 50.0);
+		rvo_agent.neighborDist_ = 5.0;
+		rvo_agent.maxNeighbors_ = 10;
+		raw_agents.push_back(&rvo_agent);
+		grid.set_agent_position(i, Vector3(rvo_agent.position_.x(), 0.0, rvo_agent.position_.y()));
+	}
+	simulation.kdTree_->buildAgentTree(raw_agents);
+
+	for (uint32_t i = 0; i < rvo_agents.size(); i++) {
+		RVO2D::Agent2D &rvo_agent = rvo_agents[i];
+		rvo_agent.computeNeighbors(&simulation);
+		const std::vector<std::pair<float, const RVO2D::Agent2D *>> expected_neighbors = rvo_agent.agentNeighbors_;
+
+		rvo_agent.agentNeighbors_.clear();
+		float range_sq = rvo_agent.neighborDist_ * rvo_agent.neighborDist_;
+		grid.query(i, range_sq, [&](uint32_t p_neighbor, float &r_range_sq) {
+			rvo_agent.insertAgentNeighbor(&rvo_agents[p_neighbor], r_range_sq);
+		});
+
+		REQUIRE(rvo_agent.agentNeighbors_.size() == expected_neighbors.size());
+		for (uint32_t j = 0; j < expected_neighbors.size(); j++) {
+			CHECK(rvo_agent.agentNeighbors_[j].second == expected_neighbors[j].second);
+		}
+	}
+}
+
+TEST_CASE("[Navigation][NavAvoidanceGrid] Moved agents are found in their new cells") {
+	RandomPCG rng(7);
+	LocalVector<Vector3> positions;
+	positions.resize(300);
+	NavAvoidanceGrid grid(false);
+	grid.set_cell_size(3.0);
+	grid.resize(positions.size());
+
+	for (int step = 0; step < 5; step++) {
+		// Agents move by up to a few cells, and the last ones leave the grid in the middle steps.
+		const uint32_t agent_count = step == 2 ? 200 : positions.size();
+		grid.resize(agent_count);
+		for (uint32_t i = 0; i < agent_count; i++) {
+			positions[i] = step == 0 ? Vector3(rng.randf(), rng.randf(), rng.randf()) * 30.0 : positions[i] + Vector3(rng.randf() - 0.5, rng.randf() - 0.5, rng.randf() - 0.5) * 8.0;
+			grid.set_agent_position(i, positions[i]);
+		}
+
+		for (uint32_t i = 0; i < agent_count; i++) {
+			uint32_t expected_count = 0;
+			for (uint32_t j = 0; j < agent_count; j++) {
+				if (j != i && positions[i].distance_squared_to(positions[j]) < 9.0f) {
+					expected_count++;
+				}
+			}
+
+			uint32_t count = 0;
+			float range_sq = 9.0;
+			grid.query(i, range_sq, [&](uint32_t p_neighbor, float &r_range_sq) {
+				CHECK_LT(p_neighbor, agent_count);
+				count++;
+			});
+			CHECK_EQ(count, expected_count);
+		}
+	}
+}
+
+TEST_CASE("[Navigation][NavAvoidanceGrid] Ranges larger than the cells") {
+	RandomPCG rng(3);
+	LocalVector<Vector3> positions;
+	positions.resize(200);
+	NavAvoidanceGrid grid(true);
+	grid.set_cell_size(1.0);
+	grid.resize(positions.size());
+	for (uint32_t i = 0; i < positions.size(); i++) {
+		positions[i] = Vector3(rng.randf(), 0.0, rng.randf()) * 20.0;
+		grid.set_agent_position(i, positions[i]);
+	}
+
+	for (uint32_t i = 0; i < positions.size(); i++) {
+		uint32_t expected_count = 0;
+		for (uint32_t j = 0; j < positions.size(); j++) {
+			if (j != i && positions[i].distance_squared_to(positions[j]) < 25.0f) {
+				expected_count++;
+			}
+		}
+
+		uint32_t count = 0;
+		float range_sq = 25.0;
+		grid.query(i, range_sq, [&](uint32_t p_neighbor, float &r_range_sq) {
+			count++;
+		});
+		CHECK_EQ(count, expected_count);
+	}
+}
+
+TEST_CASE("[Navigation][NavAvoidanceGrid][Benchmark] Crowd avoidance step") {
+	const int agent_count = 10000;
+	const int step_count = 10;
+	const real_t radius = 0.4;
+
+	NavMap *map = memnew(NavMap);
+	LocalVector<NavAgent *> agents;
+	for (int i = 0; i < agent_count; i++) {
+		// Rows of agents all walking towards the center of the crowd.
+		const Vector3 position = Vector3(i % 100, 0, i / 100) * 1.0;
+		NavAgent *agent = memnew(NavAgent);
+		agent->set_avoidance_enabled(true);
+		agent->set_radius(radius);
+		// A few agents look much further, they shouldn't slow down the queries of the others.
+		agent->set_neighbor_distance(i % 50 == 0 ? 30.0 : 3.0);
+		agent->set_max_neighbors(10);
+		agent->set_max_speed(2.0);
+		agent->set_position(position);
+		agent->set_velocity((Vector3(50, 0, 50) - position).limit_length(2.0));
+		agent->set_map(map);
+		agents.push_back(agent);
+	}
+	map->sync();
+
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < step_count; i++) {
+		map->step(1.0 / 60.0);
+	}
+	const uint64_t usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+	// Quality: agents that still overlap another agent after the steps.
+	NavAvoidanceGrid grid(true);
+	grid.set_cell_size(radius * 2.0);
+	grid.resize(agent_count);
+	for (int i = 0; i < agent_count; i++) {
+		const RVO2D::Vector2 &position = agents[i]->get_rvo_agent_2d()->position_;
+		grid.set_agent_position(i, Vector3(position.x(), 0.0, position.y()));
+	}
+	int overlapping_count = 0;
+	for (int i = 0; i < agent_count; i++) {
+		float range_sq = radius * radius * 4.0;
+		bool overlapping = false;
+		grid.query(i, range_sq, [&](uint32_t p_neighbor, float &r_range_sq) {
+			overlapping = true;
+		});
+		overlapping_count += overlapping ? 1 : 0;
+	}
+
+	MESSAGE(agent_count, " agents, ", step_count, " steps: ", (uint64_t)agent_count * step_count * 1000 / usec, " agents per msec, ", overlapping_count, " overlapping agents.");
+
+	for (NavAgent *agent : agents) {
+		agent->set_map(nullptr);
+		memdelete(agent);
+	}
+	memdelete(map);
+}
+
+} // namespace TestNavAvoidanceGrid
+
+#endif // TEST_NAV_AVOIDANCE_GRID_H
@@ -0,0 +1,117 @@
+/**************************************************************************/
+/*  test_nav_map.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_NAV_MAP_H
+#define TEST_NAV_MAP_H
+
+#include "test_nav_mesh_hierarchy_3d.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavMap {
+
+using TestNavMeshHierarchy3D::MazeMap;
+
+static void check_same_connections(const NavMap *p_map, const NavMap *p_expected_map) {
+	CHECK_EQ(p_map->get_pm_polygon_count(), p_expected_map->get_pm_polygon_count());
+	CHECK_EQ(p_map->get_pm_edge_count(), p_expected_map->get_pm_edge_count());
+	CHECK_EQ(p_map->get_pm_edge_merge_count(), p_expected_map->get_pm_edge_merge_count());
+	CHECK_EQ(p_map->get_pm_edge_free_count(), p_expected_map->get_pm_edge_free_count());
+	CHECK_EQ(p_map->get_pm_edge_connection_count(), p_expected_map->get_pm_edge_connection_count());
+}
+
+TEST_CASE("[Navigation][NavMap] Syncing a changed region matches a full rebuild") {
+	MazeMap incremental(4, 32, false);
+	MazeMap full(4, 32, false);
+	const int merge_count = incremental.map->get_pm_edge_merge_count();
+	const int connection_count = incremental.map->get_pm_edge_connection_count();
+	const uint32_t iteration_id = incremental.map->get_iteration_id();
+
+	// Shifted by more than a merge cell, the borders along X are only connected by the edge connection margin.
+	const Transform3D shifted(Basis(), Vector3(0.3, 0, 0));
+	incremental.regions[5]->set_transform(shifted);
+	incremental.map->sync();
+	CHECK_NE(incremental.map->get_iteration_id(), iteration_id);
+
+	// Adding the region again rebuilds the whole map.
+	full.regions[5]->set_transform(shifted);
+	full.regions[5]->set_map(nullptr);
+	full.regions[5]->set_map(full.map);
+	full.map->sync();
+
+	check_same_connections(incremental.map, full.map);
+	CHECK_LT(incremental.map->get_pm_edge_merge_count(), merge_count);
+	CHECK_GT(incremental.map->get_pm_edge_connection_count(), 0);
+	CHECK_EQ(incremental.map->get_region_connections_count(incremental.regions[5]), full.map->get_region_connections_count(full.regions[5]));
+
+	const Vector3 targets[] = { Vector3(40.5, 0, 40.5), Vector3(120.5, 0, 124.5), Vector3(50.5, 0, 2.5) };
+	for (const Vector3 &target : targets) {
+		const Vector<Vector3> path = incremental.map->get_path(Vector3(0.5, 0, 0.5), target, true, 1, nullptr, nullptr, nullptr);
+		const Vector<Vector3> expected_path = full.map->get_path(Vector3(0.5, 0, 0.5), target, true, 1, nullptr, nullptr, nullptr);
+		REQUIRE(path.size() > 1);
+		CHECK(path[path.size() - 1].is_equal_approx(expected_path[expected_path.size() - 1]));
+		// Paths of the same length may be picked in another order.
+		const real_t expected_length = TestNavMeshHierarchy3D::get_path_length(expected_path);
+		CHECK(Math::is_equal_approx(TestNavMeshHierarchy3D::get_path_length(path), expected_length, expected_length * (real_t)0.01));
+	}
+
+	// Moving the region back merges its borders again.
+	incremental.regions[5]->set_transform(Transform3D());
+	incremental.map->sync();
+	CHECK_EQ(incremental.map->get_pm_edge_merge_count(), merge_count);
+	CHECK_EQ(incremental.map->get_pm_edge_connection_count(), connection_count);
+}
+
+TEST_CASE("[Navigation][NavMap][Benchmark] Moving one region of a large map") {
+	MazeMap maze(8, 32, false);
+	const int sync_count = 20;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < sync_count; i++) {
+		maze.regions[27]->set_transform(Transform3D(Basis(), Vector3(0, 0, (i % 2) * 0.3)));
+		maze.map->sync();
+	}
+	const uint64_t changed_usec = (OS::get_singleton()->get_ticks_usec() - begin) / sync_count;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < sync_count; i++) {
+		maze.map->set_edge_connection_margin(0.25 + (i % 2) * 0.01);
+		maze.map->sync();
+	}
+	const uint64_t full_usec = (OS::get_singleton()->get_ticks_usec() - begin) / sync_count;
+
+	MESSAGE("Sync of ", maze.map->get_pm_polygon_count(), " polygons: ", changed_usec, " usec with one changed region, ", full_usec, " usec for a full rebuild.");
+}
+
+} // namespace TestNavMap
+
+#endif // TEST_NAV_MAP_H
@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*  test_nav_map_profiler.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_NAV_MAP_PROFILER_H
+#define TEST_NAV_MAP_PROFILER_H
+
+#include "test_nav_mesh_hierarchy_3d.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavMapProfiler {
+
+using TestNavMeshHierarchy3D::MazeMap;
+
+TEST_CASE("[Navigation][NavMapProfiler] Histogram buckets and percentiles") {
+	CHECK_EQ(NavMapProfiler::get_bucket(0), 0u);
+	CHECK_EQ(NavMapProfiler::get_bucket(1), 1u);
+	CHECK_EQ(NavMapProfiler::get_bucket(3), 2u);
+	CHECK_EQ(NavMapProfiler::get_bucket(4), 3u);
+	CHECK_EQ(NavMapProfiler::get_bucket(UINT64_MAX), NavMapProfiler::BUCKET_COUNT - 1);
+
+	NavMapProfiler profiler;
+	profiler.update(1000);
+	for (uint64_t i = 0; i < 100; i++) {
+		profiler.record(NavMapProfiler::STAGE_PATH_QUERY, i);
+	}
+
+	// The window is not over yet.
+	profiler.update(2000);
+	CHECK_EQ(profiler.get_histogram(NavMapProfiler::STAGE_PATH_QUERY).count, 0u);
+
+	profiler.update(1000 + NavMapProfiler::WINDOW_USEC);
+	const NavMapProfiler::Histogram histogram = profiler.get_histogram(NavMapProfiler::STAGE_PATH_QUERY);
+	CHECK_EQ(histogram.count, 100u);
+	CHECK_EQ(histogram.total, 4950u);
+	CHECK_EQ(histogram.max, 99u);
+	CHECK_EQ(histogram.last, 99u);
+	// The 50th value is in the bucket of [32, 64), the 99th in the one of [64, 128) and clamped to the largest value.
+	CHECK_EQ(histogram.get_percentile(0.5), 63u);
+	CHECK_EQ(histogram.get_percentile(0.99), 99u);
+
+	const Dictionary profile = profiler.get_profile();
+	CHECK_EQ(uint64_t(profile["window_usec"]), NavMapProfiler::WINDOW_USEC);
+	const Dictionary path_query = profile["path_query"];
+	CHECK_EQ(int(path_query["count"]), 100);
+	const PackedInt64Array buckets = path_query["histogram"];
+	CHECK_EQ(buckets.size(), int(NavMapProfiler::BUCKET_COUNT));
+
+	// The next window starts empty.
+	profiler.update(1000 + 2 * NavMapProfiler::WINDOW_USEC, true);
+	CHECK_EQ(profiler.get_histogram(NavMapProfiler::STAGE_PATH_QUERY).count, 0u);
+}
+
+TEST_CASE("[Navigation][NavMapProfiler] Map records its updates and path queries") {
+	MazeMap maze(2, 32, false);
+	NavMapProfiler &profiler = maze.map->get_profiler();
+
+	const int query_count = 10;
+	for (int i = 0; i < query_count; i++) {
+		uint32_t searched_polygon_count = 0;
+		const Vector<Vector3> path = maze.map->get_path(Vector3(0.5, 0, 0.5), Vector3(60.5, 0, 60.5 - i), true, 1, nullptr, nullptr, nullptr, &searched_polygon_count);
+		REQUIRE(path.size() > 1);
+		CHECK_GT(searched_polygon_count, 0u);
+	}
+	maze.map->step(0.1);
+	maze.map->dispatch_callbacks();
+	profiler.update(OS::get_singleton()->get_ticks_usec(), true);
+
+	CHECK_EQ(profiler.get_histogram(NavMapProfiler::STAGE_SYNC).count, 1u);
+	CHECK_EQ(profiler.get_histogram(NavMapProfiler::STAGE_AVOIDANCE).count, 1u);
+	CHECK_EQ(profiler.get_histogram(NavMapProfiler::STAGE_CALLBACKS).count, 1u);
+	CHECK_EQ(profiler.get_histogram(NavMapProfiler::STAGE_PATH_QUERY).count, uint64_t(query_count));
+
+	const NavMapProfiler::Histogram searched_polygons = profiler.get_histogram(NavMapProfiler::STAGE_PATH_QUERY_SEARCHED_POLYGONS);
+	CHECK_EQ(searched_polygons.count, uint64_t(query_count));
+	CHECK_GT(searched_polygons.get_percentile(0.5), 0u);
+	CHECK_GE(searched_polygons.get_percentile(0.99), searched_polygons.get_percentile(0.5));
+	CHECK_LE(searched_polygons.get_percentile(0.99), searched_polygons.max);
+}
+
+} // namespace TestNavMapProfiler
+
+#endif // TEST_NAV_MAP_PROFILER_H
@@ -0,0 +1,151 @@
+/**************************************************************************/
+/*  test_nav_mesh_flow_field_3d.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_NAV_MESH_FLOW_FIELD_3D_H
+#define TEST_NAV_MESH_FLOW_FIELD_3D_H
+
+#include "test_nav_mesh_hierarchy_3d.h"
+
+#include "../nav_link.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavMeshFlowField3D {
+
+using TestNavMeshHierarchy3D::get_path_length;
+using TestNavMeshHierarchy3D::MazeMap;
+
+TEST_CASE("[Navigation][NavMeshFlowField3D] Flow leads to the target") {
+	MazeMap maze(2, 32, false);
+	const Vector3 from(0.5, 0, 0.5);
+	const Vector3 to(60.5, 0, 62.5);
+
+	Vector3 direction;
+	real_t cost = 0.0;
+	REQUIRE(maze.map->get_flow(to, from, 1, direction, cost));
+	const real_t path_length = get_path_length(maze.map->get_path(from, to, true, 1, nullptr, nullptr, nullptr, nullptr));
+	CHECK(cost >= path_length - CMP_EPSILON);
+	CHECK_MESSAGE(cost <= path_length * 1.2, "The flow cost should be close to the shortest path length.");
+	CHECK(direction.is_normalized());
+
+	// Walking along the flow winds through the maze.
+	Vector3 position = from;
+	for (int i = 0; i < 2000 && direction != Vector3(); i++) {
+		position += direction * 0.25;
+		REQUIRE(maze.map->get_flow(to, position, 1, direction, cost));
+	}
+	CHECK(position.distance_to(to) < 0.25);
+	CHECK(cost < 0.25);
+
+	// Excluded regions can't be crossed.
+	CHECK_FALSE(maze.map->get_flow(to, from, 2, direction, cost));
+}
+
+TEST_CASE("[Navigation][NavMeshFlowField3D] Flow fields are rebuilt when the map changes") {
+	MazeMap maze(2, 32, false);
+	const Vector3 from(0.5, 0, 0.5);
+	const Vector3 to(40.5, 0, 40.5);
+
+	Vector3 direction;
+	real_t cost = 0.0;
+	REQUIRE(maze.map->get_flow(to, from, 1, direction, cost));
+
+	// The target tile is only connected through the tile in front of it.
+	maze.regions[2]->set_map(nullptr);
+	maze.map->sync();
+	CHECK_FALSE(maze.map->get_flow(to, from, 1, direction, cost));
+	CHECK(maze.map->get_flow(to, Vector3(50.5, 0, 40.5), 1, direction, cost));
+
+	maze.regions[2]->set_map(maze.map);
+	maze.map->sync();
+	CHECK(maze.map->get_flow(to, from, 1, direction, cost));
+}
+
+TEST_CASE("[Navigation][NavMeshFlowField3D] Disabled links are not part of the field") {
+	MazeMap maze(2, 32, false);
+	const Vector3 from(0.5, 0, 0.5);
+	const Vector3 to(60.5, 0, 62.5);
+
+	// The disabled link leaves an unused link polygon after the one of the enabled link.
+	NavLink *enabled_link = memnew(NavLink);
+	enabled_link->set_start_position(from);
+	enabled_link->set_end_position(to);
+	enabled_link->set_map(maze.map);
+	NavLink *disabled_link = memnew(NavLink);
+	disabled_link->set_start_position(Vector3(0.5, 0, 40.5));
+	disabled_link->set_end_position(to);
+	disabled_link->set_enabled(false);
+	disabled_link->set_map(maze.map);
+	maze.map->sync();
+
+	Vector3 direction;
+	real_t cost = 0.0;
+	REQUIRE(maze.map->get_flow(to, from, 1, direction, cost));
+	CHECK_MESSAGE(cost < from.distance_to(to) + 1.0, "The flow should take the enabled link.");
+
+	// Without the enabled link, the flow winds through the maze again.
+	enabled_link->set_enabled(false);
+	maze.map->sync();
+	REQUIRE(maze.map->get_flow(to, from, 1, direction, cost));
+	CHECK(cost > from.distance_to(to) + 1.0);
+
+	enabled_link->set_map(nullptr);
+	disabled_link->set_map(nullptr);
+	memdelete(enabled_link);
+	memdelete(disabled_link);
+}
+
+TEST_CASE("[Navigation][NavMeshFlowField3D][Benchmark] Many agents going to the same target") {
+	MazeMap maze(4, 32, false);
+	const Vector3 to(120.5, 0, 124.5);
+	const int agent_count = 1000;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < agent_count; i++) {
+		maze.map->get_path(Vector3(i % 128 + 0.5, 0, (i / 128) * 4 + 0.5), to, true, 1, nullptr, nullptr, nullptr, nullptr);
+	}
+	const uint64_t path_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	Vector3 direction;
+	real_t cost = 0.0;
+	for (int i = 0; i < agent_count; i++) {
+		maze.map->get_flow(to, Vector3(i % 128 + 0.5, 0, (i / 128) * 4 + 0.5), 1, direction, cost);
+	}
+	const uint64_t flow_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE(agent_count, " agents on ", maze.map->get_pm_polygon_count(), " polygons: ", path_usec, " usec for path queries, ", flow_usec, " usec for the flow field and its queries.");
+}
+
+} // namespace TestNavMeshFlowField3D
+
+#endif // TEST_NAV_MESH_FLOW_FIELD_3D_H
@@ -0,0 +1,188 @@
+/**************************************************************************/
+/*  test_nav_mesh_hierarchy_3d.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_NAV_MESH_HIERARCHY_3D_H
+#define TEST_NAV_MESH_HIERARCHY_3D_H
+
+#include "../nav_map.h"
+#include "../nav_region.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavMeshHierarchy3D {
+
+// A square of 1x1 quads, with walls every 16 rows that have a gap at alternating ends,
+// so that paths going across the map have to wind through it.
+static Ref<NavigationMesh> create_maze_tile(int p_size, const Vector2i &p_offset) {
+	Vector<Vector3> vertices;
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.push_back(Vector3(p_offset.x + x, 0, p_offset.y + z));
+		}
+	}
+
+	Ref<NavigationMesh> navigation_mesh;
+	navigation_mesh.instantiate();
+	navigation_mesh->set_vertices(vertices);
+	for (int z = 0; z < p_size; z++) {
+		const int row = p_offset.y + z;
+		for (int x = 0; x < p_size; x++) {
+			const int column = p_offset.x + x;
+			if (row % 16 == 15) {
+				const bool gap = (row / 16) % 2 ? column < 2 : column % 16 >= 14;
+				if (!gap) {
+					continue;
+				}
+			}
+			Vector<int> polygon;
+			polygon.push_back(z * (p_size + 1) + x);
+			polygon.push_back(z * (p_size + 1) + x + 1);
+			polygon.push_back((z + 1) * (p_size + 1) + x + 1);
+			polygon.push_back((z + 1) * (p_size + 1) + x);
+			navigation_mesh->add_polygon(polygon);
+		}
+	}
+	return navigation_mesh;
+}
+
+struct MazeMap {
+	NavMap *map = nullptr;
+	LocalVector<NavRegion *> regions;
+
+	MazeMap(int p_tiles, int p_tile_size, bool p_hierarchical) {
+		map = memnew(NavMap);
+		map->set_cell_size(0.25);
+		map->set_use_hierarchical_pathfinding(p_hierarchical);
+		map->set_hierarchical_pathfinding_cluster_size(32);
+		for (int tile_z = 0; tile_z < p_tiles; tile_z++) {
+			for (int tile_x = 0; tile_x < p_tiles; tile_x++) {
+				NavRegion *region = memnew(NavRegion);
+				region->set_map(map);
+				region->set_navigation_mesh(create_maze_tile(p_tile_size, Vector2i(tile_x, tile_z) * p_tile_size));
+				regions.push_back(region);
+			}
+		}
+		map->sync();
+	}
+
+	~MazeMap() {
+		for (NavRegion *region : regions) {
+			region->set_map(nullptr);
+			memdelete(region);
+		}
+		memdelete(map);
+	}
+};
+
+static real_t get_path_length(const Vector<Vector3> &p_path) {
+	real_t length = 0.0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
+TEST_CASE("[Navigation][NavMeshHierarchy3D] Hierarchical paths follow the flat paths") {
+	MazeMap flat(2, 32, false);
+	MazeMap hierarchical(2, 32, true);
+	const NavMeshHierarchy3D &hierarchy = hierarchical.map->get_hierarchy();
+	REQUIRE(hierarchy.get_cluster_count() > 1);
+	CHECK(hierarchy.get_portal_count() > 0);
+
+	const Vector3 from(0.5, 0, 0.5);
+	const Vector3 to(60.5, 0, 62.5);
+	uint32_t flat_searched = 0;
+	uint32_t hierarchical_searched = 0;
+	const Vector<Vector3> flat_path = flat.map->get_path(from, to, true, 1, nullptr, nullptr, nullptr, &flat_searched);
+	const Vector<Vector3> hierarchical_path = hierarchical.map->get_path(from, to, true, 1, nullptr, nullptr, nullptr, &hierarchical_searched);
+
+	REQUIRE(flat_path.size() > 2);
+	REQUIRE(hierarchical_path.size() > 2);
+	CHECK(hierarchical_path[0].is_equal_approx(flat_path[0]));
+	CHECK(hierarchical_path[hierarchical_path.size() - 1].is_equal_approx(flat_path[flat_path.size() - 1]));
+	CHECK_MESSAGE(get_path_length(hierarchical_path) <= get_path_length(flat_path) * 1.1, "The hierarchical path should be close to the shortest path.");
+	CHECK(hierarchical_searched < flat_searched);
+
+	// Layers that exclude regions fall back to the flat search, which finds the same path.
+	hierarchical.regions[3]->set_navigation_layers(2);
+	const Vector<Vector3> layered_path = hierarchical.map->get_path(from, Vector3(30.5, 0, 30.5), true, 1, nullptr, nullptr, nullptr, nullptr);
+	const Vector<Vector3> flat_layered_path = flat.map->get_path(from, Vector3(30.5, 0, 30.5), true, 1, nullptr, nullptr, nullptr, nullptr);
+	CHECK(layered_path == flat_layered_path);
+}
+
+TEST_CASE("[Navigation][NavMeshHierarchy3D] Only clusters of changed regions are updated") {
+	MazeMap hierarchical(4, 32, true);
+	const NavMeshHierarchy3D &hierarchy = hierarchical.map->get_hierarchy();
+	const uint32_t cluster_count = hierarchy.get_cluster_count();
+	CHECK(hierarchy.get_rebuilt_cluster_count() == cluster_count);
+
+	// Setting the same mesh again marks the region as changed.
+	hierarchical.regions[5]->set_navigation_mesh(create_maze_tile(32, Vector2i(1, 1) * 32));
+	hierarchical.map->sync();
+	CHECK(hierarchy.get_cluster_count() == cluster_count);
+	CHECK(hierarchy.get_rebuilt_cluster_count() > 0);
+	CHECK(hierarchy.get_rebuilt_cluster_count() <= cluster_count / 4);
+
+	// Removing a region changes the portals of the neighbor clusters too.
+	hierarchical.regions[5]->set_map(nullptr);
+	hierarchical.map->sync();
+	CHECK(hierarchy.get_rebuilt_cluster_count() < cluster_count / 2);
+	const Vector<Vector3> path = hierarchical.map->get_path(Vector3(0.5, 0, 0.5), Vector3(120.5, 0, 124.5), true, 1, nullptr, nullptr, nullptr, nullptr);
+	REQUIRE(path.size() > 2);
+	CHECK(path[path.size() - 1].is_equal_approx(Vector3(120.5, 0, 124.5)));
+	hierarchical.regions[5]->set_map(hierarchical.map);
+}
+
+TEST_CASE("[Navigation][NavMeshHierarchy3D][Benchmark] Path queries on a large map") {
+	const Vector3 from(0.5, 0, 0.5);
+	const Vector3 to(250.5, 0, 254.5);
+	for (bool hierarchical : { false, true }) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		MazeMap maze(8, 32, hierarchical);
+		const uint64_t sync_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		uint32_t searched = 0;
+		begin = OS::get_singleton()->get_ticks_usec();
+		Vector<Vector3> path;
+		for (int i = 0; i < 10; i++) {
+			path = maze.map->get_path(from, to, true, 1, nullptr, nullptr, nullptr, &searched);
+		}
+		const uint64_t query_usec = (OS::get_singleton()->get_ticks_usec() - begin) / 10;
+
+		const String search = hierarchical ? "Hierarchical" : "Flat";
+		MESSAGE(search, " search of ", maze.map->get_pm_polygon_count(), " polygons: ", searched, " polygons searched, ", query_usec, " usec per query, path length ", get_path_length(path), ", first sync ", sync_usec, " usec.");
+	}
+}
+
+} // namespace TestNavMeshHierarchy3D
+
+#endif // TEST_NAV_MESH_HIERARCHY_3D_H
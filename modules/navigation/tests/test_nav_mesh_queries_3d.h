@@ -0,0 +1,96 @@
+/**************************************************************************/
+/*  test_nav_mesh_queries_3d.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_NAV_MESH_QUERIES_3D_H
+#define TEST_NAV_MESH_QUERIES_3D_H
+
+#include "test_nav_mesh_hierarchy_3d.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavMeshQueries3D {
+
+using TestNavMeshHierarchy3D::MazeMap;
+
+TEST_CASE("[Navigation][NavMeshQueries3D] Reused search buffers find the same paths") {
+	MazeMap maze(2, 32, false);
+	gd::PathSearchBuffers buffers;
+
+	const Vector3 targets[] = { Vector3(60.5, 0, 62.5), Vector3(3.5, 0, 2.5), Vector3(40.5, 0, 20.5), Vector3(0.5, 0, 60.5) };
+	for (const Vector3 &target : targets) {
+		const Vector<Vector3> path = maze.map->get_path(Vector3(0.5, 0, 0.5), target, true, 1, nullptr, nullptr, nullptr, nullptr, nullptr);
+		const Vector<Vector3> buffered_path = maze.map->get_path(Vector3(0.5, 0, 0.5), target, true, 1, nullptr, nullptr, nullptr, nullptr, &buffers);
+		REQUIRE(path.size() > 1);
+		CHECK(buffered_path == path);
+	}
+
+	// The polygons of older searches must not be taken for reached ones when the id wraps around.
+	buffers.search_id = UINT32_MAX;
+	const Vector<Vector3> path = maze.map->get_path(Vector3(60.5, 0, 62.5), Vector3(0.5, 0, 0.5), true, 1, nullptr, nullptr, nullptr, nullptr, nullptr);
+	CHECK(maze.map->get_path(Vector3(60.5, 0, 62.5), Vector3(0.5, 0, 0.5), true, 1, nullptr, nullptr, nullptr, nullptr, &buffers) == path);
+	CHECK(buffers.search_id == 1);
+
+	// The buffers stay valid when the map changes.
+	maze.regions[3]->set_map(nullptr);
+	maze.map->sync();
+	const Vector<Vector3> changed_path = maze.map->get_path(Vector3(0.5, 0, 0.5), Vector3(40.5, 0, 20.5), true, 1, nullptr, nullptr, nullptr, nullptr, nullptr);
+	CHECK(maze.map->get_path(Vector3(0.5, 0, 0.5), Vector3(40.5, 0, 20.5), true, 1, nullptr, nullptr, nullptr, nullptr, &buffers) == changed_path);
+	maze.regions[3]->set_map(maze.map);
+}
+
+TEST_CASE("[Navigation][NavMeshQueries3D][Benchmark] Short path queries on a large map") {
+	MazeMap maze(8, 32, false);
+	const int query_count = 10000;
+
+	for (bool reuse_buffers : { false, true }) {
+		gd::PathSearchBuffers buffers;
+		uint64_t searched = 0;
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < query_count; i++) {
+			// Paths of a few meters inside the first rows of each tile.
+			const Vector3 from(i % 250 + 0.5, 0, (i / 250) % 8 * 32 + 2.5);
+			const Vector3 to = from + Vector3(3, 0, 5);
+			gd::PathSearchBuffers fresh_buffers;
+			uint32_t searched_polygon_count = 0;
+			maze.map->get_path(from, to, true, 1, nullptr, nullptr, nullptr, &searched_polygon_count, reuse_buffers ? &buffers : &fresh_buffers);
+			searched += searched_polygon_count;
+		}
+		const uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		const String search = reuse_buffers ? "Reused" : "Fresh";
+		MESSAGE(search, " search buffers, ", query_count, " queries on ", maze.map->get_pm_polygon_count(), " polygons: ", searched / query_count, " polygons searched and ", usec / query_count, " usec per query.");
+	}
+}
+
+} // namespace TestNavMeshQueries3D
+
+#endif // TEST_NAV_MESH_QUERIES_3D_H
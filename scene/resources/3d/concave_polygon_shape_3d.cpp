@@ -73,11 +73,36 @@ void ConcavePolygonShape3D::_update_shape() {
 	Dictionary d;
 	d["faces"] = faces;
 	d["backface_collision"] = backface_collision;
+	if (!bvh_data.is_empty()) {
+		d["bvh"] = bvh_data;
+	}
 	PhysicsServer3D::get_singleton()->shape_set_data(get_shape(), d);
+	if (!faces.is_empty()) {
+		// The server either adopted it or rebuilt its own, don't keep a second copy around.
+		bvh_data.clear();
+	}
 
 	Shape3D::_update_shape();
 }
 
+void ConcavePolygonShape3D::_set_bvh_data(const Vector<uint8_t> &p_data) {
+	bvh_data = p_data;
+	if (!faces.is_empty()) {
+		_update_shape();
+	}
+}
+
+Vector<uint8_t> ConcavePolygonShape3D::_get_bvh_data() const {
+	if (!save_bvh) {
+		return Vector<uint8_t>();
+	}
+	if (!bvh_data.is_empty()) {
+		return bvh_data;
+	}
+	// Empty if the physics server doesn't build one.
+	return PhysicsServer3D::get_singleton()->shape_get_bvh_data(get_shape());
+}
+
 void ConcavePolygonShape3D::set_faces(const Vector<Vector3> &p_faces) {
 	faces = p_faces;
 	_update_shape();
@@ -101,6 +126,21 @@ bool ConcavePolygonShape3D::is_backface_collision_enabled() const {
 	return backface_collision;
 }
 
+void ConcavePolygonShape3D::set_save_bvh_enabled(bool p_enabled) {
+	save_bvh = p_enabled;
+	notify_property_list_changed();
+}
+
+bool ConcavePolygonShape3D::is_save_bvh_enabled() const {
+	return save_bvh;
+}
+
+void ConcavePolygonShape3D::_validate_property(PropertyInfo &p_property) const {
+	if (p_property.name == "bvh_data" && !save_bvh) {
+		p_property.usage = PROPERTY_USAGE_NONE;
+	}
+}
+
 void ConcavePolygonShape3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_faces", "faces"), &ConcavePolygonShape3D::set_faces);
 	ClassDB::bind_method(D_METHOD("get_faces"), &ConcavePolygonShape3D::get_faces);
@@ -108,8 +148,17 @@ void ConcavePolygonShape3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_backface_collision_enabled", "enabled"), &ConcavePolygonShape3D::set_backface_collision_enabled);
 	ClassDB::bind_method(D_METHOD("is_backface_collision_enabled"), &ConcavePolygonShape3D::is_backface_collision_enabled);
 
+	ClassDB::bind_method(D_METHOD("set_save_bvh_enabled", "enabled"), &ConcavePolygonShape3D::set_save_bvh_enabled);
+	ClassDB::bind_method(D_METHOD("is_save_bvh_enabled"), &ConcavePolygonShape3D::is_save_bvh_enabled);
+
+	ClassDB::bind_method(D_METHOD("_set_bvh_data", "data"), &ConcavePolygonShape3D::_set_bvh_data);
+	ClassDB::bind_method(D_METHOD("_get_bvh_data"), &ConcavePolygonShape3D::_get_bvh_data);
+
+	// Listed before the faces, so a loaded BVH is already there when the faces are set.
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "bvh_data", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL), "_set_bvh_data", "_get_bvh_data");
 	ADD_PROPERTY(PropertyInfo(Variant::PACKED_VECTOR3_ARRAY, "data", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL), "set_faces", "get_faces");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "backface_collision"), "set_backface_collision_enabled", "is_backface_collision_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "save_bvh"), "set_save_bvh_enabled", "is_save_bvh_enabled");
 }
 
 ConcavePolygonShape3D::ConcavePolygonShape3D() :
@@ -38,6 +38,9 @@ class ConcavePolygonShape3D : public Shape3D {
 
 	Vector<Vector3> faces;
 	bool backface_collision = false;
+	// Acceleration structure loaded with the resource, handed to the physics server on the next update.
+	Vector<uint8_t> bvh_data;
+	bool save_bvh = false;
 
 	struct DrawEdge {
 		Vector3 a;
@@ -61,9 +64,13 @@ class ConcavePolygonShape3D : public Shape3D {
 
 protected:
 	static void _bind_methods();
+	void _validate_property(PropertyInfo &p_property) const;
 
 	virtual void _update_shape() override;
 
+	void _set_bvh_data(const Vector<uint8_t> &p_data);
+	Vector<uint8_t> _get_bvh_data() const;
+
 public:
 	void set_faces(const Vector<Vector3> &p_faces);
 	Vector<Vector3> get_faces() const;
@@ -71,6 +78,9 @@ public:
 	void set_backface_collision_enabled(bool p_enabled);
 	bool is_backface_collision_enabled() const;
 
+	void set_save_bvh_enabled(bool p_enabled);
+	bool is_save_bvh_enabled() const;
+
 	virtual Vector<Vector3> get_debug_mesh_lines() const override;
 	virtual real_t get_enclosing_radius() const override;
 
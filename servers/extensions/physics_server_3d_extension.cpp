@@ -150,6 +150,7 @@ void PhysicsServer3DExtension::_bind_methods() {
 
 	GDVIRTUAL_BIND(_shape_get_type, "shape");
 	GDVIRTUAL_BIND(_shape_get_data, "shape");
+	GDVIRTUAL_BIND(_shape_get_bvh_data, "shape");
 	GDVIRTUAL_BIND(_shape_get_custom_solver_bias, "shape");
 
 	/* SPACE API */
@@ -167,6 +168,9 @@ void PhysicsServer3DExtension::_bind_methods() {
 	GDVIRTUAL_BIND(_space_get_contacts, "space");
 	GDVIRTUAL_BIND(_space_get_contact_count, "space");
 
+	GDVIRTUAL_BIND(_space_save_state, "space");
+	GDVIRTUAL_BIND(_space_restore_state, "space", "state");
+
 	/* AREA API */
 
 	GDVIRTUAL_BIND(_area_create);
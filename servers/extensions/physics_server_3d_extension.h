@@ -226,6 +226,7 @@ public:
 
 	EXBIND1RC(ShapeType, shape_get_type, RID)
 	EXBIND1RC(Variant, shape_get_data, RID)
+	EXBIND1RC(Vector<uint8_t>, shape_get_bvh_data, RID)
 	EXBIND1RC(real_t, shape_get_custom_solver_bias, RID)
 
 	/* SPACE API */
@@ -243,6 +244,9 @@ public:
 	EXBIND1RC(Vector<Vector3>, space_get_contacts, RID)
 	EXBIND1RC(int, space_get_contact_count, RID)
 
+	EXBIND1RC(Vector<uint8_t>, space_save_state, RID)
+	EXBIND2(space_restore_state, RID, const Vector<uint8_t> &)
+
 	/* AREA API */
 
 	//EXBIND0RID(area);
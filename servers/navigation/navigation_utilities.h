@@ -32,6 +32,7 @@
 #define NAVIGATION_UTILITIES_H
 
 #include "core/math/vector3.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/typed_array.h"
 
 namespace NavigationUtilities {
@@ -77,6 +78,15 @@ struct PathQueryResult {
 	PackedInt64Array path_owner_ids;
 };
 
+struct PathQueryBatch {
+	LocalVector<PathQueryParameters> parameters;
+	LocalVector<PathQueryResult> results;
+
+	/// Called once all results are available, on the main thread for asynchronous batches.
+	virtual void finish() {}
+	virtual ~PathQueryBatch() {}
+};
+
 } //namespace NavigationUtilities
 
 #endif // NAVIGATION_UTILITIES_H
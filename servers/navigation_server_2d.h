@@ -104,6 +104,9 @@ public:
 	virtual void map_force_update(RID p_map) = 0;
 	virtual uint32_t map_get_iteration_id(RID p_map) const = 0;
 
+	/// Returns the timings and path query statistics of the map over the last second.
+	virtual Dictionary map_get_profile(RID p_map) const = 0;
+
 	virtual Vector2 map_get_random_point(RID p_map, uint32_t p_navigation_layers, bool p_uniformly) const = 0;
 
 	/// Creates a new region.
@@ -295,6 +298,9 @@ public:
 	/// Returns a customized navigation path using a query parameters object
 	virtual void query_path(const Ref<NavigationPathQueryParameters2D> &p_query_parameters, Ref<NavigationPathQueryResult2D> p_query_result) const = 0;
 
+	/// Runs many path queries at once, on worker threads when the server supports it.
+	virtual void query_path_batch(const TypedArray<NavigationPathQueryParameters2D> &p_query_parameters, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback = Callable()) = 0;
+
 	virtual void init() = 0;
 	virtual void sync() = 0;
 	virtual void finish() = 0;
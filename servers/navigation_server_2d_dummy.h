@@ -60,6 +60,7 @@ public:
 	void map_force_update(RID p_map) override {}
 	Vector2 map_get_random_point(RID p_map, uint32_t p_naviation_layers, bool p_uniformly) const override { return Vector2(); };
 	uint32_t map_get_iteration_id(RID p_map) const override { return 0; }
+	Dictionary map_get_profile(RID p_map) const override { return Dictionary(); }
 
 	RID region_create() override { return RID(); }
 	void region_set_enabled(RID p_region, bool p_enabled) override {}
@@ -159,6 +160,7 @@ public:
 	uint32_t obstacle_get_avoidance_layers(RID p_agent) const override { return 0; }
 
 	void query_path(const Ref<NavigationPathQueryParameters2D> &p_query_parameters, Ref<NavigationPathQueryResult2D> p_query_result) const override {}
+	void query_path_batch(const TypedArray<NavigationPathQueryParameters2D> &p_query_parameters, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback = Callable()) override {}
 
 	void init() override {}
 	void sync() override {}
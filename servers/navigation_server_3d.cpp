@@ -57,6 +57,8 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_set_link_connection_radius", "map", "radius"), &NavigationServer3D::map_set_link_connection_radius);
 	ClassDB::bind_method(D_METHOD("map_get_link_connection_radius", "map"), &NavigationServer3D::map_get_link_connection_radius);
 	ClassDB::bind_method(D_METHOD("map_get_path", "map", "origin", "destination", "optimize", "navigation_layers"), &NavigationServer3D::map_get_path, DEFVAL(1));
+	ClassDB::bind_method(D_METHOD("map_get_flow_direction", "map", "target", "position", "navigation_layers"), &NavigationServer3D::map_get_flow_direction, DEFVAL(1));
+	ClassDB::bind_method(D_METHOD("map_get_flow_cost", "map", "target", "position", "navigation_layers"), &NavigationServer3D::map_get_flow_cost, DEFVAL(1));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_to_segment", "map", "start", "end", "use_collision"), &NavigationServer3D::map_get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point", "map", "to_point"), &NavigationServer3D::map_get_closest_point);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_normal", "map", "to_point"), &NavigationServer3D::map_get_closest_point_normal);
@@ -69,10 +71,12 @@ void NavigationServer3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("map_force_update", "map"), &NavigationServer3D::map_force_update);
 	ClassDB::bind_method(D_METHOD("map_get_iteration_id", "map"), &NavigationServer3D::map_get_iteration_id);
+	ClassDB::bind_method(D_METHOD("map_get_profile", "map"), &NavigationServer3D::map_get_profile);
 
 	ClassDB::bind_method(D_METHOD("map_get_random_point", "map", "navigation_layers", "uniformly"), &NavigationServer3D::map_get_random_point);
 
 	ClassDB::bind_method(D_METHOD("query_path", "parameters", "result"), &NavigationServer3D::query_path);
+	ClassDB::bind_method(D_METHOD("query_path_batch", "parameters", "results", "callback"), &NavigationServer3D::query_path_batch, DEFVAL(Callable()));
 
 	ClassDB::bind_method(D_METHOD("region_create"), &NavigationServer3D::region_create);
 	ClassDB::bind_method(D_METHOD("region_set_enabled", "region", "enabled"), &NavigationServer3D::region_set_enabled);
@@ -190,6 +194,9 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("bake_from_source_geometry_data", "navigation_mesh", "source_geometry_data", "callback"), &NavigationServer3D::bake_from_source_geometry_data, DEFVAL(Callable()));
 	ClassDB::bind_method(D_METHOD("bake_from_source_geometry_data_async", "navigation_mesh", "source_geometry_data", "callback"), &NavigationServer3D::bake_from_source_geometry_data_async, DEFVAL(Callable()));
 	ClassDB::bind_method(D_METHOD("is_baking_navigation_mesh", "navigation_mesh"), &NavigationServer3D::is_baking_navigation_mesh);
+	ClassDB::bind_method(D_METHOD("map_bake_tiles", "map", "navigation_mesh", "source_geometry_data", "tile_size", "dirty_aabb", "callback"), &NavigationServer3D::map_bake_tiles, DEFVAL(AABB()), DEFVAL(Callable()));
+	ClassDB::bind_method(D_METHOD("map_is_baking_tiles", "map"), &NavigationServer3D::map_is_baking_tiles);
+	ClassDB::bind_method(D_METHOD("map_get_tile_regions", "map"), &NavigationServer3D::map_get_tile_regions);
 #endif // _3D_DISABLED
 
 	ClassDB::bind_method(D_METHOD("source_geometry_parser_create"), &NavigationServer3D::source_geometry_parser_create);
@@ -221,6 +228,14 @@ void NavigationServer3D::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(INFO_EDGE_FREE_COUNT);
 	BIND_ENUM_CONSTANT(INFO_OBSTACLE_COUNT);
+	BIND_ENUM_CONSTANT(INFO_SYNC_TIME);
+	BIND_ENUM_CONSTANT(INFO_AVOIDANCE_TIME);
+	BIND_ENUM_CONSTANT(INFO_CALLBACKS_TIME);
+	BIND_ENUM_CONSTANT(INFO_PATH_QUERY_COUNT);
+	BIND_ENUM_CONSTANT(INFO_PATH_QUERY_TIME_P50);
+	BIND_ENUM_CONSTANT(INFO_PATH_QUERY_TIME_P99);
+	BIND_ENUM_CONSTANT(INFO_PATH_QUERY_SEARCHED_POLYGONS_P50);
+	BIND_ENUM_CONSTANT(INFO_PATH_QUERY_SEARCHED_POLYGONS_P99);
 }
 
 NavigationServer3D *NavigationServer3D::get_singleton() {
@@ -247,6 +262,9 @@ NavigationServer3D::NavigationServer3D() {
 	GLOBAL_DEF("navigation/avoidance/thread_model/avoidance_use_multiple_threads", true);
 	GLOBAL_DEF("navigation/avoidance/thread_model/avoidance_use_high_priority_threads", true);
 
+	GLOBAL_DEF("navigation/pathfinding/use_hierarchical_pathfinding", false);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "navigation/pathfinding/hierarchical_pathfinding_cluster_size", PROPERTY_HINT_RANGE, "8,1024,1,or_greater"), 64);
+
 	GLOBAL_DEF("navigation/baking/use_crash_prevention_checks", true);
 	GLOBAL_DEF("navigation/baking/thread_model/baking_use_multiple_threads", true);
 	GLOBAL_DEF("navigation/baking/thread_model/baking_use_high_priority_threads", true);
@@ -947,6 +965,55 @@ void NavigationServer3D::query_path(const Ref<NavigationPathQueryParameters3D> &
 	p_query_result->set_path_owner_ids(_query_result.path_owner_ids);
 }
 
+struct PathQueryBatch3D : public NavigationUtilities::PathQueryBatch {
+	TypedArray<NavigationPathQueryResult3D> query_results;
+	Callable callback;
+
+	virtual void finish() override {
+		for (uint32_t i = 0; i < results.size(); i++) {
+			Ref<NavigationPathQueryResult3D> query_result = query_results[i];
+			query_result->set_path(results[i].path);
+			query_result->set_path_types(results[i].path_types);
+			query_result->set_path_rids(results[i].path_rids);
+			query_result->set_path_owner_ids(results[i].path_owner_ids);
+		}
+		if (callback.is_valid()) {
+			callback.call();
+		}
+	}
+};
+
+void NavigationServer3D::query_path_batch(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results, const Callable &p_callback) {
+	ERR_FAIL_COND_MSG(p_query_parameters.size() != p_query_results.size(), "The number of query parameters and query results must match.");
+
+	PathQueryBatch3D *batch = memnew(PathQueryBatch3D);
+	batch->parameters.resize(p_query_parameters.size());
+	for (int i = 0; i < p_query_parameters.size(); i++) {
+		Ref<NavigationPathQueryParameters3D> query_parameters = p_query_parameters[i];
+		Ref<NavigationPathQueryResult3D> query_result = p_query_results[i];
+		if (query_parameters.is_null() || query_result.is_null()) {
+			memdelete(batch);
+			ERR_FAIL_MSG(vformat("Invalid query parameters or result at index %d.", i));
+		}
+		batch->parameters[i] = query_parameters->get_parameters();
+	}
+	batch->query_results = p_query_results;
+	batch->callback = p_callback;
+
+	_query_path_batch(batch, p_callback.is_valid());
+}
+
+void NavigationServer3D::_query_path_batch(NavigationUtilities::PathQueryBatch *p_batch, bool p_async) {
+	ERR_FAIL_NULL(p_batch);
+
+	p_batch->results.resize(p_batch->parameters.size());
+	for (uint32_t i = 0; i < p_batch->parameters.size(); i++) {
+		p_batch->results[i] = _query_path(p_batch->parameters[i]);
+	}
+	p_batch->finish();
+	memdelete(p_batch);
+}
+
 ///////////////////////////////////////////////////////
 
 NavigationServer3DCallback NavigationServer3DManager::create_callback = nullptr;
@@ -105,6 +105,12 @@ public:
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const = 0;
 
+	/// Returns the direction to move from the position towards the target, from a flow field shared by all queries of that target.
+	virtual Vector3 map_get_flow_direction(RID p_map, const Vector3 &p_target, const Vector3 &p_position, uint32_t p_navigation_layers = 1) const = 0;
+
+	/// Returns the travel cost from the position to the target, from the same flow field.
+	virtual real_t map_get_flow_cost(RID p_map, const Vector3 &p_target, const Vector3 &p_position, uint32_t p_navigation_layers = 1) const = 0;
+
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const = 0;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const = 0;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const = 0;
@@ -118,6 +124,9 @@ public:
 	virtual void map_force_update(RID p_map) = 0;
 	virtual uint32_t map_get_iteration_id(RID p_map) const = 0;
 
+	/// Returns the timings and path query statistics of the map over the last second.
+	virtual Dictionary map_get_profile(RID p_map) const = 0;
+
 	virtual Vector3 map_get_random_point(RID p_map, uint32_t p_navigation_layers, bool p_uniformly) const = 0;
 
 	/// Creates a new region.
@@ -345,13 +354,25 @@ public:
 	/// Returns a customized navigation path using a query parameters object
 	virtual void query_path(const Ref<NavigationPathQueryParameters3D> &p_query_parameters, Ref<NavigationPathQueryResult3D> p_query_result) const;
 
+	/// Runs many path queries at once, on worker threads when the server supports it.
+	void query_path_batch(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results, const Callable &p_callback = Callable());
+
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const = 0;
+	/// Takes ownership of the batch, runs its queries and then calls `finish()` on it.
+	/// Asynchronous batches are finished later, on the main thread.
+	virtual void _query_path_batch(NavigationUtilities::PathQueryBatch *p_batch, bool p_async);
 
 #ifndef _3D_DISABLED
 	virtual void parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, Node *p_root_node, const Callable &p_callback = Callable()) = 0;
 	virtual void bake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) = 0;
 	virtual void bake_from_source_geometry_data_async(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) = 0;
 	virtual bool is_baking_navigation_mesh(Ref<NavigationMesh> p_navigation_mesh) const = 0;
+
+	/// Bakes the source geometry in tiles, each tile into its own region on the map.
+	/// Only the tiles around `p_dirty_aabb` are baked again, all of them if it is empty.
+	virtual void map_bake_tiles(RID p_map, const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, real_t p_tile_size, const AABB &p_dirty_aabb = AABB(), const Callable &p_callback = Callable()) = 0;
+	virtual bool map_is_baking_tiles(RID p_map) const = 0;
+	virtual TypedArray<RID> map_get_tile_regions(RID p_map) const = 0;
 #endif // _3D_DISABLED
 
 	virtual RID source_geometry_parser_create() = 0;
@@ -373,6 +394,14 @@ public:
 		INFO_EDGE_CONNECTION_COUNT,
 		INFO_EDGE_FREE_COUNT,
 		INFO_OBSTACLE_COUNT,
+		INFO_SYNC_TIME,
+		INFO_AVOIDANCE_TIME,
+		INFO_CALLBACKS_TIME,
+		INFO_PATH_QUERY_COUNT,
+		INFO_PATH_QUERY_TIME_P50,
+		INFO_PATH_QUERY_TIME_P99,
+		INFO_PATH_QUERY_SEARCHED_POLYGONS_P50,
+		INFO_PATH_QUERY_SEARCHED_POLYGONS_P99,
 	};
 
 	virtual int get_process_info(ProcessInfo p_info) const = 0;
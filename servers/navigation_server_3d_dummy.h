@@ -56,6 +56,8 @@ public:
 	void map_set_link_connection_radius(RID p_map, real_t p_connection_radius) override {}
 	real_t map_get_link_connection_radius(RID p_map) const override { return 0; }
 	Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers) const override { return Vector<Vector3>(); }
+	Vector3 map_get_flow_direction(RID p_map, const Vector3 &p_target, const Vector3 &p_position, uint32_t p_navigation_layers) const override { return Vector3(); }
+	real_t map_get_flow_cost(RID p_map, const Vector3 &p_target, const Vector3 &p_position, uint32_t p_navigation_layers) const override { return INFINITY; }
 	Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const override { return Vector3(); }
 	Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const override { return Vector3(); }
 	Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const override { return Vector3(); }
@@ -67,6 +69,7 @@ public:
 	TypedArray<RID> map_get_obstacles(RID p_map) const override { return TypedArray<RID>(); }
 	void map_force_update(RID p_map) override {}
 	uint32_t map_get_iteration_id(RID p_map) const override { return 0; }
+	Dictionary map_get_profile(RID p_map) const override { return Dictionary(); }
 
 	RID region_create() override { return RID(); }
 	void region_set_enabled(RID p_region, bool p_enabled) override {}
@@ -183,6 +186,9 @@ public:
 	void bake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override {}
 	void bake_from_source_geometry_data_async(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override {}
 	bool is_baking_navigation_mesh(Ref<NavigationMesh> p_navigation_mesh) const override { return false; }
+	void map_bake_tiles(RID p_map, const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, real_t p_tile_size, const AABB &p_dirty_aabb = AABB(), const Callable &p_callback = Callable()) override {}
+	bool map_is_baking_tiles(RID p_map) const override { return false; }
+	TypedArray<RID> map_get_tile_regions(RID p_map) const override { return TypedArray<RID>(); }
 #endif // _3D_DISABLED
 
 	RID source_geometry_parser_create() override { return RID(); }
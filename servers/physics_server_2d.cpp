@@ -346,6 +346,62 @@ Dictionary PhysicsDirectSpaceState2D::_intersect_ray(const Ref<PhysicsRayQueryPa
 	return d;
 }
 
+Dictionary PhysicsDirectSpaceState2D::_intersect_ray_batch(const Ref<PhysicsRayQueryParameters2D> &p_ray_query, const PackedVector2Array &p_from, const PackedVector2Array &p_to) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V(p_from.size() != p_to.size(), Dictionary());
+
+	int count = p_from.size();
+	LocalVector<RayResult> results;
+	results.resize(count);
+	LocalVector<bool> hits;
+	hits.resize(count);
+
+	intersect_ray_batch(p_ray_query->get_parameters(), p_from.ptr(), p_to.ptr(), count, results.ptr(), hits.ptr());
+
+	PackedByteArray hit_flags;
+	hit_flags.resize(count);
+	PackedVector2Array positions;
+	positions.resize(count);
+	PackedVector2Array normals;
+	normals.resize(count);
+	PackedInt64Array collider_ids;
+	collider_ids.resize(count);
+	PackedInt32Array shapes;
+	shapes.resize(count);
+
+	uint8_t *hit_flags_ptrw = hit_flags.ptrw();
+	Vector2 *positions_ptrw = positions.ptrw();
+	Vector2 *normals_ptrw = normals.ptrw();
+	int64_t *collider_ids_ptrw = collider_ids.ptrw();
+	int32_t *shapes_ptrw = shapes.ptrw();
+	for (int i = 0; i < count; i++) {
+		const bool hit = hits[i];
+		hit_flags_ptrw[i] = hit;
+		positions_ptrw[i] = hit ? results[i].position : Vector2();
+		normals_ptrw[i] = hit ? results[i].normal : Vector2();
+		collider_ids_ptrw[i] = hit ? int64_t(results[i].collider_id) : 0;
+		shapes_ptrw[i] = hit ? results[i].shape : -1;
+	}
+
+	Dictionary d;
+	d["hit"] = hit_flags;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+
+	return d;
+}
+
+void PhysicsDirectSpaceState2D::intersect_ray_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	RayParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.from = p_from[i];
+		parameters.to = p_to[i];
+		r_hits[i] = intersect_ray(parameters, r_results[i]);
+	}
+}
+
 TypedArray<Dictionary> PhysicsDirectSpaceState2D::_intersect_point(const Ref<PhysicsPointQueryParameters2D> &p_point_query, int p_max_results) {
 	ERR_FAIL_COND_V(p_point_query.is_null(), Array());
 
@@ -451,6 +507,7 @@ PhysicsDirectSpaceState2D::PhysicsDirectSpaceState2D() {
 void PhysicsDirectSpaceState2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("intersect_point", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_intersect_point, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("intersect_ray", "parameters"), &PhysicsDirectSpaceState2D::_intersect_ray);
+	ClassDB::bind_method(D_METHOD("intersect_ray_batch", "parameters", "from", "to"), &PhysicsDirectSpaceState2D::_intersect_ray_batch);
 	ClassDB::bind_method(D_METHOD("intersect_shape", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_intersect_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState2D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_collide_shape, DEFVAL(32));
@@ -736,6 +793,8 @@ void PhysicsServer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer2D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer2D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer2D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_save_state", "space"), &PhysicsServer2D::space_save_state);
+	ClassDB::bind_method(D_METHOD("space_restore_state", "space", "state"), &PhysicsServer2D::space_restore_state);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer2D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer2D::area_set_space);
@@ -119,6 +119,7 @@ class PhysicsDirectSpaceState2D : public Object {
 	GDCLASS(PhysicsDirectSpaceState2D, Object);
 
 	Dictionary _intersect_ray(const Ref<PhysicsRayQueryParameters2D> &p_ray_query);
+	Dictionary _intersect_ray_batch(const Ref<PhysicsRayQueryParameters2D> &p_ray_query, const PackedVector2Array &p_from, const PackedVector2Array &p_to);
 	TypedArray<Dictionary> _intersect_point(const Ref<PhysicsPointQueryParameters2D> &p_point_query, int p_max_results = 32);
 	TypedArray<Dictionary> _intersect_shape(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, int p_max_results = 32);
 	Vector<real_t> _cast_motion(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query);
@@ -151,6 +152,8 @@ public:
 	};
 
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) = 0;
+	// Casts rays that only differ by their endpoints, the ones in p_parameters are ignored. Implementations may run them on multiple threads.
+	virtual void intersect_ray_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits);
 
 	struct ShapeResult {
 		RID rid;
@@ -285,6 +288,9 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	virtual Vector<uint8_t> space_save_state(RID p_space) const = 0;
+	virtual void space_restore_state(RID p_space, const Vector<uint8_t> &p_state) = 0;
+
 	//missing space parameters
 
 	/* AREA API */
@@ -119,6 +119,9 @@ public:
 		return physics_server_2d->space_get_contact_count(p_space);
 	}
 
+	FUNC1RC(Vector<uint8_t>, space_save_state, RID);
+	FUNC2(space_restore_state, RID, const Vector<uint8_t> &);
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -377,6 +377,67 @@ Dictionary PhysicsDirectSpaceState3D::_intersect_ray(const Ref<PhysicsRayQueryPa
 	return d;
 }
 
+Dictionary PhysicsDirectSpaceState3D::_intersect_ray_batch(const Ref<PhysicsRayQueryParameters3D> &p_ray_query, const PackedVector3Array &p_from, const PackedVector3Array &p_to) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V(p_from.size() != p_to.size(), Dictionary());
+
+	int count = p_from.size();
+	LocalVector<RayResult> results;
+	results.resize(count);
+	LocalVector<bool> hits;
+	hits.resize(count);
+
+	intersect_ray_batch(p_ray_query->get_parameters(), p_from.ptr(), p_to.ptr(), count, results.ptr(), hits.ptr());
+
+	PackedByteArray hit_flags;
+	hit_flags.resize(count);
+	PackedVector3Array positions;
+	positions.resize(count);
+	PackedVector3Array normals;
+	normals.resize(count);
+	PackedInt64Array collider_ids;
+	collider_ids.resize(count);
+	PackedInt32Array shapes;
+	shapes.resize(count);
+	PackedInt32Array face_indices;
+	face_indices.resize(count);
+
+	uint8_t *hit_flags_ptrw = hit_flags.ptrw();
+	Vector3 *positions_ptrw = positions.ptrw();
+	Vector3 *normals_ptrw = normals.ptrw();
+	int64_t *collider_ids_ptrw = collider_ids.ptrw();
+	int32_t *shapes_ptrw = shapes.ptrw();
+	int32_t *face_indices_ptrw = face_indices.ptrw();
+	for (int i = 0; i < count; i++) {
+		const bool hit = hits[i];
+		hit_flags_ptrw[i] = hit;
+		positions_ptrw[i] = hit ? results[i].position : Vector3();
+		normals_ptrw[i] = hit ? results[i].normal : Vector3();
+		collider_ids_ptrw[i] = hit ? int64_t(results[i].collider_id) : 0;
+		shapes_ptrw[i] = hit ? results[i].shape : -1;
+		face_indices_ptrw[i] = hit ? results[i].face_index : -1;
+	}
+
+	Dictionary d;
+	d["hit"] = hit_flags;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+	d["face_index"] = face_indices;
+
+	return d;
+}
+
+void PhysicsDirectSpaceState3D::intersect_ray_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	RayParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.from = p_from[i];
+		parameters.to = p_to[i];
+		r_hits[i] = intersect_ray(parameters, r_results[i]);
+	}
+}
+
 TypedArray<Dictionary> PhysicsDirectSpaceState3D::_intersect_point(const Ref<PhysicsPointQueryParameters3D> &p_point_query, int p_max_results) {
 	ERR_FAIL_COND_V(p_point_query.is_null(), TypedArray<Dictionary>());
 
@@ -482,6 +543,7 @@ PhysicsDirectSpaceState3D::PhysicsDirectSpaceState3D() {
 void PhysicsDirectSpaceState3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("intersect_point", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_intersect_point, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("intersect_ray", "parameters"), &PhysicsDirectSpaceState3D::_intersect_ray);
+	ClassDB::bind_method(D_METHOD("intersect_ray_batch", "parameters", "from", "to"), &PhysicsDirectSpaceState3D::_intersect_ray_batch);
 	ClassDB::bind_method(D_METHOD("intersect_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState3D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_collide_shape, DEFVAL(32));
@@ -708,6 +770,7 @@ void PhysicsServer3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("shape_get_type", "shape"), &PhysicsServer3D::shape_get_type);
 	ClassDB::bind_method(D_METHOD("shape_get_data", "shape"), &PhysicsServer3D::shape_get_data);
+	ClassDB::bind_method(D_METHOD("shape_get_bvh_data", "shape"), &PhysicsServer3D::shape_get_bvh_data);
 	ClassDB::bind_method(D_METHOD("shape_get_margin", "shape"), &PhysicsServer3D::shape_get_margin);
 
 	ClassDB::bind_method(D_METHOD("space_create"), &PhysicsServer3D::space_create);
@@ -716,6 +779,8 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer3D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer3D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer3D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_save_state", "space"), &PhysicsServer3D::space_save_state);
+	ClassDB::bind_method(D_METHOD("space_restore_state", "space", "state"), &PhysicsServer3D::space_restore_state);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer3D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer3D::area_set_space);
@@ -1135,6 +1200,10 @@ PhysicsServer3D::PhysicsServer3D() {
 	GLOBAL_DEF("physics/3d/sleep_threshold_angular", Math::deg_to_rad(8.0));
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/time_before_sleep", PROPERTY_HINT_RANGE, "0,5,0.01,or_greater"), 0.5);
 	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/3d/solver/solver_iterations", PROPERTY_HINT_RANGE, "1,32,1,or_greater"), 16);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/3d/solver/max_threads", PROPERTY_HINT_RANGE, "1,64,1,or_greater"), -1);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/3d/solver/island_split_threshold", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), 256);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/3d/solver/contact_cache_steps", PROPERTY_HINT_RANGE, "0,64,1,or_greater"), 8);
+	GLOBAL_DEF("physics/3d/solver/deterministic", false);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_recycle_radius", PROPERTY_HINT_RANGE, "0,0.1,0.001,or_greater"), 0.01);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_separation", PROPERTY_HINT_RANGE, "0,0.1,0.001,or_greater"), 0.05);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_allowed_penetration", PROPERTY_HINT_RANGE, "0.001,0.1,0.001,or_greater"), 0.01);
@@ -146,6 +146,7 @@ public:
 
 	virtual ShapeType shape_get_type(RID p_shape) const override { return SHAPE_SPHERE; }
 	virtual Variant shape_get_data(RID p_shape) const override { return Variant(); }
+	virtual Vector<uint8_t> shape_get_bvh_data(RID p_shape) const override { return Vector<uint8_t>(); }
 
 	virtual void shape_set_margin(RID p_shape, real_t p_margin) override {}
 	virtual real_t shape_get_margin(RID p_shape) const override { return 0; }
@@ -167,6 +168,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override { return Vector<Vector3>(); }
 	virtual int space_get_contact_count(RID p_space) const override { return 0; }
 
+	virtual Vector<uint8_t> space_save_state(RID p_space) const override { return Vector<uint8_t>(); }
+	virtual void space_restore_state(RID p_space, const Vector<uint8_t> &p_state) override {}
+
 	/* AREA API */
 
 	virtual RID area_create() override { return RID(); }
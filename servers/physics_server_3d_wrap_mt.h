@@ -94,6 +94,7 @@ public:
 
 	FUNC1RC(ShapeType, shape_get_type, RID);
 	FUNC1RC(Variant, shape_get_data, RID);
+	FUNC1RC(Vector<uint8_t>, shape_get_bvh_data, RID);
 	FUNC1RC(real_t, shape_get_custom_solver_bias, RID);
 #if 0
 	//these work well, but should be used from the main thread only
@@ -128,6 +129,9 @@ public:
 		return physics_server_3d->space_get_contact_count(p_space);
 	}
 
+	FUNC1RC(Vector<uint8_t>, space_save_state, RID);
+	FUNC2(space_restore_state, RID, const Vector<uint8_t> &);
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -34,6 +34,7 @@
 #include "core/math/geometry_2d.h"
 #include "core/math/transform_interpolator.h"
 #include "renderer_viewport.h"
+#include "rendering_cpu_profiler.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
 #include "servers/rendering/storage/texture_storage.h"
@@ -47,33 +48,49 @@ const static float FEATHER_SIZE = 1.25f;
 void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, uint32_t p_canvas_cull_mask, RenderingMethod::RenderInfo *r_render_info) {
 	RENDER_TIMESTAMP("Cull CanvasItem Tree");
 
-	memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
-	memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
-
-	for (int i = 0; i < p_child_item_count; i++) {
-		_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true, p_canvas_cull_mask, Point2(), 1, nullptr);
-	}
-
 	RendererCanvasRender::Item *list = nullptr;
 	RendererCanvasRender::Item *list_end = nullptr;
+	uint32_t item_count = 0;
+
+	{
+		RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_CANVAS_CULL);
 
-	for (int i = 0; i < z_range; i++) {
-		if (!z_list[i]) {
-			continue;
+		memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
+		memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
+
+		for (int i = 0; i < p_child_item_count; i++) {
+			_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true, p_canvas_cull_mask, Point2(), 1, nullptr);
 		}
-		if (!list) {
-			list = z_list[i];
-			list_end = z_last_list[i];
-		} else {
-			list_end->next = z_list[i];
-			list_end = z_last_list[i];
+
+		for (int i = 0; i < z_range; i++) {
+			if (!z_list[i]) {
+				continue;
+			}
+			if (!list) {
+				list = z_list[i];
+				list_end = z_last_list[i];
+			} else {
+				list_end->next = z_list[i];
+				list_end = z_last_list[i];
+			}
+		}
+
+		if (RenderingCPUProfiler::is_in_scope()) {
+			for (RendererCanvasRender::Item *ci = list; ci; ci = ci->next) {
+				item_count++;
+			}
+			RENDER_CPU_PROFILE_ELEMENTS(item_count);
 		}
 	}
 
 	RENDER_TIMESTAMP("Render CanvasItems");
 
 	bool sdf_flag;
-	RSG::canvas_render->canvas_render_items(p_to_render_target, list, p_modulate, p_lights, p_directional_lights, p_transform, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, sdf_flag, r_render_info);
+	{
+		RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_COMMAND_RECORDING);
+		RENDER_CPU_PROFILE_ELEMENTS(item_count);
+		RSG::canvas_render->canvas_render_items(p_to_render_target, list, p_modulate, p_lights, p_directional_lights, p_transform, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, sdf_flag, r_render_info);
+	}
 	if (sdf_flag) {
 		sdf_used = true;
 	}
@@ -476,7 +476,13 @@ void RenderForwardClustered::_render_list_template(RenderingDevice::DrawListID p
 			prev_index_array_rd = index_array_rd;
 		}
 
-		RID pipeline_rd = pipeline->get_render_pipeline(vertex_format, framebuffer_format, p_params->force_wireframe, 0, pipeline_specialization);
+		RID pipeline_rd = pipeline->get_render_pipeline(vertex_format, framebuffer_format, p_params->force_wireframe, 0, pipeline_specialization, true);
+		if (pipeline_rd.is_null()) {
+			// Still compiling in the background, skip drawing until it's ready.
+			should_request_redraw = true;
+			i += element_info.repeat - 1; //skip equal elements
+			continue;
+		}
 
 		if (pipeline_rd != prev_pipeline_rd) {
 			// checking with prev shader does not make so much sense, as
@@ -32,6 +32,7 @@
 #define RENDER_FORWARD_CLUSTERED_H
 
 #include "core/templates/paged_allocator.h"
+#include "core/templates/radix_sort.h"
 #include "servers/rendering/renderer_rd/cluster_builder_rd.h"
 #include "servers/rendering/renderer_rd/effects/fsr2.h"
 #include "servers/rendering/renderer_rd/effects/resolve.h"
@@ -43,6 +44,7 @@
 #include "servers/rendering/renderer_rd/shaders/forward_clustered/best_fit_normal.glsl.gen.h"
 #include "servers/rendering/renderer_rd/shaders/forward_clustered/scene_forward_clustered.glsl.gen.h"
 #include "servers/rendering/renderer_rd/storage_rd/utilities.h"
+#include "servers/rendering/rendering_cpu_profiler.h"
 
 #define RB_SCOPE_FORWARD_CLUSTERED SNAME("forward_clustered")
 
@@ -522,7 +524,9 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 			element_info.clear();
 		}
 
-		//should eventually be replaced by radix
+		// Lists shorter than this are sorted with a comparison sort, which is faster
+		// than radix sort's fixed cost of building histograms.
+		static constexpr uint32_t RADIX_SORT_THRESHOLD = 256;
 
 		struct SortByKey {
 			_FORCE_INLINE_ bool operator()(const GeometryInstanceSurfaceDataCache *A, const GeometryInstanceSurfaceDataCache *B) const {
@@ -530,14 +534,28 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 			}
 		};
 
+		struct GetSortKey {
+			_FORCE_INLINE_ void operator()(const GeometryInstanceSurfaceDataCache *p_element, uint64_t &r_key_high, uint64_t &r_key_low) const {
+				r_key_high = p_element->sort.sort_key2;
+				r_key_low = p_element->sort.sort_key1;
+			}
+		};
+
+		RadixSort<GeometryInstanceSurfaceDataCache *, GetSortKey> radix_sorter;
+
 		void sort_by_key() {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr(), elements.size());
+			sort_by_key_range(0, elements.size());
 		}
 
 		void sort_by_key_range(uint32_t p_from, uint32_t p_size) {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr() + p_from, p_size);
+			RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT);
+			RENDER_CPU_PROFILE_ELEMENTS(p_size);
+			if (p_size >= RADIX_SORT_THRESHOLD) {
+				radix_sorter.sort(elements.ptr() + p_from, p_size);
+			} else {
+				SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
+				sorter.sort(elements.ptr() + p_from, p_size);
+			}
 		}
 
 		struct SortByDepth {
@@ -548,6 +566,8 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 
 		void sort_by_depth() { //used for shadows
 
+			RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT);
+			RENDER_CPU_PROFILE_ELEMENTS(elements.size());
 			SortArray<GeometryInstanceSurfaceDataCache *, SortByDepth> sorter;
 			sorter.sort(elements.ptr(), elements.size());
 		}
@@ -560,6 +580,8 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 
 		void sort_by_reverse_depth_and_priority() { //used for alpha
 
+			RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT);
+			RENDER_CPU_PROFILE_ELEMENTS(elements.size());
 			SortArray<GeometryInstanceSurfaceDataCache *, SortByReverseDepthAndPriority> sorter;
 			sorter.sort(elements.ptr(), elements.size());
 		}
@@ -37,6 +37,11 @@
 
 using namespace RendererSceneRenderImplementation;
 
+// Identifies a pipeline cache across runs so its recorded variants can be compiled ahead of time.
+static uint64_t _pipeline_variant_key(uint64_t p_code_hash, uint32_t p_cull_variant, uint32_t p_primitive, uint32_t p_version) {
+	return hash_djb2_one_64(p_version, hash_djb2_one_64(p_primitive, hash_djb2_one_64(p_cull_variant, p_code_hash)));
+}
+
 void SceneShaderForwardClustered::ShaderData::set_code(const String &p_code) {
 	//compile
 
@@ -178,6 +183,8 @@ void SceneShaderForwardClustered::ShaderData::set_code(const String &p_code) {
 	print_line("\n**vertex_globals:\n" + gen_code.stage_globals[ShaderCompiler::STAGE_VERTEX]);
 	print_line("\n**fragment_globals:\n" + gen_code.stage_globals[ShaderCompiler::STAGE_FRAGMENT]);
 #endif
+	// Pipelines may still be compiling in the background with the shader that is about to be replaced.
+	_clear_pipelines();
 	shader_singleton->shader.version_set_code(version, gen_code.code, gen_code.uniforms, gen_code.stage_globals[ShaderCompiler::STAGE_VERTEX], gen_code.stage_globals[ShaderCompiler::STAGE_FRAGMENT], gen_code.defines);
 	ERR_FAIL_COND(!shader_singleton->shader.version_is_valid(version));
 
@@ -275,6 +282,7 @@ void SceneShaderForwardClustered::ShaderData::set_code(const String &p_code) {
 		depth_stencil_state.enable_depth_write = depth_draw != DEPTH_DRAW_DISABLED ? true : false;
 	}
 	bool depth_pre_pass_enabled = bool(GLOBAL_GET("rendering/driver/depth_prepass/enable"));
+	uint64_t code_hash = code.hash64();
 
 	for (int i = 0; i < CULL_VARIANT_MAX; i++) {
 		RD::PolygonCullMode cull_mode_rd_table[CULL_VARIANT_MAX][3] = {
@@ -380,6 +388,7 @@ void SceneShaderForwardClustered::ShaderData::set_code(const String &p_code) {
 						}
 
 						RID shader_variant = shader_singleton->shader.version_get_shader(version, variant);
+						color_pipelines[i][j][l].set_variant_key(_pipeline_variant_key(code_hash, i, j, PIPELINE_VERSION_MAX + l));
 						color_pipelines[i][j][l].setup(shader_variant, primitive_rd, raster_state, multisample_state, depth_stencil, blend_state, 0, singleton->default_specialization_constants);
 					}
 				} else {
@@ -400,6 +409,7 @@ void SceneShaderForwardClustered::ShaderData::set_code(const String &p_code) {
 					}
 
 					RID shader_variant = shader_singleton->shader.version_get_shader(version, shader_version);
+					pipelines[i][j][k].set_variant_key(_pipeline_variant_key(code_hash, i, j, k));
 					pipelines[i][j][k].setup(shader_variant, primitive_rd, raster_state, multisample_state, depth_stencil, blend_state, 0, singleton->default_specialization_constants);
 				}
 			}
@@ -427,6 +437,19 @@ RS::ShaderNativeSourceCode SceneShaderForwardClustered::ShaderData::get_native_s
 	return shader_singleton->shader.version_get_native_source_code(version);
 }
 
+void SceneShaderForwardClustered::ShaderData::_clear_pipelines() {
+	for (int i = 0; i < CULL_VARIANT_MAX; i++) {
+		for (int j = 0; j < RS::PRIMITIVE_MAX; j++) {
+			for (int k = 0; k < PIPELINE_VERSION_MAX; k++) {
+				pipelines[i][j][k].clear();
+			}
+			for (int k = 0; k < PIPELINE_COLOR_PASS_FLAG_COUNT; k++) {
+				color_pipelines[i][j][k].clear();
+			}
+		}
+	}
+}
+
 SceneShaderForwardClustered::ShaderData::ShaderData() :
 		shader_list_element(this) {
 }
@@ -434,7 +457,8 @@ SceneShaderForwardClustered::ShaderData::ShaderData() :
 SceneShaderForwardClustered::ShaderData::~ShaderData() {
 	SceneShaderForwardClustered *shader_singleton = (SceneShaderForwardClustered *)SceneShaderForwardClustered::singleton;
 	ERR_FAIL_NULL(shader_singleton);
-	//pipeline variants will clear themselves if shader is gone
+	//pipeline variants will clear themselves if shader is gone, but background compilations must finish first
+	_clear_pipelines();
 	if (version.is_valid()) {
 		shader_singleton->shader.version_free(version);
 	}
@@ -195,6 +195,8 @@ public:
 		virtual RS::ShaderNativeSourceCode get_native_source_code() const;
 
 		SelfList<ShaderData> shader_list_element;
+		void _clear_pipelines();
+
 		ShaderData();
 		virtual ~ShaderData();
 	};
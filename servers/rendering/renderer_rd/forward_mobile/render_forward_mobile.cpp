@@ -2199,7 +2199,12 @@ void RenderForwardMobile::_render_list_template(RenderingDevice::DrawListID p_dr
 			prev_index_array_rd = index_array_rd;
 		}
 
-		RID pipeline_rd = pipeline->get_render_pipeline(vertex_format, framebuffer_format, p_params->force_wireframe, p_params->subpass, base_spec_constants);
+		RID pipeline_rd = pipeline->get_render_pipeline(vertex_format, framebuffer_format, p_params->force_wireframe, p_params->subpass, base_spec_constants, true);
+		if (pipeline_rd.is_null()) {
+			// Still compiling in the background, skip drawing until it's ready.
+			should_request_redraw = true;
+			continue;
+		}
 
 		if (pipeline_rd != prev_pipeline_rd) {
 			RD::get_singleton()->draw_list_bind_render_pipeline(draw_list, pipeline_rd);
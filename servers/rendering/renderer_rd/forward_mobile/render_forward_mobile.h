@@ -32,10 +32,12 @@
 #define RENDER_FORWARD_MOBILE_H
 
 #include "core/templates/paged_allocator.h"
+#include "core/templates/radix_sort.h"
 #include "servers/rendering/renderer_rd/forward_mobile/scene_shader_forward_mobile.h"
 #include "servers/rendering/renderer_rd/pipeline_cache_rd.h"
 #include "servers/rendering/renderer_rd/renderer_scene_render_rd.h"
 #include "servers/rendering/renderer_rd/storage_rd/utilities.h"
+#include "servers/rendering/rendering_cpu_profiler.h"
 
 #define RB_SCOPE_MOBILE SNAME("mobile")
 
@@ -295,7 +297,9 @@ private:
 			element_info.clear();
 		}
 
-		//should eventually be replaced by radix
+		// Lists shorter than this are sorted with a comparison sort, which is faster
+		// than radix sort's fixed cost of building histograms.
+		static constexpr uint32_t RADIX_SORT_THRESHOLD = 256;
 
 		struct SortByKey {
 			_FORCE_INLINE_ bool operator()(const GeometryInstanceSurfaceDataCache *A, const GeometryInstanceSurfaceDataCache *B) const {
@@ -303,14 +307,28 @@ private:
 			}
 		};
 
+		struct GetSortKey {
+			_FORCE_INLINE_ void operator()(const GeometryInstanceSurfaceDataCache *p_element, uint64_t &r_key_high, uint64_t &r_key_low) const {
+				r_key_high = p_element->sort.sort_key2;
+				r_key_low = p_element->sort.sort_key1;
+			}
+		};
+
+		RadixSort<GeometryInstanceSurfaceDataCache *, GetSortKey> radix_sorter;
+
 		void sort_by_key() {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr(), elements.size());
+			sort_by_key_range(0, elements.size());
 		}
 
 		void sort_by_key_range(uint32_t p_from, uint32_t p_size) {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr() + p_from, p_size);
+			RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT);
+			RENDER_CPU_PROFILE_ELEMENTS(p_size);
+			if (p_size >= RADIX_SORT_THRESHOLD) {
+				radix_sorter.sort(elements.ptr() + p_from, p_size);
+			} else {
+				SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
+				sorter.sort(elements.ptr() + p_from, p_size);
+			}
 		}
 
 		struct SortByDepth {
@@ -321,6 +339,8 @@ private:
 
 		void sort_by_depth() { //used for shadows
 
+			RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT);
+			RENDER_CPU_PROFILE_ELEMENTS(elements.size());
 			SortArray<GeometryInstanceSurfaceDataCache *, SortByDepth> sorter;
 			sorter.sort(elements.ptr(), elements.size());
 		}
@@ -333,6 +353,8 @@ private:
 
 		void sort_by_reverse_depth_and_priority() { //used for alpha
 
+			RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT);
+			RENDER_CPU_PROFILE_ELEMENTS(elements.size());
 			SortArray<GeometryInstanceSurfaceDataCache *, SortByReverseDepthAndPriority> sorter;
 			sorter.sort(elements.ptr(), elements.size());
 		}
@@ -39,6 +39,11 @@ using namespace RendererSceneRenderImplementation;
 
 /* ShaderData */
 
+// Identifies a pipeline cache across runs so its recorded variants can be compiled ahead of time.
+static uint64_t _pipeline_variant_key(uint64_t p_code_hash, uint32_t p_cull_variant, uint32_t p_primitive, uint32_t p_version) {
+	return hash_djb2_one_64(p_version, hash_djb2_one_64(p_primitive, hash_djb2_one_64(p_cull_variant, p_code_hash)));
+}
+
 void SceneShaderForwardMobile::ShaderData::set_code(const String &p_code) {
 	//compile
 
@@ -189,6 +194,8 @@ void SceneShaderForwardMobile::ShaderData::set_code(const String &p_code) {
 	print_line("\n**fragment_globals:\n" + gen_code.stage_globals[ShaderCompiler::STAGE_FRAGMENT]);
 #endif
 
+	// Pipelines may still be compiling in the background with the shader that is about to be replaced.
+	_clear_pipelines();
 	shader_singleton->shader.version_set_code(version, gen_code.code, gen_code.uniforms, gen_code.stage_globals[ShaderCompiler::STAGE_VERTEX], gen_code.stage_globals[ShaderCompiler::STAGE_FRAGMENT], gen_code.defines);
 	ERR_FAIL_COND(!shader_singleton->shader.version_is_valid(version));
 
@@ -286,6 +293,7 @@ void SceneShaderForwardMobile::ShaderData::set_code(const String &p_code) {
 		depth_stencil_state.enable_depth_write = depth_draw != DEPTH_DRAW_DISABLED ? true : false;
 	}
 
+	uint64_t code_hash = code.hash64();
 	for (int i = 0; i < CULL_VARIANT_MAX; i++) {
 		RD::PolygonCullMode cull_mode_rd_table[CULL_VARIANT_MAX][3] = {
 			{ RD::POLYGON_CULL_DISABLED, RD::POLYGON_CULL_FRONT, RD::POLYGON_CULL_BACK },
@@ -353,6 +361,7 @@ void SceneShaderForwardMobile::ShaderData::set_code(const String &p_code) {
 				}
 
 				RID shader_variant = shader_singleton->shader.version_get_shader(version, k);
+				pipelines[i][j][k].set_variant_key(_pipeline_variant_key(code_hash, i, j, k));
 				pipelines[i][j][k].setup(shader_variant, primitive_rd, raster_state, multisample_state, depth_stencil, blend_state, 0, singleton->default_specialization_constants);
 			}
 		}
@@ -379,6 +388,16 @@ RS::ShaderNativeSourceCode SceneShaderForwardMobile::ShaderData::get_native_sour
 	return shader_singleton->shader.version_get_native_source_code(version);
 }
 
+void SceneShaderForwardMobile::ShaderData::_clear_pipelines() {
+	for (int i = 0; i < CULL_VARIANT_MAX; i++) {
+		for (int j = 0; j < RS::PRIMITIVE_MAX; j++) {
+			for (int k = 0; k < SHADER_VERSION_MAX; k++) {
+				pipelines[i][j][k].clear();
+			}
+		}
+	}
+}
+
 SceneShaderForwardMobile::ShaderData::ShaderData() :
 		shader_list_element(this) {
 }
@@ -386,7 +405,8 @@ SceneShaderForwardMobile::ShaderData::ShaderData() :
 SceneShaderForwardMobile::ShaderData::~ShaderData() {
 	SceneShaderForwardMobile *shader_singleton = (SceneShaderForwardMobile *)SceneShaderForwardMobile::singleton;
 	ERR_FAIL_NULL(shader_singleton);
-	//pipeline variants will clear themselves if shader is gone
+	//pipeline variants will clear themselves if shader is gone, but background compilations must finish first
+	_clear_pipelines();
 	if (version.is_valid()) {
 		shader_singleton->shader.version_free(version);
 	}
@@ -147,6 +147,8 @@ public:
 
 		SelfList<ShaderData> shader_list_element;
 
+		void _clear_pipelines();
+
 		ShaderData();
 		virtual ~ShaderData();
 	};
@@ -30,18 +30,31 @@
 
 #include "pipeline_cache_rd.h"
 
+#include "core/io/file_access.h"
 #include "core/os/memory.h"
 
-RID PipelineCacheRD::_generate_version(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations) {
-	RD::PipelineMultisampleState multisample_state_version = multisample_state;
-	multisample_state_version.sample_count = RD::get_singleton()->framebuffer_format_get_texture_samples(p_framebuffer_format_id, p_render_pass);
+bool PipelineCacheRD::async_compilation = false;
+bool PipelineCacheRD::variant_recording = false;
+String PipelineCacheRD::variant_file_path;
+Mutex PipelineCacheRD::variant_mutex;
+HashMap<uint64_t, Vector<PackedInt64Array>> PipelineCacheRD::recorded_variants;
+bool PipelineCacheRD::recorded_variants_dirty = false;
 
-	bool wireframe = p_wireframe;
+static const uint32_t VARIANT_FILE_MAGIC = 0x52565047; // "GPVR"
+static const uint32_t VARIANT_FILE_VERSION = 1;
 
-	RD::PipelineRasterizationState raster_state_version = rasterization_state;
-	raster_state_version.wireframe = wireframe;
+void PipelineCacheRD::_prepare_version(CompileRequest &r_request, RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations) {
+	r_request.vertex_id = p_vertex_format_id;
+	r_request.framebuffer_id = p_framebuffer_format_id;
+	r_request.render_pass = p_render_pass;
 
-	Vector<RD::PipelineSpecializationConstant> specialization_constants = base_specialization_constants;
+	r_request.multisample_state = multisample_state;
+	r_request.multisample_state.sample_count = RD::get_singleton()->framebuffer_format_get_texture_samples(p_framebuffer_format_id, p_render_pass);
+
+	r_request.rasterization_state = rasterization_state;
+	r_request.rasterization_state.wireframe = p_wireframe;
+
+	r_request.specialization_constants = base_specialization_constants;
 
 	uint32_t bool_index = 0;
 	uint32_t bool_specializations = p_bool_specializations;
@@ -51,31 +64,406 @@ RID PipelineCacheRD::_generate_version(RD::VertexFormatID p_vertex_format_id, RD
 			sc.bool_value = true;
 			sc.constant_id = bool_index;
 			sc.type = RD::PIPELINE_SPECIALIZATION_CONSTANT_TYPE_BOOL;
-			specialization_constants.push_back(sc);
+			r_request.specialization_constants.push_back(sc);
 			bool_specializations &= ~(1 << bool_index);
 		}
 		bool_index++;
 	}
+}
 
-	RID pipeline = RD::get_singleton()->render_pipeline_create(shader, p_framebuffer_format_id, p_vertex_format_id, render_primitive, raster_state_version, multisample_state_version, depth_stencil_state, blend_state, dynamic_state_flags, p_render_pass, specialization_constants);
-	ERR_FAIL_COND_V(pipeline.is_null(), RID());
+RID PipelineCacheRD::_compile_version(const CompileRequest &p_request, bool p_background) {
+	// Only background compilations let the device be used by other threads meanwhile, callers compiling inline expect the device to stay locked.
+	return RD::get_singleton()->render_pipeline_create(shader, p_request.framebuffer_id, p_request.vertex_id, render_primitive, p_request.rasterization_state, p_request.multisample_state, depth_stencil_state, blend_state, dynamic_state_flags, p_request.render_pass, p_request.specialization_constants, p_background);
+}
+
+void PipelineCacheRD::_compile_version_task(void *p_userdata) {
+	CompileRequest *request = static_cast<CompileRequest *>(p_userdata);
+	PipelineCacheRD *cache = request->cache;
+
+	// The cache state used here can't change until this task is waited for, see _clear().
+	RID pipeline = cache->_compile_version(*request, true);
+
+	cache->spin_lock.lock();
+	cache->versions[request->version].pipeline = pipeline;
+	cache->versions[request->version].compiled = true;
+	cache->spin_lock.unlock();
+
+	{
+		MutexLock lock(cache->compile_mutex);
+		cache->compile_condition.notify_all();
+	}
+
+	memdelete(request);
+}
+
+uint32_t PipelineCacheRD::_add_version(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations) {
 	versions = static_cast<Version *>(memrealloc(versions, sizeof(Version) * (version_count + 1)));
 	versions[version_count].framebuffer_id = p_framebuffer_format_id;
 	versions[version_count].vertex_id = p_vertex_format_id;
-	versions[version_count].wireframe = wireframe;
-	versions[version_count].pipeline = pipeline;
+	versions[version_count].wireframe = p_wireframe;
+	versions[version_count].pipeline = RID();
 	versions[version_count].render_pass = p_render_pass;
 	versions[version_count].bool_specializations = p_bool_specializations;
-	version_count++;
+	versions[version_count].compile_task = WorkerThreadPool::INVALID_TASK_ID;
+	versions[version_count].compiled = true;
+	return version_count++;
+}
+
+RID PipelineCacheRD::_generate_version(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations, bool p_async) {
+	if (variant_recording && variant_key != 0) {
+		_record_variant(p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations);
+	}
+
+	if (p_async) {
+		CompileRequest *request = memnew(CompileRequest);
+		_prepare_version(*request, p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations);
+		request->cache = this;
+		request->version = _add_version(p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations);
+		versions[request->version].compiled = false;
+		// The task can't store its result before the spin lock held by the caller is released.
+		versions[request->version].compile_task = WorkerThreadPool::get_singleton()->add_native_task(&PipelineCacheRD::_compile_version_task, request, false, "Compile render pipeline");
+		return RID();
+	}
+
+	CompileRequest request;
+	_prepare_version(request, p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations);
+	RID pipeline = _compile_version(request, false);
+	ERR_FAIL_COND_V(pipeline.is_null(), RID());
+	uint32_t version = _add_version(p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations);
+	versions[version].pipeline = pipeline;
 	return pipeline;
 }
 
+RID PipelineCacheRD::_finish_version(uint32_t p_version, bool p_async) {
+	// Called with the spin lock held, releases it.
+	if (p_async && !versions[p_version].compiled) {
+		spin_lock.unlock();
+		return RID();
+	}
+
+	WorkerThreadPool::TaskID task = versions[p_version].compile_task;
+	versions[p_version].compile_task = WorkerThreadPool::INVALID_TASK_ID;
+	spin_lock.unlock();
+
+	if (task != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+	} else {
+		// Another thread claimed the task and is waiting for it.
+		_wait_for_compilation(p_version);
+	}
+
+	spin_lock.lock();
+	RID pipeline = versions[p_version].pipeline;
+	spin_lock.unlock();
+	return pipeline;
+}
+
+void PipelineCacheRD::_wait_for_compilation(uint32_t p_version) {
+	MutexLock lock(compile_mutex);
+	while (true) {
+		spin_lock.lock();
+		bool compiled = versions[p_version].compiled;
+		spin_lock.unlock();
+		if (compiled) {
+			return;
+		}
+		// The task notifies while holding compile_mutex, so it can't be missed between the check and the wait.
+		compile_condition.wait(lock);
+	}
+}
+
+// Variants are stored as a flat list of integers, the formats are recreated from it on load since their IDs aren't stable between runs.
+static bool _encode_variant(PackedInt64Array &r_data, RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations) {
+	Vector<RD::AttachmentFormat> attachments;
+	Vector<RD::FramebufferPass> passes;
+	uint32_t view_count = 1;
+	if (!RD::get_singleton()->framebuffer_format_get_description(p_framebuffer_format_id, attachments, passes, view_count) || attachments.is_empty()) {
+		// Empty framebuffer formats carry their sample count outside of the description, don't record them.
+		return false;
+	}
+
+	r_data.push_back(p_render_pass);
+	r_data.push_back(p_wireframe ? 1 : 0);
+	r_data.push_back(p_bool_specializations);
+
+	if (p_vertex_format_id == RD::INVALID_ID) {
+		r_data.push_back(-1);
+	} else {
+		Vector<RD::VertexAttribute> attributes = RD::get_singleton()->vertex_format_get_attributes(p_vertex_format_id);
+		r_data.push_back(attributes.size());
+		for (const RD::VertexAttribute &attribute : attributes) {
+			r_data.push_back(attribute.location);
+			r_data.push_back(attribute.offset);
+			r_data.push_back(attribute.format);
+			r_data.push_back(attribute.stride);
+			r_data.push_back(attribute.frequency);
+		}
+	}
+
+	r_data.push_back(view_count);
+	r_data.push_back(attachments.size());
+	for (const RD::AttachmentFormat &attachment : attachments) {
+		r_data.push_back(attachment.format);
+		r_data.push_back(attachment.samples);
+		r_data.push_back(attachment.usage_flags);
+	}
+
+	r_data.push_back(passes.size());
+	for (const RD::FramebufferPass &pass : passes) {
+		const Vector<int32_t> *lists[4] = { &pass.color_attachments, &pass.input_attachments, &pass.resolve_attachments, &pass.preserve_attachments };
+		for (const Vector<int32_t> *list : lists) {
+			r_data.push_back(list->size());
+			for (int32_t index : *list) {
+				r_data.push_back(index);
+			}
+		}
+		r_data.push_back(pass.depth_attachment);
+		r_data.push_back(pass.vrs_attachment);
+	}
+
+	return true;
+}
+
+struct VariantReader {
+	const PackedInt64Array &data;
+	int pos = 0;
+	bool error = false;
+
+	int64_t read() {
+		if (pos >= data.size()) {
+			error = true;
+			return 0;
+		}
+		return data[pos++];
+	}
+
+	int64_t read_count() {
+		int64_t count = read();
+		if (count < 0 || count > data.size() - pos) {
+			// Every element uses at least one entry, so this can't be valid.
+			error = true;
+			return 0;
+		}
+		return count;
+	}
+
+	VariantReader(const PackedInt64Array &p_data) :
+			data(p_data) {}
+};
+
+static bool _decode_variant(const PackedInt64Array &p_data, RD::VertexFormatID &r_vertex_format_id, RD::FramebufferFormatID &r_framebuffer_format_id, bool &r_wireframe, uint32_t &r_render_pass, uint32_t &r_bool_specializations) {
+	VariantReader reader(p_data);
+
+	r_render_pass = reader.read();
+	r_wireframe = reader.read() != 0;
+	r_bool_specializations = reader.read();
+
+	Vector<RD::VertexAttribute> attributes;
+	bool has_vertex_format = reader.pos < p_data.size() && p_data[reader.pos] >= 0;
+	if (has_vertex_format) {
+		attributes.resize(reader.read_count());
+		for (RD::VertexAttribute &attribute : attributes) {
+			attribute.location = reader.read();
+			attribute.offset = reader.read();
+			attribute.format = RD::DataFormat(CLAMP(reader.read(), 0, RD::DATA_FORMAT_MAX));
+			attribute.stride = reader.read();
+			attribute.frequency = RD::VertexFrequency(CLAMP(reader.read(), 0, RD::VERTEX_FREQUENCY_INSTANCE));
+		}
+	} else {
+		reader.read();
+	}
+
+	uint32_t view_count = reader.read();
+	Vector<RD::AttachmentFormat> attachments;
+	attachments.resize(reader.read_count());
+	for (RD::AttachmentFormat &attachment : attachments) {
+		attachment.format = RD::DataFormat(CLAMP(reader.read(), 0, RD::DATA_FORMAT_MAX));
+		attachment.samples = RD::TextureSamples(CLAMP(reader.read(), 0, RD::TEXTURE_SAMPLES_MAX));
+		attachment.usage_flags = reader.read();
+	}
+
+	Vector<RD::FramebufferPass> passes;
+	passes.resize(reader.read_count());
+	for (RD::FramebufferPass &pass : passes) {
+		Vector<int32_t> *lists[4] = { &pass.color_attachments, &pass.input_attachments, &pass.resolve_attachments, &pass.preserve_attachments };
+		for (Vector<int32_t> *list : lists) {
+			list->resize(reader.read_count());
+			for (int32_t &index : *list) {
+				index = reader.read();
+			}
+		}
+		pass.depth_attachment = reader.read();
+		pass.vrs_attachment = reader.read();
+	}
+
+	if (reader.error || reader.pos != p_data.size() || attachments.is_empty() || view_count == 0) {
+		return false;
+	}
+	for (const RD::AttachmentFormat &attachment : attachments) {
+		if (attachment.format == RD::DATA_FORMAT_MAX || attachment.samples == RD::TEXTURE_SAMPLES_MAX) {
+			return false;
+		}
+	}
+	for (const RD::VertexAttribute &attribute : attributes) {
+		if (attribute.format == RD::DATA_FORMAT_MAX) {
+			return false;
+		}
+	}
+
+	r_framebuffer_format_id = RD::get_singleton()->framebuffer_format_create_multipass(attachments, passes, view_count);
+	if (r_framebuffer_format_id == RD::INVALID_ID) {
+		return false;
+	}
+	r_vertex_format_id = RD::INVALID_ID;
+	if (has_vertex_format) {
+		r_vertex_format_id = RD::get_singleton()->vertex_format_create(attributes);
+		if (r_vertex_format_id == RD::INVALID_ID) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void PipelineCacheRD::_record_variant(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations) {
+	PackedInt64Array data;
+	if (!_encode_variant(data, p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations)) {
+		return;
+	}
+
+	MutexLock lock(variant_mutex);
+	Vector<PackedInt64Array> &variants = recorded_variants[variant_key];
+	if (variants.has(data)) {
+		return;
+	}
+	variants.push_back(data);
+	recorded_variants_dirty = true;
+}
+
+void PipelineCacheRD::_replay_recorded_variants() {
+	if (variant_key == 0) {
+		return;
+	}
+
+	Vector<PackedInt64Array> variants;
+	{
+		MutexLock lock(variant_mutex);
+		HashMap<uint64_t, Vector<PackedInt64Array>>::Iterator E = recorded_variants.find(variant_key);
+		if (!E) {
+			return;
+		}
+		variants = E->value;
+	}
+
+	for (const PackedInt64Array &data : variants) {
+		RD::VertexFormatID vertex_format_id;
+		RD::FramebufferFormatID framebuffer_format_id;
+		bool wireframe;
+		uint32_t render_pass;
+		uint32_t bool_specializations;
+		if (!_decode_variant(data, vertex_format_id, framebuffer_format_id, wireframe, render_pass, bool_specializations)) {
+			continue;
+		}
+
+		spin_lock.lock();
+		bool found = false;
+		for (uint32_t i = 0; i < version_count; i++) {
+			if (versions[i].vertex_id == vertex_format_id && versions[i].framebuffer_id == framebuffer_format_id && versions[i].wireframe == wireframe && versions[i].render_pass == render_pass && versions[i].bool_specializations == bool_specializations) {
+				found = true;
+				break;
+			}
+		}
+		if (!found) {
+			_generate_version(vertex_format_id, framebuffer_format_id, wireframe, render_pass, bool_specializations, async_compilation);
+		}
+		spin_lock.unlock();
+	}
+}
+
+void PipelineCacheRD::set_async_compilation_enabled(bool p_enabled) {
+	async_compilation = p_enabled;
+}
+
+bool PipelineCacheRD::is_async_compilation_enabled() {
+	return async_compilation;
+}
+
+void PipelineCacheRD::load_recorded_variants(const String &p_path) {
+	MutexLock lock(variant_mutex);
+	recorded_variants.clear();
+	recorded_variants_dirty = false;
+	variant_file_path = p_path;
+	variant_recording = !p_path.is_empty();
+
+	if (!variant_recording || !FileAccess::exists(p_path)) {
+		return;
+	}
+
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_MSG(f.is_null(), "Can't open recorded pipeline variants: " + p_path);
+	if (f->get_32() != VARIANT_FILE_MAGIC || f->get_32() != VARIANT_FILE_VERSION || f->get_pascal_string() != RD::get_singleton()->get_device_name()) {
+		// Recorded with another engine version or device, start over.
+		return;
+	}
+
+	Dictionary variants = f->get_var();
+	for (const Variant *key = variants.next(nullptr); key; key = variants.next(key)) {
+		Array list = variants[*key];
+		Vector<PackedInt64Array> &recorded = recorded_variants[uint64_t(int64_t(*key))];
+		for (int i = 0; i < list.size(); i++) {
+			if (list[i].get_type() == Variant::PACKED_INT64_ARRAY) {
+				recorded.push_back(list[i]);
+			}
+		}
+	}
+}
+
+void PipelineCacheRD::save_recorded_variants() {
+	MutexLock lock(variant_mutex);
+	if (!variant_recording || !recorded_variants_dirty) {
+		return;
+	}
+
+	Dictionary variants;
+	for (const KeyValue<uint64_t, Vector<PackedInt64Array>> &E : recorded_variants) {
+		Array list;
+		for (const PackedInt64Array &data : E.value) {
+			list.push_back(data);
+		}
+		variants[int64_t(E.key)] = list;
+	}
+
+	Ref<FileAccess> f = FileAccess::open(variant_file_path, FileAccess::WRITE);
+	ERR_FAIL_COND_MSG(f.is_null(), "Can't save recorded pipeline variants: " + variant_file_path);
+	f->store_32(VARIANT_FILE_MAGIC);
+	f->store_32(VARIANT_FILE_VERSION);
+	f->store_pascal_string(RD::get_singleton()->get_device_name());
+	f->store_var(variants);
+	recorded_variants_dirty = false;
+}
+
+void PipelineCacheRD::set_variant_key(uint64_t p_key) {
+	variant_key = p_key;
+}
+
 void PipelineCacheRD::_clear() {
 	// TODO: Clear should probably recompile all the variants already compiled instead to avoid stalls? Needs discussion.
 	if (versions) {
+		// Background compilations write into the versions array, so they must finish first.
+		for (uint32_t i = 0; i < version_count; i++) {
+			spin_lock.lock();
+			WorkerThreadPool::TaskID task = versions[i].compile_task;
+			versions[i].compile_task = WorkerThreadPool::INVALID_TASK_ID;
+			spin_lock.unlock();
+			if (task != WorkerThreadPool::INVALID_TASK_ID) {
+				WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+			} else {
+				_wait_for_compilation(i);
+			}
+		}
+
 		for (uint32_t i = 0; i < version_count; i++) {
 			//shader may be gone, so this may not be valid
-			if (RD::get_singleton()->render_pipeline_is_valid(versions[i].pipeline)) {
+			if (versions[i].pipeline.is_valid() && RD::get_singleton()->render_pipeline_is_valid(versions[i].pipeline)) {
 				RD::get_singleton()->free(versions[i].pipeline);
 			}
 		}
@@ -97,10 +485,12 @@ void PipelineCacheRD::setup(RID p_shader, RD::RenderPrimitive p_primitive, const
 	blend_state = p_blend_state;
 	dynamic_state_flags = p_dynamic_state_flags;
 	base_specialization_constants = p_base_specialization_constants;
+	_replay_recorded_variants();
 }
 void PipelineCacheRD::update_specialization_constants(const Vector<RD::PipelineSpecializationConstant> &p_base_specialization_constants) {
-	base_specialization_constants = p_base_specialization_constants;
 	_clear();
+	base_specialization_constants = p_base_specialization_constants;
+	_replay_recorded_variants();
 }
 
 void PipelineCacheRD::update_shader(RID p_shader) {
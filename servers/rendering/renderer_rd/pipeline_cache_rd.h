@@ -31,7 +31,11 @@
 #ifndef PIPELINE_CACHE_RD_H
 #define PIPELINE_CACHE_RD_H
 
+#include "core/object/worker_thread_pool.h"
+#include "core/os/condition_variable.h"
+#include "core/os/mutex.h"
 #include "core/os/spin_lock.h"
+#include "core/templates/hash_map.h"
 #include "servers/rendering/rendering_device.h"
 
 class PipelineCacheRD {
@@ -55,21 +59,70 @@ class PipelineCacheRD {
 		bool wireframe;
 		uint32_t bool_specializations;
 		RID pipeline;
+		// Set while the pipeline is being compiled on the WorkerThreadPool, the task must be waited for exactly once.
+		WorkerThreadPool::TaskID compile_task;
+		bool compiled;
 	};
 
 	Version *versions = nullptr;
 	uint32_t version_count;
 
-	RID _generate_version(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations = 0);
+	// Notified whenever a background compilation is done, for threads waiting on a task claimed by another one.
+	BinaryMutex compile_mutex;
+	ConditionVariable compile_condition;
+
+	struct CompileRequest {
+		PipelineCacheRD *cache = nullptr;
+		uint32_t version = 0;
+		RD::VertexFormatID vertex_id = 0;
+		RD::FramebufferFormatID framebuffer_id = 0;
+		uint32_t render_pass = 0;
+		RD::PipelineRasterizationState rasterization_state;
+		RD::PipelineMultisampleState multisample_state;
+		Vector<RD::PipelineSpecializationConstant> specialization_constants;
+	};
+
+	// Key identifying this cache across runs (usually derived from the shader code), 0 disables variant recording.
+	uint64_t variant_key = 0;
+
+	static bool async_compilation;
+	static bool variant_recording;
+	static String variant_file_path;
+	static Mutex variant_mutex;
+	static HashMap<uint64_t, Vector<PackedInt64Array>> recorded_variants;
+	static bool recorded_variants_dirty;
+
+	void _prepare_version(CompileRequest &r_request, RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations);
+	RID _compile_version(const CompileRequest &p_request, bool p_background);
+	static void _compile_version_task(void *p_userdata);
+	uint32_t _add_version(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations);
+	RID _generate_version(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations, bool p_async);
+	RID _finish_version(uint32_t p_version, bool p_async);
+	void _wait_for_compilation(uint32_t p_version);
+
+	void _record_variant(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations);
+	void _replay_recorded_variants();
 
 	void _clear();
 
 public:
+	// Compiles missing pipelines on the WorkerThreadPool. Callers that pass p_allow_async to
+	// get_render_pipeline() receive a null RID while the pipeline is still compiling.
+	static void set_async_compilation_enabled(bool p_enabled);
+	static bool is_async_compilation_enabled();
+
+	// Pipeline variants requested at runtime are recorded per variant key and written to p_path,
+	// so they can be compiled at load time on the next run instead of when first drawn.
+	static void load_recorded_variants(const String &p_path);
+	static void save_recorded_variants();
+
+	void set_variant_key(uint64_t p_key);
+
 	void setup(RID p_shader, RD::RenderPrimitive p_primitive, const RD::PipelineRasterizationState &p_rasterization_state, RD::PipelineMultisampleState p_multisample, const RD::PipelineDepthStencilState &p_depth_stencil_state, const RD::PipelineColorBlendState &p_blend_state, int p_dynamic_state_flags = 0, const Vector<RD::PipelineSpecializationConstant> &p_base_specialization_constants = Vector<RD::PipelineSpecializationConstant>());
 	void update_specialization_constants(const Vector<RD::PipelineSpecializationConstant> &p_base_specialization_constants);
 	void update_shader(RID p_shader);
 
-	_FORCE_INLINE_ RID get_render_pipeline(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe = false, uint32_t p_render_pass = 0, uint32_t p_bool_specializations = 0) {
+	_FORCE_INLINE_ RID get_render_pipeline(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe = false, uint32_t p_render_pass = 0, uint32_t p_bool_specializations = 0, bool p_allow_async = false) {
 #ifdef DEBUG_ENABLED
 		ERR_FAIL_COND_V_MSG(shader.is_null(), RID(),
 				"Attempted to use an unused shader variant (shader is null),");
@@ -81,12 +134,16 @@ public:
 		RID result;
 		for (uint32_t i = 0; i < version_count; i++) {
 			if (versions[i].vertex_id == p_vertex_format_id && versions[i].framebuffer_id == p_framebuffer_format_id && versions[i].wireframe == p_wireframe && versions[i].render_pass == p_render_pass && versions[i].bool_specializations == p_bool_specializations) {
+				if (versions[i].compile_task != WorkerThreadPool::INVALID_TASK_ID || !versions[i].compiled) {
+					// Still compiling in the background.
+					return _finish_version(i, p_allow_async && async_compilation);
+				}
 				result = versions[i].pipeline;
 				spin_lock.unlock();
 				return result;
 			}
 		}
-		result = _generate_version(p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations);
+		result = _generate_version(p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations, p_allow_async && async_compilation);
 		spin_lock.unlock();
 		return result;
 	}
@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/dir_access.h"
+#include "servers/rendering/renderer_rd/pipeline_cache_rd.h"
 
 void RendererCompositorRD::blit_render_targets_to_screen(DisplayServer::WindowID p_screen, const BlitToScreen *p_render_targets, int p_amount) {
 	Error err = RD::get_singleton()->screen_prepare_for_drawing(p_screen);
@@ -148,6 +149,8 @@ void RendererCompositorRD::initialize() {
 uint64_t RendererCompositorRD::frame = 1;
 
 void RendererCompositorRD::finalize() {
+	PipelineCacheRD::save_recorded_variants();
+
 	memdelete(scene);
 	memdelete(canvas);
 	memdelete(fog);
@@ -290,13 +293,26 @@ RendererCompositorRD::RendererCompositorRD() {
 					bool use_zstd = GLOBAL_GET("rendering/shader_compiler/shader_cache/use_zstd_compression");
 					bool strip_debug = GLOBAL_GET("rendering/shader_compiler/shader_cache/strip_debug");
 
-					ShaderRD::set_shader_cache_dir(shader_cache_dir);
 					ShaderRD::set_shader_cache_save_compressed(compress);
 					ShaderRD::set_shader_cache_save_compressed_zstd(use_zstd);
 					ShaderRD::set_shader_cache_save_debug(!strip_debug);
+					ShaderRD::set_shader_cache_dir(shader_cache_dir); // Opens the stage cache, so set after the save options.
 				}
 			}
 		}
+
+		PipelineCacheRD::set_async_compilation_enabled(GLOBAL_GET("rendering/rendering_device/pipeline_cache/async_compilation") && RD::get_singleton()->is_pipeline_creation_thread_safe());
+
+		String variants_path;
+		bool record_variants = GLOBAL_GET("rendering/rendering_device/pipeline_cache/record_pipeline_variants");
+		if (record_variants && !shader_cache_dir.is_empty()) {
+			variants_path = shader_cache_dir.path_join(vformat("pipeline_variants.%s", OS::get_singleton()->get_current_rendering_method()));
+			if (Engine::get_singleton()->is_editor_hint()) {
+				variants_path += ".editor";
+			}
+			variants_path += ".dat";
+		}
+		PipelineCacheRD::load_recorded_variants(variants_path);
 	}
 
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A RendererCompositorRD singleton already exists.");
@@ -167,13 +167,22 @@ void ShaderRD::_clear_version(Version *p_version) {
 		}
 
 		memdelete_arr(p_version->variants);
-		if (p_version->variant_data) {
-			memdelete_arr(p_version->variant_data);
-		}
+		_clear_variant_data(p_version);
 		p_version->variants = nullptr;
 	}
 }
 
+void ShaderRD::_clear_variant_data(Version *p_version) {
+	if (p_version->variant_data) {
+		memdelete_arr(p_version->variant_data);
+		p_version->variant_data = nullptr;
+	}
+	if (p_version->variant_stage_keys) {
+		memdelete_arr(p_version->variant_stage_keys);
+		p_version->variant_stage_keys = nullptr;
+	}
+}
+
 void ShaderRD::_build_variant_code(StringBuilder &builder, uint32_t p_variant, const Version *p_version, const StageTemplate &p_template) {
 	for (const StageTemplate::Chunk &chunk : p_template.chunks) {
 		switch (chunk.type) {
@@ -235,6 +244,7 @@ void ShaderRD::_compile_variant(uint32_t p_variant, const CompileData *p_data) {
 	}
 
 	Vector<RD::ShaderStageSPIRVData> stages;
+	String stage_keys;
 
 	String error;
 	String current_source;
@@ -249,7 +259,7 @@ void ShaderRD::_compile_variant(uint32_t p_variant, const CompileData *p_data) {
 
 		current_source = builder.as_string();
 		RD::ShaderStageSPIRVData stage;
-		stage.spirv = RD::get_singleton()->shader_compile_spirv_from_source(RD::SHADER_STAGE_VERTEX, current_source, RD::SHADER_LANGUAGE_GLSL, &error);
+		stage.spirv = _compile_stage(RD::SHADER_STAGE_VERTEX, current_source, &error, stage_keys);
 		if (stage.spirv.size() == 0) {
 			build_ok = false;
 		} else {
@@ -267,7 +277,7 @@ void ShaderRD::_compile_variant(uint32_t p_variant, const CompileData *p_data) {
 
 		current_source = builder.as_string();
 		RD::ShaderStageSPIRVData stage;
-		stage.spirv = RD::get_singleton()->shader_compile_spirv_from_source(RD::SHADER_STAGE_FRAGMENT, current_source, RD::SHADER_LANGUAGE_GLSL, &error);
+		stage.spirv = _compile_stage(RD::SHADER_STAGE_FRAGMENT, current_source, &error, stage_keys);
 		if (stage.spirv.size() == 0) {
 			build_ok = false;
 		} else {
@@ -286,7 +296,7 @@ void ShaderRD::_compile_variant(uint32_t p_variant, const CompileData *p_data) {
 		current_source = builder.as_string();
 
 		RD::ShaderStageSPIRVData stage;
-		stage.spirv = RD::get_singleton()->shader_compile_spirv_from_source(RD::SHADER_STAGE_COMPUTE, current_source, RD::SHADER_LANGUAGE_GLSL, &error);
+		stage.spirv = _compile_stage(RD::SHADER_STAGE_COMPUTE, current_source, &error, stage_keys);
 		if (stage.spirv.size() == 0) {
 			build_ok = false;
 		} else {
@@ -306,16 +316,55 @@ void ShaderRD::_compile_variant(uint32_t p_variant, const CompileData *p_data) {
 		return;
 	}
 
-	Vector<uint8_t> shader_data = RD::get_singleton()->shader_compile_binary_from_spirv(stages, name + ":" + itos(variant));
+	// Identical stages produce identical bytecode, so it can be shared by every version that uses them.
+	String shader_name = name + ":" + itos(variant);
+	bool use_stage_cache = stage_cache.is_open();
+	ShaderStageCacheRD::Key bytecode_key;
+	Vector<uint8_t> shader_data;
+	if (use_stage_cache) {
+		bytecode_key = ShaderStageCacheRD::make_key((shader_name + stage_keys).utf8());
+		stage_cache.get(bytecode_key, shader_data);
+	}
 
-	ERR_FAIL_COND(shader_data.is_empty());
+	if (shader_data.is_empty()) {
+		shader_data = RD::get_singleton()->shader_compile_binary_from_spirv(stages, shader_name);
+		ERR_FAIL_COND(shader_data.is_empty());
+		if (use_stage_cache) {
+			stage_cache.store(bytecode_key, shader_data);
+		}
+	}
 
 	{
 		MutexLock lock(variant_set_mutex);
 
 		p_data->version->variants[variant] = RD::get_singleton()->shader_create_from_bytecode(shader_data, p_data->version->variants[variant]);
 		p_data->version->variant_data[variant] = shader_data;
+		if (use_stage_cache) {
+			p_data->version->variant_stage_keys[variant] = bytecode_key;
+		}
+	}
+}
+
+Vector<uint8_t> ShaderRD::_compile_stage(RD::ShaderStage p_stage, const String &p_source, String *r_error, String &r_key_text) {
+	if (!stage_cache.is_open()) {
+		return RD::get_singleton()->shader_compile_spirv_from_source(p_stage, p_source, RD::SHADER_LANGUAGE_GLSL, r_error);
+	}
+
+	// The SPIR-V only depends on the source and the device API, not on which shader or material it comes from.
+	String key_text = stage_key_prefix + itos(p_stage) + "\n" + p_source;
+	ShaderStageCacheRD::Key key = ShaderStageCacheRD::make_key(key_text.utf8());
+	r_key_text += "[stage:" + String::hex_encode_buffer(key.hash, sizeof(key.hash)) + "]";
+
+	Vector<uint8_t> spirv;
+	if (stage_cache.get(key, spirv)) {
+		return spirv;
+	}
+
+	spirv = RD::get_singleton()->shader_compile_spirv_from_source(p_stage, p_source, RD::SHADER_LANGUAGE_GLSL, r_error);
+	if (!spirv.is_empty()) {
+		stage_cache.store(key, spirv);
 	}
+	return spirv;
 }
 
 RS::ShaderNativeSourceCode ShaderRD::version_get_native_source_code(RID p_version) {
@@ -400,7 +449,13 @@ String ShaderRD::_version_get_sha1(Version *p_version) const {
 }
 
 static const char *shader_file_header = "GDSC";
-static const uint32_t cache_file_version = 3;
+static const uint32_t cache_file_version = 5;
+
+// What the version cache holds for each variant.
+enum CacheFileData {
+	CACHE_FILE_DATA_BYTECODE,
+	CACHE_FILE_DATA_STAGE_KEYS, // The bytecode is in the stage cache.
+};
 
 String ShaderRD::_get_cache_file_path(Version *p_version, int p_group) {
 	const String &sha1 = _version_get_sha1(p_version);
@@ -429,21 +484,37 @@ bool ShaderRD::_load_from_cache(Version *p_version, int p_group) {
 
 	ERR_FAIL_COND_V(variant_count != (uint32_t)group_to_variant_map[p_group].size(), false); //should not happen but check
 
+	uint32_t data_type = f->get_32();
+	if (data_type == CACHE_FILE_DATA_STAGE_KEYS && !stage_cache.is_open()) {
+		return false; // The bytecode can't be looked up, compile again.
+	}
+	ERR_FAIL_COND_V(data_type != CACHE_FILE_DATA_BYTECODE && data_type != CACHE_FILE_DATA_STAGE_KEYS, false);
+
 	for (uint32_t i = 0; i < variant_count; i++) {
 		int variant_id = group_to_variant_map[p_group][i];
 		uint32_t variant_size = f->get_32();
-		ERR_FAIL_COND_V(variant_size == 0 && variants_enabled[variant_id], false);
 		if (!variants_enabled[variant_id]) {
+			f->seek(f->get_position() + variant_size);
 			continue;
 		}
-		Vector<uint8_t> variant_bytes;
-		variant_bytes.resize(variant_size);
+		if (variant_size == 0) {
+			return false; // Disabled when the cache was saved.
+		}
 
-		uint32_t br = f->get_buffer(variant_bytes.ptrw(), variant_size);
+		if (data_type == CACHE_FILE_DATA_BYTECODE) {
+			Vector<uint8_t> &variant_bytes = p_version->variant_data[variant_id];
+			variant_bytes.resize(variant_size);
+			ERR_FAIL_COND_V(f->get_buffer(variant_bytes.ptrw(), variant_size) != variant_size, false);
+			continue;
+		}
 
-		ERR_FAIL_COND_V(br != variant_size, false);
+		ShaderStageCacheRD::Key key;
+		ERR_FAIL_COND_V(variant_size != sizeof(key.hash), false);
+		ERR_FAIL_COND_V(f->get_buffer(key.hash, variant_size) != variant_size, false);
 
-		p_version->variant_data[variant_id] = variant_bytes;
+		if (!stage_cache.get(key, p_version->variant_data[variant_id])) {
+			return false; // Bytecode missing from the stage cache, compile again.
+		}
 	}
 
 	for (uint32_t i = 0; i < variant_count; i++) {
@@ -468,8 +539,7 @@ bool ShaderRD::_load_from_cache(Version *p_version, int p_group) {
 		}
 	}
 
-	memdelete_arr(p_version->variant_data); //clear stages
-	p_version->variant_data = nullptr;
+	_clear_variant_data(p_version); //clear stages
 	p_version->valid = true;
 	return true;
 }
@@ -483,10 +553,22 @@ void ShaderRD::_save_to_cache(Version *p_version, int p_group) {
 	f->store_32(cache_file_version); // File version.
 	uint32_t variant_count = group_to_variant_map[p_group].size();
 	f->store_32(variant_count); // Variant count.
+
+	// The stage cache only holds the bytecode if this process writes to it, otherwise it's saved here.
+	const bool save_stage_keys = stage_cache.is_open() && !stage_cache.is_read_only();
+	f->store_32(save_stage_keys ? CACHE_FILE_DATA_STAGE_KEYS : CACHE_FILE_DATA_BYTECODE);
 	for (uint32_t i = 0; i < variant_count; i++) {
 		int variant_id = group_to_variant_map[p_group][i];
-		f->store_32(p_version->variant_data[variant_id].size()); // Stage count.
-		f->store_buffer(p_version->variant_data[variant_id].ptr(), p_version->variant_data[variant_id].size());
+		if (!variants_enabled[variant_id]) {
+			f->store_32(0); // Disabled, nothing to save.
+		} else if (save_stage_keys) {
+			const ShaderStageCacheRD::Key &key = p_version->variant_stage_keys[variant_id];
+			f->store_32(sizeof(key.hash)); // Key size.
+			f->store_buffer(key.hash, sizeof(key.hash));
+		} else {
+			f->store_32(p_version->variant_data[variant_id].size()); // Stage size.
+			f->store_buffer(p_version->variant_data[variant_id].ptr(), p_version->variant_data[variant_id].size());
+		}
 	}
 }
 
@@ -511,6 +593,7 @@ void ShaderRD::_compile_version(Version *p_version, int p_group) {
 
 	typedef Vector<uint8_t> ShaderStageData;
 	p_version->variant_data = memnew_arr(ShaderStageData, variant_defines.size());
+	p_version->variant_stage_keys = memnew_arr(ShaderStageCacheRD::Key, variant_defines.size());
 
 	p_version->dirty = false;
 
@@ -558,19 +641,15 @@ void ShaderRD::_compile_version(Version *p_version, int p_group) {
 			}
 		}
 		memdelete_arr(p_version->variants);
-		if (p_version->variant_data) {
-			memdelete_arr(p_version->variant_data);
-		}
+		_clear_variant_data(p_version);
 		p_version->variants = nullptr;
-		p_version->variant_data = nullptr;
 		return;
 	} else if (shader_cache_dir_valid) {
 		// Save shader cache.
 		_save_to_cache(p_version, p_group);
 	}
 
-	memdelete_arr(p_version->variant_data); //clear stages
-	p_version->variant_data = nullptr;
+	_clear_variant_data(p_version); //clear stages
 
 	p_version->valid = true;
 }
@@ -826,6 +905,19 @@ void ShaderRD::initialize(const Vector<VariantDefine> &p_variant_defines, const
 
 void ShaderRD::set_shader_cache_dir(const String &p_dir) {
 	shader_cache_dir = p_dir;
+
+	if (p_dir.is_empty()) {
+		stage_cache.close();
+		return;
+	}
+
+	stage_key_prefix = "[api:" + RD::get_singleton()->get_device_api_name() + ":" + RD::get_singleton()->get_device_api_version() + "]";
+	Error err = stage_cache.open(p_dir, shader_cache_save_compressed, shader_cache_save_compressed_zstd ? Compression::MODE_ZSTD : Compression::MODE_DEFLATE);
+	if (err == ERR_BUSY) {
+		print_verbose("Shader stage cache is being created by another process, compiled shaders will not be reused between runs: " + p_dir);
+	} else if (err != OK) {
+		ERR_PRINT("Can't open shader stage cache, compiled shaders will not be reused between runs: " + p_dir);
+	}
 }
 
 void ShaderRD::set_shader_cache_save_compressed(bool p_enable) {
@@ -844,6 +936,8 @@ String ShaderRD::shader_cache_dir;
 bool ShaderRD::shader_cache_save_compressed = true;
 bool ShaderRD::shader_cache_save_compressed_zstd = true;
 bool ShaderRD::shader_cache_save_debug = true;
+ShaderStageCacheRD ShaderRD::stage_cache;
+String ShaderRD::stage_key_prefix;
 
 ShaderRD::~ShaderRD() {
 	List<RID> remaining;
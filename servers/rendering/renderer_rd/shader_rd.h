@@ -38,6 +38,8 @@
 #include "core/templates/rb_map.h"
 #include "core/templates/rid_owner.h"
 #include "core/variant/variant.h"
+#include "servers/rendering/renderer_rd/shader_stage_cache_rd.h"
+#include "servers/rendering/rendering_device.h"
 #include "servers/rendering_server.h"
 
 class ShaderRD {
@@ -71,6 +73,7 @@ private:
 		Vector<CharString> custom_defines;
 
 		Vector<uint8_t> *variant_data = nullptr;
+		ShaderStageCacheRD::Key *variant_stage_keys = nullptr; // Written to the version cache instead of the bytecode when the stage cache stores it.
 		RID *variants = nullptr; // Same size as variant defines.
 
 		bool valid;
@@ -90,6 +93,7 @@ private:
 	void _initialize_version(Version *p_version);
 	void _clear_version(Version *p_version);
 	void _compile_version(Version *p_version, int p_group);
+	void _clear_variant_data(Version *p_version);
 	void _allocate_placeholders(Version *p_version, int p_group);
 
 	RID_Owner<Version> version_owner;
@@ -129,6 +133,10 @@ private:
 	static bool shader_cache_save_debug;
 	bool shader_cache_dir_valid = false;
 
+	// Compiled stages and bytecode are deduplicated across all shaders and materials.
+	static ShaderStageCacheRD stage_cache;
+	static String stage_key_prefix;
+
 	enum StageType {
 		STAGE_TYPE_VERTEX,
 		STAGE_TYPE_FRAGMENT,
@@ -141,6 +149,7 @@ private:
 	void _build_variant_code(StringBuilder &p_builder, uint32_t p_variant, const Version *p_version, const StageTemplate &p_template);
 
 	void _add_stage(const char *p_code, StageType p_stage_type);
+	Vector<uint8_t> _compile_stage(RD::ShaderStage p_stage, const String &p_source, String *r_error, String &r_key_text);
 
 	String _version_get_sha1(Version *p_version) const;
 	String _get_cache_file_path(Version *p_version, int p_group);
@@ -0,0 +1,438 @@
+/**************************************************************************/
+/*  shader_stage_cache_rd.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "shader_stage_cache_rd.h"
+
+#include "core/crypto/crypto_core.h"
+#include "core/io/dir_access.h"
+#include "core/io/marshalls.h"
+#include "core/os/os.h"
+
+static const char *index_file_header = "GDSI";
+static const char *pack_file_header = "GDSP";
+static const uint32_t stage_cache_version = 2;
+static const uint32_t pack_header_size = 8;
+// A lock folder without a process id is only left behind if its process died right after creating it.
+static const uint64_t lock_without_pid_timeout_sec = 10;
+
+ShaderStageCacheRD::Key ShaderStageCacheRD::make_key(const uint8_t *p_data, int p_size) {
+	Key key;
+	CryptoCore::sha256(p_data, p_size, key.hash);
+	return key;
+}
+
+ShaderStageCacheRD::Key ShaderStageCacheRD::make_key(const CharString &p_text) {
+	return make_key((const uint8_t *)p_text.get_data(), p_text.length());
+}
+
+void ShaderStageCacheRD::_decode_entry(const uint8_t *p_data, Entry &r_entry) {
+	r_entry.offset = decode_uint64(p_data + 32);
+	r_entry.stored_size = decode_uint32(p_data + 40);
+	r_entry.size = decode_uint32(p_data + 44);
+	r_entry.checksum = decode_uint32(p_data + 48);
+	r_entry.compression = decode_uint32(p_data + 52);
+}
+
+void ShaderStageCacheRD::_encode_entry(const Entry &p_entry, uint8_t *r_data) {
+	encode_uint64(p_entry.offset, r_data + 32);
+	encode_uint32(p_entry.stored_size, r_data + 40);
+	encode_uint32(p_entry.size, r_data + 44);
+	encode_uint32(p_entry.checksum, r_data + 48);
+	encode_uint32(p_entry.compression, r_data + 52);
+}
+
+bool ShaderStageCacheRD::_lock() {
+	// Creating a folder is atomic and fails if it already exists, unlike creating a file with FileAccess.
+	for (int attempt = 0; attempt < 2; attempt++) {
+		Error err = DirAccess::make_dir_absolute(lock_path);
+		if (err == OK) {
+			Ref<FileAccess> f = FileAccess::open(lock_path.path_join("pid"), FileAccess::WRITE);
+			if (f.is_valid()) {
+				f->store_64(OS::get_singleton()->get_process_id());
+			}
+			return true;
+		}
+		if (err != ERR_ALREADY_EXISTS || !_is_lock_stale()) {
+			return false;
+		}
+		// Left behind by a process that didn't close the cache.
+		_unlock();
+	}
+	return false;
+}
+
+void ShaderStageCacheRD::_unlock() {
+	DirAccess::remove_absolute(lock_path.path_join("pid"));
+	DirAccess::remove_absolute(lock_path);
+}
+
+bool ShaderStageCacheRD::_is_lock_stale() const {
+	const String pid_path = lock_path.path_join("pid");
+	Ref<FileAccess> f = FileAccess::open(pid_path, FileAccess::READ);
+	if (f.is_null() || f->get_length() < 8) {
+		return OS::get_singleton()->get_unix_time() - FileAccess::get_modified_time(lock_path) > lock_without_pid_timeout_sec;
+	}
+	const OS::ProcessID pid = f->get_64();
+	// Another cache of this process, e.g. in tests.
+	if (pid == OS::get_singleton()->get_process_id()) {
+		return false;
+	}
+	return !OS::get_singleton()->is_process_running(pid);
+}
+
+bool ShaderStageCacheRD::_find(const Key &p_key, Entry &r_entry) const {
+	HashMap<Key, Entry, KeyHasher>::ConstIterator E = added.find(p_key);
+	if (E) {
+		r_entry = E->value;
+		return true;
+	}
+
+	const uint8_t *entries = index.ptr() + INDEX_HEADER_SIZE;
+	uint32_t low = 0;
+	uint32_t high = index_count;
+	while (low < high) {
+		uint32_t middle = (low + high) / 2;
+		const uint8_t *entry = entries + middle * INDEX_ENTRY_SIZE;
+		int cmp = memcmp(entry, p_key.hash, sizeof(p_key.hash));
+		if (cmp == 0) {
+			_decode_entry(entry, r_entry);
+			return true;
+		} else if (cmp < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return false;
+}
+
+bool ShaderStageCacheRD::_read_blob(const Entry &p_entry, Vector<uint8_t> &r_stored) const {
+	if (p_entry.offset < pack_header_size || p_entry.offset + p_entry.stored_size > pack_size) {
+		return false;
+	}
+
+	r_stored.resize(p_entry.stored_size);
+	pack->seek(p_entry.offset);
+	if (pack->get_buffer(r_stored.ptrw(), p_entry.stored_size) != p_entry.stored_size) {
+		return false;
+	}
+	// The pack may have been rewritten by another process since the index was read.
+	return hash_murmur3_buffer(r_stored.ptr(), r_stored.size()) == p_entry.checksum;
+}
+
+void ShaderStageCacheRD::_save_index() {
+	// Merge the blobs added this run into the sorted entries.
+	LocalVector<Key> new_keys;
+	new_keys.reserve(added.size());
+	for (const KeyValue<Key, Entry> &E : added) {
+		new_keys.push_back(E.key);
+	}
+	new_keys.sort();
+
+	uint32_t count = index_count + new_keys.size();
+	Vector<uint8_t> new_index;
+	new_index.resize(INDEX_HEADER_SIZE + count * INDEX_ENTRY_SIZE);
+	uint8_t *w = new_index.ptrw();
+	memcpy(w, index_file_header, 4);
+	encode_uint32(stage_cache_version, w + 4);
+	encode_uint64(pack_size, w + 8);
+	encode_uint32(count, w + 16);
+	w += INDEX_HEADER_SIZE;
+
+	const uint8_t *old_entry = index.ptr() + INDEX_HEADER_SIZE;
+	const uint8_t *old_end = old_entry + index_count * INDEX_ENTRY_SIZE;
+	uint32_t new_pos = 0;
+	while (old_entry < old_end || new_pos < new_keys.size()) {
+		if (new_pos == new_keys.size() || (old_entry < old_end && memcmp(old_entry, new_keys[new_pos].hash, 32) < 0)) {
+			memcpy(w, old_entry, INDEX_ENTRY_SIZE);
+			old_entry += INDEX_ENTRY_SIZE;
+		} else {
+			const Key &key = new_keys[new_pos++];
+			memcpy(w, key.hash, 32);
+			_encode_entry(added[key], w);
+		}
+		w += INDEX_ENTRY_SIZE;
+	}
+
+	// Written next to the index and moved over it, so other processes never read a partial index.
+	const String temp_path = index_path + ".tmp";
+	{
+		Ref<FileAccess> f = FileAccess::open(temp_path, FileAccess::WRITE);
+		ERR_FAIL_COND_MSG(f.is_null(), "Can't save shader stage cache index: " + index_path);
+		f->store_buffer(new_index.ptr(), new_index.size());
+	}
+	if (DirAccess::rename_absolute(temp_path, index_path) != OK) {
+		DirAccess::remove_absolute(index_path);
+		ERR_FAIL_COND_MSG(DirAccess::rename_absolute(temp_path, index_path) != OK, "Can't save shader stage cache index: " + index_path);
+	}
+
+	index = new_index;
+	index_count = count;
+	added.clear();
+}
+
+void ShaderStageCacheRD::_compact(const String &p_pack_path) {
+	// Copies the indexed blobs to a new pack, dropping the ones that fail their checksum.
+	const String temp_pack_path = p_pack_path + ".tmp";
+	Ref<FileAccess> new_pack = FileAccess::open(temp_pack_path, FileAccess::WRITE_READ);
+	ERR_FAIL_COND_MSG(new_pack.is_null(), "Can't compact shader stage cache: " + p_pack_path);
+	new_pack->store_buffer((const uint8_t *)pack_file_header, 4);
+	new_pack->store_32(stage_cache_version);
+	uint64_t new_pack_size = pack_header_size;
+
+	Vector<uint8_t> new_index;
+	new_index.resize(index.size());
+	uint8_t *w = new_index.ptrw() + INDEX_HEADER_SIZE;
+	uint32_t new_count = 0;
+	Vector<uint8_t> stored;
+	for (uint32_t i = 0; i < index_count; i++) {
+		const uint8_t *entry_data = index.ptr() + INDEX_HEADER_SIZE + i * INDEX_ENTRY_SIZE;
+		Entry entry;
+		_decode_entry(entry_data, entry);
+		if (!_read_blob(entry, stored)) {
+			continue;
+		}
+		new_pack->store_buffer(stored.ptr(), stored.size());
+		entry.offset = new_pack_size;
+		new_pack_size += entry.stored_size;
+		memcpy(w, entry_data, 32);
+		_encode_entry(entry, w);
+		w += INDEX_ENTRY_SIZE;
+		new_count++;
+	}
+	new_pack.unref();
+	pack.unref();
+
+	if (DirAccess::rename_absolute(temp_pack_path, p_pack_path) != OK) {
+		DirAccess::remove_absolute(p_pack_path);
+		DirAccess::rename_absolute(temp_pack_path, p_pack_path);
+	}
+	pack = FileAccess::open(p_pack_path, FileAccess::READ_WRITE);
+	ERR_FAIL_COND_MSG(pack.is_null(), "Can't open compacted shader stage cache: " + p_pack_path);
+
+	// The index is saved with the new offsets right away, the old ones point into the old pack.
+	new_index.resize(INDEX_HEADER_SIZE + new_count * INDEX_ENTRY_SIZE);
+	index = new_index;
+	index_count = new_count;
+	pack_size = new_pack_size;
+	added.clear();
+	_save_index();
+}
+
+Error ShaderStageCacheRD::open(const String &p_dir, bool p_compress, Compression::Mode p_compression_mode) {
+	close();
+
+	MutexLock lock(mutex);
+	compress = p_compress;
+	compression_mode = p_compression_mode;
+	index_path = p_dir.path_join("stages.index");
+	lock_path = p_dir.path_join("stages.lock");
+	String pack_path = p_dir.path_join("stages.pack");
+	read_only = !_lock();
+
+	if (FileAccess::exists(pack_path)) {
+		pack = FileAccess::open(pack_path, read_only ? FileAccess::READ : FileAccess::READ_WRITE);
+	}
+	bool valid = pack.is_valid() && pack->get_length() >= pack_header_size;
+	if (valid) {
+		char header[5] = { 0, 0, 0, 0, 0 };
+		pack->get_buffer((uint8_t *)header, 4);
+		valid = String(header) == pack_file_header && pack->get_32() == stage_cache_version;
+	}
+	uint64_t referenced_size = pack_header_size;
+	if (valid) {
+		pack_size = pack->get_length();
+		if (FileAccess::exists(index_path)) {
+			index = FileAccess::get_file_as_bytes(index_path);
+		}
+		if (index.size() >= (int)INDEX_HEADER_SIZE && memcmp(index.ptr(), index_file_header, 4) == 0 && decode_uint32(index.ptr() + 4) == stage_cache_version) {
+			index_count = decode_uint32(index.ptr() + 16);
+			// The pack may have grown after the index was saved, but never shrunk.
+			if (uint64_t(index.size()) != INDEX_HEADER_SIZE + uint64_t(index_count) * INDEX_ENTRY_SIZE || decode_uint64(index.ptr() + 8) > pack_size) {
+				valid = false;
+			}
+		} else {
+			valid = false;
+		}
+	}
+	if (valid) {
+		for (uint32_t i = 0; i < index_count; i++) {
+			referenced_size += decode_uint32(index.ptr() + INDEX_HEADER_SIZE + i * INDEX_ENTRY_SIZE + 40);
+		}
+	}
+
+	if (read_only) {
+		if (!valid) {
+			// Only the process holding the lock may create the pack.
+			pack.unref();
+			index.clear();
+			index_count = 0;
+			return ERR_BUSY;
+		}
+		return OK;
+	}
+
+	if (valid && pack_size > MAX_PACK_SIZE) {
+		print_verbose("Shader stage cache is over its maximum size, clearing it: " + pack_path);
+		valid = false;
+	}
+
+	if (!valid) {
+		// Start over, blobs that are not in the index can't be found anyway.
+		index.clear();
+		index_count = 0;
+		pack = FileAccess::open(pack_path, FileAccess::WRITE_READ);
+		if (pack.is_null()) {
+			_unlock();
+			ERR_FAIL_V_MSG(ERR_CANT_CREATE, "Can't create shader stage cache: " + pack_path);
+		}
+		pack->store_buffer((const uint8_t *)pack_file_header, 4);
+		pack->store_32(stage_cache_version);
+		pack_size = pack_header_size;
+		DirAccess::remove_absolute(index_path);
+	} else if (pack_size - referenced_size > pack_size / 4) {
+		// Blobs stored by a process that didn't save its index (e.g. it crashed) are never found again.
+		_compact(pack_path);
+		if (pack.is_null()) {
+			_unlock();
+			index.clear();
+			index_count = 0;
+			return ERR_CANT_CREATE;
+		}
+	}
+
+	if (index.is_empty()) {
+		index.resize(INDEX_HEADER_SIZE);
+	}
+	return OK;
+}
+
+void ShaderStageCacheRD::close() {
+	MutexLock lock(mutex);
+	if (pack.is_null()) {
+		return;
+	}
+	if (!added.is_empty()) {
+		pack->flush();
+		_save_index();
+	}
+	pack.unref();
+	index.clear();
+	index_count = 0;
+	added.clear();
+	if (!read_only) {
+		_unlock();
+	}
+	read_only = false;
+}
+
+bool ShaderStageCacheRD::is_open() const {
+	MutexLock lock(mutex);
+	return pack.is_valid();
+}
+
+bool ShaderStageCacheRD::is_read_only() const {
+	MutexLock lock(mutex);
+	return read_only;
+}
+
+bool ShaderStageCacheRD::get(const Key &p_key, Vector<uint8_t> &r_data) {
+	MutexLock lock(mutex);
+	Entry entry;
+	if (pack.is_null() || !_find(p_key, entry)) {
+		return false;
+	}
+
+	Vector<uint8_t> stored;
+	if (!_read_blob(entry, stored)) {
+		print_verbose("Shader stage cache blob failed its checksum, it will be compiled again.");
+		return false;
+	}
+
+	if (entry.compression == NOT_COMPRESSED) {
+		ERR_FAIL_COND_V(entry.stored_size != entry.size, false);
+		r_data = stored;
+	} else {
+		ERR_FAIL_COND_V(entry.compression > Compression::MODE_BROTLI, false);
+		r_data.resize(entry.size);
+		int size = Compression::decompress(r_data.ptrw(), entry.size, stored.ptr(), entry.stored_size, Compression::Mode(entry.compression));
+		if (size != (int)entry.size) {
+			r_data.clear();
+			ERR_FAIL_V(false);
+		}
+	}
+	return true;
+}
+
+void ShaderStageCacheRD::store(const Key &p_key, const Vector<uint8_t> &p_data) {
+	MutexLock lock(mutex);
+	Entry entry;
+	if (pack.is_null() || read_only || _find(p_key, entry)) {
+		return; // Already stored, which is the point of deduplicating.
+	}
+
+	const uint8_t *stored = p_data.ptr();
+	entry.size = p_data.size();
+	entry.stored_size = entry.size;
+
+	Vector<uint8_t> compressed;
+	if (compress) {
+		compressed.resize(Compression::get_max_compressed_buffer_size(p_data.size(), compression_mode));
+		int compressed_size = Compression::compress(compressed.ptrw(), p_data.ptr(), p_data.size(), compression_mode);
+		// Only keep it if it's actually smaller.
+		if (compressed_size > 0 && uint32_t(compressed_size) < entry.size) {
+			stored = compressed.ptr();
+			entry.stored_size = compressed_size;
+			entry.compression = compression_mode;
+		}
+	}
+	entry.checksum = hash_murmur3_buffer(stored, entry.stored_size);
+
+	entry.offset = pack_size;
+	pack->seek(pack_size);
+	pack->store_buffer(stored, entry.stored_size);
+	pack_size += entry.stored_size;
+	added.insert(p_key, entry);
+}
+
+bool ShaderStageCacheRD::has(const Key &p_key) const {
+	MutexLock lock(mutex);
+	Entry entry;
+	return pack.is_valid() && _find(p_key, entry);
+}
+
+uint32_t ShaderStageCacheRD::get_entry_count() const {
+	MutexLock lock(mutex);
+	return index_count + added.size();
+}
+
+ShaderStageCacheRD::~ShaderStageCacheRD() {
+	close();
+}
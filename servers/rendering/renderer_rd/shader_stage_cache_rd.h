@@ -0,0 +1,123 @@
+/**************************************************************************/
+/*  shader_stage_cache_rd.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SHADER_STAGE_CACHE_RD_H
+#define SHADER_STAGE_CACHE_RD_H
+
+#include "core/io/compression.h"
+#include "core/io/file_access.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+
+// Content addressed storage for compiled shader stages, shared by all ShaderRD instances.
+// Blobs are appended to a single pack file and looked up through one index file, which is
+// read in a single call and binary searched in place, so opening the cache costs the same
+// no matter how many shaders and materials use it. Identical blobs are only stored once.
+//
+// Several processes may use the same cache folder (e.g. the editor and the running project).
+// Only the process holding the lock folder writes to the pack, the others read it as it was
+// when they opened it. Each blob is checksummed, so a blob that was overwritten or truncated
+// is compiled again instead of being handed to the driver.
+class ShaderStageCacheRD {
+public:
+	struct Key {
+		uint8_t hash[32] = {};
+
+		bool operator==(const Key &p_key) const { return memcmp(hash, p_key.hash, sizeof(hash)) == 0; }
+		bool operator<(const Key &p_key) const { return memcmp(hash, p_key.hash, sizeof(hash)) < 0; }
+	};
+
+	struct KeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const Key &p_key) { return hash_murmur3_buffer(p_key.hash, sizeof(p_key.hash)); }
+	};
+
+	static Key make_key(const uint8_t *p_data, int p_size);
+	static Key make_key(const CharString &p_text);
+
+	// Past this size, the cache is cleared when it is opened, as it only ever grows otherwise.
+	static const uint64_t MAX_PACK_SIZE = 512 * 1024 * 1024;
+
+private:
+	static const uint32_t NOT_COMPRESSED = 0xFFFFFFFF;
+
+	struct Entry {
+		uint64_t offset = 0;
+		uint32_t stored_size = 0;
+		uint32_t size = 0;
+		uint32_t checksum = 0; // Of the stored bytes.
+		uint32_t compression = NOT_COMPRESSED; // Compression::Mode of the stored bytes.
+	};
+
+	// Index file layout: header, then INDEX_ENTRY_SIZE bytes per entry sorted by key
+	// (hash, offset, stored size, size, checksum, compression).
+	static const uint32_t INDEX_HEADER_SIZE = 20;
+	static const uint32_t INDEX_ENTRY_SIZE = 56;
+
+	mutable Mutex mutex;
+	String index_path;
+	String lock_path;
+	Vector<uint8_t> index;
+	uint32_t index_count = 0;
+	HashMap<Key, Entry, KeyHasher> added;
+	Ref<FileAccess> pack;
+	uint64_t pack_size = 0;
+	bool compress = false;
+	Compression::Mode compression_mode = Compression::MODE_ZSTD;
+	bool read_only = false;
+
+	static void _decode_entry(const uint8_t *p_data, Entry &r_entry);
+	static void _encode_entry(const Entry &p_entry, uint8_t *r_data);
+
+	bool _lock();
+	void _unlock();
+	bool _is_lock_stale() const;
+
+	bool _find(const Key &p_key, Entry &r_entry) const;
+	bool _read_blob(const Entry &p_entry, Vector<uint8_t> &r_stored) const;
+	void _save_index();
+	void _compact(const String &p_pack_path);
+
+public:
+	// Blobs are compressed with the given mode if `p_compress` is set and it makes them smaller.
+	Error open(const String &p_dir, bool p_compress, Compression::Mode p_compression_mode = Compression::MODE_ZSTD);
+	void close();
+	bool is_open() const;
+	// Another process holds the lock, blobs can be read but are not stored.
+	bool is_read_only() const;
+
+	bool get(const Key &p_key, Vector<uint8_t> &r_data);
+	void store(const Key &p_key, const Vector<uint8_t> &p_data);
+	bool has(const Key &p_key) const;
+	uint32_t get_entry_count() const;
+
+	~ShaderStageCacheRD();
+};
+
+#endif // SHADER_STAGE_CACHE_RD_H
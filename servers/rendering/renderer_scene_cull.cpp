@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "rendering_cpu_profiler.h"
 #include "rendering_light_culler.h"
 #include "rendering_server_constants.h"
 #include "rendering_server_default.h"
@@ -3235,6 +3236,8 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 	Vector<RID> directional_lights;
 	// directional lights
 	{
+		RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_LIGHT_AND_SHADOW_SETUP);
+
 		cull.shadow_count = 0;
 
 		Vector<Instance *> lights_with_shadow;
@@ -3262,6 +3265,7 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 		}
 
 		RSG::light_storage->set_directional_shadow_count(lights_with_shadow.size());
+		RENDER_CPU_PROFILE_ELEMENTS(directional_lights.size());
 
 		for (int i = 0; i < lights_with_shadow.size(); i++) {
 			_light_instance_setup_directional_shadow(i, lights_with_shadow[i], p_camera_data->main_transform, p_camera_data->main_projection, p_camera_data->is_orthogonal, p_camera_data->vaspect);
@@ -3296,6 +3300,8 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 	scene_cull_result.clear();
 
 	{
+		RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_SCENE_CULL);
+
 		uint64_t cull_from = 0;
 		uint64_t cull_to = scenario->instance_data.size();
 
@@ -3348,6 +3354,8 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 			}
 			RSG::mesh_storage->update_mesh_instances();
 		}
+
+		RENDER_CPU_PROFILE_ELEMENTS(scene_cull_result.geometry_instances.size());
 	}
 
 	//render shadows
@@ -3355,6 +3363,8 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 	max_shadows_used = 0;
 
 	if (p_using_shadows) { //setup shadow maps
+		RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_LIGHT_AND_SHADOW_SETUP);
+		RENDER_CPU_PROFILE_ELEMENTS(scene_cull_result.lights.size());
 
 		// Directional Shadows
 
@@ -3560,7 +3570,11 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 	}
 
 	RENDER_TIMESTAMP("Render 3D Scene");
-	scene_render->render_scene(p_render_buffers, p_camera_data, prev_camera_data, scene_cull_result.geometry_instances, scene_cull_result.light_instances, scene_cull_result.reflections, scene_cull_result.voxel_gi_instances, scene_cull_result.decals, scene_cull_result.lightmaps, scene_cull_result.fog_volumes, p_environment, camera_attributes, p_compositor, p_shadow_atlas, occluders_tex, p_reflection_probe.is_valid() ? RID() : scenario->reflection_atlas, p_reflection_probe, p_reflection_probe_pass, p_screen_mesh_lod_threshold, render_shadow_data, max_shadows_used, render_sdfgi_data, cull.sdfgi.region_count, &sdfgi_update_data, r_render_info);
+	{
+		RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_COMMAND_RECORDING);
+		RENDER_CPU_PROFILE_ELEMENTS(scene_cull_result.geometry_instances.size());
+		scene_render->render_scene(p_render_buffers, p_camera_data, prev_camera_data, scene_cull_result.geometry_instances, scene_cull_result.light_instances, scene_cull_result.reflections, scene_cull_result.voxel_gi_instances, scene_cull_result.decals, scene_cull_result.lightmaps, scene_cull_result.fog_volumes, p_environment, camera_attributes, p_compositor, p_shadow_atlas, occluders_tex, p_reflection_probe.is_valid() ? RID() : scenario->reflection_atlas, p_reflection_probe, p_reflection_probe_pass, p_screen_mesh_lod_threshold, render_shadow_data, max_shadows_used, render_sdfgi_data, cull.sdfgi.region_count, &sdfgi_update_data, r_render_info);
+	}
 
 	if (p_viewport.is_valid()) {
 		RSG::viewport->viewport_set_prev_camera_data(p_viewport, p_camera_data);
@@ -0,0 +1,281 @@
+/**************************************************************************/
+/*  rendering_cpu_profiler.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "rendering_cpu_profiler.h"
+
+#include "core/io/json.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+
+RenderingCPUProfiler *RenderingCPUProfiler::singleton = nullptr;
+thread_local RenderingCPUProfiler::Scope *RenderingCPUProfiler::current_scope = nullptr;
+
+RenderingCPUProfiler::Scope::Scope(RS::CPUProfileStage p_stage) {
+	RenderingCPUProfiler *profiler = RenderingCPUProfiler::singleton;
+	if (likely(!profiler || !profiler->is_enabled())) {
+		return;
+	}
+
+	stage = p_stage;
+	active = true;
+	parent = current_scope;
+	current_scope = this;
+	begin_usec = OS::get_singleton()->get_ticks_usec();
+}
+
+RenderingCPUProfiler::Scope::~Scope() {
+	if (likely(!active)) {
+		return;
+	}
+
+	uint64_t end_usec = OS::get_singleton()->get_ticks_usec();
+	uint64_t usec = end_usec - begin_usec;
+
+	current_scope = parent;
+	if (parent) {
+		parent->child_usec += usec;
+	}
+
+	RenderingCPUProfiler *profiler = RenderingCPUProfiler::singleton;
+	if (profiler) {
+		MutexLock lock(profiler->mutex);
+		profiler->_record(stage, begin_usec, end_usec, usec > child_usec ? usec - child_usec : 0, elements);
+	}
+}
+
+void RenderingCPUProfiler::_record(RS::CPUProfileStage p_stage, uint64_t p_begin_usec, uint64_t p_end_usec, uint64_t p_self_usec, uint64_t p_elements, bool p_count_call) {
+	// Must be called with the mutex locked.
+	ERR_FAIL_INDEX(p_stage, RS::CPU_PROFILE_STAGE_MAX);
+
+	StageData &data = stages[p_stage];
+	data.usec += p_end_usec - p_begin_usec;
+	data.self_usec += p_self_usec;
+	data.elements += p_elements;
+	if (p_count_call) {
+		data.calls++;
+	}
+
+	if (events.size() < MAX_EVENTS_PER_FRAME) {
+		Event event;
+		event.stage = p_stage;
+		event.begin_usec = p_begin_usec;
+		event.end_usec = p_end_usec;
+		event.elements = p_elements;
+		event.thread_id = Thread::get_caller_id();
+		events.push_back(event);
+	}
+}
+
+void RenderingCPUProfiler::_reset_current() {
+	for (int i = 0; i < RS::CPU_PROFILE_STAGE_MAX; i++) {
+		stages[i] = StageData();
+	}
+	events.clear();
+}
+
+String RenderingCPUProfiler::get_stage_name(RS::CPUProfileStage p_stage) {
+	switch (p_stage) {
+		case RS::CPU_PROFILE_STAGE_COMMAND_QUEUE_FLUSH:
+			return "Command Queue Flush";
+		case RS::CPU_PROFILE_STAGE_CANVAS_CULL:
+			return "Canvas Cull";
+		case RS::CPU_PROFILE_STAGE_SCENE_CULL:
+			return "Scene Cull";
+		case RS::CPU_PROFILE_STAGE_LIGHT_AND_SHADOW_SETUP:
+			return "Light and Shadow Setup";
+		case RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT:
+			return "Render List Sort";
+		case RS::CPU_PROFILE_STAGE_COMMAND_RECORDING:
+			return "Command Recording";
+		default:
+			break;
+	}
+	return String();
+}
+
+void RenderingCPUProfiler::set_enabled(bool p_enabled) {
+	MutexLock lock(mutex);
+	if (p_enabled == enabled.is_set()) {
+		return;
+	}
+	enabled.set_to(p_enabled);
+	in_frame = false;
+	in_command_queue_flush = false;
+	_reset_current();
+}
+
+void RenderingCPUProfiler::begin_frame() {
+	if (!is_enabled()) {
+		return;
+	}
+
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+
+	MutexLock lock(mutex);
+	if (in_command_queue_flush && command_queue_flush_from != 0) {
+		// Drawing happens inside the flush when using a separate render thread; pause it.
+		_record(RS::CPU_PROFILE_STAGE_COMMAND_QUEUE_FLUSH, command_queue_flush_from, now, now - command_queue_flush_from, 0, false);
+		command_queue_flush_from = 0;
+	}
+	frame_begin_usec = now;
+	in_frame = true;
+}
+
+void RenderingCPUProfiler::end_frame(uint64_t p_frame) {
+	if (!is_enabled()) {
+		return;
+	}
+
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+
+	MutexLock lock(mutex);
+	if (!in_frame) {
+		return;
+	}
+	in_frame = false;
+
+	last_frame = p_frame;
+	last_frame_begin_usec = frame_begin_usec;
+	last_frame_usec = now - frame_begin_usec;
+	for (int i = 0; i < RS::CPU_PROFILE_STAGE_MAX; i++) {
+		last_stages[i] = stages[i];
+	}
+	SWAP(last_events, events);
+	_reset_current();
+
+	if (in_command_queue_flush) {
+		command_queue_flush_from = now;
+	}
+}
+
+void RenderingCPUProfiler::command_queue_flush_begin() {
+	if (!is_enabled()) {
+		return;
+	}
+
+	MutexLock lock(mutex);
+	in_command_queue_flush = true;
+	command_queue_flush_from = OS::get_singleton()->get_ticks_usec();
+}
+
+void RenderingCPUProfiler::command_queue_flush_end() {
+	if (!is_enabled()) {
+		return;
+	}
+
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+
+	MutexLock lock(mutex);
+	if (!in_command_queue_flush) {
+		return;
+	}
+	in_command_queue_flush = false;
+
+	uint64_t from = command_queue_flush_from;
+	command_queue_flush_from = 0;
+	if (from == 0 || now == from) {
+		// Nothing measurable was flushed, don't clutter the trace.
+		return;
+	}
+	_record(RS::CPU_PROFILE_STAGE_COMMAND_QUEUE_FLUSH, from, now, now - from, 0);
+}
+
+Dictionary RenderingCPUProfiler::get_frame_profile() const {
+	MutexLock lock(mutex);
+
+	Dictionary profile;
+	profile["frame"] = last_frame;
+	profile["frame_usec"] = last_frame_usec;
+
+	Array stage_array;
+	for (int i = 0; i < RS::CPU_PROFILE_STAGE_MAX; i++) {
+		Dictionary stage;
+		stage["stage"] = i;
+		stage["name"] = get_stage_name(RS::CPUProfileStage(i));
+		stage["usec"] = last_stages[i].usec;
+		stage["self_usec"] = last_stages[i].self_usec;
+		stage["calls"] = last_stages[i].calls;
+		stage["elements"] = last_stages[i].elements;
+		stage_array.push_back(stage);
+	}
+	profile["stages"] = stage_array;
+
+	return profile;
+}
+
+String RenderingCPUProfiler::get_frame_profile_chrome_trace() const {
+	MutexLock lock(mutex);
+
+	// See the "Trace Event Format" specification; "X" are complete events with a duration.
+	Array trace_events;
+
+	Dictionary frame_event;
+	frame_event["name"] = vformat("Frame %d", last_frame);
+	frame_event["cat"] = "rendering";
+	frame_event["ph"] = "X";
+	frame_event["ts"] = last_frame_begin_usec;
+	frame_event["dur"] = last_frame_usec;
+	frame_event["pid"] = OS::get_singleton()->get_process_id();
+	frame_event["tid"] = Thread::get_main_id();
+	trace_events.push_back(frame_event);
+
+	for (const Event &E : last_events) {
+		Dictionary event;
+		event["name"] = get_stage_name(E.stage);
+		event["cat"] = "rendering";
+		event["ph"] = "X";
+		event["ts"] = E.begin_usec;
+		event["dur"] = E.end_usec - E.begin_usec;
+		event["pid"] = OS::get_singleton()->get_process_id();
+		event["tid"] = E.thread_id;
+		Dictionary args;
+		args["elements"] = E.elements;
+		event["args"] = args;
+		trace_events.push_back(event);
+	}
+
+	Dictionary trace;
+	trace["traceEvents"] = trace_events;
+	trace["displayTimeUnit"] = "ms";
+
+	return JSON::stringify(trace, "", false);
+}
+
+RenderingCPUProfiler::RenderingCPUProfiler() {
+	// Profilers created after the one of the rendering server (e.g. in tests) only replace it while they exist.
+	previous_singleton = singleton;
+	singleton = this;
+}
+
+RenderingCPUProfiler::~RenderingCPUProfiler() {
+	if (singleton == this) {
+		singleton = previous_singleton;
+	}
+}
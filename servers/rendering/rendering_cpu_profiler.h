@@ -0,0 +1,142 @@
+/**************************************************************************/
+/*  rendering_cpu_profiler.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef RENDERING_CPU_PROFILER_H
+#define RENDERING_CPU_PROFILER_H
+
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#include "servers/rendering_server.h"
+
+// Records CPU wall time spent in the main stages of a rendering frame.
+// Unlike RENDER_TIMESTAMP, this does not rely on GPU timestamp queries,
+// so it also works on headless or software-rendered setups.
+// Stages may nest (e.g. render list sorting happens during command recording),
+// so both inclusive and exclusive (self) times are reported.
+
+class RenderingCPUProfiler {
+public:
+	struct StageData {
+		uint64_t usec = 0;
+		uint64_t self_usec = 0;
+		uint64_t calls = 0;
+		uint64_t elements = 0;
+	};
+
+	struct Event {
+		RS::CPUProfileStage stage = RS::CPU_PROFILE_STAGE_MAX;
+		uint64_t begin_usec = 0;
+		uint64_t end_usec = 0;
+		uint64_t elements = 0;
+		uint64_t thread_id = 0;
+	};
+
+	class Scope {
+		friend class RenderingCPUProfiler;
+
+		RS::CPUProfileStage stage = RS::CPU_PROFILE_STAGE_MAX;
+		uint64_t begin_usec = 0;
+		uint64_t child_usec = 0;
+		uint64_t elements = 0;
+		Scope *parent = nullptr;
+		bool active = false;
+
+	public:
+		Scope(RS::CPUProfileStage p_stage);
+		~Scope();
+	};
+
+private:
+	static RenderingCPUProfiler *singleton;
+	RenderingCPUProfiler *previous_singleton = nullptr;
+	static thread_local Scope *current_scope;
+
+	// Avoid unbounded growth if a frame is never closed (e.g. rendering is stalled).
+	static constexpr uint32_t MAX_EVENTS_PER_FRAME = 65536;
+
+	SafeFlag enabled;
+	mutable Mutex mutex;
+
+	// Frame being recorded.
+	StageData stages[RS::CPU_PROFILE_STAGE_MAX];
+	LocalVector<Event> events;
+	uint64_t frame_begin_usec = 0;
+	bool in_frame = false;
+
+	// Command queue flushes can contain the frame itself (when using a separate render thread),
+	// so the flush is paused while the frame is being drawn.
+	bool in_command_queue_flush = false;
+	uint64_t command_queue_flush_from = 0;
+
+	// Last completed frame.
+	uint64_t last_frame = 0;
+	uint64_t last_frame_begin_usec = 0;
+	uint64_t last_frame_usec = 0;
+	StageData last_stages[RS::CPU_PROFILE_STAGE_MAX];
+	LocalVector<Event> last_events;
+
+	void _record(RS::CPUProfileStage p_stage, uint64_t p_begin_usec, uint64_t p_end_usec, uint64_t p_self_usec, uint64_t p_elements, bool p_count_call = true);
+	void _reset_current();
+
+public:
+	_FORCE_INLINE_ static RenderingCPUProfiler *get_singleton() { return singleton; }
+
+	// Whether a profiled stage is currently running on the calling thread.
+	// Use to skip gathering element counts that are only needed for profiling.
+	_FORCE_INLINE_ static bool is_in_scope() { return current_scope != nullptr; }
+	_FORCE_INLINE_ static void add_elements(uint64_t p_count) {
+		if (current_scope) {
+			current_scope->elements += p_count;
+		}
+	}
+
+	static String get_stage_name(RS::CPUProfileStage p_stage);
+
+	void set_enabled(bool p_enabled);
+	_FORCE_INLINE_ bool is_enabled() const { return enabled.is_set(); }
+
+	void begin_frame();
+	void end_frame(uint64_t p_frame);
+
+	void command_queue_flush_begin();
+	void command_queue_flush_end();
+
+	Dictionary get_frame_profile() const;
+	String get_frame_profile_chrome_trace() const;
+
+	RenderingCPUProfiler();
+	~RenderingCPUProfiler();
+};
+
+#define RENDER_CPU_PROFILE_SCOPE(m_stage) RenderingCPUProfiler::Scope _render_cpu_profile_scope(m_stage)
+#define RENDER_CPU_PROFILE_ELEMENTS(m_count) RenderingCPUProfiler::add_elements(m_count)
+
+#endif // RENDERING_CPU_PROFILER_H
@@ -525,6 +525,24 @@ String RenderingDevice::get_perf_report() const {
 	return perf_report_text;
 }
 
+Dictionary RenderingDevice::get_render_graph_statistics() const {
+	_THREAD_SAFE_METHOD_
+
+	const RDG::Statistics &statistics = draw_graph.get_statistics();
+	Dictionary d;
+	d["commands"] = statistics.command_count;
+	d["levels"] = statistics.level_count;
+	d["reordered_commands"] = statistics.reordered_command_count;
+	d["synchronized_commands"] = statistics.synchronized_command_count;
+	d["pipeline_barriers"] = statistics.pipeline_barrier_count;
+	d["elided_barriers"] = statistics.elided_barrier_count;
+	d["texture_barriers"] = statistics.texture_barrier_count;
+	d["buffer_barriers"] = statistics.buffer_barrier_count;
+	d["build_usec"] = statistics.build_usec;
+	d["end_usec"] = statistics.end_usec;
+	return d;
+}
+
 void RenderingDevice::update_perf_report() {
 	perf_report_text = " gpu:" + String::num_int64(gpu_copy_count);
 	perf_report_text += " bytes:" + String::num_int64(copy_bytes_count);
@@ -2243,6 +2261,19 @@ RenderingDevice::FramebufferFormatID RenderingDevice::framebuffer_format_create_
 	return id;
 }
 
+bool RenderingDevice::framebuffer_format_get_description(FramebufferFormatID p_format, Vector<AttachmentFormat> &r_attachments, Vector<FramebufferPass> &r_passes, uint32_t &r_view_count) {
+	_THREAD_SAFE_METHOD_
+
+	HashMap<FramebufferFormatID, FramebufferFormat>::Iterator E = framebuffer_formats.find(p_format);
+	ERR_FAIL_COND_V(!E, false);
+
+	const FramebufferFormatKey &key = E->value.E->key();
+	r_attachments = key.attachments;
+	r_passes = key.passes;
+	r_view_count = key.view_count;
+	return true;
+}
+
 RenderingDevice::TextureSamples RenderingDevice::framebuffer_format_get_texture_samples(FramebufferFormatID p_format, uint32_t p_pass) {
 	HashMap<FramebufferFormatID, FramebufferFormat>::Iterator E = framebuffer_formats.find(p_format);
 	ERR_FAIL_COND_V(!E, TEXTURE_SAMPLES_1);
@@ -2486,6 +2517,14 @@ RenderingDevice::VertexFormatID RenderingDevice::vertex_format_create(const Vect
 	return id;
 }
 
+Vector<RenderingDevice::VertexAttribute> RenderingDevice::vertex_format_get_attributes(VertexFormatID p_vertex_format) {
+	_THREAD_SAFE_METHOD_
+
+	HashMap<VertexFormatID, VertexDescriptionCache>::Iterator E = vertex_formats.find(p_vertex_format);
+	ERR_FAIL_COND_V(!E, Vector<VertexAttribute>());
+	return E->value.vertex_formats;
+}
+
 RID RenderingDevice::vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers, const Vector<uint64_t> &p_offsets) {
 	_THREAD_SAFE_METHOD_
 
@@ -3211,7 +3250,7 @@ void RenderingDevice::uniform_set_set_invalidation_callback(RID p_uniform_set, I
 /**** PIPELINES ****/
 /*******************/
 
-RID RenderingDevice::render_pipeline_create(RID p_shader, FramebufferFormatID p_framebuffer_format, VertexFormatID p_vertex_format, RenderPrimitive p_render_primitive, const PipelineRasterizationState &p_rasterization_state, const PipelineMultisampleState &p_multisample_state, const PipelineDepthStencilState &p_depth_stencil_state, const PipelineColorBlendState &p_blend_state, BitField<PipelineDynamicStateFlags> p_dynamic_state_flags, uint32_t p_for_render_pass, const Vector<PipelineSpecializationConstant> &p_specialization_constants) {
+RID RenderingDevice::render_pipeline_create(RID p_shader, FramebufferFormatID p_framebuffer_format, VertexFormatID p_vertex_format, RenderPrimitive p_render_primitive, const PipelineRasterizationState &p_rasterization_state, const PipelineMultisampleState &p_multisample_state, const PipelineDepthStencilState &p_depth_stencil_state, const PipelineColorBlendState &p_blend_state, BitField<PipelineDynamicStateFlags> p_dynamic_state_flags, uint32_t p_for_render_pass, const Vector<PipelineSpecializationConstant> &p_specialization_constants, bool p_allow_concurrent_creation) {
 	_THREAD_SAFE_METHOD_
 
 	// Needs a shader.
@@ -3319,20 +3358,52 @@ RID RenderingDevice::render_pipeline_create(RID p_shader, FramebufferFormatID p_
 		}
 	}
 
+	// Compiling the pipeline is slow, so callers compiling in the background can let other threads use the device meanwhile if the driver allows it.
+	// Anything needed from the device state is copied first, as it may change while unlocked, and the shader is kept alive until the driver is done with it.
+	bool unlock_for_creation = p_allow_concurrent_creation && is_pipeline_creation_thread_safe();
+	RDD::ShaderID shader_driver_id = shader->driver_id;
+	Vector<int32_t> color_attachments = pass.color_attachments;
+	RDD::RenderPassID render_pass = fb_format.render_pass;
+
+	if (unlock_for_creation) {
+		shader->pipeline_creations++;
+		_thread_safe_method_.temp_unlock();
+	}
+
 	RenderPipeline pipeline;
 	pipeline.driver_id = driver->render_pipeline_create(
-			shader->driver_id,
+			shader_driver_id,
 			driver_vertex_format,
 			p_render_primitive,
 			p_rasterization_state,
 			p_multisample_state,
 			p_depth_stencil_state,
 			p_blend_state,
-			pass.color_attachments,
+			color_attachments,
 			p_dynamic_state_flags,
-			fb_format.render_pass,
+			render_pass,
 			p_for_render_pass,
 			p_specialization_constants);
+
+	if (unlock_for_creation) {
+		_thread_safe_method_.temp_relock();
+		shader = shader_owner.get_or_null(p_shader);
+		if (shader != nullptr) {
+			shader->pipeline_creations--;
+		} else {
+			HashMap<RID, Shader>::Iterator E = shaders_freed_during_pipeline_creation.find(p_shader);
+			if (E && --E->value.pipeline_creations == 0) {
+				if (E->value.driver_id) {
+					frames[frame].shaders_to_dispose_of.push_back(E->value);
+				}
+				shaders_freed_during_pipeline_creation.remove(E);
+			}
+			if (pipeline.driver_id) {
+				driver->pipeline_free(pipeline.driver_id);
+			}
+			ERR_FAIL_V_MSG(RID(), "Shader was freed while a render pipeline was being created for it.");
+		}
+	}
 	ERR_FAIL_COND_V(!pipeline.driver_id, RID());
 
 	if (pipeline_cache_enabled) {
@@ -3387,6 +3458,10 @@ bool RenderingDevice::render_pipeline_is_valid(RID p_pipeline) {
 	return render_pipeline_owner.owns(p_pipeline);
 }
 
+bool RenderingDevice::is_pipeline_creation_thread_safe() const {
+	return driver->api_trait_get(RDD::API_TRAIT_THREAD_SAFE_PIPELINE_CREATION);
+}
+
 RID RenderingDevice::compute_pipeline_create(RID p_shader, const Vector<PipelineSpecializationConstant> &p_specialization_constants) {
 	_THREAD_SAFE_METHOD_
 
@@ -4933,7 +5008,10 @@ void RenderingDevice::_free_internal(RID p_id) {
 		index_array_owner.free(p_id);
 	} else if (shader_owner.owns(p_id)) {
 		Shader *shader = shader_owner.get_or_null(p_id);
-		if (shader->driver_id) { // Not placeholder?
+		if (shader->pipeline_creations > 0) {
+			// The driver is still creating pipelines from it with the device unlocked, the last one disposes of it.
+			shaders_freed_during_pipeline_creation.insert(p_id, *shader);
+		} else if (shader->driver_id) { // Not placeholder?
 			frames[frame].shaders_to_dispose_of.push_back(*shader);
 		}
 		shader_owner.free(p_id);
@@ -6081,6 +6159,7 @@ void RenderingDevice::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_driver_resource", "resource", "rid", "index"), &RenderingDevice::get_driver_resource);
 
 	ClassDB::bind_method(D_METHOD("get_perf_report"), &RenderingDevice::get_perf_report);
+	ClassDB::bind_method(D_METHOD("get_render_graph_statistics"), &RenderingDevice::get_render_graph_statistics);
 
 	ClassDB::bind_method(D_METHOD("get_driver_and_device_memory_report"), &RenderingDevice::get_driver_and_device_memory_report);
 	ClassDB::bind_method(D_METHOD("get_tracked_object_name", "type_index"), &RenderingDevice::get_tracked_object_name);
@@ -580,6 +580,7 @@ public:
 	FramebufferFormatID framebuffer_format_create_multipass(const Vector<AttachmentFormat> &p_attachments, const Vector<FramebufferPass> &p_passes, uint32_t p_view_count = 1);
 	FramebufferFormatID framebuffer_format_create_empty(TextureSamples p_samples = TEXTURE_SAMPLES_1);
 	TextureSamples framebuffer_format_get_texture_samples(FramebufferFormatID p_format, uint32_t p_pass = 0);
+	bool framebuffer_format_get_description(FramebufferFormatID p_format, Vector<AttachmentFormat> &r_attachments, Vector<FramebufferPass> &r_passes, uint32_t &r_view_count);
 
 	RID framebuffer_create(const Vector<RID> &p_texture_attachments, FramebufferFormatID p_format_check = INVALID_ID, uint32_t p_view_count = 1);
 	RID framebuffer_create_multipass(const Vector<RID> &p_texture_attachments, const Vector<FramebufferPass> &p_passes, FramebufferFormatID p_format_check = INVALID_ID, uint32_t p_view_count = 1);
@@ -726,6 +727,7 @@ public:
 
 	// This ID is warranted to be unique for the same formats, does not need to be freed
 	VertexFormatID vertex_format_create(const Vector<VertexAttribute> &p_vertex_descriptions);
+	Vector<VertexAttribute> vertex_format_get_attributes(VertexFormatID p_vertex_format);
 	RID vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers, const Vector<uint64_t> &p_offsets = Vector<uint64_t>());
 
 	RID index_buffer_create(uint32_t p_size_indices, IndexBufferFormat p_format, const Vector<uint8_t> &p_data = Vector<uint8_t>(), bool p_use_restart_indices = false);
@@ -792,11 +794,14 @@ private:
 		uint32_t layout_hash = 0;
 		BitField<RDD::PipelineStageBits> stage_bits;
 		Vector<uint32_t> set_formats;
+		uint32_t pipeline_creations = 0; // Render pipelines being created from it with the device unlocked.
 	};
 
 	String _shader_uniform_debug(RID p_shader, int p_set = -1);
 
 	RID_Owner<Shader> shader_owner;
+	// Shaders freed while render pipelines were being created from them, disposed of once the last one is done.
+	HashMap<RID, Shader> shaders_freed_during_pipeline_creation;
 
 #ifndef DISABLE_DEPRECATED
 public:
@@ -869,6 +874,7 @@ public:
 	/**** UNIFORMS ****/
 	/******************/
 	String get_perf_report() const;
+	Dictionary get_render_graph_statistics() const;
 
 	enum StorageBufferUsage {
 		STORAGE_BUFFER_USAGE_DISPATCH_INDIRECT = 1,
@@ -1048,8 +1054,10 @@ private:
 	RID_Owner<ComputePipeline> compute_pipeline_owner;
 
 public:
-	RID render_pipeline_create(RID p_shader, FramebufferFormatID p_framebuffer_format, VertexFormatID p_vertex_format, RenderPrimitive p_render_primitive, const PipelineRasterizationState &p_rasterization_state, const PipelineMultisampleState &p_multisample_state, const PipelineDepthStencilState &p_depth_stencil_state, const PipelineColorBlendState &p_blend_state, BitField<PipelineDynamicStateFlags> p_dynamic_state_flags = 0, uint32_t p_for_render_pass = 0, const Vector<PipelineSpecializationConstant> &p_specialization_constants = Vector<PipelineSpecializationConstant>());
+	RID render_pipeline_create(RID p_shader, FramebufferFormatID p_framebuffer_format, VertexFormatID p_vertex_format, RenderPrimitive p_render_primitive, const PipelineRasterizationState &p_rasterization_state, const PipelineMultisampleState &p_multisample_state, const PipelineDepthStencilState &p_depth_stencil_state, const PipelineColorBlendState &p_blend_state, BitField<PipelineDynamicStateFlags> p_dynamic_state_flags = 0, uint32_t p_for_render_pass = 0, const Vector<PipelineSpecializationConstant> &p_specialization_constants = Vector<PipelineSpecializationConstant>(), bool p_allow_concurrent_creation = false);
 	bool render_pipeline_is_valid(RID p_pipeline);
+	// If true, render pipelines created with p_allow_concurrent_creation don't block other device calls while the driver compiles them.
+	bool is_pipeline_creation_thread_safe() const;
 
 	RID compute_pipeline_create(RID p_shader, const Vector<PipelineSpecializationConstant> &p_specialization_constants = Vector<PipelineSpecializationConstant>());
 	bool compute_pipeline_is_valid(RID p_pipeline);
@@ -374,6 +374,8 @@ uint64_t RenderingDeviceDriver::api_trait_get(ApiTrait p_trait) {
 			return 1;
 		case API_TRAIT_CLEARS_WITH_COPY_ENGINE:
 			return true;
+		case API_TRAIT_THREAD_SAFE_PIPELINE_CREATION:
+			return false;
 		default:
 			ERR_FAIL_V(0);
 	}
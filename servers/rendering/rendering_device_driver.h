@@ -750,6 +750,7 @@ public:
 		API_TRAIT_TEXTURE_DATA_ROW_PITCH_STEP,
 		API_TRAIT_SECONDARY_VIEWPORT_SCISSOR,
 		API_TRAIT_CLEARS_WITH_COPY_ENGINE,
+		API_TRAIT_THREAD_SAFE_PIPELINE_CREATION,
 	};
 
 	enum ShaderChangeInvalidation {
@@ -30,6 +30,9 @@
 
 #include "rendering_device_graph.h"
 
+#include "core/os/os.h"
+#include "servers/rendering/rendering_cpu_profiler.h"
+
 #define PRINT_RENDER_GRAPH 0
 #define FORCE_FULL_ACCESS_BITS 0
 #define PRINT_RESOURCE_TRACKER_TOTAL 0
@@ -212,6 +215,8 @@ RenderingDeviceGraph::ComputeListInstruction *RenderingDeviceGraph::_allocate_co
 }
 
 void RenderingDeviceGraph::_add_command_to_graph(ResourceTracker **p_resource_trackers, ResourceUsage *p_resource_usages, uint32_t p_resource_count, int32_t p_command_index, RecordedCommand *r_command) {
+	const uint64_t build_begin_usec = statistics_timing_enabled ? OS::get_singleton()->get_ticks_usec() : 0;
+
 	// Assign the next stages derived from the stages the command requires first.
 	r_command->next_stages = r_command->self_stages;
 
@@ -562,6 +567,10 @@ void RenderingDeviceGraph::_add_command_to_graph(ResourceTracker **p_resource_tr
 			search_tracker->read_full_command_list_index = _add_to_command_list(p_command_index, search_tracker->read_full_command_list_index);
 		}
 	}
+
+	if (statistics_timing_enabled) {
+		statistics.build_usec += OS::get_singleton()->get_ticks_usec() - build_begin_usec;
+	}
 }
 
 void RenderingDeviceGraph::_add_texture_barrier_to_command(RDD::TextureID p_texture_id, BitField<RDD::BarrierAccessBits> p_src_access, BitField<RDD::BarrierAccessBits> p_dst_access, ResourceUsage p_prev_usage, ResourceUsage p_next_usage, RDD::TextureSubresourceRange p_subresources, LocalVector<RDD::TextureBarrier> &r_barrier_vector, int32_t &r_barrier_index, int32_t &r_barrier_count) {
@@ -993,6 +1002,9 @@ void RenderingDeviceGraph::_group_barriers_for_render_commands(RDD::CommandBuffe
 	barrier_group.src_stages = RDD::PIPELINE_STAGE_TOP_OF_PIPE_BIT;
 	barrier_group.dst_stages = RDD::PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
 
+	// Number of commands in the group that would've needed a barrier of their own if they weren't grouped.
+	uint32_t synchronized_command_count = 0;
+
 	for (uint32_t i = 0; i < p_sorted_commands_count; i++) {
 		const uint32_t command_index = p_sorted_commands[i].index;
 		const uint32_t command_data_offset = command_data_offsets[command_index];
@@ -1002,6 +1014,14 @@ void RenderingDeviceGraph::_group_barriers_for_render_commands(RDD::CommandBuffe
 		print_line(vformat("Grouping barriers for #%d", command_index));
 #endif
 
+		bool command_synchronized = !command->memory_barrier.src_access.is_empty() || !command->memory_barrier.dst_access.is_empty() || command->normalization_barrier_count > 0 || command->transition_barrier_count > 0;
+#if USE_BUFFER_BARRIERS
+		command_synchronized = command_synchronized || command->buffer_barrier_count > 0;
+#endif
+		if (command_synchronized) {
+			synchronized_command_count++;
+		}
+
 		// Merge command's stage bits with the barrier group.
 		barrier_group.src_stages = barrier_group.src_stages | command->previous_stages;
 		barrier_group.dst_stages = barrier_group.dst_stages | command->next_stages;
@@ -1050,6 +1070,7 @@ void RenderingDeviceGraph::_group_barriers_for_render_commands(RDD::CommandBuffe
 #else
 	const bool are_buffer_barriers_empty = true;
 #endif
+	statistics.synchronized_command_count += synchronized_command_count;
 	if (is_memory_barrier_empty && are_texture_barriers_empty && are_buffer_barriers_empty) {
 		// Commands don't require synchronization.
 		return;
@@ -1063,9 +1084,22 @@ void RenderingDeviceGraph::_group_barriers_for_render_commands(RDD::CommandBuffe
 	const VectorView<RDD::BufferBarrier> buffer_barriers = VectorView<RDD::BufferBarrier>();
 #endif
 
+	bool separate_texture_barriers = !barrier_group.normalization_barriers.is_empty() && !barrier_group.transition_barriers.is_empty();
+	const uint32_t pipeline_barrier_count = separate_texture_barriers ? 2 : 1;
+	statistics.pipeline_barrier_count += pipeline_barrier_count;
+	statistics.texture_barrier_count += barrier_group.normalization_barriers.size() + barrier_group.transition_barriers.size();
+	statistics.buffer_barrier_count += buffer_barriers.size();
+	if (synchronized_command_count > pipeline_barrier_count) {
+		statistics.elided_barrier_count += synchronized_command_count - pipeline_barrier_count;
+	}
+
+	if (driver == nullptr) {
+		// Statistics only mode, there's nothing to record to.
+		return;
+	}
+
 	driver->command_pipeline_barrier(p_command_buffer, barrier_group.src_stages, barrier_group.dst_stages, memory_barriers, buffer_barriers, texture_barriers);
 
-	bool separate_texture_barriers = !barrier_group.normalization_barriers.is_empty() && !barrier_group.transition_barriers.is_empty();
 	if (separate_texture_barriers) {
 		driver->command_pipeline_barrier(p_command_buffer, barrier_group.src_stages, barrier_group.dst_stages, VectorView<RDD::MemoryBarrier>(), VectorView<RDD::BufferBarrier>(), barrier_group.transition_barriers);
 	}
@@ -1289,6 +1323,14 @@ void RenderingDeviceGraph::initialize(RDD *p_driver, RenderingContextDriver::Dev
 	driver_clears_with_copy_engine = driver->api_trait_get(RDD::API_TRAIT_CLEARS_WITH_COPY_ENGINE);
 }
 
+void RenderingDeviceGraph::initialize_statistics_only(uint32_t p_frame_count) {
+	driver = nullptr;
+	device = RenderingContextDriver::Device();
+	frames.resize(p_frame_count);
+	driver_honors_barriers = true;
+	driver_clears_with_copy_engine = false;
+}
+
 void RenderingDeviceGraph::finalize() {
 	_wait_for_secondary_command_buffer_tasks();
 
@@ -1325,6 +1367,11 @@ void RenderingDeviceGraph::begin() {
 	draw_instruction_list.index = 0;
 	compute_instruction_list.index = 0;
 	tracking_frame++;
+	statistics = Statistics();
+
+	// Timing every recorded command is only worth its cost while the CPU profiler is capturing.
+	RenderingCPUProfiler *cpu_profiler = RenderingCPUProfiler::get_singleton();
+	statistics_timing_enabled = cpu_profiler != nullptr && cpu_profiler->is_enabled();
 
 #ifdef DEV_ENABLED
 	write_dependency_counters.clear();
@@ -1897,9 +1944,13 @@ void RenderingDeviceGraph::end_label() {
 void RenderingDeviceGraph::end(bool p_reorder_commands, bool p_full_barriers, RDD::CommandBufferID &r_command_buffer, CommandBufferPool &r_command_buffer_pool) {
 	if (command_count == 0) {
 		// No commands have been logged, do nothing.
+		last_statistics = statistics;
 		return;
 	}
 
+	const uint64_t end_begin_usec = OS::get_singleton()->get_ticks_usec();
+	const bool recording = driver != nullptr;
+
 	thread_local LocalVector<RecordedCommandSort> commands_sorted;
 	if (p_reorder_commands) {
 		thread_local LocalVector<int64_t> command_stack;
@@ -2009,7 +2060,9 @@ void RenderingDeviceGraph::end(bool p_reorder_commands, bool p_full_barriers, RD
 	if (command_count > 0) {
 		int32_t current_label_index = -1;
 		int32_t current_label_level = -1;
-		_run_label_command_change(r_command_buffer, -1, -1, true, true, nullptr, 0, current_label_index, current_label_level);
+		if (recording) {
+			_run_label_command_change(r_command_buffer, -1, -1, true, true, nullptr, 0, current_label_index, current_label_level);
+		}
 
 		if (device.workarounds.avoid_compute_after_draw) {
 			// Reset the state of the workaround.
@@ -2024,6 +2077,12 @@ void RenderingDeviceGraph::end(bool p_reorder_commands, bool p_full_barriers, RD
 
 			commands_sorted.sort();
 
+			for (uint32_t i = 0; i < command_count; i++) {
+				if (commands_sorted[i].index != int32_t(i)) {
+					statistics.reordered_command_count++;
+				}
+			}
+
 #if PRINT_RENDER_GRAPH
 			print_line("AFTER SORT");
 			_print_render_commands(commands_sorted.ptr(), command_count);
@@ -2042,7 +2101,10 @@ void RenderingDeviceGraph::end(bool p_reorder_commands, bool p_full_barriers, RD
 					uint32_t level_command_count = i - current_level_start;
 					_boost_priority_for_render_commands(level_command_ptr, level_command_count, boosted_priority);
 					_group_barriers_for_render_commands(r_command_buffer, level_command_ptr, level_command_count, p_full_barriers);
-					_run_render_commands(current_level, level_command_ptr, level_command_count, r_command_buffer, r_command_buffer_pool, current_label_index, current_label_level);
+					if (recording) {
+						_run_render_commands(current_level, level_command_ptr, level_command_count, r_command_buffer, r_command_buffer_pool, current_label_index, current_label_level);
+					}
+
 					current_level = commands_sorted[i].level;
 					current_level_start = i;
 				}
@@ -2052,7 +2114,11 @@ void RenderingDeviceGraph::end(bool p_reorder_commands, bool p_full_barriers, RD
 			uint32_t level_command_count = command_count - current_level_start;
 			_boost_priority_for_render_commands(level_command_ptr, level_command_count, boosted_priority);
 			_group_barriers_for_render_commands(r_command_buffer, level_command_ptr, level_command_count, p_full_barriers);
-			_run_render_commands(current_level, level_command_ptr, level_command_count, r_command_buffer, r_command_buffer_pool, current_label_index, current_label_level);
+			if (recording) {
+				_run_render_commands(current_level, level_command_ptr, level_command_count, r_command_buffer, r_command_buffer_pool, current_label_index, current_label_level);
+			}
+
+			statistics.level_count = current_level + 1;
 
 #if PRINT_RENDER_GRAPH
 			print_line("COMMANDS", command_count, "LEVELS", current_level + 1);
@@ -2060,17 +2126,27 @@ void RenderingDeviceGraph::end(bool p_reorder_commands, bool p_full_barriers, RD
 		} else {
 			for (uint32_t i = 0; i < command_count; i++) {
 				_group_barriers_for_render_commands(r_command_buffer, &commands_sorted[i], 1, p_full_barriers);
-				_run_render_commands(i, &commands_sorted[i], 1, r_command_buffer, r_command_buffer_pool, current_label_index, current_label_level);
+				if (recording) {
+					_run_render_commands(i, &commands_sorted[i], 1, r_command_buffer, r_command_buffer_pool, current_label_index, current_label_level);
+				}
 			}
+
+			statistics.level_count = command_count;
 		}
 
-		_run_label_command_change(r_command_buffer, -1, -1, true, false, nullptr, 0, current_label_index, current_label_level);
+		if (recording) {
+			_run_label_command_change(r_command_buffer, -1, -1, true, false, nullptr, 0, current_label_index, current_label_level);
+		}
 
 #if PRINT_COMMAND_RECORDING
 		print_line(vformat("Recorded %d commands", command_count));
 #endif
 	}
 
+	statistics.command_count = command_count;
+	statistics.end_usec = OS::get_singleton()->get_ticks_usec() - end_begin_usec;
+	last_statistics = statistics;
+
 	// Advance the frame counter. It's not necessary to do this if no commands are recorded because that means no secondary command buffers were used.
 	frame = (frame + 1) % frames.size();
 }
@@ -587,6 +587,22 @@ private:
 		uint32_t secondary_command_buffers_used = 0;
 	};
 
+public:
+	struct Statistics {
+		uint32_t command_count = 0;
+		uint32_t level_count = 0;
+		uint32_t reordered_command_count = 0;
+		uint32_t synchronized_command_count = 0;
+		uint32_t pipeline_barrier_count = 0;
+		uint32_t elided_barrier_count = 0;
+		uint32_t texture_barrier_count = 0;
+		uint32_t buffer_barrier_count = 0;
+		uint64_t build_usec = 0;
+		uint64_t end_usec = 0;
+	};
+
+private:
+
 	RDD *driver = nullptr;
 	RenderingContextDriver::Device device;
 	int64_t tracking_frame = 0;
@@ -615,6 +631,9 @@ private:
 	WorkaroundsState workarounds_state;
 	TightLocalVector<Frame> frames;
 	uint32_t frame = 0;
+	Statistics statistics;
+	Statistics last_statistics;
+	bool statistics_timing_enabled = false;
 
 #ifdef DEV_ENABLED
 	RBMap<ResourceTracker *, uint32_t> write_dependency_counters;
@@ -651,6 +670,8 @@ public:
 	RenderingDeviceGraph();
 	~RenderingDeviceGraph();
 	void initialize(RDD *p_driver, RenderingContextDriver::Device p_device, uint32_t p_frame_count, RDD::CommandQueueFamilyID p_secondary_command_queue_family, uint32_t p_secondary_command_buffers_per_frame);
+	// Without a driver, commands are sorted and their barriers grouped, but nothing is recorded. Only the statistics are gathered.
+	void initialize_statistics_only(uint32_t p_frame_count);
 	void finalize();
 	void begin();
 	void add_buffer_clear(RDD::BufferID p_dst, ResourceTracker *p_dst_tracker, uint32_t p_offset, uint32_t p_size);
@@ -696,6 +717,7 @@ public:
 	void begin_label(const String &p_label_name, const Color &p_color);
 	void end_label();
 	void end(bool p_reorder_commands, bool p_full_barriers, RDD::CommandBufferID &r_command_buffer, CommandBufferPool &r_command_buffer_pool);
+	const Statistics &get_statistics() const { return last_statistics; }
 	static ResourceTracker *resource_tracker_create();
 	static void resource_tracker_free(ResourceTracker *tracker);
 };
@@ -69,6 +69,8 @@ void RenderingServerDefault::request_frame_drawn_callback(const Callable &p_call
 }
 
 void RenderingServerDefault::_draw(bool p_swap_buffers, double frame_step) {
+	cpu_profiler.begin_frame();
+
 	RSG::rasterizer->begin_frame(frame_step);
 
 	TIMESTAMP_BEGIN()
@@ -180,6 +182,8 @@ void RenderingServerDefault::_draw(bool p_swap_buffers, double frame_step) {
 	}
 
 	RSG::utilities->update_memory_info();
+
+	cpu_profiler.end_frame(RSG::rasterizer->get_frame_number());
 }
 
 void RenderingServerDefault::_run_post_draw_steps() {
@@ -301,6 +305,22 @@ Vector<RenderingServer::FrameProfileArea> RenderingServerDefault::get_frame_prof
 	return frame_profile;
 }
 
+void RenderingServerDefault::set_cpu_profiling_enabled(bool p_enable) {
+	cpu_profiler.set_enabled(p_enable);
+}
+
+bool RenderingServerDefault::is_cpu_profiling_enabled() const {
+	return cpu_profiler.is_enabled();
+}
+
+Dictionary RenderingServerDefault::get_cpu_frame_profile() const {
+	return cpu_profiler.get_frame_profile();
+}
+
+String RenderingServerDefault::get_cpu_frame_profile_chrome_trace() const {
+	return cpu_profiler.get_frame_profile_chrome_trace();
+}
+
 /* TESTING */
 
 Color RenderingServerDefault::get_default_clear_color() {
@@ -371,7 +391,9 @@ void RenderingServerDefault::_thread_loop() {
 
 	while (!exit) {
 		WorkerThreadPool::get_singleton()->yield();
+		cpu_profiler.command_queue_flush_begin();
 		command_queue.flush_all();
+		cpu_profiler.command_queue_flush_end();
 	}
 
 	DisplayServer::get_singleton()->release_rendering_thread();
@@ -390,7 +412,9 @@ void RenderingServerDefault::sync() {
 	if (create_thread) {
 		command_queue.sync();
 	} else {
+		cpu_profiler.command_queue_flush_begin();
 		command_queue.flush_all(); // Flush all pending from other threads.
+		cpu_profiler.command_queue_flush_end();
 	}
 }
 
@@ -38,6 +38,7 @@
 #include "renderer_canvas_cull.h"
 #include "renderer_scene_cull.h"
 #include "renderer_viewport.h"
+#include "rendering_cpu_profiler.h"
 #include "rendering_server_globals.h"
 #include "servers/rendering/renderer_compositor.h"
 #include "servers/rendering_server.h"
@@ -66,6 +67,8 @@ class RenderingServerDefault : public RenderingServer {
 	uint64_t frame_profile_frame = 0;
 	Vector<FrameProfileArea> frame_profile;
 
+	RenderingCPUProfiler cpu_profiler;
+
 	double frame_setup_time = 0;
 
 	//for printing
@@ -1062,6 +1065,11 @@ public:
 	virtual Vector<FrameProfileArea> get_frame_profile() override;
 	virtual uint64_t get_frame_profile_frame() override;
 
+	virtual void set_cpu_profiling_enabled(bool p_enable) override;
+	virtual bool is_cpu_profiling_enabled() const override;
+	virtual Dictionary get_cpu_frame_profile() const override;
+	virtual String get_cpu_frame_profile_chrome_trace() const override;
+
 	virtual RID get_test_cube() override;
 
 	/* FREE */
@@ -3439,6 +3439,11 @@ void RenderingServer::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_frame_setup_time_cpu"), &RenderingServer::get_frame_setup_time_cpu);
 
+	ClassDB::bind_method(D_METHOD("set_cpu_profiling_enabled", "enable"), &RenderingServer::set_cpu_profiling_enabled);
+	ClassDB::bind_method(D_METHOD("is_cpu_profiling_enabled"), &RenderingServer::is_cpu_profiling_enabled);
+	ClassDB::bind_method(D_METHOD("get_cpu_frame_profile"), &RenderingServer::get_cpu_frame_profile);
+	ClassDB::bind_method(D_METHOD("get_cpu_frame_profile_chrome_trace"), &RenderingServer::get_cpu_frame_profile_chrome_trace);
+
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "render_loop_enabled"), "set_render_loop_enabled", "is_render_loop_enabled");
 
 	BIND_ENUM_CONSTANT(RENDERING_INFO_TOTAL_OBJECTS_IN_FRAME);
@@ -3448,6 +3453,14 @@ void RenderingServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(RENDERING_INFO_BUFFER_MEM_USED);
 	BIND_ENUM_CONSTANT(RENDERING_INFO_VIDEO_MEM_USED);
 
+	BIND_ENUM_CONSTANT(CPU_PROFILE_STAGE_COMMAND_QUEUE_FLUSH);
+	BIND_ENUM_CONSTANT(CPU_PROFILE_STAGE_CANVAS_CULL);
+	BIND_ENUM_CONSTANT(CPU_PROFILE_STAGE_SCENE_CULL);
+	BIND_ENUM_CONSTANT(CPU_PROFILE_STAGE_LIGHT_AND_SHADOW_SETUP);
+	BIND_ENUM_CONSTANT(CPU_PROFILE_STAGE_RENDER_LIST_SORT);
+	BIND_ENUM_CONSTANT(CPU_PROFILE_STAGE_COMMAND_RECORDING);
+	BIND_ENUM_CONSTANT(CPU_PROFILE_STAGE_MAX);
+
 	ADD_SIGNAL(MethodInfo("frame_pre_draw"));
 	ADD_SIGNAL(MethodInfo("frame_post_draw"));
 
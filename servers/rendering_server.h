@@ -1718,6 +1718,21 @@ public:
 	virtual Vector<FrameProfileArea> get_frame_profile() = 0;
 	virtual uint64_t get_frame_profile_frame() = 0;
 
+	enum CPUProfileStage {
+		CPU_PROFILE_STAGE_COMMAND_QUEUE_FLUSH,
+		CPU_PROFILE_STAGE_CANVAS_CULL,
+		CPU_PROFILE_STAGE_SCENE_CULL,
+		CPU_PROFILE_STAGE_LIGHT_AND_SHADOW_SETUP,
+		CPU_PROFILE_STAGE_RENDER_LIST_SORT,
+		CPU_PROFILE_STAGE_COMMAND_RECORDING,
+		CPU_PROFILE_STAGE_MAX
+	};
+
+	virtual void set_cpu_profiling_enabled(bool p_enable) = 0;
+	virtual bool is_cpu_profiling_enabled() const = 0;
+	virtual Dictionary get_cpu_frame_profile() const = 0;
+	virtual String get_cpu_frame_profile_chrome_trace() const = 0;
+
 	virtual double get_frame_setup_time_cpu() const = 0;
 
 	virtual void gi_set_use_half_resolution(bool p_enable) = 0;
@@ -1884,6 +1899,7 @@ VARIANT_ENUM_CAST(RenderingServer::CanvasLightShadowFilter);
 VARIANT_ENUM_CAST(RenderingServer::CanvasOccluderPolygonCullMode);
 VARIANT_ENUM_CAST(RenderingServer::GlobalShaderParameterType);
 VARIANT_ENUM_CAST(RenderingServer::RenderingInfo);
+VARIANT_ENUM_CAST(RenderingServer::CPUProfileStage);
 VARIANT_ENUM_CAST(RenderingServer::CanvasTextureChannel);
 VARIANT_ENUM_CAST(RenderingServer::BakeChannels);
 
@@ -32,6 +32,7 @@
 #define TEST_ASTAR_H
 
 #include "core/math/a_star.h"
+#include "core/object/worker_thread_pool.h"
 
 #include "tests/test_macros.h"
 
@@ -85,6 +86,138 @@ TEST_CASE("[AStar3D] ABCX path") {
 	CHECK(path[3] == ABCX::C);
 }
 
+TEST_CASE("[AStar3D] Frozen graph") {
+	ABCX abcx;
+	abcx.set_frozen();
+	CHECK(abcx.is_frozen());
+	Vector<int64_t> path = abcx.get_id_path(ABCX::X, ABCX::C);
+	REQUIRE(path.size() == 4);
+	CHECK(path[0] == ABCX::X);
+	CHECK(path[1] == ABCX::A);
+	CHECK(path[2] == ABCX::B);
+	CHECK(path[3] == ABCX::C);
+
+	// Points and connections are fixed.
+	ERR_PRINT_OFF;
+	abcx.add_point(10, Vector3());
+	abcx.remove_point(ABCX::B);
+	abcx.connect_points(ABCX::X, ABCX::C);
+	abcx.disconnect_points(ABCX::A, ABCX::B);
+	ERR_PRINT_ON;
+	CHECK_FALSE(abcx.has_point(10));
+	CHECK(abcx.has_point(ABCX::B));
+	CHECK_FALSE(abcx.are_points_connected(ABCX::X, ABCX::C));
+	CHECK(abcx.are_points_connected(ABCX::A, ABCX::B));
+
+	// Disabled points are still taken into account.
+	abcx.set_point_disabled(ABCX::B);
+	path = abcx.get_id_path(ABCX::X, ABCX::C);
+	REQUIRE(path.size() == 3);
+	CHECK(path[1] == ABCX::A);
+	CHECK(abcx.get_id_path(ABCX::X, ABCX::B).is_empty());
+	CHECK(abcx.get_id_path(ABCX::X, ABCX::B, true).size() > 0);
+	abcx.set_point_position(ABCX::C, Vector3(5, 0, 0));
+	CHECK(abcx.get_point_path(ABCX::X, ABCX::C)[2] == Vector3(5, 0, 0));
+
+	abcx.set_frozen(false);
+	abcx.connect_points(ABCX::X, ABCX::C);
+	CHECK(abcx.get_id_path(ABCX::X, ABCX::C).size() == 2);
+	abcx.set_frozen();
+	abcx.clear();
+	CHECK_FALSE(abcx.is_frozen());
+}
+
+TEST_CASE("[AStar3D] Unfreezing restores the connections") {
+	ABCX abcx;
+	abcx.add_point(10, Vector3(2, 0, 0));
+	abcx.connect_points(ABCX::B, 10, false);
+	const Vector<int64_t> connections = abcx.get_point_connections(ABCX::A);
+
+	abcx.set_frozen();
+	CHECK(abcx.get_point_connections(ABCX::A).size() == connections.size());
+	CHECK(abcx.get_point_connections(10).is_empty());
+	CHECK(abcx.get_id_path(ABCX::X, 10).size() == 4);
+
+	abcx.set_frozen(false);
+	Vector<int64_t> unfrozen_connections = abcx.get_point_connections(ABCX::A);
+	CHECK(unfrozen_connections.size() == connections.size());
+	for (int64_t id : connections) {
+		CHECK(unfrozen_connections.has(id));
+	}
+	CHECK(abcx.get_point_connections(10).is_empty());
+	CHECK(abcx.are_points_connected(ABCX::B, 10, false));
+	CHECK_FALSE(abcx.are_points_connected(10, ABCX::B, false));
+	CHECK(abcx.get_id_path(10, ABCX::B).is_empty());
+
+	// Removing a point must drop the one-way connections towards it too.
+	abcx.remove_point(10);
+	CHECK_FALSE(abcx.get_point_connections(ABCX::B).has(10));
+	abcx.remove_point(ABCX::A);
+	CHECK(abcx.get_point_connections(ABCX::X).is_empty());
+	CHECK(abcx.get_id_path(ABCX::B, ABCX::C).size() == 2);
+}
+
+struct FrozenQueries {
+	AStar3D *astar = nullptr;
+	LocalVector<Vector2i> from_to;
+	LocalVector<Vector<int64_t>> paths;
+
+	void query(uint32_t p_index, void *p_userdata) {
+		paths[p_index] = astar->get_id_path(from_to[p_index].x, from_to[p_index].y);
+	}
+};
+
+TEST_CASE("[AStar3D] Concurrent queries on a frozen graph") {
+	// A grid of points with random weights and some disabled points.
+	const int size = 64;
+	AStar3D a;
+	Math::seed(1);
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			a.add_point(y * size + x, Vector3(x, y, 0), 1 + Math::rand() % 3);
+			if (x > 0) {
+				a.connect_points(y * size + x - 1, y * size + x);
+			}
+			if (y > 0) {
+				a.connect_points((y - 1) * size + x, y * size + x);
+			}
+		}
+	}
+	for (int i = 0; i < 600; i++) {
+		a.set_point_disabled(Math::rand() % (size * size));
+	}
+
+	FrozenQueries queries;
+	queries.astar = &a;
+	LocalVector<Vector<int64_t>> expected_paths;
+	for (int i = 0; i < 256; i++) {
+		const Vector2i from_to(Math::rand() % (size * size), Math::rand() % (size * size));
+		queries.from_to.push_back(from_to);
+		expected_paths.push_back(a.get_id_path(from_to.x, from_to.y));
+	}
+	queries.paths.resize(queries.from_to.size());
+
+	a.set_frozen();
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&queries, &FrozenQueries::query, nullptr, queries.from_to.size());
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	// Ties can be broken differently, the costs must match.
+	for (uint32_t i = 0; i < queries.paths.size(); i++) {
+		const Vector<int64_t> &path = queries.paths[i];
+		const Vector<int64_t> &expected_path = expected_paths[i];
+		REQUIRE(path.is_empty() == expected_path.is_empty());
+		real_t cost = 0.0;
+		real_t expected_cost = 0.0;
+		for (int j = 1; j < path.size(); j++) {
+			cost += a.get_point_position(path[j - 1]).distance_to(a.get_point_position(path[j])) * a.get_point_weight_scale(path[j]);
+		}
+		for (int j = 1; j < expected_path.size(); j++) {
+			expected_cost += a.get_point_position(expected_path[j - 1]).distance_to(a.get_point_position(expected_path[j])) * a.get_point_weight_scale(expected_path[j]);
+		}
+		CHECK(cost == doctest::Approx(expected_cost));
+	}
+}
+
 TEST_CASE("[AStar3D] Add/Remove") {
 	AStar3D a;
 
@@ -213,8 +346,8 @@ TEST_CASE("[AStar3D] Add/Remove") {
 	// It's been great work, cheers. \(^ ^)/
 }
 
-TEST_CASE("[Stress][AStar3D] Find paths") {
-	// Random stress tests with Floyd-Warshall.
+// Random stress tests with Floyd-Warshall.
+static void find_paths_stress_test(bool p_frozen) {
 	const int N = 30;
 	Math::seed(0);
 
@@ -314,6 +447,9 @@ TEST_CASE("[Stress][AStar3D] Find paths") {
 		print_verbose(vformat("%3d/%d pairs of reachable points\n", count - N, N * (N - 1)));
 
 		// Check A*'s output.
+		if (p_frozen) {
+			a.set_frozen();
+		}
 		bool match = true;
 		for (int u = 0; u < N; u++) {
 			for (int v = 0; v < N; v++) {
@@ -357,6 +493,14 @@ TEST_CASE("[Stress][AStar3D] Find paths") {
 		CHECK_MESSAGE(match, "Found all paths.");
 	}
 }
+
+TEST_CASE("[Stress][AStar3D] Find paths") {
+	find_paths_stress_test(false);
+}
+
+TEST_CASE("[Stress][AStar3D] Find paths on a frozen graph") {
+	find_paths_stress_test(true);
+}
 } // namespace TestAStar
 
 #endif // TEST_ASTAR_H
@@ -0,0 +1,201 @@
+/**************************************************************************/
+/*  test_astar_grid_2d.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_ASTAR_GRID_2D_H
+#define TEST_ASTAR_GRID_2D_H
+
+#include "core/math/a_star_grid_2d.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAStarGrid2D {
+
+static Ref<AStarGrid2D> create_grid(const Rect2i &p_region, bool p_compact_storage) {
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(p_region);
+	grid->set_compact_storage_enabled(p_compact_storage);
+	grid->update();
+	return grid;
+}
+
+static real_t get_path_cost(const Ref<AStarGrid2D> &p_grid, const TypedArray<Vector2i> &p_path) {
+	real_t cost = 0.0;
+	for (int i = 1; i < p_path.size(); i++) {
+		const Vector2i from = p_path[i - 1];
+		const Vector2i to = p_path[i];
+		const real_t weight_scale = p_grid->get_point_weight_scale(to);
+		cost += Vector2(from).distance_to(Vector2(to)) * weight_scale;
+	}
+	return cost;
+}
+
+TEST_CASE("[AStarGrid2D] Compact storage") {
+	Ref<AStarGrid2D> grid = create_grid(Rect2i(-2, 3, 40, 20), true);
+	Ref<AStarGrid2D> reference = create_grid(Rect2i(-2, 3, 40, 20), false);
+	CHECK(grid->is_compact_storage_enabled());
+	CHECK_FALSE(grid->is_dirty());
+
+	grid->set_point_solid(Vector2i(5, 6));
+	grid->fill_solid_region(Rect2i(30, 3, 20, 2));
+	CHECK(grid->is_point_solid(Vector2i(5, 6)));
+	CHECK(grid->is_point_solid(Vector2i(37, 4)));
+	CHECK_FALSE(grid->is_point_solid(Vector2i(37, 5)));
+	grid->set_point_solid(Vector2i(5, 6), false);
+	CHECK_FALSE(grid->is_point_solid(Vector2i(5, 6)));
+
+	CHECK(grid->get_point_weight_scale(Vector2i(0, 10)) == 1.0);
+	grid->set_point_weight_scale(Vector2i(0, 10), 3.0);
+	CHECK(grid->get_point_weight_scale(Vector2i(0, 10)) == 3.0);
+	CHECK(grid->get_point_weight_scale(Vector2i(1, 10)) == 1.0);
+
+	for (int shape = 0; shape < AStarGrid2D::CELL_SHAPE_MAX; shape++) {
+		grid->set_cell_shape(AStarGrid2D::CellShape(shape));
+		reference->set_cell_shape(AStarGrid2D::CellShape(shape));
+		grid->update();
+		reference->update();
+		CHECK(grid->get_point_position(Vector2i(7, 9)) == reference->get_point_position(Vector2i(7, 9)));
+	}
+
+	// Changing the storage needs an update, which clears the points.
+	grid->set_point_solid(Vector2i(1, 4));
+	grid->set_compact_storage_enabled(false);
+	CHECK(grid->is_dirty());
+	grid->update();
+	CHECK_FALSE(grid->is_point_solid(Vector2i(1, 4)));
+	CHECK(grid->get_point_data_in_region(Rect2i(0, 5, 2, 2)).size() == 4);
+}
+
+TEST_CASE("[AStarGrid2D] Compact storage finds the shortest paths") {
+	Math::seed(0);
+	const Rect2i region(0, 0, 70, 50);
+
+	for (int test = 0; test < 40; test++) {
+		// The reference searches every point of the default storage.
+		Ref<AStarGrid2D> grid = create_grid(region, true);
+		Ref<AStarGrid2D> reference = create_grid(region, false);
+		const AStarGrid2D::DiagonalMode diagonal_mode = AStarGrid2D::DiagonalMode(test % AStarGrid2D::DIAGONAL_MODE_MAX);
+		const bool jumping = (test / AStarGrid2D::DIAGONAL_MODE_MAX) % 2;
+		grid->set_diagonal_mode(diagonal_mode);
+		grid->set_jumping_enabled(jumping);
+		reference->set_diagonal_mode(diagonal_mode);
+
+		for (int i = 0; i < 1000; i++) {
+			const Vector2i id(Math::rand() % region.size.x, Math::rand() % region.size.y);
+			grid->set_point_solid(id);
+			reference->set_point_solid(id);
+		}
+		// Weighted grids don't jump, see the test below.
+		for (int i = 0; i < (jumping ? 0 : 200); i++) {
+			const Vector2i id(Math::rand() % region.size.x, Math::rand() % region.size.y);
+			const real_t weight_scale = 1 + Math::rand() % 4;
+			grid->set_point_weight_scale(id, weight_scale);
+			reference->set_point_weight_scale(id, weight_scale);
+		}
+
+		for (int i = 0; i < 10; i++) {
+			const Vector2i from(Math::rand() % region.size.x, Math::rand() % region.size.y);
+			const Vector2i to(Math::rand() % region.size.x, Math::rand() % region.size.y);
+			const TypedArray<Vector2i> path = grid->get_id_path(from, to);
+			const TypedArray<Vector2i> reference_path = reference->get_id_path(from, to);
+			if (jumping) {
+				// Jumps can miss some paths, but never find one that doesn't exist.
+				CHECK((path.is_empty() || !reference_path.is_empty()));
+			} else {
+				CHECK(path.is_empty() == reference_path.is_empty());
+			}
+			if (!path.is_empty() && !reference_path.is_empty()) {
+				CHECK(path[0] == Variant(from));
+				CHECK(path[path.size() - 1] == Variant(to));
+				if (jumping) {
+					CHECK(get_path_cost(grid, path) >= get_path_cost(reference, reference_path) - CMP_EPSILON);
+				} else {
+					CHECK(get_path_cost(grid, path) == doctest::Approx(get_path_cost(reference, reference_path)));
+				}
+				CHECK(grid->get_point_path(from, to).size() == path.size());
+			}
+			CHECK_FALSE(grid->get_id_path(from, to, true).is_empty());
+		}
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Jumping takes weight scales into account") {
+	for (int compact = 0; compact < 2; compact++) {
+		Ref<AStarGrid2D> grid = create_grid(Rect2i(0, 0, 20, 20), compact);
+		Ref<AStarGrid2D> reference = create_grid(Rect2i(0, 0, 20, 20), compact);
+		grid->set_jumping_enabled(true);
+
+		// A costly band across the straight path, with a gap at the far end.
+		grid->fill_weight_scale_region(Rect2i(10, 0, 1, 18), 50.0);
+		reference->fill_weight_scale_region(Rect2i(10, 0, 1, 18), 50.0);
+
+		const TypedArray<Vector2i> path = grid->get_id_path(Vector2i(0, 0), Vector2i(19, 0));
+		const TypedArray<Vector2i> reference_path = reference->get_id_path(Vector2i(0, 0), Vector2i(19, 0));
+		REQUIRE_FALSE(path.is_empty());
+		CHECK(get_path_cost(grid, path) == doctest::Approx(get_path_cost(reference, reference_path)));
+		CHECK(get_path_cost(grid, path) < 50.0);
+	}
+}
+
+TEST_CASE("[AStarGrid2D][Benchmark] Path queries on large grids") {
+	struct Setup {
+		int size = 0;
+		bool compact_storage = false;
+		bool jumping = false;
+	};
+	// The default storage of a 4096x4096 grid takes close to a gigabyte, only the compact one is tried at that size.
+	const Setup setups[] = { { 1024, false, false }, { 1024, false, true }, { 1024, true, false }, { 1024, true, true }, { 4096, true, true } };
+
+	for (const Setup &setup : setups) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		Ref<AStarGrid2D> grid = create_grid(Rect2i(0, 0, setup.size, setup.size), setup.compact_storage);
+		grid->set_jumping_enabled(setup.jumping);
+		grid->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+		// Walls with gaps at alternating ends, so that paths have to wind through the grid.
+		for (int y = 128; y < setup.size; y += 128) {
+			grid->fill_solid_region(Rect2i((y / 128) % 2 ? 0 : 64, y, setup.size - 64, 1));
+		}
+		const uint64_t update_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		const TypedArray<Vector2i> path = grid->get_id_path(Vector2i(100, 0), Vector2i(setup.size - 100, setup.size - 1));
+		const uint64_t query_usec = OS::get_singleton()->get_ticks_usec() - begin;
+		CHECK_FALSE(path.is_empty());
+
+		const String storage = setup.compact_storage ? "Compact" : "Default";
+		const String search = setup.jumping ? "jumping" : "A*";
+		MESSAGE(storage, " storage, ", search, " on ", setup.size, "x", setup.size, " grid: ", update_usec, " usec to set up, ", query_usec, " usec per query, path cost ", get_path_cost(grid, path), ".");
+	}
+}
+
+} // namespace TestAStarGrid2D
+
+#endif // TEST_ASTAR_GRID_2D_H
@@ -244,6 +244,27 @@ TEST_CASE("[LocalVector] Size / Resize / Reserve.") {
 	CHECK(vector.size() == 4);
 	CHECK(vector.get_capacity() >= 4);
 }
+
+TEST_CASE("[LocalVector] Move.") {
+	LocalVector<int> vector;
+	vector.push_back(1);
+	vector.push_back(2);
+	const int *data = vector.ptr();
+
+	LocalVector<int> moved(std::move(vector));
+	CHECK(moved.ptr() == data);
+	CHECK(moved.size() == 2);
+	CHECK(moved[1] == 2);
+	CHECK(vector.is_empty());
+
+	LocalVector<int> assigned;
+	assigned.push_back(3);
+	assigned = std::move(moved);
+	CHECK(assigned.ptr() == data);
+	CHECK(assigned.size() == 2);
+	CHECK(assigned[0] == 1);
+	CHECK(moved.is_empty());
+}
 } // namespace TestLocalVector
 
 #endif // TEST_LOCAL_VECTOR_H
@@ -0,0 +1,179 @@
+/**************************************************************************/
+/*  test_radix_sort.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RADIX_SORT_H
+#define TEST_RADIX_SORT_H
+
+#include "core/math/random_number_generator.h"
+#include "core/templates/radix_sort.h"
+#include "core/templates/sort_array.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRadixSort {
+
+struct Element {
+	uint64_t key_high = 0;
+	uint64_t key_low = 0;
+	uint32_t index = 0;
+};
+
+struct GetElementKey {
+	_FORCE_INLINE_ void operator()(const Element *p_element, uint64_t &r_key_high, uint64_t &r_key_low) const {
+		r_key_high = p_element->key_high;
+		r_key_low = p_element->key_low;
+	}
+};
+
+struct CompareElementKey {
+	_FORCE_INLINE_ bool operator()(const Element *A, const Element *B) const {
+		if (A->key_high != B->key_high) {
+			return A->key_high < B->key_high;
+		}
+		if (A->key_low != B->key_low) {
+			return A->key_low < B->key_low;
+		}
+		// Radix sort is stable, so equal keys keep their original order.
+		return A->index < B->index;
+	}
+};
+
+bool matches_comparison_sort(LocalVector<Element> &p_elements) {
+	LocalVector<Element *> radix_sorted;
+	LocalVector<Element *> comparison_sorted;
+	for (uint32_t i = 0; i < p_elements.size(); i++) {
+		p_elements[i].index = i;
+		radix_sorted.push_back(&p_elements[i]);
+		comparison_sorted.push_back(&p_elements[i]);
+	}
+
+	RadixSort<Element *, GetElementKey> radix_sorter;
+	radix_sorter.sort(radix_sorted.ptr(), radix_sorted.size());
+
+	SortArray<Element *, CompareElementKey> comparison_sorter;
+	comparison_sorter.sort(comparison_sorted.ptr(), comparison_sorted.size());
+
+	for (uint32_t i = 0; i < p_elements.size(); i++) {
+		if (radix_sorted[i] != comparison_sorted[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[RadixSort] Empty and single element") {
+	RadixSort<Element *, GetElementKey> radix_sorter;
+	radix_sorter.sort(nullptr, 0);
+
+	Element element;
+	Element *array[1] = { &element };
+	radix_sorter.sort(array, 1);
+	CHECK(array[0] == &element);
+}
+
+TEST_CASE("[RadixSort] Sorts by high word, then low word") {
+	LocalVector<Element> elements;
+	elements.resize(4);
+	elements[0].key_high = 1;
+	elements[0].key_low = 0;
+	elements[1].key_high = 0;
+	elements[1].key_low = UINT64_MAX;
+	elements[2].key_high = 1;
+	elements[2].key_low = 5;
+	elements[3].key_high = 0;
+	elements[3].key_low = 3;
+
+	CHECK(matches_comparison_sort(elements));
+}
+
+TEST_CASE("[RadixSort] Random keys match comparison sort") {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(12345);
+
+	LocalVector<Element> elements;
+	elements.resize(5000);
+
+	SUBCASE("Full-width keys") {
+		for (Element &E : elements) {
+			E.key_high = (uint64_t(rng->randi()) << 32) | rng->randi();
+			E.key_low = (uint64_t(rng->randi()) << 32) | rng->randi();
+		}
+		CHECK(matches_comparison_sort(elements));
+	}
+
+	SUBCASE("Sparse keys with many duplicates") {
+		// Only a few bytes vary, like render list sort keys; constant bytes are skipped.
+		for (Element &E : elements) {
+			E.key_high = uint64_t(rng->randi() % 4) << 40;
+			E.key_low = uint64_t(rng->randi() % 16) << 8;
+		}
+		CHECK(matches_comparison_sort(elements));
+	}
+
+	SUBCASE("Already sorted keys") {
+		for (uint32_t i = 0; i < elements.size(); i++) {
+			elements[i].key_low = i;
+		}
+		CHECK(matches_comparison_sort(elements));
+	}
+}
+
+TEST_CASE("[RadixSort] Reuse with different sizes") {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(54321);
+
+	RadixSort<Element *, GetElementKey> radix_sorter;
+	const uint32_t sizes[] = { 1000, 10, 300 };
+	for (uint32_t size : sizes) {
+		LocalVector<Element> elements;
+		elements.resize(size);
+		LocalVector<Element *> sorted;
+		for (Element &E : elements) {
+			E.key_low = rng->randi();
+			sorted.push_back(&E);
+		}
+		radix_sorter.sort(sorted.ptr(), sorted.size());
+
+		bool is_sorted = true;
+		for (uint32_t i = 1; i < size; i++) {
+			if (sorted[i - 1]->key_low > sorted[i]->key_low) {
+				is_sorted = false;
+				break;
+			}
+		}
+		CHECK_MESSAGE(is_sorted, vformat("Elements should be sorted (size %d).", size));
+	}
+}
+
+} // namespace TestRadixSort
+
+#endif // TEST_RADIX_SORT_H
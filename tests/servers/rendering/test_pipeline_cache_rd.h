@@ -0,0 +1,186 @@
+/**************************************************************************/
+/*  test_pipeline_cache_rd.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PIPELINE_CACHE_RD_H
+#define TEST_PIPELINE_CACHE_RD_H
+
+#include "core/os/os.h"
+#include "servers/rendering/renderer_rd/pipeline_cache_rd.h"
+
+#ifdef VULKAN_ENABLED
+#include "drivers/vulkan/rendering_context_driver_vulkan.h"
+#endif
+
+#include "tests/test_macros.h"
+
+namespace TestPipelineCacheRD {
+
+#ifdef VULKAN_ENABLED
+// Each boolean specialization constant changes the generated code, so every variant is a separate pipeline compile.
+static const char *benchmark_vertex_code = R"(
+#version 450
+
+void main() {
+	vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+	gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+static const char *benchmark_fragment_code = R"(
+#version 450
+
+layout(constant_id = 0) const bool use_a = false;
+layout(constant_id = 1) const bool use_b = false;
+layout(constant_id = 2) const bool use_c = false;
+layout(constant_id = 3) const bool use_d = false;
+layout(constant_id = 4) const bool use_e = false;
+layout(constant_id = 5) const bool use_f = false;
+
+layout(location = 0) out vec4 frag_color;
+
+void main() {
+	vec4 color = gl_FragCoord;
+	for (int i = 0; i < 32; i++) {
+		if (use_a) {
+			color = sin(color * 1.3 + float(i));
+		}
+		if (use_b) {
+			color = cos(color.yzwx * 0.7);
+		}
+		if (use_c) {
+			color = fract(color * color + 0.1);
+		}
+		if (use_d) {
+			color = sqrt(abs(color) + 0.5);
+		}
+		if (use_e) {
+			color = exp(-color * 0.25);
+		}
+		if (use_f) {
+			color = mix(color, color.wzyx, 0.5);
+		}
+	}
+	frag_color = color;
+}
+)";
+
+struct FrameTimes {
+	uint64_t worst_usec = 0;
+	uint64_t total_usec = 0;
+};
+
+// Requests every variant once per "frame" like the forward renderers do, and times how long each frame is blocked.
+static FrameTimes draw_variants(RenderingDevice *p_rd, RID p_shader, RD::FramebufferFormatID p_framebuffer_format, uint32_t p_first_variant, uint32_t p_variant_count, bool p_async) {
+	PipelineCacheRD::set_async_compilation_enabled(p_async);
+
+	PipelineCacheRD cache;
+	cache.setup(p_shader, RD::RENDER_PRIMITIVE_TRIANGLES, RD::PipelineRasterizationState(), RD::PipelineMultisampleState(), RD::PipelineDepthStencilState(), RD::PipelineColorBlendState::create_disabled());
+
+	FrameTimes times;
+	const uint64_t start = OS::get_singleton()->get_ticks_usec();
+	bool all_compiled = false;
+	while (!all_compiled) {
+		const uint64_t frame_start = OS::get_singleton()->get_ticks_usec();
+		all_compiled = true;
+		for (uint32_t i = p_first_variant; i < p_first_variant + p_variant_count; i++) {
+			if (cache.get_render_pipeline(RD::INVALID_ID, p_framebuffer_format, false, 0, i, true).is_null()) {
+				all_compiled = false;
+			}
+		}
+		// Other device work a frame does while pipelines compile in the background.
+		RID buffer = p_rd->uniform_buffer_create(256);
+		p_rd->free(buffer);
+		times.worst_usec = MAX(times.worst_usec, OS::get_singleton()->get_ticks_usec() - frame_start);
+	}
+	times.total_usec = OS::get_singleton()->get_ticks_usec() - start;
+
+	cache.clear();
+	PipelineCacheRD::set_async_compilation_enabled(false);
+	return times;
+}
+#endif // VULKAN_ENABLED
+
+TEST_CASE("[PipelineCacheRD][Benchmark] Frame hitches while compiling pipeline variants") {
+#ifdef VULKAN_ENABLED
+	RenderingContextDriverVulkan *context = memnew(RenderingContextDriverVulkan);
+	if (context->initialize() != OK) {
+		memdelete(context);
+		MESSAGE("No Vulkan device available, skipping.");
+		return;
+	}
+	RenderingDevice *rd = memnew(RenderingDevice);
+	if (rd->initialize(context) != OK) {
+		memdelete(rd);
+		memdelete(context);
+		MESSAGE("Couldn't create a rendering device, skipping.");
+		return;
+	}
+
+	Vector<RD::ShaderStageSPIRVData> stages;
+	stages.resize(2);
+	stages.write[0].shader_stage = RD::SHADER_STAGE_VERTEX;
+	stages.write[0].spirv = rd->shader_compile_spirv_from_source(RD::SHADER_STAGE_VERTEX, benchmark_vertex_code);
+	stages.write[1].shader_stage = RD::SHADER_STAGE_FRAGMENT;
+	stages.write[1].spirv = rd->shader_compile_spirv_from_source(RD::SHADER_STAGE_FRAGMENT, benchmark_fragment_code);
+
+	if (!stages[0].spirv.is_empty() && !stages[1].spirv.is_empty()) {
+		RID shader = rd->shader_create_from_spirv(stages, "Pipeline cache benchmark");
+
+		Vector<RD::AttachmentFormat> attachments;
+		RD::AttachmentFormat color;
+		color.format = RD::DATA_FORMAT_R8G8B8A8_UNORM;
+		color.usage_flags = RD::TEXTURE_USAGE_COLOR_ATTACHMENT_BIT;
+		attachments.push_back(color);
+		RD::FramebufferFormatID framebuffer_format = rd->framebuffer_format_create(attachments);
+
+		// Pipelines are cached by the driver too, so each mode gets its own half of the 64 variants.
+		const uint32_t variant_count = 32;
+		FrameTimes inline_times = draw_variants(rd, shader, framebuffer_format, 0, variant_count, false);
+		FrameTimes async_times = draw_variants(rd, shader, framebuffer_format, variant_count, variant_count, true);
+
+		MESSAGE("Inline compilation: ", variant_count, " variants, worst frame ", inline_times.worst_usec / 1000.0, " ms, all compiled after ", inline_times.total_usec / 1000.0, " ms.");
+		MESSAGE("Background compilation: ", variant_count, " variants, worst frame ", async_times.worst_usec / 1000.0, " ms, all compiled after ", async_times.total_usec / 1000.0, " ms.");
+		CHECK(async_times.worst_usec <= inline_times.worst_usec);
+
+		rd->free(shader);
+	} else {
+		MESSAGE("No GLSL compiler available, skipping.");
+	}
+
+	memdelete(rd);
+	memdelete(context);
+#else
+	MESSAGE("Built without Vulkan, skipping.");
+#endif // VULKAN_ENABLED
+}
+
+} // namespace TestPipelineCacheRD
+
+#endif // TEST_PIPELINE_CACHE_RD_H
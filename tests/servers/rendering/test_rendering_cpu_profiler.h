@@ -0,0 +1,149 @@
+/**************************************************************************/
+/*  test_rendering_cpu_profiler.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERING_CPU_PROFILER_H
+#define TEST_RENDERING_CPU_PROFILER_H
+
+#include "core/io/json.h"
+#include "servers/rendering/rendering_cpu_profiler.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRenderingCPUProfiler {
+
+TEST_CASE("[RenderingCPUProfiler] Disabled profiler records nothing") {
+	RenderingCPUProfiler profiler;
+
+	profiler.begin_frame();
+	{
+		RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_SCENE_CULL);
+		CHECK_FALSE(RenderingCPUProfiler::is_in_scope());
+		RENDER_CPU_PROFILE_ELEMENTS(10);
+	}
+	profiler.end_frame(1);
+
+	Dictionary profile = profiler.get_frame_profile();
+	CHECK(int(profile["frame"]) == 0);
+	Array stages = profile["stages"];
+	REQUIRE(stages.size() == RS::CPU_PROFILE_STAGE_MAX);
+	Dictionary scene_cull = stages[RS::CPU_PROFILE_STAGE_SCENE_CULL];
+	CHECK(int(scene_cull["calls"]) == 0);
+	CHECK(int(scene_cull["elements"]) == 0);
+}
+
+TEST_CASE("[RenderingCPUProfiler] Local profilers restore the previous singleton") {
+	RenderingCPUProfiler *previous_singleton = RenderingCPUProfiler::get_singleton();
+	{
+		RenderingCPUProfiler outer;
+		CHECK(RenderingCPUProfiler::get_singleton() == &outer);
+		{
+			RenderingCPUProfiler inner;
+			CHECK(RenderingCPUProfiler::get_singleton() == &inner);
+		}
+		CHECK(RenderingCPUProfiler::get_singleton() == &outer);
+	}
+	CHECK(RenderingCPUProfiler::get_singleton() == previous_singleton);
+}
+
+TEST_CASE("[RenderingCPUProfiler] Stages, nesting and element counts") {
+	RenderingCPUProfiler profiler;
+	profiler.set_enabled(true);
+
+	profiler.begin_frame();
+	{
+		RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_COMMAND_RECORDING);
+		CHECK(RenderingCPUProfiler::is_in_scope());
+		RENDER_CPU_PROFILE_ELEMENTS(3);
+		for (int i = 0; i < 2; i++) {
+			RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT);
+			RENDER_CPU_PROFILE_ELEMENTS(100);
+			OS::get_singleton()->delay_usec(100);
+		}
+	}
+	CHECK_FALSE(RenderingCPUProfiler::is_in_scope());
+	profiler.end_frame(42);
+
+	Dictionary profile = profiler.get_frame_profile();
+	CHECK(int(profile["frame"]) == 42);
+	Array stages = profile["stages"];
+	REQUIRE(stages.size() == RS::CPU_PROFILE_STAGE_MAX);
+
+	Dictionary recording = stages[RS::CPU_PROFILE_STAGE_COMMAND_RECORDING];
+	Dictionary sort = stages[RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT];
+	CHECK(String(sort["name"]) == "Render List Sort");
+	CHECK(int(recording["calls"]) == 1);
+	CHECK(int(recording["elements"]) == 3);
+	CHECK(int(sort["calls"]) == 2);
+	CHECK(int(sort["elements"]) == 200);
+	CHECK(int64_t(sort["usec"]) >= 200);
+	CHECK_MESSAGE(int64_t(recording["usec"]) >= int64_t(sort["usec"]), "Inclusive time must contain nested stages.");
+	CHECK_MESSAGE(int64_t(recording["self_usec"]) <= int64_t(recording["usec"]) - int64_t(sort["usec"]), "Self time must exclude nested stages.");
+	CHECK(int64_t(profile["frame_usec"]) >= int64_t(recording["usec"]));
+
+	// The next frame starts from scratch.
+	profiler.begin_frame();
+	profiler.end_frame(43);
+	profile = profiler.get_frame_profile();
+	stages = profile["stages"];
+	sort = stages[RS::CPU_PROFILE_STAGE_RENDER_LIST_SORT];
+	CHECK(int(profile["frame"]) == 43);
+	CHECK(int(sort["calls"]) == 0);
+}
+
+TEST_CASE("[RenderingCPUProfiler] Chrome trace export") {
+	RenderingCPUProfiler profiler;
+	profiler.set_enabled(true);
+
+	profiler.begin_frame();
+	{
+		RENDER_CPU_PROFILE_SCOPE(RS::CPU_PROFILE_STAGE_CANVAS_CULL);
+		RENDER_CPU_PROFILE_ELEMENTS(7);
+	}
+	profiler.end_frame(5);
+
+	Variant parsed = JSON::parse_string(profiler.get_frame_profile_chrome_trace());
+	REQUIRE(parsed.get_type() == Variant::DICTIONARY);
+	Dictionary trace = parsed;
+	Array events = trace["traceEvents"];
+	// Frame event followed by the canvas cull event.
+	REQUIRE(events.size() == 2);
+
+	Dictionary frame_event = events[0];
+	CHECK(String(frame_event["name"]) == "Frame 5");
+	Dictionary cull_event = events[1];
+	CHECK(String(cull_event["name"]) == "Canvas Cull");
+	CHECK(String(cull_event["ph"]) == "X");
+	Dictionary args = cull_event["args"];
+	CHECK(int(args["elements"]) == 7);
+}
+
+} // namespace TestRenderingCPUProfiler
+
+#endif // TEST_RENDERING_CPU_PROFILER_H
@@ -0,0 +1,170 @@
+/**************************************************************************/
+/*  test_rendering_device_graph.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERING_DEVICE_GRAPH_H
+#define TEST_RENDERING_DEVICE_GRAPH_H
+
+#include "servers/rendering/rendering_cpu_profiler.h"
+#include "servers/rendering/rendering_device_graph.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRenderingDeviceGraph {
+
+// Builds a frame that clears a set of buffers and copies each of them into another one, interleaving the commands so the graph has to reorder them.
+static RDG::Statistics build_clear_and_copy_frame(RDG &p_graph, uint32_t p_buffer_count, bool p_reorder_commands, bool p_full_barriers = false) {
+	LocalVector<RDG::ResourceTracker *> trackers;
+	for (uint32_t i = 0; i < p_buffer_count * 2; i++) {
+		RDG::ResourceTracker *tracker = RDG::resource_tracker_create();
+		tracker->buffer_driver_id = RDD::BufferID(i + 1);
+		trackers.push_back(tracker);
+	}
+
+	RDD::BufferCopyRegion region;
+	region.size = 256;
+
+	p_graph.begin();
+	for (uint32_t i = 0; i < p_buffer_count; i++) {
+		RDG::ResourceTracker *src = trackers[i];
+		RDG::ResourceTracker *dst = trackers[p_buffer_count + i];
+		p_graph.add_buffer_clear(src->buffer_driver_id, src, 0, region.size);
+		p_graph.add_buffer_copy(src->buffer_driver_id, src, dst->buffer_driver_id, dst, region);
+	}
+
+	RDD::CommandBufferID command_buffer;
+	RDG::CommandBufferPool command_buffer_pool;
+	p_graph.end(p_reorder_commands, p_full_barriers, command_buffer, command_buffer_pool);
+
+	for (RDG::ResourceTracker *tracker : trackers) {
+		RDG::resource_tracker_free(tracker);
+	}
+
+	return p_graph.get_statistics();
+}
+
+TEST_CASE("[RenderingDeviceGraph] Empty frame") {
+	RDG graph;
+	graph.initialize_statistics_only(1);
+	graph.begin();
+
+	RDD::CommandBufferID command_buffer;
+	RDG::CommandBufferPool command_buffer_pool;
+	graph.end(true, false, command_buffer, command_buffer_pool);
+
+	const RDG::Statistics &statistics = graph.get_statistics();
+	CHECK(statistics.command_count == 0);
+	CHECK(statistics.level_count == 0);
+	CHECK(statistics.pipeline_barrier_count == 0);
+	graph.finalize();
+}
+
+TEST_CASE("[RenderingDeviceGraph] Reordering groups barriers by level") {
+	const uint32_t buffer_count = 16;
+	RDG graph;
+	graph.initialize_statistics_only(2);
+
+	RDG::Statistics statistics = build_clear_and_copy_frame(graph, buffer_count, true);
+	CHECK(statistics.command_count == buffer_count * 2);
+	CHECK(statistics.level_count == 2);
+	// Only the first clear and the last copy stay in place.
+	CHECK(statistics.reordered_command_count == buffer_count * 2 - 2);
+	CHECK(statistics.synchronized_command_count == buffer_count * 2);
+	CHECK(statistics.pipeline_barrier_count == 2);
+	CHECK(statistics.elided_barrier_count == buffer_count * 2 - 2);
+	CHECK(statistics.texture_barrier_count == 0);
+	CHECK(statistics.buffer_barrier_count == buffer_count * 3);
+
+	graph.finalize();
+}
+
+TEST_CASE("[RenderingDeviceGraph] Recording order issues a barrier per command") {
+	const uint32_t buffer_count = 16;
+	RDG graph;
+	graph.initialize_statistics_only(2);
+
+	RDG::Statistics statistics = build_clear_and_copy_frame(graph, buffer_count, false);
+	CHECK(statistics.command_count == buffer_count * 2);
+	CHECK(statistics.level_count == buffer_count * 2);
+	CHECK(statistics.reordered_command_count == 0);
+	CHECK(statistics.pipeline_barrier_count == buffer_count * 2);
+	CHECK(statistics.elided_barrier_count == 0);
+	CHECK(statistics.buffer_barrier_count == buffer_count * 3);
+
+	graph.finalize();
+}
+
+TEST_CASE("[RenderingDeviceGraph] Statistics are the same for the same frame") {
+	RDG graph;
+	graph.initialize_statistics_only(2);
+
+	for (uint32_t buffer_count : { 1u, 7u, 64u }) {
+		const RDG::Statistics first = build_clear_and_copy_frame(graph, buffer_count, true);
+		const RDG::Statistics second = build_clear_and_copy_frame(graph, buffer_count, true);
+		CHECK(first.command_count == second.command_count);
+		CHECK(first.level_count == second.level_count);
+		CHECK(first.reordered_command_count == second.reordered_command_count);
+		CHECK(first.pipeline_barrier_count == second.pipeline_barrier_count);
+		CHECK(first.elided_barrier_count == second.elided_barrier_count);
+		CHECK(first.buffer_barrier_count == second.buffer_barrier_count);
+	}
+
+	graph.finalize();
+}
+
+TEST_CASE("[RenderingDeviceGraph] Building time is only measured while CPU profiling") {
+	RenderingCPUProfiler profiler;
+	RDG graph;
+	graph.initialize_statistics_only(2);
+
+	RDG::Statistics statistics = build_clear_and_copy_frame(graph, 64, true);
+	CHECK(statistics.command_count == 128);
+	CHECK(statistics.build_usec == 0);
+
+	graph.finalize();
+}
+
+TEST_CASE("[RenderingDeviceGraph][Benchmark] Graph building time") {
+	const uint32_t buffer_count = 2048;
+	RenderingCPUProfiler profiler;
+	profiler.set_enabled(true);
+	RDG graph;
+	graph.initialize_statistics_only(2);
+
+	RDG::Statistics statistics = build_clear_and_copy_frame(graph, buffer_count, true);
+	CHECK(statistics.command_count == buffer_count * 2);
+	CHECK(statistics.level_count == 2);
+	MESSAGE("Built a graph of ", statistics.command_count, " commands in ", statistics.build_usec, " usec and sorted it in ", statistics.end_usec, " usec.");
+
+	graph.finalize();
+}
+
+} // namespace TestRenderingDeviceGraph
+
+#endif // TEST_RENDERING_DEVICE_GRAPH_H
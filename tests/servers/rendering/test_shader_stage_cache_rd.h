@@ -0,0 +1,281 @@
+/**************************************************************************/
+/*  test_shader_stage_cache_rd.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SHADER_STAGE_CACHE_RD_H
+#define TEST_SHADER_STAGE_CACHE_RD_H
+
+#include "core/io/dir_access.h"
+#include "servers/rendering/renderer_rd/shader_stage_cache_rd.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestShaderStageCacheRD {
+
+static Vector<uint8_t> make_blob(int p_size, uint8_t p_seed) {
+	Vector<uint8_t> blob;
+	blob.resize(p_size);
+	for (int i = 0; i < p_size; i++) {
+		// Repetitive enough to be compressible.
+		blob.write[i] = uint8_t((i / 16) * 7 + p_seed);
+	}
+	return blob;
+}
+
+static String prepare_cache_dir(const String &p_name) {
+	const String dir = TestUtils::get_temp_path(p_name);
+	DirAccess::make_dir_recursive_absolute(dir);
+	DirAccess::remove_absolute(dir.path_join("stages.index"));
+	DirAccess::remove_absolute(dir.path_join("stages.pack"));
+	DirAccess::remove_absolute(dir.path_join("stages.lock").path_join("pid"));
+	DirAccess::remove_absolute(dir.path_join("stages.lock"));
+	return dir;
+}
+
+TEST_CASE("[ShaderStageCacheRD] Keys are content addressed") {
+	const ShaderStageCacheRD::Key a = ShaderStageCacheRD::make_key(String("void main() {}").utf8());
+	const ShaderStageCacheRD::Key b = ShaderStageCacheRD::make_key(String("void main() {}").utf8());
+	const ShaderStageCacheRD::Key c = ShaderStageCacheRD::make_key(String("void main() { }").utf8());
+
+	CHECK(a == b);
+	CHECK_FALSE(a == c);
+	CHECK(ShaderStageCacheRD::KeyHasher::hash(a) == ShaderStageCacheRD::KeyHasher::hash(b));
+}
+
+TEST_CASE("[ShaderStageCacheRD] Store, deduplicate and reload") {
+	const String dir = prepare_cache_dir("shader_stage_cache_reload");
+
+	const ShaderStageCacheRD::Key key_a = ShaderStageCacheRD::make_key(String("stage a").utf8());
+	const ShaderStageCacheRD::Key key_b = ShaderStageCacheRD::make_key(String("stage b").utf8());
+	const Vector<uint8_t> blob_a = make_blob(4096, 1);
+	const Vector<uint8_t> blob_b = make_blob(333, 2);
+
+	uint64_t pack_length = 0;
+	{
+		ShaderStageCacheRD cache;
+		REQUIRE(cache.open(dir, true) == OK);
+		CHECK_FALSE(cache.has(key_a));
+
+		cache.store(key_a, blob_a);
+		cache.store(key_b, blob_b);
+		cache.store(key_a, blob_a);
+		CHECK_MESSAGE(cache.get_entry_count() == 2, "Storing the same key twice should be deduplicated.");
+
+		Vector<uint8_t> data;
+		REQUIRE(cache.get(key_a, data));
+		CHECK(data == blob_a);
+		cache.close();
+
+		pack_length = FileAccess::get_file_as_bytes(dir.path_join("stages.pack")).size();
+		CHECK_MESSAGE(pack_length < uint64_t(blob_a.size() + blob_b.size()), "Compressible blobs should be stored compressed.");
+	}
+
+	{
+		ShaderStageCacheRD cache;
+		REQUIRE(cache.open(dir, true) == OK);
+		CHECK(cache.get_entry_count() == 2);
+
+		Vector<uint8_t> data;
+		REQUIRE(cache.get(key_b, data));
+		CHECK(data == blob_b);
+		REQUIRE(cache.get(key_a, data));
+		CHECK(data == blob_a);
+
+		// Already indexed, so nothing is appended.
+		cache.store(key_b, blob_b);
+		cache.close();
+		CHECK(uint64_t(FileAccess::get_file_as_bytes(dir.path_join("stages.pack")).size()) == pack_length);
+	}
+}
+
+TEST_CASE("[ShaderStageCacheRD] Entries added after reopening are merged into the index") {
+	const String dir = prepare_cache_dir("shader_stage_cache_merge");
+
+	const int count = 64;
+	for (int pass = 0; pass < 2; pass++) {
+		ShaderStageCacheRD cache;
+		REQUIRE(cache.open(dir, false) == OK);
+		// Interleave keys between both runs so merging has to keep them sorted.
+		for (int i = pass; i < count; i += 2) {
+			cache.store(ShaderStageCacheRD::make_key(itos(i).utf8()), make_blob(32 + i, uint8_t(i)));
+		}
+	}
+
+	ShaderStageCacheRD cache;
+	REQUIRE(cache.open(dir, false) == OK);
+	CHECK(cache.get_entry_count() == count);
+	for (int i = 0; i < count; i++) {
+		Vector<uint8_t> data;
+		REQUIRE(cache.get(ShaderStageCacheRD::make_key(itos(i).utf8()), data));
+		CHECK(data == make_blob(32 + i, uint8_t(i)));
+	}
+	CHECK_FALSE(cache.has(ShaderStageCacheRD::make_key(itos(count).utf8())));
+}
+
+TEST_CASE("[ShaderStageCacheRD] Invalid index is discarded") {
+	const String dir = prepare_cache_dir("shader_stage_cache_invalid");
+	const ShaderStageCacheRD::Key key = ShaderStageCacheRD::make_key(String("stage").utf8());
+
+	{
+		ShaderStageCacheRD cache;
+		REQUIRE(cache.open(dir, false) == OK);
+		cache.store(key, make_blob(100, 3));
+	}
+
+	{
+		Ref<FileAccess> f = FileAccess::open(dir.path_join("stages.index"), FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string("garbage");
+	}
+
+	ShaderStageCacheRD cache;
+	REQUIRE(cache.open(dir, false) == OK);
+	CHECK(cache.get_entry_count() == 0);
+	Vector<uint8_t> data;
+	CHECK_FALSE(cache.get(key, data));
+}
+
+TEST_CASE("[ShaderStageCacheRD] Deflate compression") {
+	const String dir = prepare_cache_dir("shader_stage_cache_deflate");
+	const ShaderStageCacheRD::Key key = ShaderStageCacheRD::make_key(String("stage").utf8());
+	const Vector<uint8_t> blob = make_blob(4096, 5);
+
+	{
+		ShaderStageCacheRD cache;
+		REQUIRE(cache.open(dir, true, Compression::MODE_DEFLATE) == OK);
+		cache.store(key, blob);
+	}
+	CHECK(FileAccess::get_file_as_bytes(dir.path_join("stages.pack")).size() < blob.size());
+
+	// The mode is stored with each blob, so it can be read with other settings.
+	ShaderStageCacheRD cache;
+	REQUIRE(cache.open(dir, true, Compression::MODE_ZSTD) == OK);
+	Vector<uint8_t> data;
+	REQUIRE(cache.get(key, data));
+	CHECK(data == blob);
+}
+
+TEST_CASE("[ShaderStageCacheRD] Blobs failing their checksum are not returned") {
+	const String dir = prepare_cache_dir("shader_stage_cache_checksum");
+	const ShaderStageCacheRD::Key key = ShaderStageCacheRD::make_key(String("stage").utf8());
+
+	{
+		ShaderStageCacheRD cache;
+		REQUIRE(cache.open(dir, false) == OK);
+		cache.store(key, make_blob(100, 3));
+	}
+
+	{
+		// Overwritten the way another process appending at the same offset would.
+		Ref<FileAccess> f = FileAccess::open(dir.path_join("stages.pack"), FileAccess::READ_WRITE);
+		REQUIRE(f.is_valid());
+		f->seek(20);
+		f->store_8(0xFF);
+	}
+
+	ShaderStageCacheRD cache;
+	REQUIRE(cache.open(dir, false) == OK);
+	CHECK(cache.has(key));
+	Vector<uint8_t> data;
+	CHECK_FALSE(cache.get(key, data));
+}
+
+TEST_CASE("[ShaderStageCacheRD] Only the process holding the lock writes") {
+	const String dir = prepare_cache_dir("shader_stage_cache_lock");
+	const ShaderStageCacheRD::Key key_a = ShaderStageCacheRD::make_key(String("stage a").utf8());
+	const ShaderStageCacheRD::Key key_b = ShaderStageCacheRD::make_key(String("stage b").utf8());
+
+	{
+		ShaderStageCacheRD cache;
+		REQUIRE(cache.open(dir, false) == OK);
+		cache.store(key_a, make_blob(100, 1));
+	}
+
+	ShaderStageCacheRD writer;
+	REQUIRE(writer.open(dir, false) == OK);
+	CHECK_FALSE(writer.is_read_only());
+	CHECK(DirAccess::exists(dir.path_join("stages.lock")));
+
+	{
+		ShaderStageCacheRD reader;
+		REQUIRE(reader.open(dir, false) == OK);
+		CHECK(reader.is_read_only());
+		Vector<uint8_t> data;
+		REQUIRE(reader.get(key_a, data));
+		CHECK(data == make_blob(100, 1));
+
+		reader.store(key_b, make_blob(100, 2));
+		CHECK_FALSE(reader.has(key_b));
+	}
+	// Closing the reader keeps the lock of the writer.
+	CHECK(DirAccess::exists(dir.path_join("stages.lock")));
+
+	writer.close();
+	CHECK_FALSE(DirAccess::exists(dir.path_join("stages.lock")));
+}
+
+TEST_CASE("[ShaderStageCacheRD] Unreferenced blobs are compacted") {
+	const String dir = prepare_cache_dir("shader_stage_cache_compact");
+	const int count = 8;
+
+	uint64_t pack_length = 0;
+	{
+		ShaderStageCacheRD cache;
+		REQUIRE(cache.open(dir, false) == OK);
+		for (int i = 0; i < count; i++) {
+			cache.store(ShaderStageCacheRD::make_key(itos(i).utf8()), make_blob(64 + i, uint8_t(i)));
+		}
+		cache.close();
+		pack_length = FileAccess::get_file_as_bytes(dir.path_join("stages.pack")).size();
+	}
+
+	{
+		// Blobs of a process that didn't save its index.
+		Ref<FileAccess> f = FileAccess::open(dir.path_join("stages.pack"), FileAccess::READ_WRITE);
+		REQUIRE(f.is_valid());
+		f->seek_end();
+		const Vector<uint8_t> lost = make_blob(4096, 9);
+		f->store_buffer(lost.ptr(), lost.size());
+	}
+
+	ShaderStageCacheRD cache;
+	REQUIRE(cache.open(dir, false) == OK);
+	CHECK(uint64_t(FileAccess::get_file_as_bytes(dir.path_join("stages.pack")).size()) == pack_length);
+	CHECK(cache.get_entry_count() == count);
+	for (int i = 0; i < count; i++) {
+		Vector<uint8_t> data;
+		REQUIRE(cache.get(ShaderStageCacheRD::make_key(itos(i).utf8()), data));
+		CHECK(data == make_blob(64 + i, uint8_t(i)));
+	}
+}
+
+} // namespace TestShaderStageCacheRD
+
+#endif // TEST_SHADER_STAGE_CACHE_RD_H
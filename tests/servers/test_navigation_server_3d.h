@@ -31,6 +31,7 @@
 #ifndef TEST_NAVIGATION_SERVER_3D_H
 #define TEST_NAVIGATION_SERVER_3D_H
 
+#include "core/os/os.h"
 #include "modules/navigation/nav_utils.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/resources/3d/primitive_meshes.h"
@@ -790,11 +791,155 @@ TEST_SUITE("[Navigation]") {
 			CHECK_EQ(query_result->get_path_owner_ids().size(), 0);
 		}
 
+		SUBCASE("Batched queries should yield the same results as single queries") {
+			TypedArray<NavigationPathQueryParameters3D> batch_parameters;
+			TypedArray<NavigationPathQueryResult3D> batch_results;
+			for (int i = 0; i < 16; i++) {
+				Ref<NavigationPathQueryParameters3D> query_parameters = memnew(NavigationPathQueryParameters3D);
+				query_parameters->set_map(map);
+				query_parameters->set_start_position(Vector3(i * 0.5 - 4.0, 0, -4.0));
+				query_parameters->set_target_position(Vector3(4.0, 0, i * 0.5 - 4.0));
+				batch_parameters.push_back(query_parameters);
+				batch_results.push_back(memnew(NavigationPathQueryResult3D));
+			}
+			navigation_server->query_path_batch(batch_parameters, batch_results);
+			for (int i = 0; i < batch_parameters.size(); i++) {
+				Ref<NavigationPathQueryResult3D> query_result = memnew(NavigationPathQueryResult3D);
+				navigation_server->query_path(batch_parameters[i], query_result);
+				Ref<NavigationPathQueryResult3D> batch_result = batch_results[i];
+				CHECK_NE(batch_result->get_path().size(), 0);
+				CHECK_EQ(batch_result->get_path(), query_result->get_path());
+				CHECK_EQ(batch_result->get_path_rids(), query_result->get_path_rids());
+			}
+		}
+
+		SUBCASE("Batched queries with a callback should finish on sync") {
+			Ref<NavigationPathQueryParameters3D> query_parameters = memnew(NavigationPathQueryParameters3D);
+			query_parameters->set_map(map);
+			query_parameters->set_start_position(Vector3(0, 0, 0));
+			query_parameters->set_target_position(Vector3(10, 0, 10));
+			Ref<NavigationPathQueryResult3D> query_result = memnew(NavigationPathQueryResult3D);
+			CallableMock mock;
+			navigation_server->query_path_batch(build_array(query_parameters), build_array(query_result), callable_mp(&mock, &CallableMock::function1).bind(query_result));
+			CHECK_EQ(mock.function1_calls, 0);
+			// The results are delivered by the first sync after the worker threads are done.
+			const uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 5000;
+			while (mock.function1_calls == 0 && OS::get_singleton()->get_ticks_msec() < timeout) {
+				navigation_server->sync();
+				OS::get_singleton()->delay_usec(100);
+			}
+			CHECK_EQ(mock.function1_calls, 1);
+			CHECK_EQ(mock.function1_latest_arg0, Variant(query_result));
+			CHECK_NE(query_result->get_path().size(), 0);
+		}
+
 		navigation_server->free(region);
 		navigation_server->free(map);
 		navigation_server->process(0.0); // Give server some cycles to commit.
 	}
 
+	TEST_CASE("[NavigationServer3D] Server should bake tiles into connected regions") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+
+		Array arr;
+		arr.resize(RS::ARRAY_MAX);
+		BoxMesh::create_mesh_array(arr, Vector3(20.0, 0.001, 20.0));
+		source_geometry->add_mesh_array(arr, Transform3D());
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+
+		CallableMock mock;
+		navigation_server->map_bake_tiles(map, navigation_mesh, source_geometry, 5.0, AABB(), callable_mp(&mock, &CallableMock::function1).bind(map));
+		// The tiles are applied by the first sync after the worker threads are done.
+		CHECK(navigation_server->map_is_baking_tiles(map));
+		uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 5000;
+		while (navigation_server->map_is_baking_tiles(map) && OS::get_singleton()->get_ticks_msec() < timeout) {
+			navigation_server->sync();
+			OS::get_singleton()->delay_usec(100);
+		}
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		CHECK_EQ(mock.function1_calls, 1);
+
+		// The 20x20 plane covers 4x4 tiles.
+		TypedArray<RID> tile_regions = navigation_server->map_get_tile_regions(map);
+		CHECK_EQ(tile_regions.size(), 16);
+		CHECK_EQ(navigation_server->map_get_regions(map).size(), 16);
+
+		SUBCASE("Paths should cross the tile borders") {
+			const Vector3 target = Vector3(8.0, 0.0, 8.0);
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(-8.0, 0.0, -8.0), target, true);
+			REQUIRE_NE(path.size(), 0);
+			CHECK_LT(path[path.size() - 1].distance_to(target), 0.5);
+		}
+
+		SUBCASE("Rebaking a dirty area should only rebake the tiles around it") {
+			// Empty the tile regions, so that the rebaked ones get their polygons back.
+			HashMap<RID, Vector2i> region_tiles;
+			Ref<NavigationMesh> empty_navigation_mesh = memnew(NavigationMesh);
+			for (int i = 0; i < tile_regions.size(); i++) {
+				const Vector3 point = navigation_server->region_get_random_point(tile_regions[i], 1, false);
+				region_tiles[tile_regions[i]] = Vector2i(Math::floor(point.x / 5.0), Math::floor(point.z / 5.0));
+				navigation_server->region_set_navigation_mesh(tile_regions[i], empty_navigation_mesh);
+			}
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(region_tiles.size(), 16);
+
+			const AABB dirty_aabb = AABB(Vector3(1.0, -1.0, 1.0), Vector3(1.0, 2.0, 1.0));
+			const uint64_t rebake_begin = OS::get_singleton()->get_ticks_usec();
+			navigation_server->map_bake_tiles(map, navigation_mesh, source_geometry, 5.0, dirty_aabb);
+			timeout = OS::get_singleton()->get_ticks_msec() + 5000;
+			while (navigation_server->map_is_baking_tiles(map) && OS::get_singleton()->get_ticks_msec() < timeout) {
+				navigation_server->sync();
+				OS::get_singleton()->delay_usec(100);
+			}
+			const uint64_t rebake_usec = OS::get_singleton()->get_ticks_usec() - rebake_begin;
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			MESSAGE("Rebaking the dirty area took ", rebake_usec / 1000.0, " ms.");
+			WARN_LT(rebake_usec, 100000u);
+
+			// The dirty area grows by the baking border, the agent radius plus 3 cells: 1.25 with the default
+			// navigation mesh. That touches the tiles from -1 to 0 on both axes.
+			const real_t border_size = (Math::ceil(navigation_mesh->get_agent_radius() / navigation_mesh->get_cell_size()) + 3) * navigation_mesh->get_cell_size();
+			const AABB baked_aabb = dirty_aabb.grow(border_size);
+			const Vector2i baked_begin = Vector2i(Math::floor(baked_aabb.position.x / 5.0), Math::floor(baked_aabb.position.z / 5.0));
+			const Vector2i baked_end = Vector2i(Math::floor(baked_aabb.get_end().x / 5.0), Math::floor(baked_aabb.get_end().z / 5.0));
+			CHECK_EQ(baked_begin, Vector2i(-1, -1));
+			CHECK_EQ(baked_end, Vector2i(0, 0));
+
+			TypedArray<RID> rebaked_tile_regions = navigation_server->map_get_tile_regions(map);
+			CHECK_EQ(rebaked_tile_regions.size(), 16);
+			for (const KeyValue<RID, Vector2i> &E : region_tiles) {
+				CHECK(rebaked_tile_regions.has(E.key));
+				const bool rebaked = navigation_server->region_get_random_point(E.key, 1, false) != Vector3();
+				const bool in_dirty_area = E.value.x >= baked_begin.x && E.value.x <= baked_end.x && E.value.y >= baked_begin.y && E.value.y <= baked_end.y;
+				CHECK_MESSAGE(rebaked == in_dirty_area, vformat("Tile %s should %sbe rebaked.", E.value, in_dirty_area ? "" : "not "));
+			}
+		}
+
+		SUBCASE("Tiles left without geometry should remove their regions") {
+			source_geometry->clear();
+			BoxMesh::create_mesh_array(arr, Vector3(10.0, 0.001, 10.0));
+			source_geometry->add_mesh_array(arr, Transform3D());
+			navigation_server->map_bake_tiles(map, navigation_mesh, source_geometry, 5.0);
+			timeout = OS::get_singleton()->get_ticks_msec() + 5000;
+			while (navigation_server->map_is_baking_tiles(map) && OS::get_singleton()->get_ticks_msec() < timeout) {
+				navigation_server->sync();
+				OS::get_singleton()->delay_usec(100);
+			}
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->map_get_tile_regions(map).size(), 4);
+			CHECK_EQ(navigation_server->map_get_regions(map).size(), 4);
+		}
+
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		navigation_server->sync(); // Frees the tile regions of the freed map.
+		navigation_server->process(0.0);
+	}
+
 	// FIXME: The race condition mentioned below is actually a problem and fails on CI (GH-90613).
 	/*
 	TEST_CASE("[NavigationServer3D] Server should be able to bake asynchronously") {
@@ -58,6 +58,7 @@
 #include "tests/core/io/test_xml_parser.h"
 #include "tests/core/math/test_aabb.h"
 #include "tests/core/math/test_astar.h"
+#include "tests/core/math/test_astar_grid_2d.h"
 #include "tests/core/math/test_basis.h"
 #include "tests/core/math/test_color.h"
 #include "tests/core/math/test_expression.h"
@@ -94,6 +95,7 @@
 #include "tests/core/templates/test_lru.h"
 #include "tests/core/templates/test_oa_hash_map.h"
 #include "tests/core/templates/test_paged_array.h"
+#include "tests/core/templates/test_radix_sort.h"
 #include "tests/core/templates/test_rid.h"
 #include "tests/core/templates/test_vector.h"
 #include "tests/core/test_crypto.h"
@@ -132,7 +134,11 @@
 #include "tests/scene/test_viewport.h"
 #include "tests/scene/test_visual_shader.h"
 #include "tests/scene/test_window.h"
+#include "tests/servers/rendering/test_pipeline_cache_rd.h"
+#include "tests/servers/rendering/test_rendering_cpu_profiler.h"
+#include "tests/servers/rendering/test_rendering_device_graph.h"
 #include "tests/servers/rendering/test_shader_preprocessor.h"
+#include "tests/servers/rendering/test_shader_stage_cache_rd.h"
 #include "tests/servers/test_text_server.h"
 #include "tests/test_validate_testing.h"
 
@@ -218,14 +224,23 @@ int test_main(int argc, char *argv[]) {
 	doctest::Context test_context;
 	LocalVector<String> test_args;
 
-	// Clean arguments of "--test" from the args.
+	// Clean arguments of "--test" and "--test-benchmarks" from the args.
+	bool run_benchmarks = false;
 	for (int x = 0; x < argc; x++) {
 		String arg = String(argv[x]);
-		if (arg != "--test") {
+		if (arg == "--test-benchmarks") {
+			run_benchmarks = true;
+		} else if (arg != "--test") {
 			test_args.push_back(arg);
 		}
 	}
 
+	// Timing runs are tagged "[Benchmark]" and are only run when explicitly requested,
+	// so that they don't slow down the unit test suite.
+	if (!run_benchmarks) {
+		test_context.addFilter("test-case-exclude", "*[Benchmark]*");
+	}
+
 	if (test_args.size() > 0) {
 		// Convert Godot command line arguments back to standard arguments.
 		char **doctest_args = new char *[test_args.size()];